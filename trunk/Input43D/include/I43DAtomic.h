@@ -0,0 +1,119 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+#ifndef _I43D_ATOMIC_H_
+#define _I43D_ATOMIC_H_
+
+#include "I43DCommon.h"
+
+#if defined( _MSC_VER )
+#	include <intrin.h>
+#	pragma intrinsic(_InterlockedExchangeAdd, _InterlockedCompareExchange, _ReadWriteBarrier)
+#endif
+
+/*!
+ * @file
+ *     This file contains the few atomic operations the lock free parts of the library need.
+ *     They map to compiler intrinsics so they are always inlined.
+ * @author Robert Eugene Simmons Jr. (Kraythe)
+ */
+
+namespace I43D {
+
+/*!
+ * @brief
+ *     Reads a value with acquire semantics. 
+ * @remarks
+ *     Reads and writes that follow in program order can not be moved before this read.
+ */
+inline unsigned int atomicLoad(const volatile unsigned int& value) {
+#if defined( _MSC_VER )
+	// -- Volatile reads have acquire semantics with MSVC on x86.
+	const unsigned int result = value;
+	_ReadWriteBarrier();
+	return result;
+#else
+	return __atomic_load_n(&value, __ATOMIC_ACQUIRE);
+#endif
+}
+
+/*!
+ * @brief
+ *     Writes a value with release semantics.
+ * @remarks
+ *     Reads and writes that precede in program order can not be moved after this write.
+ */
+inline void atomicStore(volatile unsigned int& value, const unsigned int newValue) {
+#if defined( _MSC_VER )
+	// -- Volatile writes have release semantics with MSVC on x86.
+	_ReadWriteBarrier();
+	value = newValue;
+#else
+	__atomic_store_n(&value, newValue, __ATOMIC_RELEASE);
+#endif
+}
+
+/*!
+ * @brief
+ *     Adds to a value as a full barrier.
+ * @return
+ *     The value after the addition.
+ */
+inline unsigned int atomicAdd(volatile unsigned int& value, const unsigned int delta) {
+#if defined( _MSC_VER )
+	return static_cast<unsigned int>(_InterlockedExchangeAdd(
+		reinterpret_cast<volatile long*>(&value), static_cast<long>(delta))) + delta;
+#else
+	return __atomic_add_fetch(&value, delta, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/*!
+ * @brief
+ *     Replaces a value if it holds the expected value, as a full barrier.
+ * @return
+ *     True if the value was replaced.
+ */
+inline bool atomicCompareExchange(volatile unsigned int& value, const unsigned int expected, 
+                                  const unsigned int desired) {
+#if defined( _MSC_VER )
+	return static_cast<unsigned int>(_InterlockedCompareExchange(
+		reinterpret_cast<volatile long*>(&value), static_cast<long>(desired), 
+		static_cast<long>(expected))) == expected;
+#else
+	unsigned int current = expected;
+	return __atomic_compare_exchange_n(&value, &current, desired, false, __ATOMIC_SEQ_CST, 
+	                                   __ATOMIC_SEQ_CST);
+#endif
+}
+
+/*!
+ * @brief
+ *     A full memory barrier.
+ */
+inline void atomicFence() {
+#if defined( _MSC_VER )
+	_mm_mfence();
+#else
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+#endif
+}
+
+} // namespace I43D
+#endif  // _I43D_ATOMIC_H_
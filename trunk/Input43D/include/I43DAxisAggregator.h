@@ -0,0 +1,174 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+#ifndef _I43D_AXIS_AGGREGATOR_H_
+#define _I43D_AXIS_AGGREGATOR_H_
+
+#include "I43DCommon.h"
+#include <vector>
+
+/*!
+ * @file
+ *     This file contains the aggregation of the axis samples that arrive between frames.
+ * @author Robert Eugene Simmons Jr. (Kraythe)
+ */
+
+namespace I43D {
+
+// ---- Forward Declarations
+struct _DLL_EXPORT AxisSummary;
+class _DLL_EXPORT AxisAggregator;
+
+/*!
+ * @brief
+ *     The summary of the samples of one axis during a frame.
+ */
+struct _DLL_EXPORT AxisSummary {
+	/*! @brief The first sample of the frame. */
+	int first;
+
+	/*! @brief The last sample of the frame. */
+	int last;
+
+	/*! @brief The smallest sample of the frame. */
+	int minimum;
+
+	/*! @brief The largest sample of the frame. */
+	int maximum;
+
+	/*! @brief The mean of the samples of the frame. */
+	float mean;
+
+	/*! @brief The number of samples in the frame. */
+	unsigned int count;
+};
+
+/*!
+ * @brief
+ *     Summarizes every sample of a number of axes between frames.
+ * @remarks
+ *     Devices like flight sticks and racing wheels report far more often than a game 
+ *     renders frames, and reading only the latest position misses short peaks. The 
+ *     aggregator folds every sample into the first, last, smallest and largest sample, a
+ *     sum and a count of each axis. Each of these is kept in its own array so memory is 
+ *     fixed by the number of axes no matter how many samples arrive. An axis without
+ *     samples in a frame holds its last position.
+ */
+class _DLL_EXPORT AxisAggregator {
+public:
+	/*!
+	 * @brief
+	 *     Constructor.
+	 * @param axisCount
+	 *     The number of axes.
+	 */
+	AxisAggregator(const unsigned int axisCount = 0);
+
+	/*!
+	 * @brief
+	 *     Changes the number of axes. All axes are reset to zero.
+	 */
+	void setAxisCount(const unsigned int axisCount);
+
+	/*!
+	 * @brief
+	 *     Gets the number of axes.
+	 */
+	inline unsigned int getAxisCount() const {
+		return static_cast<unsigned int>(this->last.size());
+	}
+
+	/*!
+	 * @brief
+	 *     Adds a sample of an axis to the current frame.
+	 * @param axis
+	 *     The axis.
+	 * @param value
+	 *     The sample.
+	 */
+	inline void addSample(const unsigned int axis, const int value) {
+		if (this->count[axis]++ == 0) {
+			this->first[axis] = this->minimum[axis] = this->maximum[axis] = value;
+		} else if (value < this->minimum[axis]) {
+			this->minimum[axis] = value;
+		} else if (value > this->maximum[axis]) {
+			this->maximum[axis] = value;
+		}
+		this->last[axis] = value;
+		this->sum[axis] += value;
+	}
+
+	/*!
+	 * @brief
+	 *     Starts a new frame, discarding the summary of the previous one.
+	 */
+	void beginFrame();
+
+	/*!
+	 * @brief
+	 *     Gets the summary of an axis for the current frame.
+	 */
+	AxisSummary getSummary(const unsigned int axis) const;
+
+	/*!
+	 * @brief
+	 *     Gets the mean of the samples of an axis for the current frame.
+	 */
+	inline float getMean(const unsigned int axis) const {
+		return this->count[axis] == 0 ? static_cast<float>(this->last[axis]) : 
+		       static_cast<float>(static_cast<double>(this->sum[axis]) / this->count[axis]);
+	}
+
+	/*! @brief Gets the first sample of each axis. */
+	inline const int* getFirst() const { return &this->first[0]; }
+
+	/*! @brief Gets the last sample of each axis. */
+	inline const int* getLast() const { return &this->last[0]; }
+
+	/*! @brief Gets the smallest sample of each axis. */
+	inline const int* getMinimum() const { return &this->minimum[0]; }
+
+	/*! @brief Gets the largest sample of each axis. */
+	inline const int* getMaximum() const { return &this->maximum[0]; }
+
+	/*! @brief Gets the number of samples of each axis. */
+	inline const unsigned int* getCount() const { return &this->count[0]; }
+
+private:
+	/*! @brief The first sample of each axis. */
+	std::vector<int> first;
+
+	/*! @brief The last sample of each axis. */
+	std::vector<int> last;
+
+	/*! @brief The smallest sample of each axis. */
+	std::vector<int> minimum;
+
+	/*! @brief The largest sample of each axis. */
+	std::vector<int> maximum;
+
+	/*! @brief The sum of the samples of each axis. */
+	std::vector<long long> sum;
+
+	/*! @brief The number of samples of each axis. */
+	std::vector<unsigned int> count;
+};
+
+} // namespace I43D
+#endif  // _I43D_AXIS_AGGREGATOR_H_
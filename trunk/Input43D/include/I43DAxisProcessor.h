@@ -0,0 +1,183 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+#ifndef _I43D_AXIS_PROCESSOR_H_
+#define _I43D_AXIS_PROCESSOR_H_
+
+#include "I43DCommon.h"
+#include <vector>
+
+/*!
+ * @file
+ *     This file contains the processing that turns the raw positions of controller axes
+ *     into normalized values with deadzones and response curves applied.
+ * @author Robert Eugene Simmons Jr. (Kraythe)
+ */
+
+namespace I43D {
+
+// ---- Forward Declarations
+struct _DLL_EXPORT AxisSettings;
+class _DLL_EXPORT AxisProcessor;
+
+/*!
+ * @brief
+ *     The shapes of deadzone that can be applied to an axis.
+ */
+enum _DLL_EXPORT DeadzoneShape {
+	DEADZONE_AXIAL = 0,		// The deadzone of each axis is applied on its own
+	DEADZONE_RADIAL			// The deadzone is applied to the length of the stick formed with the paired axis
+};
+
+/*!
+ * @brief
+ *     How the raw position of an axis is turned into a normalized value.
+ * @remarks
+ *     The raw position is first mapped to -1 to 1 for centered axes or 0 to 1 for axes 
+ *     that rest at their minimum, like triggers. Positions within the deadzone read as
+ *     zero, positions past the saturation read as full deflection and the range between
+ *     is rescaled and shaped by the response curve.
+ */
+struct _DLL_EXPORT AxisSettings {
+	/*! @brief The smallest raw position the device reports. */
+	int minimum;
+
+	/*! @brief The largest raw position the device reports. */
+	int maximum;
+
+	/*! @brief Whether the axis rests in the middle of its range (true) or at its minimum (false). */
+	bool centered;
+
+	/*! @brief The normalized deflection below which the axis reads as zero. */
+	float deadzone;
+
+	/*! @brief The normalized deflection above which the axis reads as full deflection. */
+	float saturation;
+
+	/*! @brief The response curve from 0 for linear to 1 for cubic. */
+	float curve;
+
+	/*! @brief The shape of the deadzone. */
+	DeadzoneShape shape;
+
+	/*! @brief The other axis of the stick for radial deadzones. */
+	unsigned short pairedAxis;
+
+	/*!
+	 * @brief
+	 *     Constructor. Creates the settings of a centered axis with the full range of a
+	 *     signed short, no deadzone and a linear response.
+	 */
+	AxisSettings() 
+		: minimum(-32768), maximum(32767), centered(true), deadzone(0.0f), saturation(1.0f), 
+		  curve(0.0f), shape(DEADZONE_AXIAL), pairedAxis(0) {}
+};
+
+/*!
+ * @brief
+ *     Normalizes a batch of axes in a single pass.
+ * @remarks
+ *     The processor holds the settings of a number of lanes, one per axis, in separate
+ *     arrays so the processing runs four lanes at a time with SSE2 where it is available 
+ *     and falls back to plain code elsewhere. The lanes of many controllers can be put in
+ *     one processor so that all of the axes of all controllers are processed together.
+ */
+class _DLL_EXPORT AxisProcessor {
+public:
+	/*!
+	 * @brief
+	 *     Constructor.
+	 * @param laneCount
+	 *     The number of lanes.
+	 */
+	AxisProcessor(const unsigned int laneCount = 0);
+
+	/*!
+	 * @brief
+	 *     Changes the number of lanes. All lanes are reset to the default settings.
+	 */
+	void setLaneCount(const unsigned int laneCount);
+
+	/*!
+	 * @brief
+	 *     Gets the number of lanes.
+	 */
+	inline unsigned int getLaneCount() const {
+		return this->laneCount;
+	}
+
+	/*!
+	 * @brief
+	 *     Configures a lane.
+	 * @param lane
+	 *     The lane to configure.
+	 * @param settings
+	 *     The settings of the axis.
+	 * @param pairedLane
+	 *     The lane of the paired axis used for radial deadzones.
+	 * @return
+	 *     RESULT_OUT_OF_RANGE if the lane does not exist.
+	 */
+	ResultCode setLane(const unsigned int lane, const AxisSettings& settings, 
+	                   const unsigned int pairedLane);
+
+	/*!
+	 * @brief
+	 *     Normalizes the raw positions of all lanes.
+	 * @param raw
+	 *     The raw position of each lane.
+	 * @param normalized
+	 *     Receives the normalized value of each lane.
+	 */
+	void process(const int* raw, float* normalized);
+
+private:
+	/*! @brief The number of lanes. */
+	unsigned int laneCount;
+
+	/*! @brief The raw position that maps to zero for each lane. */
+	std::vector<float> center;
+
+	/*! @brief The factor that maps the raw position to a unit deflection for each lane. */
+	std::vector<float> scale;
+
+	/*! @brief The deadzone of each lane. */
+	std::vector<float> deadzone;
+
+	/*! @brief The reciprocal of the distance between deadzone and saturation for each lane. */
+	std::vector<float> liveScale;
+
+	/*! @brief The response curve of each lane. */
+	std::vector<float> curve;
+
+	/*! @brief 1 for lanes with a radial deadzone and 0 otherwise. */
+	std::vector<float> radial;
+
+	/*! @brief The paired lane of each lane. */
+	std::vector<unsigned int> paired;
+
+	/*! @brief The unit deflection of each lane during processing. */
+	std::vector<float> deflection;
+
+	/*! @brief The unit deflection of the paired lane of each lane during processing. */
+	std::vector<float> pairedDeflection;
+};
+
+} // namespace I43D
+#endif  // _I43D_AXIS_PROCESSOR_H_
@@ -0,0 +1,82 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+#ifndef _I43D_BACKEND_H_
+#define _I43D_BACKEND_H_
+
+/*!
+ * @file
+ *     This file selects the device classes of the one backend a build ships with. Code 
+ *     that polls devices every frame can hold them as BackendMouse and BackendKeyboard 
+ *     instead of I43D::Mouse and I43D::Keyboard; the backend classes are final, so those 
+ *     calls are direct and the state accessors inline. The abstract interfaces stay for 
+ *     plugins and for code that must work with any backend.
+ *     <br><br>
+ *     Define I43D_BACKEND_VIRTUAL to select the event driven devices on any platform, for 
+ *     example for a dedicated server or a replay tool. Otherwise the platform devices are
+ *     selected.
+ * @author Robert Eugene Simmons Jr. (Kraythe)
+ */
+
+#if defined( I43D_BACKEND_VIRTUAL ) || !defined( _WIN32 )
+#	include "I43DVirtualDevice.h"
+#else
+#	include "Win32/I43DWin32Keyboard.h"
+#	include "Win32/I43DWin32Mouse.h"
+#endif
+
+namespace I43D {
+
+#if defined( I43D_BACKEND_VIRTUAL ) || !defined( _WIN32 )
+/*! @brief The mouse class of the backend. */
+typedef VirtualMouse BackendMouse;
+
+/*! @brief The keyboard class of the backend. */
+typedef VirtualKeyboard BackendKeyboard;
+#else
+/*! @brief The mouse class of the backend. */
+typedef Win32Mouse BackendMouse;
+
+/*! @brief The keyboard class of the backend. */
+typedef Win32Keyboard BackendKeyboard;
+#endif
+
+/*!
+ * @brief
+ *     Gets the backend class of a mouse handed out through the abstract interface.
+ * @remarks
+ *     Only valid in builds with a single backend, where every mouse is a BackendMouse.
+ */
+inline BackendMouse& getBackendMouse(Mouse& mouse) {
+	return static_cast<BackendMouse&>(mouse);
+}
+
+/*!
+ * @brief
+ *     Gets the backend class of a keyboard handed out through the abstract interface.
+ * @remarks
+ *     Only valid in builds with a single backend, where every keyboard is a 
+ *     BackendKeyboard.
+ */
+inline BackendKeyboard& getBackendKeyboard(Keyboard& keyboard) {
+	return static_cast<BackendKeyboard&>(keyboard);
+}
+
+} // namespace I43D
+#endif  // _I43D_BACKEND_H_
@@ -46,10 +46,26 @@ http://www.gnu.org/copyleft/lesser.txt.
 #	endif
 #elif defined( __APPLE_CC__ ) // Apple OS X
 #elif defined( __MINGW32__ ) // Linux
+#elif defined( __linux__ ) // Linux
 #else // for any other platform create an error.
 #	error Unknown Platform
 #endif
 
+// -- The abstract keyword is an MSVC extension so it expands to nothing on other compilers.
+#if !defined( _MSC_VER ) && !defined( abstract )
+#	define abstract
+#endif
+
+// -- Marks a class that can not be derived from. Calls through a reference to such a class
+// -- need no virtual dispatch, so the compiler can inline them.
+#if defined( _MSC_VER ) && _MSC_VER < 1700
+#	define I43D_FINAL sealed
+#elif defined( _MSC_VER ) || __cplusplus >= 201103L
+#	define I43D_FINAL final
+#else
+#	define I43D_FINAL
+#endif
+
 // -- Create a macro for wide string file names if it doesnt exist. 
 #ifndef __WFILE__
 #	define WIDEN2(x) L ## x
@@ -57,8 +73,110 @@ http://www.gnu.org/copyleft/lesser.txt.
 #	define __WFILE__ WIDEN(__FILE__)
 #endif
 
+// -- Reports a failure. Builds with I43D_NO_EXCEPTIONS return the code from the failing 
+// -- method instead of throwing, and report failures of constructors to the startup error
+// -- handler, which does not return.
+#if defined( I43D_NO_EXCEPTIONS )
+#	define I43D_FAIL(code, detail) return (code)
+#	define I43D_FAIL_STARTUP(code, detail) \
+		I43D::failStartup((code), (detail), __WFILE__, __LINE__)
+#else
+#	define I43D_FAIL(code, detail) \
+		throw I43D::I43DException((detail), __WFILE__, __LINE__, (code))
+#	define I43D_FAIL_STARTUP(code, detail) \
+		throw I43D::I43DException((detail), __WFILE__, __LINE__, (code))
+#endif
+
 #include <string>
 namespace I43D {
+
+/*!
+ * @brief
+ *     The outcome of an operation.
+ * @remarks
+ *     Operations that can fail while the application runs return one of these. Builds 
+ *     with exceptions throw an I43D::I43DException carrying the code instead of returning
+ *     anything but RESULT_OK, except for RESULT_NOT_IMPLEMENTED which is always returned.
+ */
+enum _DLL_EXPORT ResultCode {
+	/*! @brief The operation succeeded. */
+	RESULT_OK = 0,
+
+	/*! @brief The device does not support the operation. */
+	RESULT_NOT_IMPLEMENTED,
+
+	/*! @brief An index or number was outside the valid range. */
+	RESULT_OUT_OF_RANGE,
+
+	/*! @brief A fixed size table is full. */
+	RESULT_FULL,
+
+	/*! @brief An object was not registered where the operation expected it. */
+	RESULT_NOT_FOUND,
+
+	/*! @brief The operating system refused a request. */
+	RESULT_SYSTEM_ERROR,
+
+	/*! @brief Data or a device did not have the expected format or capabilities. */
+	RESULT_INCOMPATIBLE
+};
+
+/*!
+ * @brief
+ *     Gets a short description of a result code. The text is static.
+ */
+inline const wchar_t* getResultText(const ResultCode code) {
+	switch (code) {
+		case RESULT_OK:
+			return L"Success";
+		case RESULT_NOT_IMPLEMENTED:
+			return L"Not implemented";
+		case RESULT_OUT_OF_RANGE:
+			return L"Out of range";
+		case RESULT_FULL:
+			return L"Table full";
+		case RESULT_NOT_FOUND:
+			return L"Not found";
+		case RESULT_SYSTEM_ERROR:
+			return L"System error";
+		case RESULT_INCOMPATIBLE:
+			return L"Incompatible";
+		default:
+			return L"Unknown result";
+	}
+}
+
+/*!
+ * @brief
+ *     Called when a device can not be created in a build without exceptions.
+ * @param code
+ *     What went wrong.
+ * @param detail
+ *     The detail message.
+ * @param file
+ *     The source file of the failure.
+ * @param line
+ *     The line in the source file.
+ */
+typedef void (*StartupErrorHandler)(const ResultCode code, const wchar_t* detail, 
+                                    const wchar_t* file, const unsigned int line);
+
+/*!
+ * @brief
+ *     Sets the function told about failed constructors in builds without exceptions, for 
+ *     example to log them. The process is aborted after the handler returns.
+ * @param handler
+ *     The handler, or 0 for none.
+ */
+_DLL_EXPORT void setStartupErrorHandler(StartupErrorHandler handler);
+
+/*!
+ * @brief
+ *     Reports a failed constructor to the startup error handler and aborts. Used by 
+ *     I43D_FAIL_STARTUP in builds without exceptions.
+ */
+_DLL_EXPORT void failStartup(const ResultCode code, const wchar_t* detail, 
+                             const wchar_t* file, const unsigned int line);
 	
 class I43DException {
 public: 
@@ -71,12 +189,16 @@ public:
 	/*! @brief contains the line number in the file where the exception occurred. */
 	const unsigned int line;
 
+	/*! @brief contains what went wrong. */
+	const ResultCode code;
+
 	/*!
 	 * @breif
 	 *     Constructor
 	 */
-	I43DException(const std::wstring detail, std::wstring file, const unsigned int line) 
-		: detail(detail), file(file), line(line) {
+	I43DException(const std::wstring& detail, const std::wstring& file, const unsigned int line,
+	              const ResultCode code = RESULT_SYSTEM_ERROR) 
+		: detail(detail), file(file), line(line), code(code) {
 		// no code needed.
 	}
 };
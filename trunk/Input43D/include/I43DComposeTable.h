@@ -0,0 +1,323 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+#ifndef _I43D_COMPOSE_TABLE_H_
+#define _I43D_COMPOSE_TABLE_H_
+
+#include "I43DCommon.h"
+#include "I43DMappedFile.h"
+#include "I43DTextInput.h"
+#include <vector>
+
+/*!
+ * @file
+ *     This file contains the compose engine that turns dead key and compose key sequences
+ *     into characters. 
+ * @author Robert Eugene Simmons Jr. (Kraythe)
+ */
+
+namespace I43D {
+
+// ---- Forward Declarations
+class _DLL_EXPORT ComposeTable;
+class _DLL_EXPORT ComposeState;
+
+/*!
+ * @brief
+ *     A symbol produced by a key for the purpose of composition.
+ * @remarks
+ *     Keys that type a character produce the unicode code point of the character. Keys that
+ *     do not, such as dead keys and the compose key, produce their X11 keysym value with 
+ *     COMPOSE_KEYSYM_FLAG set so the two ranges never collide.
+ */
+typedef unsigned int ComposeSymbol;
+
+/*! @brief Marks a ComposeSymbol that is a keysym rather than a code point. */
+const ComposeSymbol COMPOSE_KEYSYM_FLAG = 0x01000000;
+
+/*! @brief The compose key, also known as Multi_key. */
+const ComposeSymbol COMPOSE_MULTI_KEY = COMPOSE_KEYSYM_FLAG | 0xFF20;
+
+/*! @brief Dead grave accent. */
+const ComposeSymbol COMPOSE_DEAD_GRAVE = COMPOSE_KEYSYM_FLAG | 0xFE50;
+
+/*! @brief Dead acute accent. */
+const ComposeSymbol COMPOSE_DEAD_ACUTE = COMPOSE_KEYSYM_FLAG | 0xFE51;
+
+/*! @brief Dead circumflex, the ^ key on German layouts. */
+const ComposeSymbol COMPOSE_DEAD_CIRCUMFLEX = COMPOSE_KEYSYM_FLAG | 0xFE52;
+
+/*! @brief Dead tilde. */
+const ComposeSymbol COMPOSE_DEAD_TILDE = COMPOSE_KEYSYM_FLAG | 0xFE53;
+
+/*! @brief Dead diaeresis. */
+const ComposeSymbol COMPOSE_DEAD_DIAERESIS = COMPOSE_KEYSYM_FLAG | 0xFE57;
+
+/*! @brief Dead cedilla. */
+const ComposeSymbol COMPOSE_DEAD_CEDILLA = COMPOSE_KEYSYM_FLAG | 0xFE5B;
+
+/*!
+ * @brief
+ *     The outcome of feeding a symbol to a ComposeState.
+ */
+enum _DLL_EXPORT ComposeResult {
+	COMPOSE_IGNORED,	// The symbol does not start a sequence and should be typed normally
+	COMPOSE_PENDING,	// The symbol continued a sequence that is not complete yet
+	COMPOSE_COMPLETE,	// The symbol completed a sequence; the composed text is available
+	COMPOSE_CANCELLED	// The symbol does not continue the sequence; the sequence is dropped
+};
+
+/*!
+ * @brief
+ *     A precompiled table of compose sequences.
+ * @remarks
+ *     The table is a trie flattened into three arrays: nodes, sorted edges and a pool of
+ *     result characters. Following a symbol is a binary search among the edges of one node,
+ *     so composing costs time proportional to the length of the sequence no matter how many 
+ *     sequences the table holds.
+ *     <br><br>
+ *     Tables are compiled from the X11 Compose file format and stored in a binary cache 
+ *     file. The cache records the size and modification time of the source file and is
+ *     mapped into memory as is, so once it exists opening a table neither parses nor copies
+ *     anything. Keep one table per layout and switch with Keyboard::setComposeTable() to
+ *     change layouts without reloading.
+ */
+class _DLL_EXPORT ComposeTable {
+public:
+	/*!
+	 * @brief
+	 *     Constructor. Creates an empty table.
+	 */
+	ComposeTable();
+
+	/*!
+	 * @brief
+	 *     Opens a table, compiling it only if the cache is missing or out of date.
+	 * @remarks
+	 *     If the cache is valid it is mapped. Otherwise the source is compiled and the cache
+	 *     is rewritten. If the cache can not be written the compiled table is still used.
+	 * @param sourcePath
+	 *     The path of the X11 Compose file.
+	 * @param cachePath
+	 *     The path of the binary cache file.
+	 * @return
+	 *     True if the table was opened, false if neither the cache nor the source could be
+	 *     read.
+	 */
+	bool open(const std::string& sourcePath, const std::string& cachePath);
+
+	/*!
+	 * @brief
+	 *     Maps a binary cache file without checking its source.
+	 * @param cachePath
+	 *     The path of the binary cache file.
+	 * @return
+	 *     True if the file is a valid compose table.
+	 */
+	bool openCache(const std::string& cachePath);
+
+	/*!
+	 * @brief
+	 *     Compiles an X11 Compose file.
+	 * @remarks
+	 *     Lines whose keysyms are unknown to the engine and include statements are skipped.
+	 *     When a sequence is defined twice the later definition wins. 
+	 * @param sourcePath
+	 *     The path of the X11 Compose file.
+	 * @param cachePath
+	 *     The path to write the binary cache to or an empty string to not write one.
+	 * @return
+	 *     True if the source was read. The cache is best effort.
+	 */
+	bool compile(const std::string& sourcePath, const std::string& cachePath);
+
+	/*!
+	 * @brief
+	 *     Compiles compose definitions held in memory.
+	 * @param source
+	 *     The definitions in the X11 Compose file format.
+	 * @param length
+	 *     The number of bytes in source.
+	 */
+	void compileText(const char* source, const size_t length);
+
+	/*!
+	 * @brief
+	 *     Gets the number of sequences in the table.
+	 */
+	unsigned int getSequenceCount() const;
+
+	/*!
+	 * @brief
+	 *     Gets the number of lines that were skipped by the last compile.
+	 */
+	inline unsigned int getSkippedLineCount() const {
+		return this->skippedLines;
+	}
+
+	/*!
+	 * @brief
+	 *     Looks up the symbol name used in X11 Compose files.
+	 * @param name
+	 *     The keysym name without the angle brackets, for example dead_circumflex or U00F4.
+	 * @param symbol
+	 *     Receives the symbol.
+	 * @return
+	 *     True if the name is known.
+	 */
+	static bool lookupSymbolName(const std::string& name, ComposeSymbol& symbol);
+
+private:
+	friend class ComposeState;
+
+	/*!
+	 * @brief
+	 *     A node of the flattened trie.
+	 */
+	struct Node {
+		/*! @brief The index of the first edge of the node. */
+		unsigned int firstEdge;
+
+		/*! @brief The number of edges of the node. */
+		unsigned int edgeCount;
+
+		/*! @brief The index of the result in the pool. */
+		unsigned int resultOffset;
+
+		/*! @brief The number of characters in the result or 0 if there is none. */
+		unsigned int resultLength;
+	};
+
+	/*!
+	 * @brief
+	 *     Follows the edge for a symbol.
+	 * @return
+	 *     The index of the child node or 0 if there is no such edge. The root is never a child.
+	 */
+	unsigned int follow(const unsigned int node, const ComposeSymbol symbol) const;
+
+	/*!
+	 * @brief
+	 *     Points the table at the arrays stored in a cache image.
+	 * @return
+	 *     False if the image is not a valid table.
+	 */
+	bool attach(const void* image, const size_t size);
+
+	/*! @brief The nodes. Node 0 is the root. */
+	const Node* nodes;
+
+	/*! @brief The symbol of each edge. The edges of a node are sorted by symbol. */
+	const ComposeSymbol* edgeSymbols;
+
+	/*! @brief The target node of each edge. */
+	const unsigned int* edgeTargets;
+
+	/*! @brief The result characters. */
+	const UnicodeChar* pool;
+
+	/*! @brief The number of nodes. */
+	unsigned int nodeCount;
+
+	/*! @brief The number of edges. */
+	unsigned int edgeCount;
+
+	/*! @brief The number of characters in the pool. */
+	unsigned int poolLength;
+
+	/*! @brief The number of lines skipped by the last compile. */
+	unsigned int skippedLines;
+
+	/*! @brief The mapped cache file. */
+	MappedFile cacheFile;
+
+	/*! @brief A cache image built in memory when the cache file could not be used. */
+	std::vector<unsigned int> image;
+};
+
+/*!
+ * @brief
+ *     The progress of a single compose sequence through a ComposeTable.
+ */
+class _DLL_EXPORT ComposeState {
+public:
+	/*!
+	 * @brief
+	 *     Constructor.
+	 */
+	ComposeState() : table(0), node(0) {}
+
+	/*!
+	 * @brief
+	 *     Sets the table to compose with. Any sequence in progress is dropped.
+	 * @param table
+	 *     The table or NULL to disable composition.
+	 */
+	inline void setTable(const ComposeTable* table) {
+		this->table = table;
+		this->node = 0;
+	}
+
+	/*!
+	 * @brief
+	 *     Gets the table to compose with.
+	 */
+	inline const ComposeTable* getTable() const {
+		return this->table;
+	}
+
+	/*!
+	 * @brief
+	 *     Feeds the next symbol.
+	 * @param symbol
+	 *     The symbol produced by the key that was typed.
+	 * @param text
+	 *     Receives the composed characters when the result is COMPOSE_COMPLETE. They are 
+	 *     owned by the table.
+	 * @param length
+	 *     Receives the number of composed characters.
+	 */
+	ComposeResult feed(const ComposeSymbol symbol, const UnicodeChar*& text, unsigned int& length);
+
+	/*!
+	 * @brief
+	 *     Determines if a sequence is in progress.
+	 */
+	inline bool isComposing() const {
+		return this->node != 0;
+	}
+
+	/*!
+	 * @brief
+	 *     Drops the sequence in progress.
+	 */
+	inline void reset() {
+		this->node = 0;
+	}
+
+private:
+	/*! @brief The table to compose with. */
+	const ComposeTable* table;
+
+	/*! @brief The node reached by the sequence so far. 0 when no sequence is in progress. */
+	unsigned int node;
+};
+
+} // namespace I43D
+#endif  // _I43D_COMPOSE_TABLE_H_
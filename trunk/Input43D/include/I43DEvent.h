@@ -0,0 +1,267 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+#ifndef _I43D_EVENT_H_
+#define _I43D_EVENT_H_
+
+#include "I43DCommon.h"
+#include "I43DGameController.h"
+#include "I43DInputManager.h"
+#include "I43DKeyboard.h"
+#include "I43DMouse.h"
+#include "I43DTimer.h"
+
+/*!
+ * @file
+ *     This file contains the plain event record used when input leaves the listener 
+ *     callbacks of a device, for example to be queued for another thread, along with the
+ *     listeners that translate device callbacks into such records.
+ * @author Robert Eugene Simmons Jr. (Kraythe)
+ */
+
+namespace I43D {
+
+// ---- Forward Declarations
+struct _DLL_EXPORT InputEvent;
+class _DLL_EXPORT InputEventSink;
+class _DLL_EXPORT KeyboardEventTranslator;
+class _DLL_EXPORT MouseEventTranslator;
+class _DLL_EXPORT GameControllerEventTranslator;
+
+/*!
+ * @brief
+ *     The kinds of input events. 
+ * @remarks
+ *     The meaning of the code and values of an InputEvent depends on its type as noted for
+ *     each member.
+ */
+enum _DLL_EXPORT InputEventType {
+	IEVT_NONE = 0,
+	IEVT_KEY_PRESSED,					// code: key number, value: scan code
+	IEVT_KEY_RELEASED,					// code: key number, value: scan code
+	IEVT_KEY_REPEATED,					// code: key number, value: scan code, value2: repeat count
+	IEVT_CHAR_TYPED,					// value: the unicode code point
+	IEVT_MOUSE_MOVED,					// value: x, value2: y
+	IEVT_MOUSE_BUTTON_PRESSED,			// code: button number
+	IEVT_MOUSE_BUTTON_RELEASED,			// code: button number
+	IEVT_MOUSE_SCROLLED,				// code: MouseScrollDirection
+	IEVT_CONTROLLER_BUTTON_PRESSED,		// code: button number
+	IEVT_CONTROLLER_BUTTON_RELEASED,	// code: button number
+	IEVT_CONTROLLER_AXIS_MOVED,			// code: axis number, value: raw position, value2: normalized in 1/32767
+	IEVT_DEVICE_CONNECTED,				// code: DeviceType
+	IEVT_DEVICE_DISCONNECTED,			// code: DeviceType
+	IEVT_COUNT							// The number of event types
+};
+
+/*!
+ * @brief
+ *     A single input event as plain data.
+ * @remarks
+ *     Events are small and trivially copyable so they can be stored in fixed size rings
+ *     and copied between threads and processes.
+ */
+struct _DLL_EXPORT InputEvent {
+	/*! @brief When the event happened on the input clock. */
+	Timestamp time;
+
+	/*! @brief The device that generated the event. */
+	DeviceID device;
+
+	/*! @brief One of the InputEventType values. */
+	unsigned short type;
+
+	/*! @brief The key, button or axis number. */
+	unsigned short code;
+
+	/*! @brief The first value. */
+	int value;
+
+	/*! @brief The second value. */
+	int value2;
+};
+
+/*!
+ * @brief
+ *     Receives input events.
+ */
+class _DLL_EXPORT InputEventSink abstract {
+public:
+	/*!
+	 * @brief
+	 *     Destructor.
+	 */
+	virtual ~InputEventSink() {}
+
+	/*!
+	 * @brief
+	 *     Receives an event.
+	 * @param event
+	 *     The event.
+	 * @return
+	 *     False if the event could not be accepted.
+	 */
+	virtual bool pushEvent(const InputEvent& event) = 0;
+};
+
+/*!
+ * @brief
+ *     Translates the callbacks of a keyboard into input events.
+ * @remarks
+ *     Register the translator as a listener of the keyboard. Events are stamped with the
+ *     time of the callback except for repeats which carry their exact due time.
+ */
+class _DLL_EXPORT KeyboardEventTranslator : public KeyboardListener {
+public:
+	/*!
+	 * @brief
+	 *     Constructor.
+	 * @param sink
+	 *     The sink that receives the events.
+	 * @param device
+	 *     The id to stamp the events with.
+	 */
+	KeyboardEventTranslator(InputEventSink& sink, const DeviceID device) 
+		: sink(sink), device(device) {}
+
+	/*! @see I43D::KeyboardListener:: */
+	virtual void keyPressed(const Keyboard* source, const unsigned short keyNum, 
+	                        const unsigned int scanCode);
+
+	/*! @see I43D::KeyboardListener:: */
+	virtual void keyReleased(const Keyboard* source, const unsigned short keyNum, 
+	                         const unsigned int scanCode);
+
+	/*! @see I43D::KeyboardListener:: */
+	virtual void keyRepeated(const Keyboard* source, const unsigned short keyNum, 
+	                         const unsigned int scanCode, const unsigned int repeatCount,
+	                         const Timestamp time);
+
+	/*! @see I43D::KeyboardListener:: */
+	virtual void textInput(const Keyboard* source, const TextInput& text);
+
+private:
+	KeyboardEventTranslator& operator=(const KeyboardEventTranslator&);
+
+	/*! @brief The sink that receives the events. */
+	InputEventSink& sink;
+
+	/*! @brief The id to stamp the events with. */
+	const DeviceID device;
+};
+
+/*!
+ * @brief
+ *     Translates the callbacks of a mouse into input events.
+ * @remarks
+ *     Register the translator as a listener of the mouse. 
+ */
+class _DLL_EXPORT MouseEventTranslator : public MouseListener {
+public:
+	/*!
+	 * @brief
+	 *     Constructor.
+	 * @param sink
+	 *     The sink that receives the events.
+	 * @param device
+	 *     The id to stamp the events with.
+	 */
+	MouseEventTranslator(InputEventSink& sink, const DeviceID device) 
+		: sink(sink), device(device) {}
+
+	/*! @see I43D::MouseListener:: */
+	virtual void moved(const Mouse* source, const unsigned int x, const unsigned int y);
+
+	/*! @see I43D::MouseListener:: */
+	virtual void buttonPressed(const Mouse* source, const unsigned short buttonNum);
+
+	/*! @see I43D::MouseListener:: */
+	virtual void buttonReleased(const Mouse* source, const unsigned short buttonNum);
+
+	/*! @see I43D::MouseListener:: */
+	virtual void scrollUp(const Mouse* source, const MouseScrollDirection direction);
+
+private:
+	MouseEventTranslator& operator=(const MouseEventTranslator&);
+
+	/*! @brief The sink that receives the events. */
+	InputEventSink& sink;
+
+	/*! @brief The id to stamp the events with. */
+	const DeviceID device;
+};
+
+/*!
+ * @brief
+ *     Translates the callbacks of a game controller into input events.
+ * @remarks
+ *     Register the translator as a listener of the controller. Each changed axis becomes
+ *     its own event.
+ */
+class _DLL_EXPORT GameControllerEventTranslator : public GameControllerListener {
+public:
+	/*!
+	 * @brief
+	 *     Constructor.
+	 * @param sink
+	 *     The sink that receives the events.
+	 * @param device
+	 *     The id to stamp the events with.
+	 */
+	GameControllerEventTranslator(InputEventSink& sink, const DeviceID device) 
+		: sink(sink), device(device) {}
+
+	/*! @see I43D::GameControllerListener:: */
+	virtual void buttonPressed(const GameController* source, const unsigned short buttonNum);
+
+	/*! @see I43D::GameControllerListener:: */
+	virtual void buttonReleased(const GameController* source, const unsigned short buttonNum);
+
+	/*! @see I43D::GameControllerListener:: */
+	virtual void axesChanged(const GameController* source, const ControllerState& state, 
+	                         const unsigned int changedAxes);
+
+private:
+	GameControllerEventTranslator& operator=(const GameControllerEventTranslator&);
+
+	/*! @brief The sink that receives the events. */
+	InputEventSink& sink;
+
+	/*! @brief The id to stamp the events with. */
+	const DeviceID device;
+};
+
+/*!
+ * @brief
+ *     Builds an input event.
+ */
+inline InputEvent makeInputEvent(const Timestamp time, const DeviceID device, 
+                                 const InputEventType type, const unsigned short code,
+                                 const int value = 0, const int value2 = 0) {
+	InputEvent event;
+	event.time = time;
+	event.device = device;
+	event.type = static_cast<unsigned short>(type);
+	event.code = code;
+	event.value = value;
+	event.value2 = value2;
+	return event;
+}
+
+} // namespace I43D
+#endif  // _I43D_EVENT_H_
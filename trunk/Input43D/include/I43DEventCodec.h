@@ -0,0 +1,228 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+#ifndef _I43D_EVENT_CODEC_H_
+#define _I43D_EVENT_CODEC_H_
+
+#include "I43DEvent.h"
+
+/*!
+ * @file
+ *     This file contains the compact wire format used to send input events between 
+ *     processes and machines.
+ * @author Robert Eugene Simmons Jr. (Kraythe)
+ */
+
+namespace I43D {
+
+// ---- Forward Declarations
+class _DLL_EXPORT EventPacketWriter;
+class _DLL_EXPORT EventPacketReader;
+
+/*!
+ * @brief
+ *     Collects input events into a packet.
+ * @remarks
+ *     A packet starts with a fixed header: the size of the rest of the packet as 16 bits,
+ *     a 32 bit sequence number and the 64 bit time the packet was sent, all little endian.
+ *     Each event follows as a tag byte holding the type and which fields changed, then 
+ *     variable length integers: the device if it differs from the previous event, the 
+ *     time since the previous event, the code, and the change of each value against the
+ *     previous event of the same type if it changed. Signed numbers are zigzag encoded so
+ *     small changes either way take one byte. A mouse move typically takes 6 bytes 
+ *     instead of the 24 of an InputEvent.
+ *     <br><br>
+ *     The encoding starts over with every packet, so any packet can be decoded on its own.
+ */
+class _DLL_EXPORT EventPacketWriter {
+public:
+	/*! @brief The size of the packet header. */
+	enum { HEADER_SIZE = 14 };
+
+	/*! @brief The largest packet, chosen to fit an Ethernet frame. */
+	enum { MAX_PACKET_SIZE = 1400 };
+
+	/*! @brief The most bytes one event can take. */
+	enum { MAX_EVENT_SIZE = 40 };
+
+	/*!
+	 * @brief
+	 *     Constructor.
+	 */
+	EventPacketWriter();
+
+	/*!
+	 * @brief
+	 *     Adds an event to the packet.
+	 * @return
+	 *     False if the packet is full. The event was not added.
+	 */
+	bool addEvent(const InputEvent& event);
+
+	/*!
+	 * @brief
+	 *     Gets the number of events in the packet.
+	 */
+	inline unsigned int getEventCount() const {
+		return this->eventCount;
+	}
+
+	/*!
+	 * @brief
+	 *     Completes the header of the packet.
+	 * @param sendTime
+	 *     The time the packet is sent on the input clock.
+	 * @param size
+	 *     Receives the size of the packet in bytes.
+	 * @return
+	 *     The packet. It stays valid until the next call to reset().
+	 */
+	const unsigned char* finish(const Timestamp sendTime, unsigned int& size);
+
+	/*!
+	 * @brief
+	 *     Empties the packet and advances the sequence number.
+	 */
+	void reset();
+
+private:
+	/*!
+	 * @brief
+	 *     Appends an unsigned variable length integer.
+	 */
+	void writeVarint(unsigned long long value);
+
+	/*!
+	 * @brief
+	 *     Appends a signed variable length integer.
+	 */
+	inline void writeSigned(const long long value) {
+		this->writeVarint((static_cast<unsigned long long>(value) << 1) ^ 
+		                  static_cast<unsigned long long>(value >> 63));
+	}
+
+	/*! @brief The packet being built. */
+	unsigned char buffer[MAX_PACKET_SIZE];
+
+	/*! @brief The number of bytes used. */
+	unsigned int size;
+
+	/*! @brief The number of events in the packet. */
+	unsigned int eventCount;
+
+	/*! @brief The sequence number of the packet. */
+	unsigned int sequence;
+
+	/*! @brief The time of the previous event. */
+	Timestamp lastTime;
+
+	/*! @brief The device of the previous event. */
+	DeviceID lastDevice;
+
+	/*! @brief The first value of the previous event of each type. */
+	int lastValue[IEVT_COUNT];
+
+	/*! @brief The second value of the previous event of each type. */
+	int lastValue2[IEVT_COUNT];
+};
+
+/*!
+ * @brief
+ *     Decodes packets built by an EventPacketWriter.
+ */
+class _DLL_EXPORT EventPacketReader {
+public:
+	/*!
+	 * @brief
+	 *     Constructor.
+	 */
+	EventPacketReader();
+
+	/*!
+	 * @brief
+	 *     Gets the size of a whole packet from its first two bytes.
+	 */
+	static inline unsigned int getPacketSize(const unsigned char* data) {
+		return 2 + (data[0] | (static_cast<unsigned int>(data[1]) << 8));
+	}
+
+	/*!
+	 * @brief
+	 *     Decodes a packet and pushes its events to a sink.
+	 * @param data
+	 *     The whole packet.
+	 * @param size
+	 *     The size of the packet.
+	 * @param sink
+	 *     Receives the events.
+	 * @return
+	 *     False if the packet is malformed. The events before the fault were pushed.
+	 */
+	bool readPacket(const unsigned char* data, const unsigned int size, InputEventSink& sink);
+
+	/*!
+	 * @brief
+	 *     Starts over for a new stream, forgetting the sequence and the lost packet count.
+	 * @remarks
+	 *     A sender that starts again begins its sequence anew, which would otherwise count
+	 *     as lost packets.
+	 */
+	void reset();
+
+	/*!
+	 * @brief
+	 *     Gets the time the last packet was sent on the clock of the sender.
+	 */
+	inline Timestamp getSendTime() const {
+		return this->sendTime;
+	}
+
+	/*!
+	 * @brief
+	 *     Gets the number of packets missing from the sequence so far.
+	 */
+	inline unsigned int getLostPacketCount() const {
+		return this->lostCount;
+	}
+
+private:
+	/*!
+	 * @brief
+	 *     Reads an unsigned variable length integer.
+	 * @return
+	 *     False if the integer runs past the end of the data.
+	 */
+	bool readVarint(const unsigned char*& data, const unsigned char* end, 
+	                unsigned long long& value);
+
+	/*! @brief The time the last packet was sent. */
+	Timestamp sendTime;
+
+	/*! @brief The sequence number expected next. */
+	unsigned int nextSequence;
+
+	/*! @brief Whether a packet was read yet. */
+	bool started;
+
+	/*! @brief The number of packets missing from the sequence. */
+	unsigned int lostCount;
+};
+
+} // namespace I43D
+#endif  // _I43D_EVENT_CODEC_H_
@@ -0,0 +1,428 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+#ifndef _I43D_EVENT_QUEUE_H_
+#define _I43D_EVENT_QUEUE_H_
+
+#include "I43DAtomic.h"
+#include "I43DEvent.h"
+#include "I43DInputNotifier.h"
+#include "I43DThreading.h"
+#include <map>
+
+/*!
+ * @file
+ *     This file contains the fixed size queues that hand input events from the input 
+ *     thread to a consumer thread.
+ * @author Robert Eugene Simmons Jr. (Kraythe)
+ */
+
+namespace I43D {
+
+// ---- Forward Declarations
+class _DLL_EXPORT EventQueue;
+struct _DLL_EXPORT LaneCounters;
+class _DLL_EXPORT PriorityEventQueue;
+
+/*!
+ * @brief
+ *     What a PriorityEventQueue does with a motion event that does not fit.
+ */
+enum _DLL_EXPORT OverflowPolicy {
+	/*! @brief The new event is dropped. */
+	OVERFLOW_DROP_NEWEST,
+
+	/*! @brief The oldest motion event is dropped to make room. */
+	OVERFLOW_DROP_OLDEST,
+
+	/*! 
+	 * @brief 
+	 *     The newest queued event of the same device, type and code takes the position 
+	 *     and time of the new one where it stands. Events queued before a key or button 
+	 *     of the device that is still queued are not used, as that would move the motion
+	 *     ahead of the press. If there is none the oldest motion event is dropped.
+	 */
+	OVERFLOW_COALESCE,
+
+	/*! @brief The producer waits until the consumer makes room. */
+	OVERFLOW_BLOCK
+};
+
+/*!
+ * @brief
+ *     A lock free single producer, single consumer ring of input events.
+ * @remarks
+ *     The ring is allocated once by the constructor. One thread may push while another 
+ *     pops without any lock; the positions are published with release stores and read with
+ *     acquire loads. The producer and consumer positions are kept on separate cache lines
+ *     so the two threads do not slow each other down. When the ring is full new events are
+ *     dropped and counted; see PriorityEventQueue for other ways to handle overflow.
+ *     <br><br>
+ *     Instrumented builds also record the depth of the queue and the time each event 
+ *     waited in it, see I43DInstrumentation.h.
+ */
+class _DLL_EXPORT EventQueue : public InputEventSink {
+public:
+	/*!
+	 * @brief
+	 *     Constructor.
+	 * @param capacity
+	 *     The number of events the queue holds. Rounded up to a power of two.
+	 */
+	explicit EventQueue(const unsigned int capacity = 1024);
+
+	/*!
+	 * @brief
+	 *     Destructor.
+	 */
+	virtual ~EventQueue();
+
+	/*!
+	 * @brief
+	 *     Adds an event. Must only be called by the producer thread.
+	 * @return
+	 *     False if the queue was full and the event was dropped.
+	 */
+	virtual bool pushEvent(const InputEvent& event);
+
+	/*!
+	 * @brief
+	 *     Removes the oldest event. Must only be called by the consumer thread.
+	 * @param event
+	 *     Receives the event.
+	 * @return
+	 *     False if the queue was empty.
+	 */
+	bool popEvent(InputEvent& event);
+
+	/*!
+	 * @brief
+	 *     Removes up to a number of the oldest events. Must only be called by the consumer 
+	 *     thread.
+	 * @param events
+	 *     Receives the events.
+	 * @param maxCount
+	 *     The most events to remove.
+	 * @return
+	 *     The number of events removed.
+	 */
+	unsigned int popEvents(InputEvent* events, const unsigned int maxCount);
+
+	/*!
+	 * @brief
+	 *     Gets the number of events in the queue. Only exact when called by the producer or
+	 *     the consumer while the other is idle.
+	 */
+	inline unsigned int getSize() const {
+		return atomicLoad(this->tail) - atomicLoad(this->head);
+	}
+
+	/*!
+	 * @brief
+	 *     Gets the number of events the queue holds.
+	 */
+	inline unsigned int getCapacity() const {
+		return this->mask + 1;
+	}
+
+	/*!
+	 * @brief
+	 *     Gets the number of events dropped because the queue was full.
+	 */
+	inline unsigned int getDroppedCount() const {
+		return atomicLoad(this->droppedCount);
+	}
+
+	/*!
+	 * @brief
+	 *     Sets the notifier told about every event queued.
+	 * @param notifier
+	 *     The notifier, or 0 for none. It must outlive the queue or be removed first.
+	 */
+	inline void setNotifier(InputNotifier* notifier) {
+		this->notifier = notifier;
+	}
+
+private:
+	/*! @brief Copying a queue is not supported. */
+	EventQueue(const EventQueue&);
+
+	/*! @brief Copying a queue is not supported. */
+	EventQueue& operator=(const EventQueue&);
+
+	/*! @brief The size of a cache line, used to keep the positions apart. */
+	enum { CACHE_LINE = 64 };
+
+	/*! @brief The ring of events. */
+	InputEvent* events;
+
+	/*! @brief The time each event was pushed, in instrumented builds only. */
+	Timestamp* enqueueTimes;
+
+	/*! @brief The capacity minus one, used to wrap positions. */
+	unsigned int mask;
+
+	/*! @brief Keeps the consumer position off the line of the fields above. */
+	char headPadding[CACHE_LINE];
+
+	/*! @brief The position of the next event to pop. Written by the consumer only. */
+	volatile unsigned int head;
+
+	/*! @brief Keeps the producer position off the line of the consumer position. */
+	char tailPadding[CACHE_LINE];
+
+	/*! @brief The position of the next event to push. Written by the producer only. */
+	volatile unsigned int tail;
+
+	/*! @brief The number of events dropped. Written by the producer only. */
+	volatile unsigned int droppedCount;
+
+	/*! @brief Told about every event queued, or 0. */
+	InputNotifier* notifier;
+};
+
+/*!
+ * @brief
+ *     The counters of one lane of a PriorityEventQueue, for tuning its capacity.
+ */
+struct _DLL_EXPORT LaneCounters {
+	/*! @brief The most events the lane held. */
+	unsigned int highWater;
+
+	/*! @brief The events dropped, new or old. */
+	unsigned int dropped;
+
+	/*! @brief The events folded into a queued event. */
+	unsigned int coalesced;
+
+	/*! @brief The pushes that had to wait for room. */
+	unsigned int blocked;
+};
+
+/*!
+ * @brief
+ *     A queue of input events with a lane for motion and a lane for everything else.
+ * @remarks
+ *     Mouse motion and controller axis events go to the motion lane. When it is full the
+ *     overflow policy of the device decides what happens; the default policy applies to
+ *     devices without one of their own. Keys, characters, buttons, scrolling and devices
+ *     connecting or disconnecting go to the priority lane and are never dropped: when it
+ *     is full the producer waits for the consumer. Size the priority lane for the longest
+ *     stall of the consumer, and only use waiting, by the priority lane or by 
+ *     OVERFLOW_BLOCK, with the consumer on another thread.
+ *     <br><br>
+ *     Events are popped in the order they were pushed across both lanes. Unlike 
+ *     EventQueue the queue is guarded by a lock, which is what lets the producer drop or 
+ *     rewrite queued events. Any number of threads may push and pop.
+ */
+class _DLL_EXPORT PriorityEventQueue : public InputEventSink {
+public:
+	/*! @brief The lanes of the queue. */
+	enum Lane {
+		/*! @brief The lane of mouse motion and controller axes. */
+		LANE_MOTION,
+
+		/*! @brief The lane of every other event. */
+		LANE_PRIORITY,
+
+		/*! @brief The number of lanes. */
+		LANE_COUNT
+	};
+
+	/*!
+	 * @brief
+	 *     Constructor.
+	 * @param motionCapacity
+	 *     The number of events the motion lane holds.
+	 * @param priorityCapacity
+	 *     The number of events the priority lane holds.
+	 */
+	PriorityEventQueue(const unsigned int motionCapacity = 1024, 
+	                   const unsigned int priorityCapacity = 256);
+
+	/*!
+	 * @brief
+	 *     Destructor.
+	 */
+	virtual ~PriorityEventQueue();
+
+	/*!
+	 * @brief
+	 *     Gets the lane an event type goes to.
+	 */
+	static Lane getLane(const InputEventType type);
+
+	/*!
+	 * @brief
+	 *     Sets the overflow policy of the devices without one of their own.
+	 */
+	void setDefaultOverflowPolicy(const OverflowPolicy policy);
+
+	/*!
+	 * @brief
+	 *     Sets the overflow policy of a device.
+	 */
+	void setOverflowPolicy(const DeviceID device, const OverflowPolicy policy);
+
+	/*!
+	 * @brief
+	 *     Gets the overflow policy that applies to a device.
+	 */
+	OverflowPolicy getOverflowPolicy(const DeviceID device) const;
+
+	/*!
+	 * @brief
+	 *     Adds an event.
+	 * @return
+	 *     False if the event was dropped.
+	 */
+	virtual bool pushEvent(const InputEvent& event);
+
+	/*!
+	 * @brief
+	 *     Removes the oldest event.
+	 * @return
+	 *     False if the queue was empty.
+	 */
+	bool popEvent(InputEvent& event);
+
+	/*!
+	 * @brief
+	 *     Removes up to a number of the oldest events.
+	 * @return
+	 *     The number of events removed.
+	 */
+	unsigned int popEvents(InputEvent* events, const unsigned int maxCount);
+
+	/*!
+	 * @brief
+	 *     Gets the number of events in a lane.
+	 */
+	unsigned int getSize(const Lane lane) const;
+
+	/*!
+	 * @brief
+	 *     Gets the number of events a lane holds.
+	 */
+	inline unsigned int getCapacity(const Lane lane) const {
+		return this->lanes[lane].capacity;
+	}
+
+	/*!
+	 * @brief
+	 *     Gets the counters of a lane.
+	 */
+	LaneCounters getCounters(const Lane lane) const;
+
+	/*!
+	 * @brief
+	 *     Clears the counters of every lane.
+	 */
+	void resetCounters();
+
+	/*!
+	 * @brief
+	 *     Sets the notifier told about every event queued.
+	 * @param notifier
+	 *     The notifier, or 0 for none. It must outlive the queue or be removed first.
+	 */
+	inline void setNotifier(InputNotifier* notifier) {
+		ScopedLock guard(this->lock);
+		this->notifier = notifier;
+	}
+
+private:
+	/*! @brief Copying a queue is not supported. */
+	PriorityEventQueue(const PriorityEventQueue&);
+
+	/*! @brief Copying a queue is not supported. */
+	PriorityEventQueue& operator=(const PriorityEventQueue&);
+
+	/*!
+	 * @brief
+	 *     A queued event and its place in the order of both lanes.
+	 */
+	struct Slot {
+		InputEvent event;
+		unsigned int sequence;
+	};
+
+	/*!
+	 * @brief
+	 *     A ring of slots.
+	 */
+	struct Ring {
+		Slot* slots;
+		unsigned int capacity;
+		unsigned int head;
+		unsigned int size;
+		LaneCounters counters;
+	};
+
+	/*!
+	 * @brief
+	 *     Appends an event to a lane that has room. Called with the lock held.
+	 */
+	void append(Ring& ring, const InputEvent& event);
+
+	/*!
+	 * @brief
+	 *     Folds an event into the newest queued event like it that was queued after the 
+	 *     last priority event of the device. Called with the lock held.
+	 * @return
+	 *     False if the lane has no such event.
+	 */
+	bool coalesce(Ring& ring, const InputEvent& event);
+
+	/*!
+	 * @brief
+	 *     Removes the oldest event of both lanes. Called with the lock held.
+	 */
+	bool take(InputEvent& event);
+
+	/*! @brief The lanes. */
+	Ring lanes[LANE_COUNT];
+
+	/*! @brief The order of the next event pushed. */
+	unsigned int nextSequence;
+
+	/*! @brief The policy of devices without one of their own. */
+	OverflowPolicy defaultPolicy;
+
+	/*! @brief The policies of single devices. */
+	std::map<DeviceID, OverflowPolicy> policies;
+
+	/*! @brief The order of the newest event of each device pushed to the priority lane. */
+	std::map<DeviceID, unsigned int> prioritySequences;
+
+	/*! @brief The number of producers waiting for room. */
+	unsigned int waitingProducers;
+
+	/*! @brief Told about every event queued, or 0. */
+	InputNotifier* notifier;
+
+	/*! @brief Guards everything above. */
+	mutable Mutex lock;
+
+	/*! @brief Signalled when the consumer makes room. */
+	Condition roomAvailable;
+};
+
+} // namespace I43D
+#endif  // _I43D_EVENT_QUEUE_H_
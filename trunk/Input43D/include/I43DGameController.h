@@ -20,7 +20,12 @@ http://www.gnu.org/copyleft/lesser.txt.
 #ifndef _I43D_GAME_CONTROLLER_H_
 #define _I43D_GAME_CONTROLLER_H_
 
-#include "I43DPlatform.h"
+#include "I43DCommon.h"
+#include "I43DAxisAggregator.h"
+#include "I43DAxisProcessor.h"
+#include "I43DTimer.h"
+#include <set>
+#include <vector>
 
 /*!
  * @file
@@ -34,55 +39,245 @@ http://www.gnu.org/copyleft/lesser.txt.
 namespace I43D {
 
 // ---- Forward Declarations
+struct _DLL_EXPORT ControllerState;
 class _DLL_EXPORT GameControllerListener;
 class _DLL_EXPORT GameController;
+class _DLL_EXPORT GameControllerGroup;
+
+/*!
+ * @brief
+ *     The directions of a hat switch, such as the directional pad of a game pad. Diagonals
+ *     combine two directions.
+ */
+enum _DLL_EXPORT HatDirection {
+	HAT_CENTERED = 0,
+	HAT_UP = 1,
+	HAT_RIGHT = 2,
+	HAT_DOWN = 4,
+	HAT_LEFT = 8
+};
+
+/*!
+ * @brief
+ *     The state of a game controller.
+ */
+struct _DLL_EXPORT ControllerState {
+	/*! @brief The number of axes a controller can have. */
+	enum { MAX_AXES = 16 };
+
+	/*! @brief The number of buttons a controller can have. */
+	enum { MAX_BUTTONS = 32 };
+
+	/*! @brief The number of hat switches a controller can have. */
+	enum { MAX_HATS = 4 };
+
+	/*! @brief The time the axes were last processed. */
+	Timestamp time;
+
+	/*! @brief A bit for each button that is down; bit 0 is button 1. */
+	unsigned int buttons;
+
+	/*! @brief The HatDirection flags of each hat switch. */
+	unsigned char hats[MAX_HATS];
+
+	/*! @brief The raw position of each axis as reported by the device. */
+	int raw[MAX_AXES];
+
+	/*! @brief The normalized value of each axis, -1 to 1 or 0 to 1 for uncentered axes. */
+	float axes[MAX_AXES];
+
+	/*!
+	 * @brief
+	 *     Determines if a button is down.
+	 * @param buttonNum
+	 *     The number of the button starting with button 1.
+	 */
+	inline bool isButtonPressed(const unsigned short buttonNum) const {
+		return buttonNum >= 1 && buttonNum <= MAX_BUTTONS && 
+		       (this->buttons & (1u << (buttonNum - 1))) != 0;
+	}
+
+	/*!
+	 * @brief
+	 *     Gets the normalized value of an axis as fixed point with 15 fraction bits.
+	 */
+	inline int getFixedAxis(const unsigned short axisNum) const {
+		return static_cast<int>(this->axes[axisNum] * 32767.0f);
+	}
+};
 
 /*!
  * @brief
  *     Implements a listener to game controller input. 
+ * @remarks
+ *     Buttons are reported one at a time as they change. Axes are reported once per 
+ *     update with the complete state of the controller and a mask of the axes that 
+ *     changed, so a listener costs one call per controller per frame no matter how many
+ *     axes moved.
  */
 class _DLL_EXPORT GameControllerListener abstract {
 public: 
-	virtual void buttonPressed(const unsigned short buttonNum) {}
-	virtual void buttonReleased(const unsigned short buttonNum) {}
-	virtual void axisMoved(const unsigned short axisNum, const int[] delta){}
+	/*!
+	 * @brief
+	 *     Destructor.
+	 */
+	virtual ~GameControllerListener() {}
+
+	/*!
+	 * @brief 
+	 *     Called when a button is pressed. 
+	 * @param source
+	 *     The controller that generated the event. 
+	 * @param buttonNum
+	 *     The number of the button that was pressed starting with button 1.
+	 */
+	virtual void buttonPressed(const GameController* source, const unsigned short buttonNum) {}
+
+	/*!
+	 * @brief 
+	 *     Called when a button is released. 
+	 * @param source
+	 *     The controller that generated the event. 
+	 * @param buttonNum
+	 *     The number of the button that was released starting with button 1.
+	 */
+	virtual void buttonReleased(const GameController* source, const unsigned short buttonNum) {}
+
+	/*!
+	 * @brief 
+	 *     Called when the normalized value of one or more axes changed during an update. 
+	 * @param source
+	 *     The controller that generated the event. 
+	 * @param state
+	 *     The state of the controller.
+	 * @param changedAxes
+	 *     A bit for each axis that changed; bit 0 is axis 0.
+	 */
+	virtual void axesChanged(const GameController* source, const ControllerState& state, 
+	                         const unsigned int changedAxes) {}
 };
 
 /*!
  * @brief
  *     A controller for a game. This consist of devices such as game pads, wheels, 
  *     joysticks, flight yokes and other game oriented controllers.
+ * @remarks
+ *     Platform implementations read the device in poll() and report raw axis positions 
+ *     with setRawAxis() and buttons with fireButtonPressed() and fireButtonReleased(). 
+ *     The base class turns the raw positions into normalized values once per update.
+ *     Devices that buffer samples should report every one of them; the state holds the 
+ *     last one and the samples of the frame are summarized by getAxisSamples().
  */
 class _DLL_EXPORT GameController abstract {
+public:
 	/*!
 	 * @brief
 	 *     Constructor.
 	 */
-	GameController() {}
+	GameController();
 
 	/*!
 	 * @brief
 	 *     Destructor.
 	 */
-	virtual ~GameController() {
-	}
+	virtual ~GameController();
+
+	/*!
+	 * @brief
+	 *     Gets the number of axes on the controller.
+	 */
+	virtual unsigned short getAxisCount() = 0;
 
-	virtual unsigned short getAxesCount() = 0;
+	/*!
+	 * @brief
+	 *     Gets the number of buttons on the controller.
+	 */
 	virtual unsigned short getButtonCount() = 0;
-	virtual int[] getXAxisMinMax(const unsigned short axisNum) = 0;
-	virtual int[] getYAxisMinMax(const unsigned short axisNum) = 0;
-	virtual int[] getZAxisMinMax(const unsigned short axisNum) = 0;
-	virtual bool isButtonPressed(const unsigned short buttonNum) = 0;
-	virtual int[] getCurrentAxisPosition(const unsigned short axisNum) = 0;
 
-		/*!
+	/*!
+	 * @brief
+	 *     Polls the device and processes its axes.
+	 * @remarks
+	 *     Do not call this for controllers that are in a GameControllerGroup; the group 
+	 *     updates them.
+	 * @param now
+	 *     The current time on the input clock.
+	 */
+	void update(const Timestamp now);
+
+	/*!
+	 * @brief
+	 *     Gets the state of the controller.
+	 */
+	inline const ControllerState& getState() const {
+		return this->state;
+	}
+
+	/*!
+	 * @brief 
+	 *     Determines if the given button is currently pressed.
+	 * @param buttonNum
+	 *     The number of the button to check starting with number 1.
+	 */
+	inline bool isButtonPressed(const unsigned short buttonNum) const {
+		return this->state.isButtonPressed(buttonNum);
+	}
+
+	/*!
+	 * @brief 
+	 *     Gets the normalized value of an axis.
+	 */
+	inline float getAxis(const unsigned short axisNum) const {
+		return this->state.axes[axisNum];
+	}
+
+	/*!
+	 * @brief 
+	 *     Gets the raw position of an axis.
+	 */
+	inline int getRawAxis(const unsigned short axisNum) const {
+		return this->state.raw[axisNum];
+	}
+
+	/*!
+	 * @brief 
+	 *     Gets the summary of the axis samples reported during the last update.
+	 * @remarks
+	 *     Use this to catch peaks, like a quick tap of a trigger, that came and went 
+	 *     between two frames.
+	 */
+	inline const AxisAggregator& getAxisSamples() const {
+		return this->samples;
+	}
+
+	/*!
+	 * @brief 
+	 *     Gets the settings of an axis.
+	 */
+	inline const AxisSettings& getAxisSettings(const unsigned short axisNum) const {
+		return this->settings[axisNum];
+	}
+
+	/*!
+	 * @brief 
+	 *     Changes the settings of an axis. Takes effect on the next update.
+	 * @param axisNum
+	 *     The number of the axis starting with axis 0.
+	 * @param settings
+	 *     The new settings.
+	 * @return
+	 *     RESULT_OUT_OF_RANGE if the axis does not exist.
+	 */
+	ResultCode setAxisSettings(const unsigned short axisNum, const AxisSettings& settings);
+
+	/*!
 	 * @brief 
 	 *     Adds a new Game Controller listener.
 	 * @param listener
 	 *     The listener to add.
-	 * @see I43D::GameController::removeGameControllerListener(const GameControllerListener const *)
+	 * @see I43D::GameController::removeGameControllerListener(GameControllerListener*)
 	 */
-	inline void addGameControllerListener(const GameControllerListener* listener) {
+	inline void addGameControllerListener(GameControllerListener* listener) {
 		this->listeners.insert(listener);
 	}
 
@@ -94,19 +289,163 @@ class _DLL_EXPORT GameController abstract {
 	 *     violation exceptions all over. 
 	 * @param listener
 	 *     The listener to remove.
-	 * @see I43D::GameController::addGameControllerListener(const GameControllerListener const *)
+	 * @see I43D::GameController::addGameControllerListener(GameControllerListener*)
 	 */
-	inline void removeGameControllerListener(const GameControllerListener* listener) {
+	inline void removeGameControllerListener(GameControllerListener* listener) {
 		this->listeners.erase(listener);
 	}
 
+protected:
+	/*!
+	 * @brief
+	 *     Reads the device. 
+	 * @remarks
+	 *     Implementations report what they read with setRawAxis() and the fire methods.
+	 * @param now
+	 *     The current time on the input clock.
+	 */
+	virtual void poll(const Timestamp now) = 0;
+
+	/*!
+	 * @brief
+	 *     Stores a sample of the raw position of an axis. Processed on the next update.
+	 */
+	inline void setRawAxis(const unsigned short axisNum, const int position) {
+		if (axisNum < ControllerState::MAX_AXES) {
+			this->state.raw[axisNum] = position;
+			this->samples.addSample(axisNum, position);
+		}
+	}
+
+	/*!
+	 * @brief
+	 *     Stores the position of a hat switch.
+	 * @param hatNum
+	 *     The number of the hat starting with hat 0.
+	 * @param directions
+	 *     The HatDirection flags of the hat.
+	 */
+	inline void setHat(const unsigned short hatNum, const unsigned int directions) {
+		if (hatNum < ControllerState::MAX_HATS) {
+			this->state.hats[hatNum] = static_cast<unsigned char>(directions);
+		}
+	}
+
+	/*!
+	 * @brief
+	 *     Dispatches a button press to the listeners. Presses of buttons that are already
+	 *     down are ignored.
+	 * @param buttonNum
+	 *     The number of the button that was pressed starting with button 1.
+	 */
+	void fireButtonPressed(const unsigned short buttonNum);
+
+	/*!
+	 * @brief
+	 *     Dispatches a button release to the listeners. Releases of buttons that are not
+	 *     down are ignored.
+	 * @param buttonNum
+	 *     The number of the button that was released starting with button 1.
+	 */
+	void fireButtonReleased(const unsigned short buttonNum);
+
 private:
+	friend class GameControllerGroup;
+
+	/*! @brief Copying a controller is not supported. */
+	GameController(const GameController&);
+
+	/*! @brief Copying a controller is not supported. */
+	GameController& operator=(const GameController&);
+
+	/*!
+	 * @brief
+	 *     Stores newly processed axis values and dispatches the changes to the listeners.
+	 */
+	void publishAxes(const float* axes, const Timestamp now);
+
+	/*! @brief The state of the controller. */
+	ControllerState state;
+
+	/*! @brief The settings of each axis. */
+	AxisSettings settings[ControllerState::MAX_AXES];
+
+	/*! @brief The summary of the samples of each axis since the last update. */
+	AxisAggregator samples;
+
+	/*! @brief Processes the axes when the controller is updated on its own. */
+	AxisProcessor processor;
+
+	/*! @brief Whether the settings changed since the processor was configured. */
+	bool settingsChanged;
+
+	/*!
+	 * @brief
+	 *     Stores the listeners to the controller.
+	 */
+	std::set<GameControllerListener*> listeners;
+};
+
+/*!
+ * @brief
+ *     Updates a number of game controllers together.
+ * @remarks
+ *     The axes of all of the controllers in the group are processed in a single pass, 
+ *     which is cheaper than updating each controller on its own when there are several
+ *     controllers.
+ */
+class _DLL_EXPORT GameControllerGroup {
+public:
+	/*!
+	 * @brief
+	 *     Constructor.
+	 */
+	GameControllerGroup();
+
 	/*!
 	 * @brief
-	 *     Stores the listeners to the keyboard.
+	 *     Adds a controller to the group.
 	 */
-	std::set<const GameControllerListener*> listeners;
-}
+	void addController(GameController* controller);
+
+	/*!
+	 * @brief
+	 *     Removes a controller from the group.
+	 */
+	void removeController(GameController* controller);
+
+	/*!
+	 * @brief
+	 *     Gets the number of controllers in the group.
+	 */
+	inline unsigned int getControllerCount() const {
+		return static_cast<unsigned int>(this->controllers.size());
+	}
+
+	/*!
+	 * @brief
+	 *     Polls all controllers and processes all of their axes.
+	 * @param now
+	 *     The current time on the input clock.
+	 */
+	void update(const Timestamp now);
+
+private:
+	/*! @brief The controllers in the group. */
+	std::vector<GameController*> controllers;
+
+	/*! @brief Processes the axes of all of the controllers. */
+	AxisProcessor processor;
+
+	/*! @brief Whether the processor must be configured again. */
+	bool layoutChanged;
+
+	/*! @brief The raw positions of all axes. */
+	std::vector<int> raw;
+
+	/*! @brief The normalized values of all axes. */
+	std::vector<float> normalized;
+};
 
 } // namespace I43D 
-#endif  // _I43D_GAME_CONTROLLER_H_
\ No newline at end of file
+#endif  // _I43D_GAME_CONTROLLER_H_
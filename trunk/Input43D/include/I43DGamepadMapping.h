@@ -0,0 +1,361 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+#ifndef _I43D_GAMEPAD_MAPPING_H_
+#define _I43D_GAMEPAD_MAPPING_H_
+
+#include "I43DCommon.h"
+#include "I43DGameController.h"
+#include "I43DMappedFile.h"
+#include <vector>
+
+/*!
+ * @file
+ *     This file contains the database that maps the buttons and axes of known game 
+ *     controllers to a standard game pad layout.
+ * @author Robert Eugene Simmons Jr. (Kraythe)
+ */
+
+namespace I43D {
+
+// ---- Forward Declarations
+struct _DLL_EXPORT ControllerGUID;
+struct _DLL_EXPORT GamepadBinding;
+struct _DLL_EXPORT GamepadMapping;
+struct _DLL_EXPORT GamepadState;
+class _DLL_EXPORT GamepadMappingTable;
+
+/*!
+ * @brief
+ *     The buttons of the standard game pad layout.
+ */
+enum _DLL_EXPORT GamepadButton {
+	GPB_A = 0,				// The bottom face button
+	GPB_B,					// The right face button
+	GPB_X,					// The left face button
+	GPB_Y,					// The top face button
+	GPB_BACK,
+	GPB_GUIDE,
+	GPB_START,
+	GPB_LEFT_STICK,			// Pressing the left stick
+	GPB_RIGHT_STICK,		// Pressing the right stick
+	GPB_LEFT_SHOULDER,
+	GPB_RIGHT_SHOULDER,
+	GPB_DPAD_UP,
+	GPB_DPAD_DOWN,
+	GPB_DPAD_LEFT,
+	GPB_DPAD_RIGHT,
+	GPB_MISC1,				// Share, capture or microphone button
+	GPB_PADDLE1,
+	GPB_PADDLE2,
+	GPB_PADDLE3,
+	GPB_PADDLE4,
+	GPB_TOUCHPAD,
+	GPB_COUNT				// The number of buttons
+};
+
+/*!
+ * @brief
+ *     The axes of the standard game pad layout.
+ */
+enum _DLL_EXPORT GamepadAxis {
+	GPA_LEFT_X = 0,			// -1 left to 1 right
+	GPA_LEFT_Y,				// -1 up to 1 down
+	GPA_RIGHT_X,
+	GPA_RIGHT_Y,
+	GPA_LEFT_TRIGGER,		// 0 released to 1 pulled
+	GPA_RIGHT_TRIGGER,
+	GPA_COUNT				// The number of axes
+};
+
+/*!
+ * @brief
+ *     The kinds of controller input a game pad button or axis can be bound to.
+ */
+enum _DLL_EXPORT GamepadBindingKind {
+	GPBIND_NONE = 0,
+	GPBIND_BUTTON,
+	GPBIND_AXIS,
+	GPBIND_HAT
+};
+
+/*!
+ * @brief
+ *     Flags that select part of an axis for a GamepadBinding.
+ */
+enum _DLL_EXPORT GamepadAxisRange {
+	GPRANGE_FULL = 0,
+	GPRANGE_POSITIVE = 1,	// Only the positive half of the axis
+	GPRANGE_NEGATIVE = 2,	// Only the negative half of the axis
+	GPRANGE_INVERTED = 4	// The axis is flipped
+};
+
+/*!
+ * @brief
+ *     Identifies a model of game controller. 
+ * @remarks
+ *     The layout matches the GUIDs of the community mapping format: the bus type, vendor,
+ *     product and version are stored as little endian 16 bit values at bytes 0, 4, 8 and 
+ *     12.
+ */
+struct _DLL_EXPORT ControllerGUID {
+	/*! @brief The bytes of the GUID. */
+	unsigned char data[16];
+};
+
+/*!
+ * @brief
+ *     Where a button or axis of the standard layout comes from on the controller.
+ */
+struct _DLL_EXPORT GamepadBinding {
+	/*! @brief One of the GamepadBindingKind values. */
+	unsigned char kind;
+
+	/*! @brief The number of the raw button, axis or hat starting with 0. */
+	unsigned char index;
+
+	/*! @brief The GamepadAxisRange flags for axes or the HatDirection flags for hats. */
+	unsigned char detail;
+
+	/*! @brief The GamepadAxisRange of the axis of the layout that the binding drives. */
+	unsigned char outputRange;
+};
+
+/*!
+ * @brief
+ *     The mapping of one controller model.
+ */
+struct _DLL_EXPORT GamepadMapping {
+	/*! @brief The offset of the name in the string pool of the table. */
+	unsigned int nameOffset;
+
+	/*! @brief The binding of each GamepadButton. */
+	GamepadBinding buttons[GPB_COUNT];
+
+	/*! @brief The binding of each GamepadAxis or of its positive half. */
+	GamepadBinding axes[GPA_COUNT];
+
+	/*! @brief The binding of the negative half of each GamepadAxis, if it has its own. */
+	GamepadBinding negativeAxes[GPA_COUNT];
+
+	/*!
+	 * @brief
+	 *     Translates the state of a controller to the standard layout.
+	 * @param controller
+	 *     The state of the controller.
+	 * @param gamepad
+	 *     Receives the state in the standard layout.
+	 */
+	void apply(const ControllerState& controller, GamepadState& gamepad) const;
+};
+
+/*!
+ * @brief
+ *     The state of a controller in the standard game pad layout.
+ */
+struct _DLL_EXPORT GamepadState {
+	/*! @brief A bit for each GamepadButton that is down. */
+	unsigned int buttons;
+
+	/*! @brief The value of each GamepadAxis. */
+	float axes[GPA_COUNT];
+
+	/*!
+	 * @brief
+	 *     Determines if a button is down.
+	 */
+	inline bool isButtonPressed(const GamepadButton button) const {
+		return (this->buttons & (1u << button)) != 0;
+	}
+};
+
+/*!
+ * @brief
+ *     A database of game controller mappings.
+ * @remarks
+ *     The database is compiled from the community mapping text format, one controller per
+ *     line: the GUID, the name and then comma separated bindings like "a:b0", "leftx:a0", 
+ *     "dpup:h0.1" or "lefttrigger:+a2". Lines for other platforms are skipped.
+ *     <br><br>
+ *     Mappings are found through a perfect hash table built at compile time, so a lookup
+ *     hashes the key once and compares one slot no matter how many mappings there are. 
+ *     Like the ComposeTable, the compiled table is written to a cache file that records
+ *     the size and modification time of its source and is mapped into memory as is, so 
+ *     opening a database of thousands of controllers neither parses nor copies anything.
+ */
+class _DLL_EXPORT GamepadMappingTable {
+public:
+	/*!
+	 * @brief
+	 *     Constructor. Creates an empty table.
+	 */
+	GamepadMappingTable();
+
+	/*!
+	 * @brief
+	 *     Opens a table, compiling it only if the cache is missing or out of date.
+	 * @param sourcePath
+	 *     The path of the mapping text file.
+	 * @param cachePath
+	 *     The path of the binary cache file.
+	 * @return
+	 *     True if the table was opened, false if neither the cache nor the source could be
+	 *     read.
+	 * @see I43D::ComposeTable::open(const std::string&, const std::string&)
+	 */
+	bool open(const std::string& sourcePath, const std::string& cachePath);
+
+	/*!
+	 * @brief
+	 *     Maps a binary cache file without checking its source.
+	 * @return
+	 *     True if the file is a valid mapping table.
+	 */
+	bool openCache(const std::string& cachePath);
+
+	/*!
+	 * @brief
+	 *     Compiles a mapping text file.
+	 * @param sourcePath
+	 *     The path of the mapping text file.
+	 * @param cachePath
+	 *     The path to write the binary cache to or an empty string to not write one.
+	 * @return
+	 *     True if the source was read. The cache is best effort.
+	 */
+	bool compile(const std::string& sourcePath, const std::string& cachePath);
+
+	/*!
+	 * @brief
+	 *     Compiles mappings held in memory. When a GUID appears twice the later line wins.
+	 * @param source
+	 *     The mappings in the community text format.
+	 * @param length
+	 *     The number of bytes in source.
+	 */
+	void compileText(const char* source, const size_t length);
+
+	/*!
+	 * @brief
+	 *     Gets the number of mappings in the table.
+	 */
+	inline unsigned int getMappingCount() const {
+		return this->mappingCount;
+	}
+
+	/*!
+	 * @brief
+	 *     Gets the number of lines that were skipped by the last compile.
+	 */
+	inline unsigned int getSkippedLineCount() const {
+		return this->skippedLines;
+	}
+
+	/*!
+	 * @brief
+	 *     Finds the mapping of a GUID.
+	 * @return
+	 *     The mapping or NULL if the controller is unknown.
+	 */
+	const GamepadMapping* find(const ControllerGUID& guid) const;
+
+	/*!
+	 * @brief
+	 *     Finds the mapping of a controller, trying the exact GUID first and then any 
+	 *     mapping with the same vendor and product.
+	 * @return
+	 *     The mapping or NULL if the controller is unknown.
+	 */
+	const GamepadMapping* find(const unsigned short busType, const unsigned short vendor, 
+	                           const unsigned short product, const unsigned short version) const;
+
+	/*!
+	 * @brief
+	 *     Gets the name of the controller of a mapping.
+	 */
+	const char* getName(const GamepadMapping& mapping) const;
+
+	/*!
+	 * @brief
+	 *     Builds the GUID of a controller.
+	 */
+	static ControllerGUID makeGUID(const unsigned short busType, const unsigned short vendor, 
+	                               const unsigned short product, const unsigned short version);
+
+	/*!
+	 * @brief
+	 *     Parses a GUID written as 32 hexadecimal digits.
+	 * @return
+	 *     False if the text is not a GUID.
+	 */
+	static bool parseGUID(const std::string& text, ControllerGUID& guid);
+
+private:
+	/*!
+	 * @brief
+	 *     Looks up a key in the perfect hash table.
+	 * @return
+	 *     The mapping or NULL if the key is not in the table.
+	 */
+	const GamepadMapping* lookup(const unsigned int* key) const;
+
+	/*!
+	 * @brief
+	 *     Points the table at the arrays stored in a cache image.
+	 * @return
+	 *     False if the image is not a valid table.
+	 */
+	bool attach(const void* image, const size_t size);
+
+	/*! @brief The seed of each bucket of the perfect hash. */
+	const unsigned int* seeds;
+
+	/*! @brief The key and mapping index of each slot of the perfect hash. */
+	const unsigned int* slots;
+
+	/*! @brief The mappings. */
+	const GamepadMapping* mappings;
+
+	/*! @brief The names of the controllers. */
+	const char* names;
+
+	/*! @brief The number of buckets in the perfect hash. */
+	unsigned int bucketCount;
+
+	/*! @brief The number of slots in the perfect hash. */
+	unsigned int slotCount;
+
+	/*! @brief The number of mappings. */
+	unsigned int mappingCount;
+
+	/*! @brief The number of bytes of names. */
+	unsigned int namesLength;
+
+	/*! @brief The number of lines skipped by the last compile. */
+	unsigned int skippedLines;
+
+	/*! @brief The mapped cache file. */
+	MappedFile cacheFile;
+
+	/*! @brief A cache image built in memory when the cache file could not be used. */
+	std::vector<unsigned int> image;
+};
+
+} // namespace I43D
+#endif  // _I43D_GAMEPAD_MAPPING_H_
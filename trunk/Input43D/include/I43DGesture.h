@@ -0,0 +1,663 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+#ifndef _I43D_GESTURE_H_
+#define _I43D_GESTURE_H_
+
+#include "I43DCommon.h"
+#include "I43DTouchScreen.h"
+#include <set>
+#include <vector>
+
+/*!
+ * @file
+ *     This file contains the gesture engine that recognizes taps, pans, pinches, 
+ *     rotations and swipes from the contacts of a touch screen.
+ * @author Robert Eugene Simmons Jr. (Kraythe)
+ */
+
+namespace I43D {
+
+// ---- Forward Declarations
+struct _DLL_EXPORT GestureFrame;
+struct _DLL_EXPORT GestureEvent;
+class _DLL_EXPORT GestureListener;
+class _DLL_EXPORT GestureRecognizer;
+class _DLL_EXPORT GestureEngine;
+
+/*!
+ * @brief
+ *     The kinds of gestures.
+ */
+enum _DLL_EXPORT GestureType {
+	GESTURE_TAP = 0,
+	GESTURE_PAN,
+	GESTURE_PINCH,
+	GESTURE_ROTATE,
+	GESTURE_SWIPE
+};
+
+/*!
+ * @brief
+ *     The point in the life of a gesture that an event reports.
+ * @remarks
+ *     Continuous gestures like pans begin, change any number of times and then end or are
+ *     cancelled. Discrete gestures like taps are simply recognized.
+ */
+enum _DLL_EXPORT GesturePhase {
+	GESTURE_BEGAN = 0,
+	GESTURE_CHANGED,
+	GESTURE_ENDED,
+	GESTURE_CANCELLED,
+	GESTURE_RECOGNIZED
+};
+
+/*!
+ * @brief
+ *     What a recognizer asks of the engine after looking at a frame.
+ */
+enum _DLL_EXPORT GestureStep {
+	GSTEP_NONE = 0,		// Nothing to report yet
+	GSTEP_FAIL,			// The touches can not be this gesture
+	GSTEP_BEGIN,		// A continuous gesture starts
+	GSTEP_CHANGE,		// A continuous gesture changed
+	GSTEP_END,			// A continuous gesture is over
+	GSTEP_RECOGNIZE		// A discrete gesture happened
+};
+
+/*!
+ * @brief
+ *     A summary of the contacts on the surface that every recognizer shares.
+ * @remarks
+ *     The engine updates the summary once per frame in time proportional to the number
+ *     of contacts. The totals since the first touch skip frames in which contacts were 
+ *     added or lifted, so a finger joining a pan does not make it jump.
+ */
+struct _DLL_EXPORT GestureFrame {
+	/*! @brief The time of the frame. */
+	Timestamp time;
+
+	/*! @brief The time the first contact touched down. */
+	Timestamp startTime;
+
+	/*! @brief The number of contacts on the surface. */
+	unsigned int contactCount;
+
+	/*! @brief The largest number of contacts on the surface at once since the first touch. */
+	unsigned int maxContactCount;
+
+	/*! @brief Whether contacts were added or lifted in this frame. */
+	bool contactsChanged;
+
+	/*! @brief The center of the contacts, or of the last contacts once all have lifted. */
+	float x;
+
+	/*! @brief The vertical center of the contacts. */
+	float y;
+
+	/*! @brief The mean distance of the contacts from their center. */
+	float spread;
+
+	/*! @brief The angle in radians of the line from the first contact to the second. */
+	float angle;
+
+	/*! @brief The horizontal movement of the center since the first touch. */
+	float translationX;
+
+	/*! @brief The vertical movement of the center since the first touch. */
+	float translationY;
+
+	/*! @brief The change of the spread since there were two contacts, as a factor. */
+	float scale;
+
+	/*! @brief The change of the angle in radians since there were two contacts. */
+	float rotation;
+
+	/*! @brief The smoothed horizontal speed of the center in surface widths per second. */
+	float velocityX;
+
+	/*! @brief The smoothed vertical speed of the center in surface heights per second. */
+	float velocityY;
+};
+
+/*!
+ * @brief
+ *     A recognized gesture.
+ */
+struct _DLL_EXPORT GestureEvent {
+	/*! @brief The recognizer that reports the gesture. */
+	const GestureRecognizer* recognizer;
+
+	/*! @brief The kind of gesture. */
+	GestureType type;
+
+	/*! @brief The point in the life of the gesture. */
+	GesturePhase phase;
+
+	/*! @brief The time of the frame. */
+	Timestamp time;
+
+	/*! @brief The number of contacts, or the most contacts at once for discrete gestures. */
+	unsigned int contactCount;
+
+	/*! @brief The horizontal center of the contacts. */
+	float x;
+
+	/*! @brief The vertical center of the contacts. */
+	float y;
+
+	/*! @brief The horizontal movement since the gesture began. */
+	float translationX;
+
+	/*! @brief The vertical movement since the gesture began. */
+	float translationY;
+
+	/*! @brief The change of the spread of the contacts as a factor. */
+	float scale;
+
+	/*! @brief The change of the angle of the contacts in radians. */
+	float rotation;
+
+	/*! @brief The horizontal speed in surface widths per second. */
+	float velocityX;
+
+	/*! @brief The vertical speed in surface heights per second. */
+	float velocityY;
+
+	/*! @brief The number of taps in a row for taps. */
+	unsigned int tapCount;
+};
+
+/*!
+ * @brief
+ *     Implements a listener to recognized gestures.
+ */
+class _DLL_EXPORT GestureListener abstract {
+public:
+	/*!
+	 * @brief
+	 *     Destructor.
+	 */
+	virtual ~GestureListener() {}
+
+	/*!
+	 * @brief
+	 *     Called for each step of each recognized gesture.
+	 * @param source
+	 *     The touch screen the gesture was made on.
+	 * @param event
+	 *     The gesture.
+	 */
+	virtual void gesture(const TouchScreen* source, const GestureEvent& event) {}
+};
+
+/*!
+ * @brief
+ *     The state machine of one kind of gesture.
+ * @remarks
+ *     Recognizers look only at the shared GestureFrame so each one costs constant time
+ *     per frame. The engine decides whether a step is allowed to happen; the recognizer 
+ *     only says what it sees.
+ */
+class _DLL_EXPORT GestureRecognizer abstract {
+public:
+	/*!
+	 * @brief
+	 *     Constructor.
+	 * @param type
+	 *     The kind of gesture the recognizer reports.
+	 */
+	GestureRecognizer(const GestureType type) : type(type) {}
+
+	/*!
+	 * @brief
+	 *     Destructor.
+	 */
+	virtual ~GestureRecognizer() {}
+
+	/*!
+	 * @brief
+	 *     Gets the kind of gesture the recognizer reports.
+	 */
+	inline GestureType getType() const {
+		return this->type;
+	}
+
+	/*!
+	 * @brief
+	 *     Called when the first contact touches down.
+	 * @param frame
+	 *     The first frame.
+	 */
+	virtual void beginSequence(const GestureFrame& frame) {}
+
+	/*!
+	 * @brief
+	 *     Determines if the recognizer is waiting for more touches after the last contact 
+	 *     lifted, for example for the second tap of a double tap. Waiting recognizers do
+	 *     not fail when the contacts lift.
+	 */
+	virtual bool isWaiting() const {
+		return false;
+	}
+
+	/*!
+	 * @brief
+	 *     Looks at a frame.
+	 * @param frame
+	 *     The frame.
+	 * @param active
+	 *     Whether the engine accepted the beginning of this continuous gesture.
+	 * @param event
+	 *     Receives the values of the gesture for every step but GSTEP_NONE and GSTEP_FAIL.
+	 *     The engine fills in the recognizer, type, phase and time.
+	 * @return
+	 *     The step the recognizer wants to take.
+	 */
+	virtual GestureStep update(const GestureFrame& frame, const bool active, 
+	                           GestureEvent& event) = 0;
+
+protected:
+	// -- The engine fills in cancellations the same way recognizers fill in their events.
+	friend class GestureEngine;
+
+	/*!
+	 * @brief
+	 *     Fills the values of an event from a frame.
+	 */
+	static void fillEvent(const GestureFrame& frame, GestureEvent& event);
+
+private:
+	/*! @brief The kind of gesture the recognizer reports. */
+	const GestureType type;
+};
+
+/*!
+ * @brief
+ *     Recognizes quick touches that barely move.
+ */
+class _DLL_EXPORT TapRecognizer : public GestureRecognizer {
+public:
+	/*!
+	 * @brief
+	 *     Constructor.
+	 * @param contactCount
+	 *     The number of fingers the tap is made with.
+	 * @param requiredTaps
+	 *     The number of taps in a row, 2 for a double tap.
+	 * @param maxDuration
+	 *     The longest time in microseconds the fingers may rest on the surface.
+	 * @param maxMovement
+	 *     The farthest the fingers may move.
+	 * @param repeatInterval
+	 *     The longest time in microseconds between taps that count as a double tap.
+	 */
+	TapRecognizer(const unsigned int contactCount = 1, const unsigned int requiredTaps = 1, 
+	              const Timestamp maxDuration = 300000, const float maxMovement = 0.02f, 
+	              const Timestamp repeatInterval = 300000);
+
+	/*! @see I43D::GestureRecognizer:: */
+	virtual bool isWaiting() const;
+
+	/*! @see I43D::GestureRecognizer:: */
+	virtual GestureStep update(const GestureFrame& frame, const bool active, 
+	                           GestureEvent& event);
+
+private:
+	/*! @brief The number of fingers the tap is made with. */
+	unsigned int contactCount;
+
+	/*! @brief The number of taps in a row. */
+	unsigned int requiredTaps;
+
+	/*! @brief The longest time the fingers may rest on the surface. */
+	Timestamp maxDuration;
+
+	/*! @brief The farthest the fingers may move. */
+	float maxMovement;
+
+	/*! @brief The longest time between taps that count as a double tap. */
+	Timestamp repeatInterval;
+
+	/*! @brief The time of the last tap. */
+	Timestamp lastTapTime;
+
+	/*! @brief The position of the last tap. */
+	float lastTapX;
+
+	/*! @brief The vertical position of the last tap. */
+	float lastTapY;
+
+	/*! @brief The number of taps in a row so far. */
+	unsigned int tapCount;
+};
+
+/*!
+ * @brief
+ *     Recognizes dragging one or more fingers.
+ */
+class _DLL_EXPORT PanRecognizer : public GestureRecognizer {
+public:
+	/*!
+	 * @brief
+	 *     Constructor.
+	 * @param minDistance
+	 *     How far the fingers must move before the pan begins.
+	 * @param minContacts
+	 *     The fewest fingers the pan may be made with.
+	 * @param maxContacts
+	 *     The most fingers the pan may be made with.
+	 */
+	PanRecognizer(const float minDistance = 0.02f, const unsigned int minContacts = 1, 
+	              const unsigned int maxContacts = TouchContacts::MAX_SLOTS);
+
+	/*! @see I43D::GestureRecognizer:: */
+	virtual GestureStep update(const GestureFrame& frame, const bool active, 
+	                           GestureEvent& event);
+
+private:
+	/*! @brief How far the fingers must move before the pan begins. */
+	float minDistance;
+
+	/*! @brief The fewest fingers the pan may be made with. */
+	unsigned int minContacts;
+
+	/*! @brief The most fingers the pan may be made with. */
+	unsigned int maxContacts;
+};
+
+/*!
+ * @brief
+ *     Recognizes two or more fingers moving apart or together.
+ */
+class _DLL_EXPORT PinchRecognizer : public GestureRecognizer {
+public:
+	/*!
+	 * @brief
+	 *     Constructor.
+	 * @param minScale
+	 *     How much the spread must change, as a fraction, before the pinch begins.
+	 */
+	PinchRecognizer(const float minScale = 0.1f);
+
+	/*! @see I43D::GestureRecognizer:: */
+	virtual GestureStep update(const GestureFrame& frame, const bool active, 
+	                           GestureEvent& event);
+
+private:
+	/*! @brief How much the spread must change before the pinch begins. */
+	float minScale;
+};
+
+/*!
+ * @brief
+ *     Recognizes two fingers turning around each other.
+ */
+class _DLL_EXPORT RotateRecognizer : public GestureRecognizer {
+public:
+	/*!
+	 * @brief
+	 *     Constructor.
+	 * @param minAngle
+	 *     How far in radians the fingers must turn before the rotation begins.
+	 */
+	RotateRecognizer(const float minAngle = 0.15f);
+
+	/*! @see I43D::GestureRecognizer:: */
+	virtual GestureStep update(const GestureFrame& frame, const bool active, 
+	                           GestureEvent& event);
+
+private:
+	/*! @brief How far the fingers must turn before the rotation begins. */
+	float minAngle;
+};
+
+/*!
+ * @brief
+ *     Recognizes a quick flick in one direction.
+ */
+class _DLL_EXPORT SwipeRecognizer : public GestureRecognizer {
+public:
+	/*!
+	 * @brief
+	 *     Constructor.
+	 * @param minDistance
+	 *     How far the fingers must travel.
+	 * @param minSpeed
+	 *     How fast the fingers must be moving when they lift, in surface sizes per second.
+	 * @param maxDuration
+	 *     The longest time in microseconds the swipe may take.
+	 */
+	SwipeRecognizer(const float minDistance = 0.1f, const float minSpeed = 0.5f, 
+	                const Timestamp maxDuration = 500000);
+
+	/*! @see I43D::GestureRecognizer:: */
+	virtual GestureStep update(const GestureFrame& frame, const bool active, 
+	                           GestureEvent& event);
+
+private:
+	/*! @brief How far the fingers must travel. */
+	float minDistance;
+
+	/*! @brief How fast the fingers must be moving when they lift. */
+	float minSpeed;
+
+	/*! @brief The longest time the swipe may take. */
+	Timestamp maxDuration;
+};
+
+/*!
+ * @brief
+ *     Runs a number of gesture recognizers on the contacts of a touch screen.
+ * @remarks
+ *     Register the engine as a listener of the touch screen. Each frame the engine 
+ *     summarizes the contacts once and steps every recognizer that has not failed in the
+ *     order they were added, so earlier recognizers take priority.
+ *     <br><br>
+ *     Arbitration follows two rules. A gesture can not begin while another gesture is
+ *     active unless the two were allowed to run together with setSimultaneous(), and the
+ *     first to begin wins. A recognizer made to wait for another with requireFailure() 
+ *     holds its gesture until the other fails and drops it if the other succeeds, which
+ *     is how a single tap is kept from firing on the first tap of a double tap.
+ */
+class _DLL_EXPORT GestureEngine : public TouchListener {
+public:
+	/*! @brief The largest number of recognizers in an engine. */
+	enum { MAX_RECOGNIZERS = 32 };
+
+	/*!
+	 * @brief
+	 *     Constructor.
+	 */
+	GestureEngine();
+
+	/*!
+	 * @brief
+	 *     Adds a recognizer after all of the others. The engine does not own it.
+	 * @return
+	 *     RESULT_FULL if the engine already has MAX_RECOGNIZERS recognizers.
+	 */
+	ResultCode addRecognizer(GestureRecognizer* recognizer);
+
+	/*!
+	 * @brief
+	 *     Removes a recognizer along with its arbitration rules.
+	 */
+	void removeRecognizer(GestureRecognizer* recognizer);
+
+	/*!
+	 * @brief
+	 *     Allows or forbids two recognizers to have active gestures at the same time.
+	 * @return
+	 *     RESULT_NOT_FOUND if either recognizer was not added to the engine.
+	 */
+	ResultCode setSimultaneous(GestureRecognizer* first, GestureRecognizer* second, const bool flag);
+
+	/*!
+	 * @brief
+	 *     Makes a recognizer wait for another to fail.
+	 * @param recognizer
+	 *     The recognizer that waits.
+	 * @param other
+	 *     The recognizer that must fail first.
+	 * @return
+	 *     RESULT_NOT_FOUND if either recognizer was not added to the engine.
+	 */
+	ResultCode requireFailure(GestureRecognizer* recognizer, GestureRecognizer* other);
+
+	/*!
+	 * @brief
+	 *     Lets recognizers that wait for more touches time out. Call once per frame.
+	 * @param now
+	 *     The current time on the input clock.
+	 */
+	void update(const Timestamp now);
+
+	/*!
+	 * @brief
+	 *     Gets the summary of the contacts as of the last frame.
+	 */
+	inline const GestureFrame& getFrame() const {
+		return this->frame;
+	}
+
+	/*!
+	 * @brief 
+	 *     Adds a new Gesture listener.
+	 * @param listener
+	 *     The listener to add.
+	 */
+	inline void addGestureListener(GestureListener* listener) {
+		this->listeners.insert(listener);
+	}
+
+	/*!
+	 * @brief 
+	 *     Remove a Gesture listener. 
+	 * @param listener
+	 *     The listener to remove.
+	 */
+	inline void removeGestureListener(GestureListener* listener) {
+		this->listeners.erase(listener);
+	}
+
+	/*! @see I43D::TouchListener:: */
+	virtual void contactsChanged(const TouchScreen* source, const TouchContacts& contacts);
+
+private:
+	/*!
+	 * @brief
+	 *     The states of a recognizer during a touch sequence.
+	 */
+	enum RecognizerState {
+		STATE_POSSIBLE,		// Still watching
+		STATE_ACTIVE,		// A continuous gesture began and has not ended
+		STATE_HELD,			// A discrete gesture waits for other recognizers to fail
+		STATE_DONE,			// The gesture was delivered
+		STATE_FAILED		// The touches are not this gesture
+	};
+
+	/*!
+	 * @brief
+	 *     A recognizer and its place in the arbitration.
+	 */
+	struct Entry {
+		/*! @brief The recognizer. */
+		GestureRecognizer* recognizer;
+
+		/*! @brief The state of the recognizer in the current sequence. */
+		RecognizerState state;
+
+		/*! @brief A bit for each entry that may be active at the same time as this one. */
+		unsigned int simultaneousMask;
+
+		/*! @brief A bit for each entry that must fail before this one may succeed. */
+		unsigned int failureMask;
+
+		/*! @brief The gesture held while waiting for other recognizers to fail. */
+		GestureEvent held;
+	};
+
+	/*!
+	 * @brief
+	 *     Updates the summary of the contacts.
+	 */
+	void updateFrame(const TouchContacts& contacts);
+
+	/*!
+	 * @brief
+	 *     Finds the entry of a recognizer.
+	 * @return
+	 *     The index of the entry or the number of entries if the recognizer is not added.
+	 */
+	unsigned int findEntry(const GestureRecognizer* recognizer) const;
+
+	/*!
+	 * @brief
+	 *     Marks an entry as failed and cancels its gesture if it was active.
+	 */
+	void fail(const unsigned int index);
+
+	/*!
+	 * @brief
+	 *     Steps the recognizers that are still undecided or active.
+	 * @param activeToo
+	 *     Whether active recognizers are stepped as well.
+	 */
+	void stepRecognizers(const bool activeToo);
+
+	/*!
+	 * @brief
+	 *     Marks an entry as successful, failing the entries that wait for it to fail.
+	 */
+	void succeed(const unsigned int index);
+
+	/*!
+	 * @brief
+	 *     Delivers the gestures that were held for recognizers that have since failed.
+	 */
+	void releaseHeld();
+
+	/*!
+	 * @brief
+	 *     Sends an event to the listeners.
+	 */
+	void dispatch(const GestureEvent& event);
+
+	/*! @brief The recognizers in order of priority. */
+	std::vector<Entry> entries;
+
+	/*! @brief The summary of the contacts. */
+	GestureFrame frame;
+
+	/*! @brief The slots of the two contacts the angle was measured between, or MAX_SLOTS. */
+	unsigned int angleSlots[2];
+
+	/*! @brief The touch screen being handled. */
+	const TouchScreen* source;
+
+	/*!
+	 * @brief
+	 *     Stores the listeners to the engine.
+	 */
+	std::set<GestureListener*> listeners;
+};
+
+} // namespace I43D
+#endif  // _I43D_GESTURE_H_
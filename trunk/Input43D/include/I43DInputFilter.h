@@ -0,0 +1,1078 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+#ifndef _I43D_INPUT_FILTER_H_
+#define _I43D_INPUT_FILTER_H_
+
+#include "I43DEvent.h"
+#include <map>
+#include <vector>
+
+/*!
+ * @file
+ *     This file contains a pipeline of filters that rework batches of input events before 
+ *     they are dispatched, and the filters shipped with the library.
+ * @author Robert Eugene Simmons Jr. (Kraythe)
+ */
+
+namespace I43D {
+
+// ---- Forward Declarations
+struct _DLL_EXPORT FilterBatch;
+class _DLL_EXPORT PassFilter;
+class _DLL_EXPORT DeadzoneFilter;
+class _DLL_EXPORT SmoothingFilter;
+class _DLL_EXPORT CoalesceFilter;
+class _DLL_EXPORT RemapFilter;
+class _DLL_EXPORT InvertFilter;
+class _DLL_EXPORT RateLimitFilter;
+class _DLL_EXPORT InputFilter;
+class _DLL_EXPORT DynamicFilterChain;
+
+/*!
+ * @brief
+ *     The events of a batch that passed the filters so far.
+ * @remarks
+ *     Filters that fold an event into an earlier one, like CoalesceFilter, point replaced
+ *     at that event. The event being filtered then takes its place once it has passed all
+ *     filters, so the folded event is filtered as fully as the one it replaces.
+ */
+struct _DLL_EXPORT FilterBatch {
+	/*! @brief The events that passed. */
+	InputEvent* events;
+
+	/*! @brief The number of events that passed. */
+	unsigned int count;
+
+	/*! @brief The passed event that the event being filtered replaces, or 0 to add it. */
+	InputEvent* replaced;
+};
+
+/*!
+ * @brief
+ *     Builds the key that per device state of the filters is stored under.
+ */
+inline unsigned long long makeFilterKey(const DeviceID device, const unsigned short type, 
+                                        const unsigned short code) {
+	return (static_cast<unsigned long long>(device) << 32) | 
+	       (static_cast<unsigned long long>(type) << 16) | code;
+}
+
+/*!
+ * @brief
+ *     Gets whether an event reports motion, which filters may change, fold or drop.
+ */
+inline bool isMotionEvent(const InputEvent& event) {
+	return event.type == IEVT_MOUSE_MOVED || event.type == IEVT_CONTROLLER_AXIS_MOVED;
+}
+
+/*!
+ * @brief
+ *     The state a filter keeps for each device, axis or button.
+ * @remarks
+ *     The state is kept in a small open addressed hash table, so finding it takes one 
+ *     multiplication and mostly one compare no matter how the events of the devices and 
+ *     axes interleave. The table only allocates when it grows.
+ */
+template <class T>
+class FilterStateTable {
+public:
+	/*!
+	 * @brief
+	 *     Constructor.
+	 */
+	FilterStateTable() : slots(INITIAL_CAPACITY), count(0), shift(64 - INITIAL_BITS) {
+	}
+
+	/*!
+	 * @brief
+	 *     Finds the state under a key.
+	 * @param key
+	 *     The key made with I43D::makeFilterKey().
+	 * @return
+	 *     The state, or 0 if there is none.
+	 */
+	inline T* find(const unsigned long long key) {
+		const unsigned int mask = static_cast<unsigned int>(this->slots.size()) - 1;
+		for (unsigned int idx = this->hash(key); this->slots[idx].used; idx = (idx + 1) & mask) {
+			if (this->slots[idx].key == key) {
+				return &this->slots[idx].state;
+			}
+		}
+		return 0;
+	}
+
+	/*!
+	 * @brief
+	 *     Gets the state under a key, creating it if there is none.
+	 * @param key
+	 *     The key made with I43D::makeFilterKey().
+	 * @param created
+	 *     Set to true if the state was created by this call.
+	 */
+	inline T& get(const unsigned long long key, bool& created) {
+		T* found = this->find(key);
+		created = found == 0;
+		return created ? this->insert(key) : *found;
+	}
+
+	/*!
+	 * @brief
+	 *     Forgets the state under a key.
+	 */
+	void remove(const unsigned long long key) {
+		this->rebuild(this->slots.size(), key, false);
+	}
+
+	/*!
+	 * @brief
+	 *     Forgets the state of a device, for example when it is disconnected.
+	 */
+	void removeDevice(const DeviceID device) {
+		this->rebuild(this->slots.size(), device, true);
+	}
+
+	/*!
+	 * @brief
+	 *     Gets whether the table holds no state.
+	 */
+	inline bool isEmpty() const {
+		return this->count == 0;
+	}
+
+	/*!
+	 * @brief
+	 *     Forgets all state.
+	 */
+	void clear() {
+		this->slots.assign(INITIAL_CAPACITY, Slot());
+		this->count = 0;
+		this->shift = 64 - INITIAL_BITS;
+	}
+
+private:
+	/*! @brief The number of slots of a new table. */
+	enum { INITIAL_BITS = 4, INITIAL_CAPACITY = 1 << INITIAL_BITS };
+
+	/*!
+	 * @brief
+	 *     A slot of the table.
+	 */
+	struct Slot {
+		unsigned long long key;
+		T state;
+		bool used;
+
+		Slot() : key(0), state(), used(false) {}
+	};
+
+	/*!
+	 * @brief
+	 *     Spreads a key over the slots with Fibonacci hashing, which takes the top bits of
+	 *     the product so keys that only differ in the device or axis land far apart.
+	 */
+	inline unsigned int hash(const unsigned long long key) const {
+		return static_cast<unsigned int>((key * 0x9E3779B97F4A7C15ull) >> this->shift);
+	}
+
+	/*!
+	 * @brief
+	 *     Adds state under a key that is not in the table. Kept apart from find() so 
+	 *     lookups stay small enough to inline.
+	 */
+	T& insert(const unsigned long long key) {
+		if ((this->count + 1) * 2 > this->slots.size()) {
+			--this->shift;
+			this->rebuild(this->slots.size() * 2, 0, false);
+		}
+		const unsigned int mask = static_cast<unsigned int>(this->slots.size()) - 1;
+		unsigned int idx = this->hash(key);
+		while (this->slots[idx].used) {
+			idx = (idx + 1) & mask;
+		}
+		++this->count;
+		this->slots[idx].used = true;
+		this->slots[idx].key = key;
+		this->slots[idx].state = T();
+		return this->slots[idx].state;
+	}
+
+	/*!
+	 * @brief
+	 *     Rehashes the table into a number of slots, leaving out a key or a device.
+	 * @param capacity
+	 *     The number of slots, a power of two.
+	 * @param left
+	 *     The key or device to leave out.
+	 * @param device
+	 *     Whether left is a device rather than a key.
+	 */
+	void rebuild(const size_t capacity, const unsigned long long left, const bool device) {
+		std::vector<Slot> old(capacity);
+		old.swap(this->slots);
+		this->count = 0;
+		const unsigned int mask = static_cast<unsigned int>(capacity) - 1;
+		for (unsigned int from = 0; from < old.size(); ++from) {
+			const Slot& slot = old[from];
+			if (slot.used && (device ? (slot.key >> 32) != left : slot.key != left)) {
+				unsigned int idx = this->hash(slot.key);
+				while (this->slots[idx].used) {
+					idx = (idx + 1) & mask;
+				}
+				this->slots[idx] = slot;
+				++this->count;
+			}
+		}
+	}
+
+	/*! @brief The slots, a power of two of them. */
+	std::vector<Slot> slots;
+
+	/*! @brief The number of used slots. */
+	unsigned int count;
+
+	/*! @brief Shifts a hash down to the bits that index the slots. */
+	unsigned int shift;
+};
+
+/*!
+ * @brief
+ *     A filter that passes every event. Ends a FilterChain.
+ */
+class _DLL_EXPORT PassFilter {
+public:
+	/*!
+	 * @brief
+	 *     Passes the event.
+	 */
+	inline bool filter(InputEvent& event, FilterBatch& batch) {
+		return true;
+	}
+
+	/*! @brief Holds no events back. */
+	inline bool release(const Timestamp now, InputEvent& event, FilterBatch& batch) {
+		return false;
+	}
+};
+
+/*!
+ * @brief
+ *     Joins two filters into one, so a chain of any length can be built at compile time.
+ * @remarks
+ *     Every filter has a method <code>bool filter(InputEvent& event, FilterBatch& batch)
+ *     </code> that may change the event and returns false to drop it. The chain calls its
+ *     head and then its tail, which may be a chain again: 
+ *     <code>FilterChain<DeadzoneFilter, FilterChain<InvertFilter, CoalesceFilter> ></code>
+ *     filters with the three in that order. No call is virtual, so the compiler inlines 
+ *     the whole chain into the single loop of FilterPipeline.
+ *     <br><br>
+ *     Every filter also has a method <code>bool release(const Timestamp now, InputEvent& 
+ *     event, FilterBatch& batch)</code> that hands out one event it held back and whose 
+ *     time has come, like RateLimitFilter does, and returns false when there is none.
+ */
+template <class Head, class Tail = PassFilter>
+class FilterChain {
+public:
+	/*!
+	 * @brief
+	 *     Filters an event with the head and then the tail.
+	 */
+	inline bool filter(InputEvent& event, FilterBatch& batch) {
+		return this->head.filter(event, batch) && this->tail.filter(event, batch);
+	}
+
+	/*!
+	 * @brief
+	 *     Gets an event that a filter of the chain held back and whose time has come.
+	 * @param now
+	 *     The current time on the input clock.
+	 * @param event
+	 *     Receives the event.
+	 * @param batch
+	 *     The events of the batch that passed so far.
+	 * @return
+	 *     False if no event is let go.
+	 */
+	inline bool release(const Timestamp now, InputEvent& event, FilterBatch& batch) {
+		// -- What the head lets go of has only run the filters up to the head.
+		while (this->head.release(now, event, batch)) {
+			if (this->tail.filter(event, batch)) {
+				return true;
+			}
+		}
+		return this->tail.release(now, event, batch);
+	}
+
+	/*!
+	 * @brief
+	 *     Gets the first filter, to configure it.
+	 */
+	inline Head& getHead() {
+		return this->head;
+	}
+
+	/*!
+	 * @brief
+	 *     Gets the rest of the chain, to configure it.
+	 */
+	inline Tail& getTail() {
+		return this->tail;
+	}
+
+private:
+	/*! @brief The first filter. */
+	Head head;
+
+	/*! @brief The rest of the chain. */
+	Tail tail;
+};
+
+/*!
+ * @brief
+ *     Runs batches of events through a filter and hands the survivors on.
+ * @remarks
+ *     Put the pipeline between the event translators of the devices and the queue or the
+ *     dispatch: the translators push into the pipeline, which collects the events until
+ *     flush() runs the filter over the whole batch in one loop and pushes what is left to
+ *     the sink. A batch of events that is already at hand, for example one popped from a
+ *     queue, is filtered in place with process(). Events that filters hold back, like the
+ *     motion a RateLimitFilter suppressed last, are only let go by flush(), so call it 
+ *     every frame when such filters are used, even when nothing was pushed.
+ *     <br><br>
+ *     The filter is usually a FilterChain. For chains that are put together at run time,
+ *     like in tools, use a DynamicFilterChain instead.
+ */
+template <class Filter>
+class FilterPipeline : public InputEventSink {
+public:
+	/*!
+	 * @brief
+	 *     Constructor.
+	 * @param sink
+	 *     The sink that receives the filtered events, or 0 to only use process().
+	 * @param batchCapacity
+	 *     The number of events reserved for a batch; larger batches allocate.
+	 */
+	explicit FilterPipeline(InputEventSink* sink = 0, const unsigned int batchCapacity = 256) 
+		: sink(sink) {
+		this->batch.reserve(batchCapacity);
+	}
+
+	/*!
+	 * @brief
+	 *     Destructor.
+	 */
+	virtual ~FilterPipeline() {
+	}
+
+	/*!
+	 * @brief
+	 *     Adds an event to the batch.
+	 */
+	virtual bool pushEvent(const InputEvent& event) {
+		this->batch.push_back(event);
+		return true;
+	}
+
+	/*!
+	 * @brief
+	 *     Filters the batch and pushes the events that are left to the sink.
+	 * @remarks
+	 *     The events that filters held back and whose time has come are pushed first, as
+	 *     they are older than the batch.
+	 * @param now
+	 *     The current time on the input clock.
+	 * @return
+	 *     The number of events pushed.
+	 */
+	unsigned int flush(const Timestamp now) {
+		unsigned int count = 0;
+		InputEvent event;
+		FilterBatch released;
+		released.events = &event;
+		released.count = 0;
+		released.replaced = 0;
+		while (this->filter.release(now, event, released)) {
+			if (this->sink != 0) {
+				this->sink->pushEvent(event);
+			}
+			++count;
+		}
+		if (this->batch.empty() == false) {
+			const unsigned int passed = 
+				this->process(&this->batch[0], static_cast<unsigned int>(this->batch.size()));
+			if (this->sink != 0) {
+				for (unsigned int idx = 0; idx < passed; ++idx) {
+					this->sink->pushEvent(this->batch[idx]);
+				}
+			}
+			count += passed;
+			this->batch.clear();
+		}
+		return count;
+	}
+
+	/*!
+	 * @brief
+	 *     Filters a batch of events in place.
+	 * @param events
+	 *     The events. The events that are left are moved to the front, in order.
+	 * @param count
+	 *     The number of events.
+	 * @return
+	 *     The number of events left.
+	 */
+	inline unsigned int process(InputEvent* events, const unsigned int count) {
+		FilterBatch passed;
+		passed.events = events;
+		passed.count = 0;
+		for (unsigned int idx = 0; idx < count; ++idx) {
+			InputEvent event = events[idx];
+			passed.replaced = 0;
+			if (this->filter.filter(event, passed)) {
+				if (passed.replaced != 0) {
+					*passed.replaced = event;
+				} else {
+					events[passed.count++] = event;
+				}
+			}
+		}
+		return passed.count;
+	}
+
+	/*!
+	 * @brief
+	 *     Gets the filter, to configure it.
+	 */
+	inline Filter& getFilter() {
+		return this->filter;
+	}
+
+	/*!
+	 * @brief
+	 *     Sets the sink that receives the filtered events.
+	 */
+	inline void setSink(InputEventSink* sink) {
+		this->sink = sink;
+	}
+
+private:
+	/*! @brief Copying a pipeline is not supported. */
+	FilterPipeline(const FilterPipeline&);
+
+	/*! @brief Copying a pipeline is not supported. */
+	FilterPipeline& operator=(const FilterPipeline&);
+
+	/*! @brief The filter. */
+	Filter filter;
+
+	/*! @brief The events pushed since the last flush. */
+	std::vector<InputEvent> batch;
+
+	/*! @brief Receives the filtered events, or 0. */
+	InputEventSink* sink;
+};
+
+/*!
+ * @brief
+ *     Zeroes controller axes near their center and rescales the rest.
+ * @remarks
+ *     Works on the normalized value of IEVT_CONTROLLER_AXIS_MOVED events, which runs from 
+ *     -32767 to 32767. Use I43D::AxisProcessor instead where the raw positions are at 
+ *     hand; this filter is for event streams such as recordings or network input.
+ */
+class _DLL_EXPORT DeadzoneFilter {
+public:
+	/*!
+	 * @brief
+	 *     Constructor. The filter has no deadzone until one is set.
+	 */
+	DeadzoneFilter() : defaultDeadzone(0) {
+	}
+
+	/*!
+	 * @brief
+	 *     Sets the deadzone of devices without one of their own.
+	 * @param deadzone
+	 *     The deadzone from 0 to 1.
+	 */
+	void setDefaultDeadzone(const float deadzone);
+
+	/*!
+	 * @brief
+	 *     Sets the deadzone of one device.
+	 * @param device
+	 *     The device.
+	 * @param deadzone
+	 *     The deadzone from 0 to 1.
+	 */
+	void setDeadzone(const DeviceID device, const float deadzone);
+
+	/*!
+	 * @brief
+	 *     Applies the deadzone of the device to axis events.
+	 */
+	inline bool filter(InputEvent& event, FilterBatch& batch) {
+		if (event.type == IEVT_CONTROLLER_AXIS_MOVED) {
+			int deadzone = this->defaultDeadzone;
+			if (this->deadzones.isEmpty() == false) {
+				const int* found = this->deadzones.find(makeFilterKey(event.device, 0, 0));
+				if (found != 0) {
+					deadzone = *found;
+				}
+			}
+			if (deadzone > 0) {
+				const int magnitude = event.value2 < 0 ? -event.value2 : event.value2;
+				int scaled = 0;
+				if (magnitude > deadzone) {
+					scaled = (magnitude - deadzone) * 32767 / (32767 - deadzone);
+				}
+				event.value2 = event.value2 < 0 ? -scaled : scaled;
+			}
+		}
+		return true;
+	}
+
+	/*! @brief Holds no events back. */
+	inline bool release(const Timestamp now, InputEvent& event, FilterBatch& batch) {
+		return false;
+	}
+
+private:
+	/*! @brief The deadzone of devices without one of their own in 1/32767. */
+	int defaultDeadzone;
+
+	/*! @brief The deadzones of single devices in 1/32767. */
+	FilterStateTable<int> deadzones;
+};
+
+/*!
+ * @brief
+ *     Smooths mouse motion and controller axes with an exponential moving average.
+ * @remarks
+ *     Each axis of each device is smoothed on its own. A factor of 0 passes the values 
+ *     unchanged and a factor close to 1 smooths strongly at the cost of lag. Mouse motion
+ *     reports absolute positions, so both the x and y of IEVT_MOUSE_MOVED are smoothed; 
+ *     controller axes only have their normalized value smoothed.
+ */
+class _DLL_EXPORT SmoothingFilter {
+public:
+	/*!
+	 * @brief
+	 *     Constructor.
+	 * @param factor
+	 *     The weight of the previous value from 0 to 1.
+	 */
+	explicit SmoothingFilter(const float factor = 0.5f);
+
+	/*!
+	 * @brief
+	 *     Sets the weight of the previous value from 0 to 1.
+	 */
+	void setFactor(const float factor);
+
+	/*!
+	 * @brief
+	 *     Forgets the smoothed values of all devices.
+	 */
+	inline void reset() {
+		this->states.clear();
+	}
+
+	/*!
+	 * @brief
+	 *     Smooths motion events.
+	 */
+	inline bool filter(InputEvent& event, FilterBatch& batch) {
+		if (isMotionEvent(event)) {
+			bool created = false;
+			State& state = this->states.get(makeFilterKey(event.device, event.type, event.code), 
+			                                created);
+			const long long value = static_cast<long long>(event.value) * ONE;
+			const long long value2 = static_cast<long long>(event.value2) * ONE;
+			if (created) {
+				state.value = value;
+				state.value2 = value2;
+			} else {
+				// -- Kept in fixed point so slow motion is not lost to rounding.
+				state.value += (value - state.value) * this->weight / ONE;
+				state.value2 += (value2 - state.value2) * this->weight / ONE;
+			}
+			if (event.type == IEVT_MOUSE_MOVED) {
+				event.value = toWhole(state.value);
+			}
+			event.value2 = toWhole(state.value2);
+		} else if (event.type == IEVT_DEVICE_DISCONNECTED) {
+			this->states.removeDevice(event.device);
+		}
+		return true;
+	}
+
+	/*! @brief Holds no events back. */
+	inline bool release(const Timestamp now, InputEvent& event, FilterBatch& batch) {
+		return false;
+	}
+
+private:
+	/*! @brief The fraction bits of the smoothed values and the weight, and one in them. */
+	enum { FRACTION_BITS = 8, ONE = 1 << FRACTION_BITS };
+
+	/*!
+	 * @brief
+	 *     Rounds a smoothed value to the nearest whole value.
+	 */
+	static inline int toWhole(const long long value) {
+		// -- Shifting rounds negative values down like positive ones and takes no branch, 
+		// -- which matters for axes that swing around their center.
+		return static_cast<int>((value + ONE / 2) >> FRACTION_BITS);
+	}
+
+	/*!
+	 * @brief
+	 *     The smoothed values of one axis in fixed point.
+	 */
+	struct State {
+		long long value;
+		long long value2;
+	};
+
+	/*! @brief The weight of a new value in fixed point. */
+	long long weight;
+
+	/*! @brief The smoothed values. */
+	FilterStateTable<State> states;
+};
+
+/*!
+ * @brief
+ *     Folds motion events of a batch into the latest one.
+ * @remarks
+ *     A motion event replaces the previous event of the same device if that one is motion
+ *     of the same axis, so a batch carries one event per axis between any two button or 
+ *     key events of the device. Since motion events carry absolute values, nothing but 
+ *     the intermediate samples is lost; the time of the replaced event is kept as the 
+ *     time of the latest sample.
+ *     <br><br>
+ *     The event is folded in by FilterPipeline once the filters after this one passed it.
+ *     The filter compares the event as the filters before it left it with the events of 
+ *     the batch as all filters left them, so put filters that change the device, type or 
+ *     number of events, like RemapFilter, before it.
+ */
+class _DLL_EXPORT CoalesceFilter {
+public:
+	/*!
+	 * @brief
+	 *     Folds motion into the previous event of the device where possible.
+	 */
+	inline bool filter(InputEvent& event, FilterBatch& batch) {
+		if (isMotionEvent(event)) {
+			for (unsigned int idx = batch.count; idx > 0; --idx) {
+				InputEvent& previous = batch.events[idx - 1];
+				if (previous.device == event.device) {
+					if (previous.type == event.type && previous.code == event.code) {
+						batch.replaced = &previous;
+						return true;
+					}
+					if (isMotionEvent(previous) == false) {
+						break;
+					}
+				}
+			}
+		}
+		return true;
+	}
+
+	/*! @brief Holds no events back. */
+	inline bool release(const Timestamp now, InputEvent& event, FilterBatch& batch) {
+		return false;
+	}
+};
+
+/*!
+ * @brief
+ *     Changes the key, button or axis number of events.
+ * @remarks
+ *     Mappings are per device and per kind of event, so swapping two buttons of one 
+ *     controller leaves the keyboard alone. Presses and releases are mapped together.
+ */
+class _DLL_EXPORT RemapFilter {
+public:
+	/*!
+	 * @brief
+	 *     Maps a number of one device to another.
+	 * @param device
+	 *     The device.
+	 * @param type
+	 *     An event of the kind to map, for example IEVT_KEY_PRESSED for keys.
+	 * @param from
+	 *     The number the device reports.
+	 * @param to
+	 *     The number the events carry instead.
+	 */
+	void setMapping(const DeviceID device, const InputEventType type, const unsigned short from, 
+	                const unsigned short to);
+
+	/*!
+	 * @brief
+	 *     Removes a mapping.
+	 */
+	void removeMapping(const DeviceID device, const InputEventType type, 
+	                   const unsigned short from);
+
+	/*!
+	 * @brief
+	 *     Removes the mappings of all devices.
+	 */
+	inline void clear() {
+		this->mappings.clear();
+	}
+
+	/*!
+	 * @brief
+	 *     Maps the number of the event.
+	 */
+	inline bool filter(InputEvent& event, FilterBatch& batch) {
+		if (this->mappings.empty() == false) {
+			const std::map<unsigned long long, unsigned short>::const_iterator found = 
+				this->mappings.find(makeFilterKey(event.device, getKind(event.type), event.code));
+			if (found != this->mappings.end()) {
+				event.code = found->second;
+			}
+		}
+		return true;
+	}
+
+	/*! @brief Holds no events back. */
+	inline bool release(const Timestamp now, InputEvent& event, FilterBatch& batch) {
+		return false;
+	}
+
+private:
+	/*!
+	 * @brief
+	 *     Gets the event that stands for the kind of an event, so presses and releases share
+	 *     their mappings.
+	 */
+	static inline unsigned short getKind(const unsigned short type) {
+		switch (type) {
+			case IEVT_KEY_RELEASED:
+			case IEVT_KEY_REPEATED:
+				return IEVT_KEY_PRESSED;
+			case IEVT_MOUSE_BUTTON_RELEASED:
+				return IEVT_MOUSE_BUTTON_PRESSED;
+			case IEVT_CONTROLLER_BUTTON_RELEASED:
+				return IEVT_CONTROLLER_BUTTON_PRESSED;
+			default:
+				return type;
+		}
+	}
+
+	/*! @brief The mapped numbers by device, kind and number. */
+	std::map<unsigned long long, unsigned short> mappings;
+};
+
+/*!
+ * @brief
+ *     Inverts controller axes.
+ * @remarks
+ *     Only the normalized value of the axis is inverted; the raw position is left as the
+ *     device reported it.
+ */
+class _DLL_EXPORT InvertFilter {
+public:
+	/*!
+	 * @brief
+	 *     Inverts an axis of a device or stops inverting it.
+	 * @param device
+	 *     The device.
+	 * @param axis
+	 *     The number of the axis, up to 31.
+	 * @param inverted
+	 *     Whether to invert the axis.
+	 */
+	void setInverted(const DeviceID device, const unsigned short axis, const bool inverted);
+
+	/*!
+	 * @brief
+	 *     Inverts the axes that are set to be inverted.
+	 */
+	inline bool filter(InputEvent& event, FilterBatch& batch) {
+		if (event.type == IEVT_CONTROLLER_AXIS_MOVED && this->axes.isEmpty() == false) {
+			const unsigned int* found = this->axes.find(makeFilterKey(event.device, 0, 0));
+			if (found != 0 && event.code < 32 && (*found & (1u << event.code)) != 0) {
+				event.value2 = -event.value2;
+			}
+		}
+		return true;
+	}
+
+	/*! @brief Holds no events back. */
+	inline bool release(const Timestamp now, InputEvent& event, FilterBatch& batch) {
+		return false;
+	}
+
+private:
+	/*! @brief A bit for each inverted axis by device. */
+	FilterStateTable<unsigned int> axes;
+};
+
+/*!
+ * @brief
+ *     Limits how often each axis of a device reports motion.
+ * @remarks
+ *     Motion events that follow the last passed event of the same axis within the 
+ *     interval are held back. A later event of the axis replaces the held one, and the 
+ *     held event is let go by FilterPipeline::flush() once the interval has passed, so the
+ *     position the device comes to rest at is always delivered. Held motion can arrive 
+ *     after a button or key event of the device that followed it.
+ */
+class _DLL_EXPORT RateLimitFilter {
+public:
+	/*!
+	 * @brief
+	 *     Constructor.
+	 * @param interval
+	 *     The shortest time between two motion events of an axis in microseconds.
+	 */
+	explicit RateLimitFilter(const Timestamp interval = 0) : interval(interval) {
+	}
+
+	/*!
+	 * @brief
+	 *     Sets the shortest time between two motion events of an axis in microseconds.
+	 */
+	inline void setInterval(const Timestamp interval) {
+		this->interval = interval;
+	}
+
+	/*!
+	 * @brief
+	 *     Drops motion that comes too soon.
+	 */
+	inline bool filter(InputEvent& event, FilterBatch& batch) {
+		if (isMotionEvent(event) && (this->interval > 0 || this->held.empty() == false)) {
+			bool created = false;
+			State& state = this->states.get(makeFilterKey(event.device, event.type, event.code),
+			                                created);
+			if (created == false && event.time - state.last < this->interval) {
+				this->hold(event, state);
+				return false;
+			}
+			if (state.holding) {
+				// -- The event supersedes the one held back.
+				this->dropHeld(event);
+				state.holding = false;
+			}
+			state.last = event.time;
+		} else if (event.type == IEVT_DEVICE_DISCONNECTED) {
+			this->states.removeDevice(event.device);
+			this->removeHeld(event.device);
+		}
+		return true;
+	}
+
+	/*!
+	 * @brief
+	 *     Lets go of a held back event once the interval has passed since its axis last 
+	 *     passed an event.
+	 */
+	bool release(const Timestamp now, InputEvent& event, FilterBatch& batch);
+
+private:
+	/*!
+	 * @brief
+	 *     The state of one axis.
+	 */
+	struct State {
+		/*! @brief The time of the last passed motion. */
+		Timestamp last;
+
+		/*! @brief Whether motion of the axis is held back. */
+		bool holding;
+	};
+
+	/*!
+	 * @brief
+	 *     Holds back an event in place of the one of its axis held before.
+	 */
+	void hold(const InputEvent& event, State& state);
+
+	/*!
+	 * @brief
+	 *     Forgets the event held back for the axis of an event.
+	 */
+	void dropHeld(const InputEvent& event);
+
+	/*!
+	 * @brief
+	 *     Forgets the events held back for a device.
+	 */
+	void removeHeld(const DeviceID device);
+
+	/*! @brief The shortest time between two motion events. */
+	Timestamp interval;
+
+	/*! @brief The state of each axis. */
+	FilterStateTable<State> states;
+
+	/*! @brief The latest suppressed motion of each axis that holds some back. */
+	std::vector<InputEvent> held;
+};
+
+/*!
+ * @brief
+ *     A filter that can be put into a DynamicFilterChain.
+ */
+class _DLL_EXPORT InputFilter abstract {
+public:
+	/*!
+	 * @brief
+	 *     Destructor.
+	 */
+	virtual ~InputFilter() {}
+
+	/*!
+	 * @brief
+	 *     Filters an event.
+	 * @param event
+	 *     The event, which may be changed.
+	 * @param batch
+	 *     The events of the batch that passed so far.
+	 * @return
+	 *     False to drop the event.
+	 */
+	virtual bool filter(InputEvent& event, FilterBatch& batch) = 0;
+
+	/*!
+	 * @brief
+	 *     Gets an event the filter held back and whose time has come.
+	 * @param now
+	 *     The current time on the input clock.
+	 * @param event
+	 *     Receives the event.
+	 * @param batch
+	 *     The events of the batch that passed so far.
+	 * @return
+	 *     False if no event is let go, which filters that hold nothing back always return.
+	 */
+	virtual bool release(const Timestamp now, InputEvent& event, FilterBatch& batch) {
+		return false;
+	}
+};
+
+/*!
+ * @brief
+ *     Makes any filter usable in a DynamicFilterChain.
+ */
+template <class Filter>
+class InputFilterAdapter : public InputFilter {
+public:
+	/*! @see I43D::InputFilter::filter(InputEvent&, FilterBatch&) */
+	virtual bool filter(InputEvent& event, FilterBatch& batch) {
+		return this->wrapped.filter(event, batch);
+	}
+
+	/*! @see I43D::InputFilter::release(const Timestamp, InputEvent&, FilterBatch&) */
+	virtual bool release(const Timestamp now, InputEvent& event, FilterBatch& batch) {
+		return this->wrapped.release(now, event, batch);
+	}
+
+	/*!
+	 * @brief
+	 *     Gets the wrapped filter, to configure it.
+	 */
+	inline Filter& getFilter() {
+		return this->wrapped;
+	}
+
+private:
+	/*! @brief The wrapped filter. */
+	Filter wrapped;
+};
+
+/*!
+ * @brief
+ *     A chain of filters that can be changed at run time.
+ * @remarks
+ *     Each filter costs a virtual call per event, so prefer a FilterChain where the 
+ *     filters are known when the application is compiled. The chain does not own its 
+ *     filters. Use it as the filter of a FilterPipeline.
+ */
+class _DLL_EXPORT DynamicFilterChain {
+public:
+	/*!
+	 * @brief
+	 *     Appends a filter to the chain.
+	 */
+	inline void addFilter(InputFilter* filter) {
+		this->filters.push_back(filter);
+	}
+
+	/*!
+	 * @brief
+	 *     Inserts a filter before the filter at a position.
+	 * @return
+	 *     RESULT_OUT_OF_RANGE if the position is past the end of the chain.
+	 */
+	ResultCode insertFilter(const unsigned int position, InputFilter* filter);
+
+	/*!
+	 * @brief
+	 *     Removes a filter from the chain.
+	 * @remarks
+	 *     Make sure you call this method before deleting the filter.
+	 */
+	void removeFilter(InputFilter* filter);
+
+	/*!
+	 * @brief
+	 *     Gets the number of filters in the chain.
+	 */
+	inline unsigned int getFilterCount() const {
+		return static_cast<unsigned int>(this->filters.size());
+	}
+
+	/*!
+	 * @brief
+	 *     Filters an event with each filter of the chain in turn.
+	 */
+	inline bool filter(InputEvent& event, FilterBatch& batch) {
+		for (std::vector<InputFilter*>::iterator iter = this->filters.begin(); 
+		     iter != this->filters.end(); ++iter) {
+			if ((*iter)->filter(event, batch) == false) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/*!
+	 * @brief
+	 *     Gets an event that a filter of the chain held back and whose time has come, 
+	 *     filtered by the filters after it.
+	 */
+	bool release(const Timestamp now, InputEvent& event, FilterBatch& batch);
+
+private:
+	/*! @brief The filters in order. */
+	std::vector<InputFilter*> filters;
+};
+
+} // namespace I43D
+#endif  // _I43D_INPUT_FILTER_H_
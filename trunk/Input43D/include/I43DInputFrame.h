@@ -0,0 +1,160 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+#ifndef _I43D_INPUT_FRAME_H_
+#define _I43D_INPUT_FRAME_H_
+
+#include "I43DGameController.h"
+#include "I43DSeat.h"
+
+/*!
+ * @file
+ *     This file contains the fixed size snapshot of the input of one player for one frame,
+ *     as used by rollback netcode.
+ * @author Robert Eugene Simmons Jr. (Kraythe)
+ */
+
+namespace I43D {
+
+/*!
+ * @brief
+ *     The input of one player for one frame.
+ * @remarks
+ *     The frame is 96 bytes of plain data with no padding, so frames are compared 16 
+ *     bytes at a time with SSE2 where it is available and copied with memcpy. Axes are 
+ *     quantized to 16 bits so a prediction matches the real input exactly once the stick 
+ *     is at rest, and mouse movement is kept as the motion during the frame.
+ *     <br><br>
+ *     A frame is sent as a delta against the previous frame: a bit for each 16 byte 
+ *     block, four bits for each word of a changed block, then each changed word as the 
+ *     positions of up to three flipped bits or the whole changed bits. A frame without
+ *     changes takes one byte and a key press three.
+ */
+struct _DLL_EXPORT InputFrame {
+	/*! @brief The number of keys tracked. */
+	enum { MAX_KEYS = 512 };
+
+	/*! @brief The number of controller axes tracked. */
+	enum { MAX_AXES = 8 };
+
+	/*! @brief The size of the frame in 32 bit words. */
+	enum { WORD_COUNT = 24 };
+
+	/*! @brief The most bytes a delta can take. */
+	enum { MAX_DELTA_SIZE = 106 };
+
+	/*! @brief A bit for each key that is down. */
+	unsigned int keys[MAX_KEYS / 32];
+
+	/*! @brief A bit for each mouse button that is down; bit 0 is button 1. */
+	unsigned int mouseButtons;
+
+	/*! @brief A bit for each controller button that is down; bit 0 is button 1. */
+	unsigned int controllerButtons;
+
+	/*! @brief The HatDirection flags of each hat switch. */
+	unsigned char hats[ControllerState::MAX_HATS];
+
+	/*! @brief The horizontal motion of the mouse during the frame. */
+	short mouseDeltaX;
+
+	/*! @brief The vertical motion of the mouse during the frame. */
+	short mouseDeltaY;
+
+	/*! @brief The normalized controller axes in 1/32767. */
+	short axes[MAX_AXES];
+
+	/*!
+	 * @brief
+	 *     Sets the frame to no input.
+	 */
+	void clear();
+
+	/*!
+	 * @brief
+	 *     Determines if a key is down.
+	 */
+	inline bool isKeyDown(const unsigned short keyNum) const {
+		return keyNum < MAX_KEYS && (this->keys[keyNum >> 5] & (1u << (keyNum & 31))) != 0;
+	}
+
+	/*!
+	 * @brief
+	 *     Presses or releases a key.
+	 */
+	void setKey(const unsigned short keyNum, const bool down);
+
+	/*!
+	 * @brief
+	 *     Takes the keys and mouse buttons from the state of a seat.
+	 */
+	void captureSeat(const SeatState& state);
+
+	/*!
+	 * @brief
+	 *     Takes the buttons, hats and quantized axes of a game controller.
+	 */
+	void captureController(const ControllerState& state);
+
+	/*!
+	 * @brief
+	 *     Determines if two frames hold the same input.
+	 */
+	bool equals(const InputFrame& other) const;
+
+	/*!
+	 * @brief
+	 *     Finds the words that differ between two frames.
+	 * @return
+	 *     A bit for each of the WORD_COUNT words that differs.
+	 */
+	unsigned int getChangedWords(const InputFrame& other) const;
+
+	/*!
+	 * @brief
+	 *     Encodes the frame as a delta against the previous frame.
+	 * @param previous
+	 *     The frame the receiver already has.
+	 * @param buffer
+	 *     Receives the delta. Must hold MAX_DELTA_SIZE bytes.
+	 * @return
+	 *     The number of bytes written.
+	 */
+	unsigned int encodeDelta(const InputFrame& previous, unsigned char* buffer) const;
+
+	/*!
+	 * @brief
+	 *     Sets the frame from a delta against the previous frame.
+	 * @remarks
+	 *     Deltas are whole bytes so several can be sent back to back in one packet.
+	 * @param previous
+	 *     The frame the delta was encoded against.
+	 * @param data
+	 *     The delta.
+	 * @param size
+	 *     The number of bytes available.
+	 * @return
+	 *     The number of bytes the delta took, or 0 if it is malformed or cut short.
+	 */
+	unsigned int decodeDelta(const InputFrame& previous, const unsigned char* data, 
+	                         const unsigned int size);
+};
+
+} // namespace I43D
+#endif  // _I43D_INPUT_FRAME_H_
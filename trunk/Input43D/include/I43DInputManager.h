@@ -0,0 +1,307 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+#ifndef _I43D_INPUT_MANAGER_H_
+#define _I43D_INPUT_MANAGER_H_
+
+#include "I43DCommon.h"
+#include <map>
+#include <set>
+#include <vector>
+
+/*!
+ * @file
+ *     This file contains the input manager which discovers the input devices on the system,
+ *     gives them stable ids and reports devices that are plugged in or removed.
+ * @author Robert Eugene Simmons Jr. (Kraythe)
+ */
+
+namespace I43D {
+
+// ---- Forward Declarations
+struct _DLL_EXPORT DeviceInfo;
+class _DLL_EXPORT InputManagerListener;
+class _DLL_EXPORT InputManager;
+
+/*!
+ * @brief
+ *     Identifies a device for the lifetime of the input manager. 
+ * @remarks
+ *     A device that is unplugged and plugged back into the same port gets the same id. 
+ */
+typedef unsigned int DeviceID;
+
+/*! @brief A device id that never identifies a device. */
+const DeviceID INVALID_DEVICE_ID = 0;
+
+/*!
+ * @brief
+ *     The kinds of devices that the input manager discovers.
+ */
+enum _DLL_EXPORT DeviceType {
+	DEVICE_UNKNOWN = 0,
+	DEVICE_KEYBOARD,
+	DEVICE_MOUSE,
+	DEVICE_GAME_CONTROLLER,
+	DEVICE_TABLET,
+	DEVICE_TOUCH_SCREEN
+};
+
+/*!
+ * @brief
+ *     Flags that describe what a device can report.
+ */
+enum _DLL_EXPORT DeviceCapability {
+	DEVCAP_KEYS = 0x01,				// Reports keys or buttons
+	DEVCAP_RELATIVE_AXES = 0x02,	// Reports relative motion
+	DEVCAP_ABSOLUTE_AXES = 0x04,	// Reports absolute positions
+	DEVCAP_MULTI_TOUCH = 0x08,		// Reports several contacts at once
+	DEVCAP_PEN = 0x10,				// Reports a pen or stylus
+	DEVCAP_FORCE_FEEDBACK = 0x20,	// Accepts force feedback effects
+	DEVCAP_DIRECT = 0x40			// Input is located on a display
+};
+
+/*!
+ * @brief
+ *     Describes an input device.
+ */
+struct _DLL_EXPORT DeviceInfo {
+	/*! @brief The stable id of the device. */
+	DeviceID id;
+
+	/*! @brief The kind of device. */
+	DeviceType type;
+
+	/*! @brief A combination of DeviceCapability flags. */
+	unsigned int capabilities;
+
+	/*! @brief The name the device reports. */
+	std::string name;
+
+	/*! @brief The platform path of the device. */
+	std::string path;
+
+	/*! @brief The physical location of the device, such as the port it is plugged into. */
+	std::string location;
+
+	/*! @brief The serial number of the device if it reports one. */
+	std::string serial;
+
+	/*! @brief The bus the device is connected to. */
+	unsigned short busType;
+
+	/*! @brief The vendor id of the device. */
+	unsigned short vendor;
+
+	/*! @brief The product id of the device. */
+	unsigned short product;
+
+	/*! @brief The version of the device. */
+	unsigned short version;
+
+	/*! @brief The number of keys or buttons of the device. */
+	unsigned short buttonCount;
+
+	/*! @brief The number of axes of the device. */
+	unsigned short axisCount;
+
+	/*!
+	 * @brief
+	 *     Constructor.
+	 */
+	DeviceInfo() : id(INVALID_DEVICE_ID), type(DEVICE_UNKNOWN), capabilities(0), busType(0), 
+		vendor(0), product(0), version(0), buttonCount(0), axisCount(0) {}
+};
+
+/*!
+ * @brief
+ *     Listens for devices being plugged in and removed.
+ */
+class _DLL_EXPORT InputManagerListener abstract {
+public:
+	/*!
+	 * @brief
+	 *     Destructor.
+	 */
+	virtual ~InputManagerListener() {}
+
+	/*!
+	 * @brief
+	 *     Called when a device is discovered, either by enumeration or because it was 
+	 *     plugged in.
+	 * @param source
+	 *     The input manager that discovered the device.
+	 * @param device
+	 *     The device.
+	 */
+	virtual void deviceAdded(const InputManager* source, const DeviceInfo& device) {}
+
+	/*!
+	 * @brief
+	 *     Called when a device is removed. 
+	 * @param source
+	 *     The input manager that owned the device.
+	 * @param device
+	 *     The device. Its id is reused if it is plugged back in.
+	 */
+	virtual void deviceRemoved(const InputManager* source, const DeviceInfo& device) {}
+};
+
+/*!
+ * @brief
+ *     Discovers and owns the input devices of the system.
+ * @remarks
+ *     Platform implementations probe the devices and watch for hot plug notifications. This
+ *     class keeps the device table and assigns the ids. Ids are derived from the identity 
+ *     of the device: its bus, vendor, product, version, physical location and serial. A
+ *     device that comes back with the same identity gets the id it had before.
+ */
+class _DLL_EXPORT InputManager abstract {
+public:
+	/*!
+	 * @brief
+	 *     Constructor.
+	 */
+	InputManager() : nextID(INVALID_DEVICE_ID + 1) {}
+
+	/*!
+	 * @brief
+	 *     Destructor.
+	 */
+	virtual ~InputManager() {
+		this->listeners.clear();
+	}
+
+	/*!
+	 * @brief
+	 *     Discovers all of the devices currently connected.
+	 * @remarks
+	 *     Devices that are already known are not reported again. deviceAdded() is called for
+	 *     each new device.
+	 */
+	virtual void enumerateDevices() = 0;
+
+	/*!
+	 * @brief
+	 *     Processes pending hot plug notifications.
+	 * @remarks
+	 *     This never blocks and should be called once per frame. deviceAdded() and 
+	 *     deviceRemoved() are called from inside this method.
+	 */
+	virtual void update() = 0;
+
+	/*!
+	 * @brief
+	 *     Gets a device.
+	 * @param id
+	 *     The id of the device.
+	 * @return
+	 *     The device or NULL if no connected device has the id.
+	 */
+	const DeviceInfo* getDevice(const DeviceID id) const;
+
+	/*!
+	 * @brief
+	 *     Gets the ids of the connected devices of a type.
+	 * @param type
+	 *     The type of devices to get or DEVICE_UNKNOWN to get all of them.
+	 * @param ids
+	 *     Receives the ids in ascending order.
+	 */
+	void getDevices(const DeviceType type, std::vector<DeviceID>& ids) const;
+
+	/*!
+	 * @brief
+	 *     Gets the number of connected devices.
+	 */
+	inline unsigned int getDeviceCount() const {
+		return static_cast<unsigned int>(this->devices.size());
+	}
+
+	/*!
+	 * @brief 
+	 *     Adds a new input manager listener.
+	 * @param listener
+	 *     The listener to add.
+	 * @see I43D::InputManager::removeInputManagerListener(InputManagerListener*)
+	 */
+	inline void addInputManagerListener(InputManagerListener* listener) {
+		this->listeners.insert(listener);
+	}
+
+	/*!
+	 * @brief 
+	 *     Remove an input manager listener. 
+	 * @param listener
+	 *     The listener to remove.
+	 * @see I43D::InputManager::addInputManagerListener(InputManagerListener*)
+	 */
+	inline void removeInputManagerListener(InputManagerListener* listener) {
+		this->listeners.erase(listener);
+	}
+
+protected:
+	/*!
+	 * @brief
+	 *     Adds a device to the table, assigns its id and notifies the listeners.
+	 * @param device
+	 *     The device. The id is ignored and assigned by this method.
+	 * @return
+	 *     The id assigned to the device.
+	 */
+	DeviceID addDevice(const DeviceInfo& device);
+
+	/*!
+	 * @brief
+	 *     Removes the device with a path from the table and notifies the listeners.
+	 * @param path
+	 *     The platform path of the device.
+	 * @return
+	 *     False if no device has the path.
+	 */
+	bool removeDevice(const std::string& path);
+
+	/*!
+	 * @brief
+	 *     Determines if a device with a path is in the table.
+	 */
+	bool hasDevice(const std::string& path) const;
+
+private:
+	/*!
+	 * @brief
+	 *     Builds the identity string that stable ids are derived from.
+	 */
+	static std::string getIdentity(const DeviceInfo& device);
+
+	/*! @brief The connected devices by id. */
+	std::map<DeviceID, DeviceInfo> devices;
+
+	/*! @brief The ids ever assigned, by identity. */
+	std::map<std::string, DeviceID> knownIdentities;
+
+	/*! @brief The next id to assign. */
+	DeviceID nextID;
+
+	/*! @brief Stores the listeners to the input manager. */
+	std::set<InputManagerListener*> listeners;
+};
+
+} // namespace I43D
+#endif  // _I43D_INPUT_MANAGER_H_
@@ -0,0 +1,189 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+#ifndef _I43D_INPUT_NOTIFIER_H_
+#define _I43D_INPUT_NOTIFIER_H_
+
+#include "I43DAtomic.h"
+#include "I43DEvent.h"
+#include "I43DTimer.h"
+
+/*!
+ * @file
+ *     This file contains a waitable handle that is signalled when input arrives, for 
+ *     applications that sleep until there is something to do.
+ * @author Robert Eugene Simmons Jr. (Kraythe)
+ */
+
+namespace I43D {
+
+// ---- Forward Declarations
+class _DLL_EXPORT InputNotifier;
+
+#if defined( _WIN32 )
+/*! @brief A handle the platform can wait for. An event HANDLE on Win32. */
+typedef void* WaitHandle;
+#else
+/*! @brief A handle the platform can wait for. A file descriptor on POSIX systems. */
+typedef int WaitHandle;
+#endif
+
+/*!
+ * @brief
+ *     Signals a waitable handle when enough of the chosen events were queued.
+ * @remarks
+ *     Attach the notifier to a queue with setNotifier() and wait for getHandle() in the 
+ *     poll, epoll or WaitForMultipleObjects loop of the application. The handle is an 
+ *     eventfd on Linux, the read end of a pipe on other POSIX systems and a manual reset
+ *     event on Win32; it becomes readable or signalled once the threshold is reached and 
+ *     stays so until reset() is called. Only the event that reaches the threshold costs a
+ *     system call, every other one a single atomic addition.
+ *     <br><br>
+ *     After waking, call reset() before draining the queue so events queued while draining
+ *     signal the handle again.
+ */
+class _DLL_EXPORT InputNotifier {
+public:
+	enum {
+		/*! @brief The type mask that counts every event. */
+		ALL_EVENTS = 0xFFFFFFFF,
+
+		/*! @brief The type mask that counts key and button presses and releases only. */
+		BUTTON_EVENTS = (1 << IEVT_KEY_PRESSED) | (1 << IEVT_KEY_RELEASED) | 
+		                (1 << IEVT_MOUSE_BUTTON_PRESSED) | (1 << IEVT_MOUSE_BUTTON_RELEASED) | 
+		                (1 << IEVT_CONTROLLER_BUTTON_PRESSED) | 
+		                (1 << IEVT_CONTROLLER_BUTTON_RELEASED)
+	};
+
+	/*!
+	 * @brief
+	 *     Constructor. The notifier signals on the first event of any type.
+	 */
+	InputNotifier();
+
+	/*!
+	 * @brief
+	 *     Destructor.
+	 */
+	~InputNotifier();
+
+	/*!
+	 * @brief
+	 *     Gets the handle to wait for.
+	 */
+	inline WaitHandle getHandle() const {
+		return this->handle;
+	}
+
+	/*!
+	 * @brief
+	 *     Sets the number of counted events that signal the handle.
+	 * @param threshold
+	 *     The number of events, at least 1.
+	 */
+	inline void setThreshold(const unsigned int threshold) {
+		this->threshold = threshold > 0 ? threshold : 1;
+	}
+
+	/*!
+	 * @brief
+	 *     Gets the number of counted events that signal the handle.
+	 */
+	inline unsigned int getThreshold() const {
+		return this->threshold;
+	}
+
+	/*!
+	 * @brief
+	 *     Chooses the events that are counted.
+	 * @param typeMask
+	 *     A bit for each I43D::InputEventType that counts, for example BUTTON_EVENTS.
+	 */
+	inline void setTypeMask(const unsigned int typeMask) {
+		this->typeMask = typeMask;
+	}
+
+	/*!
+	 * @brief
+	 *     Gets the mask of the events that are counted.
+	 */
+	inline unsigned int getTypeMask() const {
+		return this->typeMask;
+	}
+
+	/*!
+	 * @brief
+	 *     Counts a queued event. Called by the queues; safe on any thread.
+	 */
+	inline void notify(const InputEvent& event) {
+		if ((this->typeMask & (1u << event.type)) != 0 && 
+		    atomicAdd(this->pending, 1) == this->threshold) {
+			this->signal();
+		}
+	}
+
+	/*!
+	 * @brief
+	 *     Clears the handle and starts counting again.
+	 * @return
+	 *     The number of events counted since the last reset.
+	 */
+	unsigned int reset();
+
+	/*!
+	 * @brief
+	 *     Waits for the handle, for applications without a wait loop of their own.
+	 * @param timeout
+	 *     The longest time to wait in microseconds.
+	 * @return
+	 *     True if the handle was signalled, false on timeout.
+	 */
+	bool wait(const Timestamp timeout);
+
+private:
+	/*! @brief Copying a notifier is not supported. */
+	InputNotifier(const InputNotifier&);
+
+	/*! @brief Copying a notifier is not supported. */
+	InputNotifier& operator=(const InputNotifier&);
+
+	/*!
+	 * @brief
+	 *     Signals the handle.
+	 */
+	void signal();
+
+	/*! @brief The handle waited for. */
+	WaitHandle handle;
+
+	/*! @brief The write end of the pipe where there is no eventfd, otherwise unused. */
+	int writeHandle;
+
+	/*! @brief The number of counted events that signal the handle. */
+	unsigned int threshold;
+
+	/*! @brief The types of events counted. */
+	unsigned int typeMask;
+
+	/*! @brief The events counted since the last reset. */
+	volatile unsigned int pending;
+};
+
+} // namespace I43D
+#endif  // _I43D_INPUT_NOTIFIER_H_
@@ -0,0 +1,442 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+#ifndef _I43D_INPUT_SCRIPT_H_
+#define _I43D_INPUT_SCRIPT_H_
+
+#include "I43DEvent.h"
+#include "I43DTimer.h"
+#include <string>
+#include <vector>
+
+/*!
+ * @file
+ *     This file contains scripts of input events and the bots that play them back into
+ *     virtual devices, for automated tests that need many input sessions at once.
+ * @author Robert Eugene Simmons Jr. (Kraythe)
+ */
+
+namespace I43D {
+
+// ---- Forward Declarations
+struct _DLL_EXPORT ScriptStep;
+class _DLL_EXPORT InputScript;
+class _DLL_EXPORT ScriptBot;
+
+/*!
+ * @brief
+ *     The kinds of steps of an input script.
+ */
+enum _DLL_EXPORT ScriptOp {
+	SCRIPT_EVENT = 0,		// Sends an event
+	SCRIPT_WAIT,			// Waits, optionally with jitter
+	SCRIPT_MOVE,			// Moves the mouse to a position in a number of steps over a time
+	SCRIPT_LOOP,			// Starts a loop
+	SCRIPT_END_LOOP			// Ends the innermost loop
+};
+
+/*!
+ * @brief
+ *     One step of an input script.
+ * @remarks
+ *     The meaning of the fields depends on the operation: events use type, code, value 
+ *     and value2; waits use duration and jitter; moves use value and value2 as the 
+ *     target, duration, steps and jitter in pixels; loops use value as the number of 
+ *     runs, 0 for forever.
+ */
+struct _DLL_EXPORT ScriptStep {
+	/*! @brief One of the ScriptOp values. */
+	unsigned short op;
+
+	/*! @brief The InputEventType of an event step. */
+	unsigned short type;
+
+	/*! @brief The key, button or axis number of an event step. */
+	unsigned short code;
+
+	/*! @brief The number of steps of a move. */
+	unsigned short steps;
+
+	/*! @brief The first value. */
+	int value;
+
+	/*! @brief The second value. */
+	int value2;
+
+	/*! @brief The time of a wait or move in microseconds. */
+	unsigned int duration;
+
+	/*! @brief The jitter of a wait in microseconds or of a move in pixels. */
+	unsigned int jitter;
+};
+
+/*!
+ * @brief
+ *     A compact script of input events, waits and loops.
+ * @remarks
+ *     Scripts are built with the add methods or parsed from text, and are shared by any 
+ *     number of ScriptBot objects, each of which keeps its own place in the script. The 
+ *     text has one step per line; '#' starts a comment and times take a suffix of us, ms
+ *     or s, microseconds if there is none:
+ *     <pre>
+ *     key 30 down              # press or release key 30
+ *     char 97                  # type a character by its code point
+ *     button 1 up              # press or release mouse button 1
+ *     scroll down              # scroll up, down, left or right
+ *     move 400 300 over 250ms steps 25 jitter 3
+ *     pad 2 down               # press or release controller button 2
+ *     axis 0 -32768            # set the raw position of controller axis 0
+ *     wait 50ms jitter 10ms    # wait 40 to 60 ms
+ *     loop 10                  # repeat the steps up to the matching end, 
+ *     end                      # forever if no count is given
+ *     </pre>
+ */
+class _DLL_EXPORT InputScript {
+public:
+	/*! @brief The deepest nesting of loops. */
+	enum { MAX_LOOP_DEPTH = 8 };
+
+	/*!
+	 * @brief
+	 *     Constructor. Creates an empty script.
+	 */
+	InputScript() : openLoops(0) {
+	}
+
+	/*!
+	 * @brief
+	 *     Adds an event.
+	 */
+	void addEvent(const InputEventType type, const unsigned short code, const int value = 0, 
+	              const int value2 = 0);
+
+	/*!
+	 * @brief
+	 *     Adds a wait.
+	 * @param duration
+	 *     The time to wait in microseconds.
+	 * @param jitter
+	 *     The most the wait is made longer or shorter at random, in microseconds.
+	 */
+	void addWait(const Timestamp duration, const Timestamp jitter = 0);
+
+	/*!
+	 * @brief
+	 *     Adds a mouse movement from wherever the mouse is to a position.
+	 * @param x
+	 *     The x coordinate of the target.
+	 * @param y
+	 *     The y coordinate of the target.
+	 * @param duration
+	 *     The time the movement takes in microseconds, or 0 to jump.
+	 * @param steps
+	 *     The number of motion events spread evenly over the time.
+	 * @param jitter
+	 *     The most each position before the target is moved at random, in pixels.
+	 */
+	void addMove(const int x, const int y, const Timestamp duration = 0, 
+	             const unsigned short steps = 1, const unsigned int jitter = 0);
+
+	/*!
+	 * @brief
+	 *     Starts a loop that ends with endLoop().
+	 * @param count
+	 *     The number of runs, or 0 to loop forever.
+	 * @return
+	 *     RESULT_FULL if the loops are nested too deeply.
+	 */
+	ResultCode beginLoop(const unsigned int count = 0);
+
+	/*!
+	 * @brief
+	 *     Ends the innermost loop.
+	 * @return
+	 *     RESULT_INCOMPATIBLE if no loop is open.
+	 */
+	ResultCode endLoop();
+
+	/*!
+	 * @brief
+	 *     Appends the steps of a script in text form.
+	 * @param text
+	 *     The text.
+	 * @param errorLine
+	 *     Receives the number of the first line that could not be parsed, starting with 1,
+	 *     if given.
+	 * @return
+	 *     RESULT_INCOMPATIBLE if a line could not be parsed; the steps before it are kept.
+	 */
+	ResultCode parse(const std::string& text, unsigned int* errorLine = 0);
+
+	/*!
+	 * @brief
+	 *     Gets whether every loop of the script is closed, which it must be to be played.
+	 */
+	inline bool isComplete() const {
+		return this->openLoops == 0;
+	}
+
+	/*!
+	 * @brief
+	 *     Gets the steps.
+	 */
+	inline const ScriptStep* getSteps() const {
+		return this->steps.empty() ? 0 : &this->steps[0];
+	}
+
+	/*!
+	 * @brief
+	 *     Gets the number of steps.
+	 */
+	inline unsigned int getStepCount() const {
+		return static_cast<unsigned int>(this->steps.size());
+	}
+
+	/*!
+	 * @brief
+	 *     Removes every step.
+	 */
+	inline void clear() {
+		this->steps.clear();
+		this->openLoops = 0;
+	}
+
+private:
+	/*!
+	 * @brief
+	 *     Adds a step with every field cleared but the operation.
+	 */
+	ScriptStep& addStep(const ScriptOp op);
+
+	/*!
+	 * @brief
+	 *     Parses one line of the text form.
+	 * @return
+	 *     False if the line could not be parsed.
+	 */
+	bool parseLine(const std::string& line);
+
+	/*! @brief The steps. */
+	std::vector<ScriptStep> steps;
+
+	/*! @brief The number of loops begun but not ended. */
+	unsigned int openLoops;
+};
+
+/*!
+ * @brief
+ *     Plays an input script into virtual devices.
+ * @remarks
+ *     The bot is an entry of a TimerWheel and runs the script from one wait to the next 
+ *     each time it expires. Events are stamped with the time the script says they happen
+ *     rather than the time the wheel got to them, and waits are measured from there, so 
+ *     a late wakeup never shifts the rest of the script. Jitter comes from a generator 
+ *     seeded per bot, so a bot with the same script and seed always produces the same 
+ *     events at the same offsets from its start.
+ *     <br><br>
+ *     Mouse events go to the mouse, key and character events to the keyboard and 
+ *     controller events to the controller; usually these are a VirtualMouse, a 
+ *     VirtualKeyboard and a VirtualGameController. Events for a device that is not set 
+ *     are counted and dropped. The bot calls the devices on the thread that advances its
+ *     wheel; see LinuxScriptRunner for running many bots on a few threads.
+ */
+class _DLL_EXPORT ScriptBot : public TimerEntry {
+public:
+	/*!
+	 * @brief
+	 *     Constructor.
+	 * @param script
+	 *     The script to play. It must be complete, must not change while it plays, and 
+	 *     must outlive the bot.
+	 * @param seed
+	 *     The seed of the jitter.
+	 * @param device
+	 *     The id to stamp the events with.
+	 */
+	ScriptBot(const InputScript& script, const unsigned int seed, const DeviceID device = 0);
+
+	/*!
+	 * @brief
+	 *     Destructor.
+	 */
+	virtual ~ScriptBot() {}
+
+	/*!
+	 * @brief
+	 *     Sets the device that receives mouse events, or 0 for none.
+	 */
+	inline void setMouse(InputEventSink* mouse) {
+		this->mouse = mouse;
+	}
+
+	/*!
+	 * @brief
+	 *     Sets the device that receives key and character events, or 0 for none.
+	 */
+	inline void setKeyboard(InputEventSink* keyboard) {
+		this->keyboard = keyboard;
+	}
+
+	/*!
+	 * @brief
+	 *     Sets the device that receives controller events, or 0 for none.
+	 */
+	inline void setController(InputEventSink* controller) {
+		this->controller = controller;
+	}
+
+	/*!
+	 * @brief
+	 *     Starts the script from the beginning.
+	 * @param wheel
+	 *     The wheel that times the bot.
+	 * @param startTime
+	 *     The time of the first step on the input clock.
+	 */
+	void start(TimerWheel& wheel, const Timestamp startTime);
+
+	/*!
+	 * @brief
+	 *     Gets whether the script has played to its end.
+	 */
+	inline bool isFinished() const {
+		return this->finished;
+	}
+
+	/*!
+	 * @brief
+	 *     Gets the number of events sent.
+	 */
+	inline unsigned int getEventCount() const {
+		return this->eventCount;
+	}
+
+	/*!
+	 * @brief
+	 *     Gets the number of events dropped because their device is not set.
+	 */
+	inline unsigned int getDroppedCount() const {
+		return this->droppedCount;
+	}
+
+	/*!
+	 * @brief
+	 *     Gets the latest the wheel ever got to the bot after its deadline, in 
+	 *     microseconds, for checking the timing of a test run.
+	 */
+	inline Timestamp getMaxLateness() const {
+		return this->maxLateness;
+	}
+
+	/*! @see I43D::TimerEntry::timerExpired(const Timestamp, const Timestamp) */
+	virtual void timerExpired(const Timestamp deadline, const Timestamp now);
+
+private:
+	ScriptBot& operator=(const ScriptBot&);
+
+	/*! @brief The most steps run in one go before the bot lets other entries run. */
+	enum { MAX_STEPS_PER_RUN = 4096 };
+
+	/*!
+	 * @brief
+	 *     The place of the bot in a loop.
+	 */
+	struct LoopFrame {
+		unsigned int start;
+		unsigned int remaining;
+	};
+
+	/*!
+	 * @brief
+	 *     Hands an event to its device.
+	 */
+	void send(const InputEvent& event);
+
+	/*!
+	 * @brief
+	 *     Gets a random offset from -range to range.
+	 */
+	int getRandomOffset(const unsigned int range);
+
+	/*! @brief The script. */
+	const InputScript& script;
+
+	/*! @brief The seed of the jitter. */
+	const unsigned int seed;
+
+	/*! @brief The id the events are stamped with. */
+	const DeviceID device;
+
+	/*! @brief Receives mouse events, or 0. */
+	InputEventSink* mouse;
+
+	/*! @brief Receives key and character events, or 0. */
+	InputEventSink* keyboard;
+
+	/*! @brief Receives controller events, or 0. */
+	InputEventSink* controller;
+
+	/*! @brief The wheel the bot runs on. */
+	TimerWheel* wheel;
+
+	/*! @brief The index of the current step. */
+	unsigned int position;
+
+	/*! @brief The loops the current step is in. */
+	LoopFrame loops[InputScript::MAX_LOOP_DEPTH];
+
+	/*! @brief The number of loops the current step is in. */
+	unsigned int loopDepth;
+
+	/*! @brief The motion event of the current move that comes next, from 1, or 0. */
+	unsigned int moveIndex;
+
+	/*! @brief The time the current move started. */
+	Timestamp moveStart;
+
+	/*! @brief The x coordinate the current move started at. */
+	int moveFromX;
+
+	/*! @brief The y coordinate the current move started at. */
+	int moveFromY;
+
+	/*! @brief The x coordinate of the last motion event. */
+	int mouseX;
+
+	/*! @brief The y coordinate of the last motion event. */
+	int mouseY;
+
+	/*! @brief The state of the generator of the jitter. */
+	unsigned int random;
+
+	/*! @brief The number of events sent. */
+	unsigned int eventCount;
+
+	/*! @brief The number of events without a device. */
+	unsigned int droppedCount;
+
+	/*! @brief The latest the bot ran after its deadline. */
+	Timestamp maxLateness;
+
+	/*! @brief Whether the script has played to its end. */
+	bool finished;
+};
+
+} // namespace I43D
+#endif  // _I43D_INPUT_SCRIPT_H_
@@ -0,0 +1,432 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+#ifndef _I43D_INPUT_WAIT_H_
+#define _I43D_INPUT_WAIT_H_
+
+#include "I43DCommon.h"
+#include <map>
+
+#if defined( __cpp_impl_coroutine )
+#	include <coroutine>
+#	include <tuple>
+#	include <utility>
+#endif
+
+/*!
+ * @file
+ *     This file contains the wait lists that let code wait for one particular input 
+ *     instead of checking for it every frame. With a compiler that supports C++20 
+ *     coroutines it also contains awaitables built on them, so a coroutine can write
+ *     co_await keyboard.nextKeyPress(key).
+ * @author Robert Eugene Simmons Jr. (Kraythe)
+ */
+
+namespace I43D {
+
+// ---- Forward Declarations
+class _DLL_EXPORT InputWaiter;
+class _DLL_EXPORT InputWaitTable;
+
+/*!
+ * @brief
+ *     Something waiting for an input in an I43D::InputWaitTable.
+ * @remarks
+ *     A waiter is in at most one table at a time and leaves it when it is woken, when it
+ *     is cancelled or when it is destroyed. Copies of a waiter start out waiting for 
+ *     nothing.
+ */
+class _DLL_EXPORT InputWaiter abstract {
+public:
+	/*!
+	 * @brief
+	 *     Constructor.
+	 */
+	InputWaiter() : next(0), previous(0), table(0) {}
+
+	/*!
+	 * @brief
+	 *     Copy constructor. The copy does not wait.
+	 */
+	InputWaiter(const InputWaiter&) : next(0), previous(0), table(0) {}
+
+	/*!
+	 * @brief
+	 *     Destructor. Stops waiting.
+	 */
+	virtual ~InputWaiter() {
+		this->cancel();
+	}
+
+	/*!
+	 * @brief
+	 *     Assignment. Does not change what this waiter waits for.
+	 */
+	InputWaiter& operator=(const InputWaiter&) {
+		return *this;
+	}
+
+	/*!
+	 * @brief
+	 *     Determines if the waiter is in a table.
+	 */
+	inline bool isWaiting() const {
+		return this->next != 0;
+	}
+
+	/*!
+	 * @brief
+	 *     Stops waiting without being woken.
+	 */
+	void cancel();
+
+protected:
+	/*!
+	 * @brief
+	 *     Called once when the input arrives. The waiter has already left its table, so
+	 *     it may wait again or be destroyed from here.
+	 * @param code
+	 *     The key or button that arrived.
+	 */
+	virtual void inputArrived(const unsigned int code) = 0;
+
+private:
+	friend class InputWaitTable;
+
+	/*! @brief The next waiter in the circular list, or 0 when not waiting. */
+	InputWaiter* next;
+
+	/*! @brief The previous waiter in the circular list, or 0 when not waiting. */
+	InputWaiter* previous;
+
+	/*! @brief The table that counts the waiter, or 0 for sentinels and idle waiters. */
+	InputWaitTable* table;
+};
+
+/*!
+ * @brief
+ *     Wait lists of a device, one for each key or button somebody waits for.
+ * @remarks
+ *     Devices wake the table with the key or button of every matching event. Only the 
+ *     waiters of that code and those waiting for any code are woken, so any number of idle
+ *     waiters cost nothing per event. A table nobody waits in costs one test per event.
+ *     <br><br>
+ *     Each list is circular around a sentinel, so a waiter unlinks itself without knowing
+ *     its list. A wake first moves the list onto a sentinel of its own and then wakes the
+ *     waiters one at a time. Waiters that wait again go onto the emptied list and are not
+ *     woken twice, and waiters cancelled or destroyed by an earlier one simply drop out.
+ */
+class _DLL_EXPORT InputWaitTable {
+public:
+	/*! @brief The code of the list that is woken for every code. */
+	enum { ANY = 0xFFFFFFFF };
+
+	/*!
+	 * @brief
+	 *     Constructor.
+	 */
+	InputWaitTable() : waiterCount(0) {}
+
+	/*!
+	 * @brief
+	 *     Destructor. Waiters still in the table stop waiting and are never woken.
+	 */
+	~InputWaitTable();
+
+	/*!
+	 * @brief
+	 *     Adds a waiter. A waiter that is already waiting is moved.
+	 * @param code
+	 *     The key or button to wait for, or ANY.
+	 */
+	void add(const unsigned int code, InputWaiter& waiter);
+
+	/*!
+	 * @brief
+	 *     Wakes the waiters of a code and those of ANY.
+	 */
+	void wake(const unsigned int code);
+
+	/*!
+	 * @brief
+	 *     Determines if nobody waits in the table.
+	 */
+	inline bool isEmpty() const {
+		return this->waiterCount == 0;
+	}
+
+private:
+	friend class InputWaiter;
+
+	/*! @brief Copying a table is not supported. */
+	InputWaitTable(const InputWaitTable&);
+
+	/*! @brief Copying a table is not supported. */
+	InputWaitTable& operator=(const InputWaitTable&);
+
+	/*!
+	 * @brief
+	 *     A list head that is never woken itself.
+	 */
+	class Sentinel : public InputWaiter {
+	public:
+		Sentinel() {
+			InputWaitTable::makeEmpty(*this);
+		}
+
+		Sentinel(const Sentinel&) : InputWaiter() {
+			InputWaitTable::makeEmpty(*this);
+		}
+
+		/*! @brief Unlinks every waiter in the list. */
+		virtual ~Sentinel();
+
+	protected:
+		virtual void inputArrived(const unsigned int code) {}
+
+	private:
+		friend class InputWaitTable;
+		Sentinel& operator=(const Sentinel&);
+	};
+
+	/*!
+	 * @brief
+	 *     Links a sentinel to itself.
+	 */
+	static void makeEmpty(InputWaiter& sentinel);
+
+	/*!
+	 * @brief
+	 *     Unlinks every waiter from a sentinel.
+	 */
+	static void cancelAll(InputWaiter& sentinel);
+
+	/*!
+	 * @brief
+	 *     Moves the waiters of one list onto a local list.
+	 * @remarks
+	 *     The emptied list stays in the map so waiting for the code again does not allocate.
+	 */
+	void detachList(const unsigned int listCode, Sentinel& pending);
+
+	/*!
+	 * @brief
+	 *     Wakes every waiter of a detached list.
+	 */
+	static void resumeList(Sentinel& pending, const unsigned int code);
+
+	/*! @brief The number of waiters in the table, including those of a wake in progress. */
+	unsigned int waiterCount;
+
+	/*!
+	 * @brief
+	 *     The lists by code. Map nodes do not move, so the sentinels can be linked. The list
+	 *     of a code is kept once created, so that waiting again for it does not allocate.
+	 */
+	std::map<unsigned int, Sentinel> lists;
+};
+
+#if defined( __cpp_impl_coroutine )
+
+// ---- Forward Declarations
+class InputAwaiter;
+
+/*!
+ * @brief
+ *     A set of awaiters of which only the first to complete counts.
+ */
+class InputAwaitGroup abstract {
+public:
+	/*!
+	 * @brief
+	 *     Destructor.
+	 */
+	virtual ~InputAwaitGroup() {}
+
+	/*!
+	 * @brief
+	 *     Called when one awaiter of the group completes.
+	 */
+	virtual void completed(InputAwaiter& awaiter) = 0;
+};
+
+/*!
+ * @brief
+ *     Suspends a coroutine until a key or button arrives.
+ * @remarks
+ *     Obtain one from Keyboard::nextKeyPress(), Keyboard::nextKeyRelease() or 
+ *     Mouse::nextClick(). The coroutine is resumed on the thread that dispatches the 
+ *     event, from inside the dispatch and after the listeners, and co_await yields the 
+ *     key or button. Destroying a suspended coroutine stops the wait. A coroutine still 
+ *     waiting when its device is destroyed is never resumed.
+ */
+class InputAwaiter : public InputWaiter {
+public:
+	/*!
+	 * @brief
+	 *     Constructor.
+	 * @param table
+	 *     The table to wait in.
+	 * @param code
+	 *     The key or button to wait for, or InputWaitTable::ANY.
+	 */
+	InputAwaiter(InputWaitTable& table, const unsigned int code) 
+		: table(&table), code(code), result(0), group(0) {}
+
+	bool await_ready() const {
+		return false;
+	}
+
+	void await_suspend(std::coroutine_handle<> handle) {
+		this->handle = handle;
+		this->table->add(this->code, *this);
+	}
+
+	unsigned int await_resume() const {
+		return this->result;
+	}
+
+	/*!
+	 * @brief
+	 *     Waits on behalf of a group instead of a coroutine.
+	 */
+	void join(InputAwaitGroup& group) {
+		this->group = &group;
+		this->table->add(this->code, *this);
+	}
+
+	/*!
+	 * @brief
+	 *     Gets the key or button that arrived.
+	 */
+	inline unsigned int getResult() const {
+		return this->result;
+	}
+
+protected:
+	virtual void inputArrived(const unsigned int code) {
+		this->result = code;
+		if (this->group != 0) {
+			this->group->completed(*this);
+		} else {
+			this->handle.resume();
+		}
+	}
+
+private:
+	/*! @brief The table to wait in. */
+	InputWaitTable* table;
+
+	/*! @brief The key or button waited for. */
+	unsigned int code;
+
+	/*! @brief The key or button that arrived. */
+	unsigned int result;
+
+	/*! @brief The group waited for, or 0 when a coroutine waits directly. */
+	InputAwaitGroup* group;
+
+	/*! @brief The suspended coroutine. */
+	std::coroutine_handle<> handle;
+};
+
+/*!
+ * @brief
+ *     What co_await anyOf() yields.
+ */
+struct AnyOfResult {
+	/*! @brief The position of the awaiter that completed among the arguments. */
+	unsigned int index;
+
+	/*! @brief The key or button it yielded. */
+	unsigned int code;
+};
+
+/*!
+ * @brief
+ *     Suspends a coroutine until the first of a number of awaiters completes.
+ * @remarks
+ *     The others are cancelled before the coroutine resumes, so it is resumed exactly once
+ *     even if one event satisfies several of them.
+ */
+template <class... Awaiters>
+class AnyOfAwaiter : public InputAwaitGroup {
+public:
+	explicit AnyOfAwaiter(Awaiters... awaiters) : awaiters(std::move(awaiters)...) {
+		this->result.index = 0;
+		this->result.code = 0;
+	}
+
+	bool await_ready() const {
+		return false;
+	}
+
+	void await_suspend(std::coroutine_handle<> handle) {
+		this->handle = handle;
+		std::apply([this](Awaiters&... each) { (each.join(*this), ...); }, this->awaiters);
+	}
+
+	AnyOfResult await_resume() const {
+		return this->result;
+	}
+
+	virtual void completed(InputAwaiter& awaiter) {
+		unsigned int position = 0;
+		std::apply([&](Awaiters&... each) { (this->settle(each, awaiter, position++), ...); }, 
+		           this->awaiters);
+		this->result.code = awaiter.getResult();
+		this->handle.resume();
+	}
+
+private:
+	/*!
+	 * @brief
+	 *     Cancels one awaiter and notes its position if it is the one that completed.
+	 */
+	void settle(InputAwaiter& each, const InputAwaiter& completed, const unsigned int position) {
+		if (&each == &completed) {
+			this->result.index = position;
+		}
+		each.cancel();
+	}
+
+	/*! @brief The awaiters raced against each other. */
+	std::tuple<Awaiters...> awaiters;
+
+	/*! @brief What the first awaiter yielded. */
+	AnyOfResult result;
+
+	/*! @brief The suspended coroutine. */
+	std::coroutine_handle<> handle;
+};
+
+/*!
+ * @brief
+ *     Waits for the first of a number of inputs, for example
+ *     co_await anyOf(keyboard.nextKeyPress(KC_ESCAPE), mouse.nextClick(1)).
+ */
+template <class... Awaiters>
+inline AnyOfAwaiter<Awaiters...> anyOf(Awaiters... awaiters) {
+	return AnyOfAwaiter<Awaiters...>(std::move(awaiters)...);
+}
+
+#endif // __cpp_impl_coroutine
+
+} // namespace I43D
+#endif  // _I43D_INPUT_WAIT_H_
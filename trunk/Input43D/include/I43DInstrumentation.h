@@ -0,0 +1,287 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+#ifndef _I43D_INSTRUMENTATION_H_
+#define _I43D_INSTRUMENTATION_H_
+
+#include "I43DCommon.h"
+#include "I43DInputManager.h"
+#include "I43DTimer.h"
+
+/*!
+ * @file
+ *     This file contains the counters and latency histograms that measure how input 
+ *     moves through the library. Recording is only compiled in when I43D_INSTRUMENTATION 
+ *     is defined for the library build; otherwise the recording macros expand to nothing 
+ *     and snapshots stay empty.
+ * @author Robert Eugene Simmons Jr. (Kraythe)
+ */
+
+// -- Records a statement only in instrumented builds.
+#if defined( I43D_INSTRUMENTATION )
+#	define I43D_INSTRUMENT(statement) statement
+#	define I43D_TIME_LISTENER(listener) I43D::ListenerTimer i43dListenerTimer(listener)
+#else
+#	define I43D_INSTRUMENT(statement)
+#	define I43D_TIME_LISTENER(listener)
+#endif
+
+namespace I43D {
+
+// ---- Forward Declarations
+struct _DLL_EXPORT LatencyHistogram;
+struct _DLL_EXPORT DeviceCounters;
+struct _DLL_EXPORT ListenerTiming;
+struct _DLL_EXPORT InstrumentationSnapshot;
+class _DLL_EXPORT ListenerTimer;
+
+/*!
+ * @brief
+ *     The stages of the path of an event that latency is measured for.
+ */
+enum _DLL_EXPORT LatencyStage {
+	/*! @brief From the time stamp of the event to its push into a queue. */
+	LATENCY_ENQUEUE,
+
+	/*! @brief From the push of the event into a queue to its pop. */
+	LATENCY_DISPATCH,
+
+	/*! @brief From the call of a listener to its return. */
+	LATENCY_LISTENER,
+
+	/*! @brief The number of stages. */
+	LATENCY_STAGE_COUNT
+};
+
+/*!
+ * @brief
+ *     Counts latencies in buckets of powers of two microseconds.
+ * @remarks
+ *     Bucket 0 counts latencies below 1 µs and bucket n those from 2^(n-1) up to 2^n µs.
+ *     The last bucket also takes everything longer.
+ */
+struct _DLL_EXPORT LatencyHistogram {
+	/*! @brief The number of buckets. The last one starts at about 4 seconds. */
+	enum { BUCKET_COUNT = 24 };
+
+	/*! @brief The number of latencies in each bucket. */
+	unsigned int buckets[BUCKET_COUNT];
+
+	/*!
+	 * @brief
+	 *     Gets the number of latencies counted.
+	 */
+	unsigned int getCount() const;
+
+	/*!
+	 * @brief
+	 *     Gets an upper bound of a percentile of the latencies.
+	 * @param fraction
+	 *     The percentile as a fraction, for example 0.99.
+	 * @return
+	 *     The upper end of the bucket the percentile falls in, in microseconds, or 0 if 
+	 *     nothing was counted.
+	 */
+	Timestamp getPercentile(const float fraction) const;
+};
+
+/*!
+ * @brief
+ *     The counters of one device.
+ */
+struct _DLL_EXPORT DeviceCounters {
+	/*! @brief The number of events pushed into a queue. */
+	unsigned int events;
+
+	/*! @brief The number of samples folded into an event that already covered them. */
+	unsigned int coalesced;
+
+	/*! @brief The number of events dropped because a queue was full. */
+	unsigned int dropped;
+
+	/*! @brief The most events of the device a queue held after a push. */
+	unsigned int queueHighWater;
+};
+
+/*!
+ * @brief
+ *     The time spent in one listener.
+ */
+struct _DLL_EXPORT ListenerTiming {
+	/*! @brief The listener, or 0 for the listeners that did not fit the table. */
+	const void* listener;
+
+	/*! @brief The number of calls. */
+	unsigned int calls;
+
+	/*! @brief The total time spent in the calls in microseconds. */
+	Timestamp totalTime;
+
+	/*! @brief The longest call in microseconds. */
+	Timestamp maximumTime;
+};
+
+/*!
+ * @brief
+ *     The totals of every counter since the start of the process.
+ * @remarks
+ *     Counters only grow, so rates are measured by taking two snapshots and dividing the
+ *     difference by the time between them.
+ */
+struct _DLL_EXPORT InstrumentationSnapshot {
+	enum {
+		/*! @brief Devices with higher identifiers are counted together in otherDevices. */
+		MAX_DEVICES = 64,
+
+		/*! @brief The number of listeners timed separately. */
+		MAX_LISTENERS = 64
+	};
+
+	/*! @brief The time the snapshot was taken. */
+	Timestamp time;
+
+	/*! @brief The counters indexed by device identifier. */
+	DeviceCounters devices[MAX_DEVICES];
+
+	/*! 
+	 * @brief 
+	 *     The counters of all devices with an identifier of MAX_DEVICES or higher, added 
+	 *     together. The high water mark is the highest of any of them.
+	 */
+	DeviceCounters otherDevices;
+
+	/*! @brief The latencies of each I43D::LatencyStage. */
+	LatencyHistogram latency[LATENCY_STAGE_COUNT];
+
+	/*! @brief The listeners that were called, slowest total first. */
+	ListenerTiming listeners[MAX_LISTENERS];
+
+	/*! @brief The number of entries in listeners. */
+	unsigned int listenerCount;
+
+	/*!
+	 * @brief
+	 *     Gets the events per second of a device between an earlier snapshot and this one.
+	 * @return
+	 *     The rate, or 0 for devices that are counted in otherDevices.
+	 */
+	double getEventRate(const InstrumentationSnapshot& earlier, const DeviceID device) const;
+};
+
+/*!
+ * @brief
+ *     Sums the counters of every thread.
+ * @remarks
+ *     Each thread records into its own buffer without locks or shared writes; this merges
+ *     them while the threads keep running, so counters recorded during the call may or may
+ *     not be included. Without I43D_INSTRUMENTATION the snapshot is all zero.
+ * @param snapshot
+ *     Receives the totals.
+ */
+_DLL_EXPORT void getInstrumentationSnapshot(InstrumentationSnapshot& snapshot);
+
+/*!
+ * @brief
+ *     Records an event pushed into a queue.
+ * @param device
+ *     The device of the event.
+ * @param eventTime
+ *     The time stamp of the event.
+ * @param now
+ *     The time of the push.
+ * @param queueSize
+ *     The number of events in the queue after the push.
+ */
+_DLL_EXPORT void instrumentEvent(const DeviceID device, const Timestamp eventTime, 
+                                 const Timestamp now, const unsigned int queueSize);
+
+/*!
+ * @brief
+ *     Records samples of a device that were folded into fewer events.
+ */
+_DLL_EXPORT void instrumentCoalesced(const DeviceID device, const unsigned int count);
+
+/*!
+ * @brief
+ *     Records an event dropped because a queue was full.
+ */
+_DLL_EXPORT void instrumentDropped(const DeviceID device);
+
+/*!
+ * @brief
+ *     Records a latency.
+ * @param stage
+ *     The stage that took the time.
+ * @param elapsed
+ *     The time in microseconds.
+ */
+_DLL_EXPORT void instrumentLatency(const LatencyStage stage, const Timestamp elapsed);
+
+/*!
+ * @brief
+ *     Records a call of a listener.
+ * @param listener
+ *     The listener.
+ * @param elapsed
+ *     The time the call took in microseconds.
+ */
+_DLL_EXPORT void instrumentListener(const void* listener, const Timestamp elapsed);
+
+/*!
+ * @brief
+ *     Times a listener call for the lifetime of the object.
+ * @remarks
+ *     Use the I43D_TIME_LISTENER macro inside the loop that calls the listeners so the 
+ *     timer disappears from builds without instrumentation.
+ */
+class _DLL_EXPORT ListenerTimer {
+public:
+	/*!
+	 * @brief
+	 *     Constructor. Starts the timer.
+	 */
+	explicit ListenerTimer(const void* listener) : listener(listener), start(getTimestamp()) {
+	}
+
+	/*!
+	 * @brief
+	 *     Destructor. Records the call.
+	 */
+	~ListenerTimer() {
+		const Timestamp elapsed = getTimestamp() - this->start;
+		instrumentListener(this->listener, elapsed);
+		instrumentLatency(LATENCY_LISTENER, elapsed);
+	}
+
+private:
+	/*! @brief Copying a timer is not supported. */
+	ListenerTimer(const ListenerTimer&);
+
+	/*! @brief Copying a timer is not supported. */
+	ListenerTimer& operator=(const ListenerTimer&);
+
+	/*! @brief The listener being called. */
+	const void* listener;
+
+	/*! @brief The time the call started. */
+	const Timestamp start;
+};
+
+} // namespace I43D
+#endif  // _I43D_INSTRUMENTATION_H_
@@ -21,6 +21,10 @@ http://www.gnu.org/copyleft/lesser.txt.
 #define _I43D_KEYBOARD_H_
 
 #include "I43DCommon.h"
+#include "I43DComposeTable.h"
+#include "I43DInputWait.h"
+#include "I43DTextInput.h"
+#include "I43DTimer.h"
 #include <set>
 
 /*!
@@ -33,7 +37,6 @@ http://www.gnu.org/copyleft/lesser.txt.
 namespace I43D {
 
 // ---- Forward Declarations
-enum _DLL_EXPORT NPKeyID;
 class _DLL_EXPORT KeyboardListener;
 class _DLL_EXPORT Keyboard;
 
@@ -47,6 +50,7 @@ class _DLL_EXPORT Keyboard;
  *     translation of these control keys.
  */
 enum _DLL_EXPORT NPKeyID {
+	NPK_NONE = 0,								// Not a non-printable key
 	NPK_ENTER = 1,								
 	NPK_LCONTROL, NPK_RCONTROL,					// CTRL Keys
 	NPK_LSHIFT, NPK_RSHIFT,						// Shift keys
@@ -82,6 +86,37 @@ enum _DLL_EXPORT NPKeyID {
 	NPK_POWER, NPK_SLEEP, NPK_WAKE				// Power and computer sleep command keys
 };
 
+/*!
+ * @brief
+ *     Classes of keys that share the same key repeat settings.
+ * @see I43D::Keyboard::setKeyRepeat(const KeyClass, const KeyRepeatSettings&)
+ */
+enum _DLL_EXPORT KeyClass {
+	KEYCLASS_PRINTABLE = 0,		// Keys that type a character
+	KEYCLASS_EDITING,			// Enter, Backspace, Insert and Delete
+	KEYCLASS_NAVIGATION,		// Arrow keys, Home, End, Page-Up/Down and the numpad equivalents
+	KEYCLASS_FUNCTION,			// F keys, Escape and the application key
+	KEYCLASS_MODIFIER,			// Control, Shift, Alt, OS and the lock keys
+	KEYCLASS_MEDIA,				// Multimedia and OS command keys
+	KEYCLASS_SYSTEM,			// Power, sleep, print screen and pause keys
+	KEYCLASS_COUNT				// The number of key classes
+};
+
+/*!
+ * @brief
+ *     The typematic settings of a class of keys.
+ */
+struct _DLL_EXPORT KeyRepeatSettings {
+	/*! @brief Whether held keys of the class generate repeats at all. */
+	bool enabled;
+
+	/*! @brief The time in microseconds between the key press and the first repeat. */
+	Timestamp delay;
+
+	/*! @brief The time in microseconds between repeats after the first one. */
+	Timestamp interval;
+};
+
 /*!
  * @brief
  *     The base of all listeners to key events.
@@ -140,6 +175,30 @@ public:
 	virtual void keyReleased(const Keyboard* source, const unsigned short keyNum, 
 	                         const unsigned int scanCode) {}	
 
+	/*!
+	 * @brief
+	 *     Called whenever a held key repeats.
+	 * @remarks
+	 *     Repeats are generated by the library according to the settings of the class of
+	 *     the key so the rate is the same on all platforms and in raw input modes. A repeat
+	 *     of a printable key is followed by a charTyped() call and a repeat of a non-printable
+	 *     key by a nonPrintKeyTyped() call, just as if the key had been typed again. 
+	 * @param source
+	 *     The source of the event. 
+	 * @param keyNum
+	 *     The number of the key that is repeating.
+	 * @param scanCode
+	 *     The scan code of the key that is repeating.
+	 * @param repeatCount
+	 *     The number of repeats since the key was pressed starting with 1.
+	 * @param time
+	 *     The exact time the repeat was due on the input clock. 
+	 * @see I43D::Keyboard::setKeyRepeat(const KeyClass, const KeyRepeatSettings&)
+	 */
+	virtual void keyRepeated(const Keyboard* source, const unsigned short keyNum, 
+	                         const unsigned int scanCode, const unsigned int repeatCount,
+	                         const Timestamp time) {}
+
 	/*!
 	 * @brief
 	 *     Called whenever a unicode character is typed by the user.
@@ -157,6 +216,22 @@ public:
 	 */
 	virtual void charTyped(const Keyboard* source, const wchar_t typedChar) {}
 
+	/*!
+	 * @brief
+	 *     Called once per frame with all of the text typed during the frame.
+	 * @remarks
+	 *     This delivers the same characters as charTyped(), including IME commits and key 
+	 *     repeats, in a single call. Characters outside of the basic multilingual plane 
+	 *     arrive whole even where wchar_t is 16 bits wide. If more text is typed in a frame 
+	 *     than the buffer of the keyboard holds the text is delivered in several calls.
+	 * @param source
+	 *     The source of the event. 
+	 * @param text
+	 *     The typed text. The view is only valid until this method returns.
+	 * @see I43D::Keyboard::update(const Timestamp)
+	 */
+	virtual void textInput(const Keyboard* source, const TextInput& text) {}
+
 	/*!
 	 * @brief
 	 *     Called whenever a non-printable key is typed by the user.
@@ -177,7 +252,7 @@ public:
 	 * @brief
 	 *     Constructor.
 	 */
-	Keyboard() {}
+	Keyboard();
 	
 	/*!
 	 * @brief
@@ -190,6 +265,9 @@ public:
 	/*!
 	 * @brief
 	 *     Gets the layout name of the keyboard.
+	 * @remarks
+	 *     The name is platform specific. On Win32 it is the keyboard layout identifier, for
+	 *     example 00000407 for German. It can be used to pick the compose table to use.
 	 * @todo
 	 *     Should this be switched to an enumeration to allow platform neutral switching 
 	 *     on the name?
@@ -263,14 +341,118 @@ public:
 	 */
 	virtual unsigned short getKeyNumForNPK(const NPKeyID npk) = 0;
 
+	/*!
+	 * @brief
+	 *     Gets the class of a key which determines its key repeat settings.
+	 * @remarks
+	 *     The default implementation classifies keys by their non-printing key. Keys that
+	 *     are not non-printing keys are printable.
+	 * @param keyNum
+	 *     The key number to classify.
+	 */
+	virtual KeyClass getKeyClass(const unsigned short keyNum);
+
+	/*!
+	 * @brief
+	 *     Sets the key repeat settings of a class of keys.
+	 * @remarks
+	 *     By default printable, editing and navigation keys repeat after 500ms at 30 repeats
+	 *     per second and all other classes do not repeat. Changing the settings does not 
+	 *     affect a repeat that is already running until the key is pressed again.
+	 * @param keyClass
+	 *     The class of keys to change.
+	 * @param settings
+	 *     The new settings.
+	 */
+	void setKeyRepeat(const KeyClass keyClass, const KeyRepeatSettings& settings);
+
+	/*!
+	 * @brief
+	 *     Gets the key repeat settings of a class of keys.
+	 * @param keyClass
+	 *     The class of keys to get the settings for.
+	 */
+	const KeyRepeatSettings& getKeyRepeat(const KeyClass keyClass) const {
+		return this->repeatSettings[keyClass];
+	}
+
+	/*!
+	 * @brief
+	 *     Updates the timing of the keyboard.
+	 * @remarks
+	 *     Advances the timer wheel of the keyboard and dispatches all of the key repeats that
+	 *     were due up to the given time, each with its exact due time. Then delivers the text
+	 *     typed since the last update to the textInput() method of the listeners. This should
+	 *     be called once per frame.
+	 * @param now
+	 *     The current time on the input clock.
+	 */
+	virtual void update(const Timestamp now);
+
+	/*!
+	 * @brief
+	 *     Delivers the text typed since the last delivery to the listeners immediately.
+	 * @remarks
+	 *     This is normally done by update(). Nothing is delivered if no text was typed.
+	 */
+	void flushTextInput();
+
+	/*!
+	 * @brief
+	 *     Enable or disable the charTyped() events.
+	 * @remarks
+	 *     Applications that consume text through textInput() can disable the per character
+	 *     events to save a virtual call per character and listener. They are enabled by 
+	 *     default.
+	 * @param flag
+	 *     Whether charTyped() should be called (true) or not (false).
+	 */
+	inline void enableCharEvents(const bool flag) {
+		this->charEventsEnabled = flag;
+	}
+
+	/*!
+	 * @brief
+	 *     Sets the table used to compose dead key and compose key sequences.
+	 * @remarks
+	 *     The keyboard does not take ownership of the table. Switching tables is only a
+	 *     pointer change so a table per layout can be kept open and switched along with the
+	 *     layout. A sequence in progress is dropped.
+	 * @param table
+	 *     The table to use or NULL to disable composition.
+	 * @see I43D::ComposeTable
+	 */
+	inline void setComposeTable(const ComposeTable* table) {
+		this->composeState.setTable(table);
+	}
+
+	/*!
+	 * @brief
+	 *     Gets the table used to compose dead key and compose key sequences.
+	 */
+	inline const ComposeTable* getComposeTable() const {
+		return this->composeState.getTable();
+	}
+
+	/*!
+	 * @brief
+	 *     Gets the timer wheel that drives the timing of the keyboard.
+	 * @remarks
+	 *     Other timers that should advance together with the keyboard can be scheduled on
+	 *     this wheel.
+	 */
+	inline TimerWheel& getTimerWheel() {
+		return this->timerWheel;
+	}
+
 	/*!
 	 * @brief 
 	 *     Adds a new keyboard listener.
 	 * @param listener
 	 *     The listener to add.
-	 * @see I43D::Keyboard::removeKeyboardListener(const KeyboardListener const *)
+	 * @see I43D::Keyboard::removeKeyboardListener(KeyboardListener*)
 	 */
-	void addKeyboardListener(const KeyboardListener* listener) {
+	void addKeyboardListener(KeyboardListener* listener) {
 		this->listeners.insert(listener);
 	}
 
@@ -282,18 +464,238 @@ public:
 	 *     violation exceptions all over. 
 	 * @param listener
 	 *     The listener to remove.
-	 * @see I43D::Keyboard::addKeyboardListener(const KeyboardListener const *)
+	 * @see I43D::Keyboard::addKeyboardListener(KeyboardListener*)
 	 */
-	void removeKeyboardListener(const KeyboardListener* listener) {
+	void removeKeyboardListener(KeyboardListener* listener) {
 		this->listeners.erase(listener);
 	}
 
+	/*!
+	 * @brief
+	 *     Gets the waiters for key presses, woken with the key number after the listeners.
+	 */
+	inline InputWaitTable& getKeyPressWaits() {
+		return this->pressWaits;
+	}
+
+	/*!
+	 * @brief
+	 *     Gets the waiters for key releases, woken with the key number after the listeners.
+	 */
+	inline InputWaitTable& getKeyReleaseWaits() {
+		return this->releaseWaits;
+	}
+
+#if defined( __cpp_impl_coroutine )
+	/*!
+	 * @brief
+	 *     Suspends a coroutine until a key is pressed.
+	 * @param keyNum
+	 *     The key to wait for, or InputWaitTable::ANY for any key.
+	 * @return
+	 *     An awaitable that yields the number of the key.
+	 */
+	inline InputAwaiter nextKeyPress(const unsigned int keyNum = InputWaitTable::ANY) {
+		return InputAwaiter(this->pressWaits, keyNum);
+	}
+
+	/*!
+	 * @brief
+	 *     Suspends a coroutine until a key is released.
+	 * @param keyNum
+	 *     The key to wait for, or InputWaitTable::ANY for any key.
+	 * @return
+	 *     An awaitable that yields the number of the key.
+	 */
+	inline InputAwaiter nextKeyRelease(const unsigned int keyNum = InputWaitTable::ANY) {
+		return InputAwaiter(this->releaseWaits, keyNum);
+	}
+#endif
+
+protected:
+	/*!
+	 * @brief
+	 *     Dispatches a key press to the listeners and starts the key repeat for the key.
+	 * @remarks
+	 *     Platform implementations call this for every key press they read. Presses of a key
+	 *     that is already down are repeats generated by the operating system; they are 
+	 *     discarded because the keyboard generates its own repeats.
+	 * @param keyNum
+	 *     The number of the key that was pressed.
+	 * @param scanCode
+	 *     The scan code of the key that was pressed.
+	 * @param time
+	 *     The time of the key press on the input clock.
+	 * @return
+	 *     True if the press was dispatched, false if it was discarded as a repeat.
+	 */
+	bool fireKeyPressed(const unsigned short keyNum, const unsigned int scanCode, 
+	                    const Timestamp time);
+
+	/*!
+	 * @brief
+	 *     Dispatches a key release to the listeners and stops the key repeat for the key.
+	 * @param keyNum
+	 *     The number of the key that was released.
+	 * @param scanCode
+	 *     The scan code of the key that was released.
+	 */
+	void fireKeyReleased(const unsigned short keyNum, const unsigned int scanCode);
+
+	/*!
+	 * @brief
+	 *     Dispatches a key repeat to the listeners.
+	 * @remarks
+	 *     The keyboard calls this for the repeats it generates. Implementations that 
+	 *     receive repeats generated elsewhere, with the repeat settings disabled, call it 
+	 *     directly.
+	 * @param keyNum
+	 *     The number of the key that is repeating.
+	 * @param scanCode
+	 *     The scan code of the key that is repeating.
+	 * @param repeatCount
+	 *     The number of repeats so far including this one.
+	 * @param time
+	 *     The time the repeat was due on the input clock.
+	 */
+	void fireKeyRepeated(const unsigned short keyNum, const unsigned int scanCode, 
+	                     const unsigned int repeatCount, const Timestamp time);
+
+	/*!
+	 * @brief
+	 *     Dispatches a typed character to the listeners.
+	 * @remarks
+	 *     The character is remembered as the character of the repeating key so that repeats
+	 *     type it again.
+	 * @param typedChar
+	 *     The character that was typed.
+	 */
+	void fireCharTyped(const wchar_t typedChar);
+
+	/*!
+	 * @brief
+	 *     Dispatches a string of typed characters to the listeners.
+	 * @remarks
+	 *     Used for text that arrives all at once, such as an IME commit. Where wchar_t is 16
+	 *     bits wide the text is UTF-16.
+	 * @param text
+	 *     The characters that were typed.
+	 * @param length
+	 *     The number of characters in text.
+	 */
+	void fireText(const wchar_t* text, const unsigned int length);
+
+	/*!
+	 * @brief
+	 *     Runs the symbol produced by a key through the compose table.
+	 * @remarks
+	 *     Platform implementations that translate keys themselves, rather than receiving 
+	 *     characters from the operating system, call this for every key press that produces
+	 *     a character, a dead key or the compose key. Characters that are not part of a 
+	 *     sequence are typed as is, completed sequences type the composed text and broken 
+	 *     sequences are dropped.
+	 * @param symbol
+	 *     The symbol produced by the key.
+	 * @see I43D::ComposeSymbol
+	 */
+	void fireKeySymbol(const ComposeSymbol symbol);
+
+	/*!
+	 * @brief
+	 *     Dispatches a typed non-printable key to the listeners.
+	 * @param typedKey
+	 *     The key that was typed.
+	 */
+	void fireNonPrintKeyTyped(const NPKeyID typedKey);
+
 private:
+	/*!
+	 * @brief
+	 *     The timer that generates the repeats of the held key.
+	 */
+	class _DLL_EXPORT RepeatTimer : public TimerEntry {
+	public:
+		/*! @brief Constructor. */
+		RepeatTimer(Keyboard& keyboard) : keyboard(keyboard), keyNum(0), scanCode(0), 
+			repeatChar(0), npk(NPK_NONE), repeatCount(0), interval(0) {}
+
+		/*! @see I43D::TimerEntry::timerExpired(const Timestamp, const Timestamp) */
+		virtual void timerExpired(const Timestamp deadline, const Timestamp now);
+
+		/*! @brief The keyboard that owns the timer. */
+		Keyboard& keyboard;
+
+		/*! @brief The number of the repeating key. */
+		unsigned short keyNum;
+
+		/*! @brief The scan code of the repeating key. */
+		unsigned int scanCode;
+
+		/*! @brief The character typed by the repeating key or 0 if it hasnt typed one. */
+		UnicodeChar repeatChar;
+
+		/*! @brief The non-printing key typed by the repeating key. */
+		NPKeyID npk;
+
+		/*! @brief The number of repeats generated so far. */
+		unsigned int repeatCount;
+
+		/*! @brief The time between repeats. */
+		Timestamp interval;
+
+	private:
+		RepeatTimer& operator=(const RepeatTimer&);
+	};
+
+	/*! @brief The highest key number that is tracked for OS repeat filtering. */
+	enum { MAX_TRACKED_KEYS = 512 };
+
+	/*!
+	 * @brief
+	 *     Dispatches a single code point to the text buffer and the charTyped() listeners.
+	 */
+	void fireCodePoint(const UnicodeChar codePoint);
+
+	/*!
+	 * @brief
+	 *     Determines if a key is down according to the events dispatched so far.
+	 */
+	inline bool isKeyDown(const unsigned short keyNum) const {
+		return keyNum < MAX_TRACKED_KEYS && (this->keysDown[keyNum >> 5] & (1u << (keyNum & 31))) != 0;
+	}
+
 	/*!
 	 * @breif
 	 *     Stores the listeners to the keyboard.
 	 */
-	std::set<const KeyboardListener*> listeners;
+	std::set<KeyboardListener*> listeners;
+
+	/*! @brief The key repeat settings for each class of keys. */
+	KeyRepeatSettings repeatSettings[KEYCLASS_COUNT];
+
+	/*! @brief The wheel that drives the timing of the keyboard. */
+	TimerWheel timerWheel;
+
+	/*! @brief Generates the repeats of the key that was pressed last. */
+	RepeatTimer repeatTimer;
+
+	/*! @brief A bit for each key that is down. */
+	unsigned int keysDown[MAX_TRACKED_KEYS / 32];
+
+	/*! @brief The text typed since the last delivery. */
+	TextInputBuffer textBuffer;
+
+	/*! @brief Whether charTyped() events are dispatched. */
+	bool charEventsEnabled;
+
+	/*! @brief The progress of the compose sequence being typed. */
+	ComposeState composeState;
+
+	/*! @brief The waiters for key presses. */
+	InputWaitTable pressWaits;
+
+	/*! @brief The waiters for key releases. */
+	InputWaitTable releaseWaits;
 };
 
 } // namespace I43D 
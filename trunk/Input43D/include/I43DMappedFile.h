@@ -0,0 +1,141 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+#ifndef _I43D_MAPPED_FILE_H_
+#define _I43D_MAPPED_FILE_H_
+
+#include "I43DCommon.h"
+#include <cstddef>
+
+/*!
+ * @file
+ *     This file contains a read only memory mapped file used to load precompiled tables
+ *     without parsing or copying them.
+ * @author Robert Eugene Simmons Jr. (Kraythe)
+ */
+
+namespace I43D {
+
+/*!
+ * @brief
+ *     A file mapped read only into memory.
+ * @remarks
+ *     Uses file mappings on Win32 and mmap() on other platforms. The contents of the file
+ *     are paged in on demand so opening even a large file is nearly free.
+ */
+class _DLL_EXPORT MappedFile {
+public:
+	/*!
+	 * @brief
+	 *     Constructor.
+	 */
+	MappedFile();
+
+	/*!
+	 * @brief
+	 *     Destructor. Unmaps the file.
+	 */
+	~MappedFile();
+
+	/*!
+	 * @brief
+	 *     Maps a file, unmapping any file that was mapped before.
+	 * @param path
+	 *     The path of the file to map.
+	 * @return
+	 *     True if the file was mapped, false if it could not be opened or is empty.
+	 */
+	bool open(const std::string& path);
+
+	/*!
+	 * @brief
+	 *     Unmaps the file.
+	 */
+	void close();
+
+	/*!
+	 * @brief
+	 *     Determines if a file is mapped.
+	 */
+	inline bool isOpen() const {
+		return this->data != 0;
+	}
+
+	/*!
+	 * @brief
+	 *     Gets the contents of the file or NULL if no file is mapped.
+	 */
+	inline const void* getData() const {
+		return this->data;
+	}
+
+	/*!
+	 * @brief
+	 *     Gets the size of the file in bytes.
+	 */
+	inline size_t getSize() const {
+		return this->size;
+	}
+
+	/*!
+	 * @brief
+	 *     Gets the size and modification time of a file.
+	 * @return
+	 *     False if the file does not exist.
+	 */
+	static bool getFileStamp(const std::string& path, unsigned int& size, unsigned int& time);
+
+	/*!
+	 * @brief
+	 *     Writes a file through a temporary file so that nobody maps a partial file.
+	 * @remarks
+	 *     The temporary file has a unique name so several processes can write the same
+	 *     file at once. One of the complete copies ends up in place.
+	 * @param path
+	 *     The path of the file.
+	 * @param contents
+	 *     The contents of the file.
+	 * @param size
+	 *     The number of bytes in contents.
+	 * @return
+	 *     True if the file was written.
+	 */
+	static bool writeFile(const std::string& path, const void* contents, const size_t size);
+
+private:
+	/*! @brief Copying a mapping is not supported. */
+	MappedFile(const MappedFile&);
+
+	/*! @brief Copying a mapping is not supported. */
+	MappedFile& operator=(const MappedFile&);
+
+	/*! @brief The mapped contents of the file. */
+	const void* data;
+
+	/*! @brief The size of the file in bytes. */
+	size_t size;
+
+#if defined( _WIN32 )
+	/*! @brief The handle of the file mapping object. */
+	void* mapping;
+#endif
+};
+
+} // namespace I43D
+#endif  // _I43D_MAPPED_FILE_H_
@@ -22,6 +22,7 @@ http://www.gnu.org/copyleft/lesser.txt.
 #define _I43D_MOUSE_H_
 
 #include "I43DCommon.h"
+#include "I43DInputWait.h"
 #include <set>
 
 /*!
@@ -36,8 +37,6 @@ namespace I43D {
 // ---- Forward Declarations
 class _DLL_EXPORT Mouse;
 class _DLL_EXPORT MouseListener;
-enum _DLL_EXPORT MouseScrollDirection;
-enum _DLL_EXPORT StandardCursorID;
 
 /*!
  * @brief
@@ -238,15 +237,18 @@ public:
 	 *     This method is highly OS (and window manager for Unix) dependent. It is here mainly
 	 *     as a hook for those that wish to subclass this class or one of the platform implementation
 	 *     classes to set a cursor in a way that can be easily ported across platforms. The default 
-	 *     implementation of this class will merely throw an exception.
+	 *     implementation of this class merely reports that it is not implemented.
 	 * @param cursorID 
 	 *     This is the cursor to set. The void pointer would be interpreted differently depending
 	 *     upon the user's wishes. For example, Some users might choose to define an enumeration  
 	 *     like the I43D::StandardCursorID enumeration and pass that ID. Other users might take a 
 	 *     different approach. 
+	 * @return
+	 *     RESULT_OK if the cursor was set, RESULT_NOT_IMPLEMENTED if the mouse does not 
+	 *     support custom cursors.
 	 */
-	virtual void setCustomCursor(const void* cursorID) {
-		throw I43DException(L"Not Implemented in this class", __WFILE__, __LINE__);
+	virtual ResultCode setCustomCursor(const void* cursorID) {
+		return RESULT_NOT_IMPLEMENTED;
 	}
 
 	/*!
@@ -273,9 +275,9 @@ public:
 	 *     Adds a new Mouse listener.
 	 * @param listener
 	 *     The listener to add.
-	 * @see I43D::Mouse::removeMouseListener(const MouseListener const *)
+	 * @see I43D::Mouse::removeMouseListener(MouseListener*)
 	 */
-	inline void addMouseListener(const MouseListener* listener) {
+	inline void addMouseListener(MouseListener* listener) {
 		this->listeners.insert(listener);
 	}
 
@@ -287,18 +289,130 @@ public:
 	 *     violation exceptions all over. 
 	 * @param listener
 	 *     The listener to remove.
-	 * @see I43D::Mouse::addMouseListener(const MouseListener const *)
+	 * @see I43D::Mouse::addMouseListener(MouseListener*)
 	 */
-	inline void removeMouseListener(const MouseListener* listener) {
+	inline void removeMouseListener(MouseListener* listener) {
 		this->listeners.erase(listener);
 	}
 
+	/*!
+	 * @brief
+	 *     Gets the waiters for button presses, woken with the button number after the 
+	 *     listeners.
+	 */
+	inline InputWaitTable& getButtonPressWaits() {
+		return this->pressWaits;
+	}
+
+	/*!
+	 * @brief
+	 *     Gets the waiters for button clicks, woken with the button number after the 
+	 *     listeners.
+	 */
+	inline InputWaitTable& getClickWaits() {
+		return this->clickWaits;
+	}
+
+#if defined( __cpp_impl_coroutine )
+	/*!
+	 * @brief
+	 *     Suspends a coroutine until a button is pressed.
+	 * @param buttonNum
+	 *     The button to wait for starting with button 1, or InputWaitTable::ANY for any
+	 *     button.
+	 * @return
+	 *     An awaitable that yields the number of the button.
+	 */
+	inline InputAwaiter nextButtonPress(const unsigned int buttonNum = InputWaitTable::ANY) {
+		return InputAwaiter(this->pressWaits, buttonNum);
+	}
+
+	/*!
+	 * @brief
+	 *     Suspends a coroutine until a button is clicked.
+	 * @param buttonNum
+	 *     The button to wait for starting with button 1, or InputWaitTable::ANY for any
+	 *     button.
+	 * @return
+	 *     An awaitable that yields the number of the button.
+	 */
+	inline InputAwaiter nextClick(const unsigned int buttonNum = InputWaitTable::ANY) {
+		return InputAwaiter(this->clickWaits, buttonNum);
+	}
+#endif
+
+protected:
+	/*!
+	 * @brief
+	 *     Dispatches a mouse move to the listeners. 
+	 * @remarks
+	 *     Platform implementations call this and the other fire methods for the input they
+	 *     read.
+	 * @param x 
+	 *     The current x coordinate of the mouse.
+	 * @param y
+	 *     The current y coordinate of the mouse.
+	 */
+	void fireMoved(const unsigned int x, const unsigned int y);
+
+	/*!
+	 * @brief
+	 *     Dispatches a button press to the listeners. 
+	 * @param buttonNum
+	 *     The number of the button that was pressed starting with button 1.
+	 */
+	void fireButtonPressed(const unsigned short buttonNum);
+
+	/*!
+	 * @brief
+	 *     Dispatches a button release to the listeners. 
+	 * @param buttonNum
+	 *     The number of the button that was released starting with button 1.
+	 */
+	void fireButtonReleased(const unsigned short buttonNum);
+
+	/*!
+	 * @brief
+	 *     Dispatches a button click to the listeners. 
+	 * @param buttonNum
+	 *     The number of the button that was clicked starting with button 1.
+	 * @param clickCount
+	 *     The number of times that the button was clicked.
+	 */
+	void fireButtonClicked(const unsigned short buttonNum, const unsigned short clickCount);
+
+	/*!
+	 * @brief
+	 *     Dispatches a scroll to the listeners. 
+	 * @param direction
+	 *     The direction that the mouse was scrolled.
+	 */
+	void fireScrolled(const MouseScrollDirection direction);
+
+	/*!
+	 * @brief
+	 *     Dispatches the mouse entering the client area to the listeners. 
+	 */
+	void fireEntered();
+
+	/*!
+	 * @brief
+	 *     Dispatches the mouse leaving the client area to the listeners. 
+	 */
+	void fireExited();
+
 private:
 	/*!
 	 * @brief
 	 *     Stores the listeners to the keyboard.
 	 */
-	std::set<const MouseListener*> listeners;
+	std::set<MouseListener*> listeners;
+
+	/*! @brief The waiters for button presses. */
+	InputWaitTable pressWaits;
+
+	/*! @brief The waiters for button clicks. */
+	InputWaitTable clickWaits;
 };
 	
 } // namespace I43D 
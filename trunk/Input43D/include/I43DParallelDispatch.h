@@ -0,0 +1,209 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+#ifndef _I43D_PARALLEL_DISPATCH_H_
+#define _I43D_PARALLEL_DISPATCH_H_
+
+#include "I43DEvent.h"
+#include "I43DWorkerPool.h"
+#include <map>
+#include <vector>
+
+/*!
+ * @file
+ *     This file contains a dispatcher that hands batches of input events to listeners on
+ *     a pool of threads, so expensive listeners do not add to the latency of the others.
+ * @author Robert Eugene Simmons Jr. (Kraythe)
+ */
+
+namespace I43D {
+
+// ---- Forward Declarations
+class _DLL_EXPORT InputBatchListener;
+class _DLL_EXPORT ParallelEventDispatcher;
+
+/*!
+ * @brief
+ *     Implements a listener to batches of input events.
+ */
+class _DLL_EXPORT InputBatchListener abstract {
+public:
+	/*!
+	 * @brief
+	 *     Destructor.
+	 */
+	virtual ~InputBatchListener() {}
+
+	/*!
+	 * @brief
+	 *     Called with the events of a batch in the order they were pushed.
+	 * @remarks
+	 *     With a pool the call is made on one of its threads, but never while another call
+	 *     to the same listener is running. Listeners that share state with each other or 
+	 *     with the application must guard it themselves.
+	 * @param events
+	 *     The events. Only valid for the duration of the call.
+	 * @param count
+	 *     The number of events.
+	 */
+	virtual void eventsReceived(const InputEvent* events, const unsigned int count) {}
+};
+
+/*!
+ * @brief
+ *     Collects input events and hands them to listeners in batches.
+ * @remarks
+ *     Use the dispatcher as the sink of the event translators, or push to it yourself, and
+ *     call dispatch() once a frame. Without a pool the listeners are called one after the
+ *     other inside dispatch(). With a pool dispatch() returns at once and each listener 
+ *     receives the batch on a thread of the pool: every listener has its own strand, so it
+ *     sees the batches in order and one at a time while different listeners run in 
+ *     parallel. Call join() where the frame needs all input handling to be finished.
+ *     <br><br>
+ *     Pushing, dispatching, joining and changing the listeners must all happen on the 
+ *     same thread. Batches are recycled, so a steady stream of frames does not allocate.
+ */
+class _DLL_EXPORT ParallelEventDispatcher : public InputEventSink {
+public:
+	/*!
+	 * @brief
+	 *     Constructor.
+	 * @param pool
+	 *     The pool that runs the listeners, or 0 to run them in dispatch(). The pool may be
+	 *     shared with other work and must outlive the dispatcher.
+	 */
+	explicit ParallelEventDispatcher(WorkerPool* pool = 0);
+
+	/*!
+	 * @brief
+	 *     Destructor. Waits for the listeners to finish.
+	 * @remarks
+	 *     With a pool this waits for every task of the pool, since a strand may still be 
+	 *     returning from its last task after its listener finished.
+	 */
+	virtual ~ParallelEventDispatcher();
+
+	/*!
+	 * @brief
+	 *     Adds an event to the next batch.
+	 */
+	virtual bool pushEvent(const InputEvent& event);
+
+	/*!
+	 * @brief
+	 *     Hands the events pushed since the last call to every listener.
+	 */
+	void dispatch();
+
+	/*!
+	 * @brief
+	 *     Waits until every listener has handled every batch dispatched so far.
+	 */
+	void join();
+
+	/*!
+	 * @brief
+	 *     Sets the pool that runs the listeners. Joins first.
+	 * @param pool
+	 *     The pool, or 0 to run the listeners in dispatch().
+	 */
+	void setPool(WorkerPool* pool);
+
+	/*!
+	 * @brief 
+	 *     Adds a new listener. It receives the batches dispatched from now on.
+	 * @param listener
+	 *     The listener to add.
+	 * @see I43D::ParallelEventDispatcher::removeListener(InputBatchListener*)
+	 */
+	void addListener(InputBatchListener* listener);
+
+	/*!
+	 * @brief 
+	 *     Remove a listener. Joins first, so the listener can be deleted afterwards.
+	 * @param listener
+	 *     The listener to remove.
+	 * @see I43D::ParallelEventDispatcher::addListener(InputBatchListener*)
+	 */
+	void removeListener(InputBatchListener* listener);
+
+private:
+	/*! @brief Copying a dispatcher is not supported. */
+	ParallelEventDispatcher(const ParallelEventDispatcher&);
+
+	/*! @brief Copying a dispatcher is not supported. */
+	ParallelEventDispatcher& operator=(const ParallelEventDispatcher&);
+
+	class Strand;
+	friend class Strand;
+
+	/*!
+	 * @brief
+	 *     A batch of events shared by the strands of the listeners.
+	 */
+	struct Batch {
+		std::vector<InputEvent> events;
+		volatile unsigned int references;
+	};
+
+	/*!
+	 * @brief
+	 *     Called by a strand when its listener has handled a batch.
+	 */
+	void finish(Batch* batch);
+
+	/*!
+	 * @brief
+	 *     Gets an empty batch from the recycled ones, or a new one.
+	 */
+	Batch* acquire();
+
+	/*! @brief The pool, or 0. */
+	WorkerPool* pool;
+
+	/*! @brief The batch being collected. */
+	Batch* current;
+
+	/*! @brief Every batch ever made, for deleting them. */
+	std::vector<Batch*> batches;
+
+	/*! @brief The batches that no strand holds any more. */
+	std::vector<Batch*> recycled;
+
+	/*! @brief Guards the recycled batches. */
+	Mutex recycleLock;
+
+	/*! @brief The strand of each listener. */
+	std::map<InputBatchListener*, Strand*> strands;
+
+	/*! @brief The strands of removed listeners, kept until the pool is known to be done. */
+	std::vector<Strand*> retired;
+
+	/*! @brief The deliveries of batches to listeners that have not finished. */
+	volatile unsigned int pending;
+
+	/*! @brief Guards waiting for the deliveries. */
+	Mutex joinLock;
+
+	/*! @brief Signalled when the last pending delivery finishes. */
+	Condition finished;
+};
+
+} // namespace I43D
+#endif  // _I43D_PARALLEL_DISPATCH_H_
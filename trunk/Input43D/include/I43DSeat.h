@@ -0,0 +1,402 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+#ifndef _I43D_SEAT_H_
+#define _I43D_SEAT_H_
+
+#include "I43DEventQueue.h"
+#include "I43DInputManager.h"
+#include <map>
+#include <vector>
+
+/*!
+ * @file
+ *     This file contains the seats that route the input of several players to separate 
+ *     queues, so the logic of each player can run on its own thread.
+ * @author Robert Eugene Simmons Jr. (Kraythe)
+ */
+
+namespace I43D {
+
+// ---- Forward Declarations
+struct _DLL_EXPORT SeatState;
+class _DLL_EXPORT Seat;
+class _DLL_EXPORT SeatManager;
+
+/*!
+ * @brief
+ *     The state of all of the devices bound to a seat at one moment.
+ */
+struct _DLL_EXPORT SeatState {
+	/*! @brief The number of keys tracked. */
+	enum { MAX_KEYS = 512 };
+
+	/*! @brief The number of game controllers a seat can hold. */
+	enum { MAX_CONTROLLERS = 2 };
+
+	/*! @brief The number of axes tracked per game controller. */
+	enum { MAX_AXES = 16 };
+
+	/*! @brief The time of the latest event reflected in the state. */
+	Timestamp time;
+
+	/*! @brief A bit for each key that is down. */
+	unsigned int keys[MAX_KEYS / 32];
+
+	/*! @brief The x coordinate of the mouse. */
+	int mouseX;
+
+	/*! @brief The y coordinate of the mouse. */
+	int mouseY;
+
+	/*! @brief A bit for each mouse button that is down; bit 0 is button 1. */
+	unsigned int mouseButtons;
+
+	/*! @brief The devices in each controller slot or INVALID_DEVICE_ID. */
+	DeviceID controllers[MAX_CONTROLLERS];
+
+	/*! @brief A bit for each controller button that is down; bit 0 is button 1. */
+	unsigned int controllerButtons[MAX_CONTROLLERS];
+
+	/*! @brief The raw position of each controller axis. */
+	int controllerAxes[MAX_CONTROLLERS][MAX_AXES];
+
+	/*!
+	 * @brief
+	 *     Determines if a key is down.
+	 */
+	inline bool isKeyDown(const unsigned short keyNum) const {
+		return keyNum < MAX_KEYS && (this->keys[keyNum >> 5] & (1u << (keyNum & 31))) != 0;
+	}
+
+	/*!
+	 * @brief
+	 *     Determines if a mouse button is down.
+	 * @param buttonNum
+	 *     The number of the button starting with button 1.
+	 */
+	inline bool isMouseButtonDown(const unsigned short buttonNum) const {
+		return buttonNum >= 1 && buttonNum <= 32 && (this->mouseButtons & (1u << (buttonNum - 1))) != 0;
+	}
+
+	/*!
+	 * @brief
+	 *     Finds the controller slot of a device, claiming a free slot if needed.
+	 * @return
+	 *     The slot or MAX_CONTROLLERS if the device has no slot and none could be claimed.
+	 */
+	unsigned int getControllerSlot(const DeviceID device, const bool claim);
+
+	/*!
+	 * @brief
+	 *     Brings the state up to date with an event.
+	 */
+	void applyEvent(const InputEvent& event);
+};
+
+/*!
+ * @brief
+ *     The input of one player.
+ * @remarks
+ *     A seat has its own event queue and state snapshot. The input thread feeds the seat
+ *     through the devices bound to it, or by pushing events directly, while the thread 
+ *     running the logic of the player pops the events and reads the snapshot. The queue is
+ *     a lock free single producer, single consumer ring and the snapshot is a sequence 
+ *     lock, so seats never contend with each other or with a global lock.
+ */
+class _DLL_EXPORT Seat : public InputEventSink {
+public:
+	/*!
+	 * @brief
+	 *     Constructor.
+	 * @param index
+	 *     The index of the seat.
+	 * @param queueCapacity
+	 *     The number of events the queue of the seat holds.
+	 */
+	Seat(const unsigned int index, const unsigned int queueCapacity = 1024);
+
+	/*!
+	 * @brief
+	 *     Destructor. Unbinds all devices.
+	 */
+	virtual ~Seat();
+
+	/*!
+	 * @brief
+	 *     Gets the index of the seat.
+	 */
+	inline unsigned int getIndex() const {
+		return this->index;
+	}
+
+	/*!
+	 * @brief
+	 *     Routes the events of a keyboard to this seat.
+	 * @param keyboard
+	 *     The keyboard.
+	 * @param device
+	 *     The id of the keyboard.
+	 */
+	void bindKeyboard(Keyboard* keyboard, const DeviceID device);
+
+	/*!
+	 * @brief
+	 *     Stops routing the events of a keyboard to this seat.
+	 */
+	void unbindKeyboard(Keyboard* keyboard);
+
+	/*!
+	 * @brief
+	 *     Routes the events of a mouse to this seat.
+	 * @param mouse
+	 *     The mouse.
+	 * @param device
+	 *     The id of the mouse.
+	 */
+	void bindMouse(Mouse* mouse, const DeviceID device);
+
+	/*!
+	 * @brief
+	 *     Stops routing the events of a mouse to this seat.
+	 */
+	void unbindMouse(Mouse* mouse);
+
+	/*!
+	 * @brief
+	 *     Routes the events of a game controller to this seat.
+	 * @param controller
+	 *     The controller.
+	 * @param device
+	 *     The id of the controller.
+	 */
+	void bindGameController(GameController* controller, const DeviceID device);
+
+	/*!
+	 * @brief
+	 *     Stops routing the events of a game controller to this seat.
+	 */
+	void unbindGameController(GameController* controller);
+
+	/*!
+	 * @brief
+	 *     Updates the snapshot with an event and queues it. Must only be called on the input
+	 *     thread.
+	 * @remarks
+	 *     The events of a game controller are tracked in the first free controller slot of
+	 *     the snapshot.
+	 * @return
+	 *     False if the queue was full. The snapshot is updated either way.
+	 */
+	virtual bool pushEvent(const InputEvent& event);
+
+	/*!
+	 * @brief
+	 *     Removes the oldest event. Must only be called by the thread of the player.
+	 * @see I43D::EventQueue::popEvent(InputEvent&)
+	 */
+	inline bool popEvent(InputEvent& event) {
+		return this->queue.popEvent(event);
+	}
+
+	/*!
+	 * @brief
+	 *     Removes up to a number of the oldest events. Must only be called by the thread of
+	 *     the player.
+	 * @see I43D::EventQueue::popEvents(InputEvent*, const unsigned int)
+	 */
+	inline unsigned int popEvents(InputEvent* events, const unsigned int maxCount) {
+		return this->queue.popEvents(events, maxCount);
+	}
+
+	/*!
+	 * @brief
+	 *     Copies a consistent snapshot of the state of the seat. Safe on any thread.
+	 * @param state
+	 *     Receives the state.
+	 */
+	void getState(SeatState& state) const;
+
+	/*!
+	 * @brief
+	 *     Gets the queue of the seat.
+	 */
+	inline const EventQueue& getQueue() const {
+		return this->queue;
+	}
+
+	/*!
+	 * @brief
+	 *     Sets the notifier told about every event queued for the seat, so the thread of the
+	 *     player can sleep until there is input.
+	 * @param notifier
+	 *     The notifier, or 0 for none.
+	 */
+	inline void setNotifier(InputNotifier* notifier) {
+		this->queue.setNotifier(notifier);
+	}
+
+private:
+	/*! @brief Copying a seat is not supported. */
+	Seat(const Seat&);
+
+	/*! @brief Copying a seat is not supported. */
+	Seat& operator=(const Seat&);
+
+	/*! @brief The index of the seat. */
+	const unsigned int index;
+
+	/*! @brief The events waiting for the player. */
+	EventQueue queue;
+
+	/*! @brief The state written by the input thread. */
+	SeatState state;
+
+	/*! @brief The sequence lock of the state. Odd while the state is being written. */
+	volatile unsigned int sequence;
+
+	/*! @brief The translators of the bound keyboards. */
+	std::map<Keyboard*, KeyboardEventTranslator*> keyboards;
+
+	/*! @brief The translators of the bound mice. */
+	std::map<Mouse*, MouseEventTranslator*> mice;
+
+	/*! @brief The translators of the bound game controllers. */
+	std::map<GameController*, GameControllerEventTranslator*> controllers;
+};
+
+/*!
+ * @brief
+ *     Assigns devices to seats.
+ * @remarks
+ *     Register the manager as a listener of the input manager and it assigns each new 
+ *     device to a seat: every game controller to the first seat without one and every 
+ *     keyboard and mouse to the first seat without one of its kind. Assignments are kept
+ *     when a device is removed so a player who reconnects a controller is given their old 
+ *     seat back. Connection changes are pushed to the seat as events.
+ */
+class _DLL_EXPORT SeatManager : public InputManagerListener {
+public:
+	/*!
+	 * @brief
+	 *     Constructor.
+	 * @param seatCount
+	 *     The number of seats.
+	 * @param queueCapacity
+	 *     The number of events the queue of each seat holds.
+	 */
+	SeatManager(const unsigned int seatCount, const unsigned int queueCapacity = 1024);
+
+	/*!
+	 * @brief
+	 *     Destructor.
+	 */
+	virtual ~SeatManager();
+
+	/*!
+	 * @brief
+	 *     Gets the number of seats.
+	 */
+	inline unsigned int getSeatCount() const {
+		return static_cast<unsigned int>(this->seats.size());
+	}
+
+	/*!
+	 * @brief
+	 *     Gets a seat.
+	 * @param index
+	 *     The index of the seat.
+	 */
+	inline Seat& getSeat(const unsigned int index) {
+		return *this->seats[index];
+	}
+
+	/*!
+	 * @brief
+	 *     Assigns a device to a seat, replacing any automatic assignment.
+	 * @param device
+	 *     The id of the device.
+	 * @param seat
+	 *     The index of the seat.
+	 */
+	void assignDevice(const DeviceID device, const unsigned int seat);
+
+	/*!
+	 * @brief
+	 *     Forgets the seat of a device.
+	 */
+	void unassignDevice(const DeviceID device);
+
+	/*!
+	 * @brief
+	 *     Gets the seat a device is assigned to.
+	 * @return
+	 *     The seat or NULL if the device is not assigned.
+	 */
+	Seat* getSeatOfDevice(const DeviceID device);
+
+	/*!
+	 * @brief
+	 *     Binds a keyboard to the seat its device is assigned to.
+	 * @return
+	 *     False if the device is not assigned to a seat.
+	 */
+	bool bindKeyboard(Keyboard* keyboard, const DeviceID device);
+
+	/*!
+	 * @brief
+	 *     Binds a mouse to the seat its device is assigned to.
+	 * @return
+	 *     False if the device is not assigned to a seat.
+	 */
+	bool bindMouse(Mouse* mouse, const DeviceID device);
+
+	/*!
+	 * @brief
+	 *     Binds a game controller to the seat its device is assigned to.
+	 * @return
+	 *     False if the device is not assigned to a seat.
+	 */
+	bool bindGameController(GameController* controller, const DeviceID device);
+
+	/*! @see I43D::InputManagerListener:: */
+	virtual void deviceAdded(const InputManager* source, const DeviceInfo& device);
+
+	/*! @see I43D::InputManagerListener:: */
+	virtual void deviceRemoved(const InputManager* source, const DeviceInfo& device);
+
+private:
+	/*! @brief Copying a seat manager is not supported. */
+	SeatManager(const SeatManager&);
+
+	/*! @brief Copying a seat manager is not supported. */
+	SeatManager& operator=(const SeatManager&);
+
+	/*! @brief The seats. */
+	std::vector<Seat*> seats;
+
+	/*! @brief The seat of each assigned device. */
+	std::map<DeviceID, unsigned int> assignments;
+
+	/*! @brief The type of each assigned device. */
+	std::map<DeviceID, DeviceType> deviceTypes;
+};
+
+} // namespace I43D
+#endif  // _I43D_SEAT_H_
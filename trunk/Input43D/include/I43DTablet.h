@@ -20,7 +20,10 @@ http://www.gnu.org/copyleft/lesser.txt.
 #ifndef _I43D_TABLET_H_
 #define _I43D_TABLET_H_
 
-#include "I43DPlatform.h"
+#include "I43DCommon.h"
+#include "I43DTimer.h"
+#include <set>
+#include <vector>
 
 /*!
  * @file
@@ -33,29 +36,117 @@ http://www.gnu.org/copyleft/lesser.txt.
 namespace I43D {
 
 // ---- Forward Declarations
+struct _DLL_EXPORT PenSample;
+class _DLL_EXPORT TabletListener;
+class _DLL_EXPORT Tablet;
 
-// ---- Forward Declarations
-class _DLL_EXPORT GameControllerListener;
-class _DLL_EXPORT GameController;
+/*!
+ * @brief
+ *     Flags that describe the state of the pen in a sample.
+ */
+enum _DLL_EXPORT PenFlags {
+	/*! @brief The pen is close enough to the tablet to be tracked. */
+	PEN_IN_PROXIMITY = 1,
+
+	/*! @brief The tip of the pen touches the tablet. */
+	PEN_TOUCHING = 2,
+
+	/*! @brief The pen is used with its eraser end. */
+	PEN_ERASER = 4
+};
+
+/*!
+ * @brief
+ *     The state of the pen at one moment.
+ * @remarks
+ *     Positions are fractions of the width and height of the active area and pressure runs
+ *     from 0 to 1. Tilt is the angle of the pen away from upright towards positive x and 
+ *     y, and rotation the angle of the barrel, both in radians.
+ */
+struct _DLL_EXPORT PenSample {
+	/*! @brief The time of the sample on the input clock. */
+	Timestamp time;
+
+	/*! @brief The horizontal position of the pen. */
+	float x;
+
+	/*! @brief The vertical position of the pen. */
+	float y;
+
+	/*! @brief The pressure on the tip. */
+	float pressure;
+
+	/*! @brief The tilt towards positive x. */
+	float tiltX;
+
+	/*! @brief The tilt towards positive y. */
+	float tiltY;
+
+	/*! @brief The rotation of the barrel from -pi to pi. */
+	float rotation;
+
+	/*! @brief A bit for each barrel button that is pressed, starting with bit 0. */
+	unsigned short buttons;
+
+	/*! @brief A combination of I43D::PenFlags. */
+	unsigned short flags;
+};
 
 /*!
  * @brief
  *     Implements a listener to graphics tablet input. 
  */
 class _DLL_EXPORT TabletListener abstract {
+public:
+	/*!
+	 * @brief
+	 *     Destructor.
+	 */
+	virtual ~TabletListener() {}
+
+	/*!
+	 * @brief
+	 *     Called with the pen samples read since the last call.
+	 * @remarks
+	 *     Samples arrive in time order in one contiguous block per update of the tablet, 
+	 *     so a listener handles hundreds of samples a second with a single call per frame.
+	 *     The block is only valid for the duration of the call.
+	 * @param source
+	 *     The tablet that generated the samples.
+	 * @param samples
+	 *     The samples.
+	 * @param count
+	 *     The number of samples.
+	 */
+	virtual void samplesReceived(const Tablet* source, const PenSample* samples, 
+	                             const unsigned int count) {}
 };
 
 /*!
  * @brief
  *     A graphics tablet that allows input of data through using a pen and
  *     special pad.
+ * @remarks
+ *     Platform implementations set the properties of the pen as the device reports them 
+ *     and call commitSample() at the end of each report. Samples are collected into a 
+ *     batch that flushSamples() hands to the listeners in one call.
+ *     <br><br>
+ *     The tablet can also resample the pen to a uniform time step. Every delivered 
+ *     sample then falls on a multiple of the interval, with the continuous properties 
+ *     interpolated between the two reports around it and the buttons and flags of the 
+ *     earlier one. Resampled output runs up to one interval behind the device. The pen 
+ *     entering and leaving proximity and every report that changes the buttons or flags,
+ *     such as the tip touching down or lifting, are always delivered as reported and 
+ *     restart the time grid there. A gap of more than 100 ms between reports restarts the
+ *     grid too instead of filling the gap.
  */
 class _DLL_EXPORT Tablet abstract {
+public:
 	/*!
 	 * @brief
 	 *     Constructor.
 	 */
-	Tablet() {}
+	Tablet();
 
 	/*!
 	 * @brief
@@ -64,14 +155,46 @@ class _DLL_EXPORT Tablet abstract {
 	virtual ~Tablet() {
 	}
 
+	/*!
+	 * @brief
+	 *     Reads the pending input of the device and dispatches it.
+	 * @param now
+	 *     The current time on the input clock.
+	 */
+	virtual void update(const Timestamp now) = 0;
+
+	/*!
+	 * @brief
+	 *     Gets the state of the pen as of the last report.
+	 */
+	inline const PenSample& getPen() const {
+		return this->pen;
+	}
+
+	/*!
+	 * @brief
+	 *     Sets the time step the samples are resampled to.
+	 * @param interval
+	 *     The step in microseconds, or 0 to deliver the samples as reported.
+	 */
+	void setResampleInterval(const Timestamp interval);
+
+	/*!
+	 * @brief
+	 *     Gets the time step the samples are resampled to, or 0 if they are not.
+	 */
+	inline Timestamp getResampleInterval() const {
+		return this->interval;
+	}
+
 	/*!
 	 * @brief 
 	 *     Adds a new Tablet listener.
 	 * @param listener
 	 *     The listener to add.
-	 * @see I43D::Tablet::removeTabletListener(const TabletListener const *)
+	 * @see I43D::Tablet::removeTabletListener(TabletListener*)
 	 */
-	inline void addTabletListener(const TabletListener* listener) {
+	inline void addTabletListener(TabletListener* listener) {
 		this->listeners.insert(listener);
 	}
 
@@ -83,19 +206,117 @@ class _DLL_EXPORT Tablet abstract {
 	 *     violation exceptions all over. 
 	 * @param listener
 	 *     The listener to remove.
-	 * @see I43D::Tablet::addMTabletListener(const TabletListener const *)
+	 * @see I43D::Tablet::addTabletListener(TabletListener*)
 	 */
-	inline void removeTabletListener(const TabletListener* listener) {
+	inline void removeTabletListener(TabletListener* listener) {
 		this->listeners.erase(listener);
 	}
 
+protected:
+	/*!
+	 * @brief
+	 *     Sets the position of the pen.
+	 */
+	inline void setPosition(const float x, const float y) {
+		this->pen.x = x;
+		this->pen.y = y;
+	}
+
+	/*!
+	 * @brief
+	 *     Sets the pressure on the tip of the pen.
+	 */
+	inline void setPressure(const float pressure) {
+		this->pen.pressure = pressure;
+	}
+
+	/*!
+	 * @brief
+	 *     Sets the tilt of the pen.
+	 */
+	inline void setTilt(const float tiltX, const float tiltY) {
+		this->pen.tiltX = tiltX;
+		this->pen.tiltY = tiltY;
+	}
+
+	/*!
+	 * @brief
+	 *     Sets the rotation of the barrel of the pen.
+	 */
+	inline void setRotation(const float rotation) {
+		this->pen.rotation = rotation;
+	}
+
+	/*!
+	 * @brief
+	 *     Presses or releases a barrel button.
+	 * @param button
+	 *     The number of the button starting with 0.
+	 * @param pressed
+	 *     Whether the button is pressed.
+	 */
+	void setButton(const unsigned int button, const bool pressed);
+
+	/*!
+	 * @brief
+	 *     Sets or clears one of the I43D::PenFlags.
+	 */
+	void setFlag(const PenFlags flag, const bool set);
+
+	/*!
+	 * @brief
+	 *     Adds the current state of the pen to the batch.
+	 * @param time
+	 *     The time of the report.
+	 */
+	void commitSample(const Timestamp time);
+
+	/*!
+	 * @brief
+	 *     Hands the batch to the listeners, resampled if an interval is set.
+	 */
+	void flushSamples();
+
 private:
+	/*! @brief Copying a device is not supported. */
+	Tablet(const Tablet&);
+
+	/*! @brief Copying a device is not supported. */
+	Tablet& operator=(const Tablet&);
+
 	/*!
 	 * @brief
-	 *     Stores the listeners to the keyboard.
+	 *     Resamples the batch into the output.
 	 */
-	std::set<const TabletListener*> listeners;
-}
+	void resample();
+
+	/*! @brief The state of the pen being reported. */
+	PenSample pen;
+
+	/*! @brief The samples committed since the last flush. */
+	std::vector<PenSample> batch;
+
+	/*! @brief The resampled samples. */
+	std::vector<PenSample> output;
+
+	/*! @brief The resampling step, or 0. */
+	Timestamp interval;
+
+	/*! @brief The last sample resampling saw, which starts the next batch. */
+	PenSample previous;
+
+	/*! @brief Whether previous holds a sample. */
+	bool hasPrevious;
+
+	/*! @brief The time of the next resampled sample. */
+	Timestamp nextTime;
+
+	/*!
+	 * @brief
+	 *     Stores the listeners to the tablet.
+	 */
+	std::set<TabletListener*> listeners;
+};
 
 } // namespace I43D 
-#endif  // _I43D_TABLET_H_
\ No newline at end of file
+#endif  // _I43D_TABLET_H_
@@ -0,0 +1,158 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+#ifndef _I43D_TEXT_INPUT_H_
+#define _I43D_TEXT_INPUT_H_
+
+#include "I43DCommon.h"
+
+/*!
+ * @file
+ *     This file contains the classes used to deliver typed text in batches rather than one
+ *     character at a time.
+ * @author Robert Eugene Simmons Jr. (Kraythe)
+ */
+
+namespace I43D {
+
+// ---- Forward Declarations
+struct _DLL_EXPORT TextInput;
+class _DLL_EXPORT TextInputBuffer;
+
+/*!
+ * @brief
+ *     A unicode code point. 
+ * @remarks
+ *     Unlike wchar_t this is always wide enough to hold characters outside of the basic 
+ *     multilingual plane.
+ */
+typedef unsigned int UnicodeChar;
+
+/*!
+ * @brief
+ *     A view of the text typed during a frame in both UTF-32 and UTF-8.
+ * @remarks
+ *     The view points into the buffer of the keyboard and is only valid for the duration
+ *     of the listener call it was passed to. The UTF-8 text is zero terminated.
+ */
+struct _DLL_EXPORT TextInput {
+	/*! @brief The typed characters as UTF-32 code points. */
+	const UnicodeChar* utf32;
+
+	/*! @brief The number of code points in utf32. */
+	unsigned int length;
+
+	/*! @brief The typed characters as zero terminated UTF-8. */
+	const char* utf8;
+
+	/*! @brief The number of bytes in utf8 not including the terminator. */
+	unsigned int utf8Length;
+};
+
+/*!
+ * @brief
+ *     Accumulates typed characters in fixed size UTF-32 and UTF-8 buffers.
+ * @remarks
+ *     The buffer never allocates; it is cleared and reused every frame. UTF-16 input, such
+ *     as the characters reported by Win32, is combined into code points so characters
+ *     outside of the basic multilingual plane arrive whole.
+ */
+class _DLL_EXPORT TextInputBuffer {
+public:
+	/*! @brief The number of code points the buffer holds. */
+	enum { CAPACITY = 256 };
+
+	/*!
+	 * @brief
+	 *     Constructor.
+	 */
+	TextInputBuffer() : pendingSurrogate(0) {
+		this->clear();
+	}
+
+	/*!
+	 * @brief
+	 *     Appends a code point.
+	 * @param codePoint
+	 *     The code point to append. Invalid code points are replaced with U+FFFD.
+	 * @return
+	 *     False if the buffer is full and the code point was not appended.
+	 */
+	bool append(const UnicodeChar codePoint);
+
+	/*!
+	 * @brief
+	 *     Appends a wide character.
+	 * @remarks
+	 *     Where wchar_t is 16 bits wide the character is treated as a UTF-16 code unit. A high
+	 *     surrogate is held back until the low surrogate that completes it arrives.
+	 * @param typedChar
+	 *     The character to append.
+	 * @return
+	 *     False if the buffer is full and the character was not appended.
+	 */
+	bool appendWide(const wchar_t typedChar);
+
+	/*!
+	 * @brief
+	 *     Empties the buffer. A pending high surrogate is kept.
+	 */
+	void clear();
+
+	/*!
+	 * @brief
+	 *     Determines if the buffer is empty.
+	 */
+	inline bool isEmpty() const {
+		return this->length == 0;
+	}
+
+	/*!
+	 * @brief
+	 *     Determines if the buffer can not hold another code point.
+	 */
+	inline bool isFull() const {
+		return this->length == CAPACITY;
+	}
+
+	/*!
+	 * @brief
+	 *     Gets a view of the contents of the buffer.
+	 */
+	TextInput getText() const;
+
+private:
+	/*! @brief The accumulated code points. */
+	UnicodeChar utf32[CAPACITY];
+
+	/*! @brief The accumulated UTF-8 text and its terminator. */
+	char utf8[CAPACITY * 4 + 1];
+
+	/*! @brief The number of code points in the buffer. */
+	unsigned int length;
+
+	/*! @brief The number of bytes of UTF-8 text in the buffer. */
+	unsigned int utf8Length;
+
+	/*! @brief A high surrogate waiting for its low surrogate or 0. */
+	wchar_t pendingSurrogate;
+};
+
+} // namespace I43D
+#endif  // _I43D_TEXT_INPUT_H_
@@ -0,0 +1,238 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+#ifndef _I43D_THREADING_H_
+#define _I43D_THREADING_H_
+
+#include "I43DCommon.h"
+
+/*!
+ * @file
+ *     This file contains the thin threading layer used by the parts of the library that do
+ *     work in the background. It wraps Win32 threads and POSIX threads.
+ * @author Robert Eugene Simmons Jr. (Kraythe)
+ */
+
+namespace I43D {
+
+// ---- Forward Declarations
+class _DLL_EXPORT Mutex;
+class _DLL_EXPORT ScopedLock;
+class _DLL_EXPORT Condition;
+class _DLL_EXPORT Thread;
+
+/*!
+ * @brief
+ *     A mutual exclusion lock.
+ */
+class _DLL_EXPORT Mutex {
+public:
+	/*!
+	 * @brief
+	 *     Constructor.
+	 */
+	Mutex();
+
+	/*!
+	 * @brief
+	 *     Destructor.
+	 */
+	~Mutex();
+
+	/*!
+	 * @brief
+	 *     Acquires the lock, waiting for it if another thread holds it.
+	 */
+	void lock();
+
+	/*!
+	 * @brief
+	 *     Releases the lock.
+	 */
+	void unlock();
+
+private:
+	friend class Condition;
+
+	/*! @brief Copying a mutex is not supported. */
+	Mutex(const Mutex&);
+
+	/*! @brief Copying a mutex is not supported. */
+	Mutex& operator=(const Mutex&);
+
+	/*! @brief The platform lock. */
+	void* handle;
+};
+
+/*!
+ * @brief
+ *     Holds a Mutex for the lifetime of the object.
+ */
+class _DLL_EXPORT ScopedLock {
+public:
+	/*!
+	 * @brief
+	 *     Constructor. Acquires the lock.
+	 */
+	explicit ScopedLock(Mutex& mutex) : mutex(mutex) {
+		this->mutex.lock();
+	}
+
+	/*!
+	 * @brief
+	 *     Destructor. Releases the lock.
+	 */
+	~ScopedLock() {
+		this->mutex.unlock();
+	}
+
+private:
+	/*! @brief Copying a lock is not supported. */
+	ScopedLock(const ScopedLock&);
+
+	/*! @brief Copying a lock is not supported. */
+	ScopedLock& operator=(const ScopedLock&);
+
+	/*! @brief The held lock. */
+	Mutex& mutex;
+};
+
+/*!
+ * @brief
+ *     Lets threads sleep until another thread changes something they wait for.
+ * @remarks
+ *     Wait in a loop that checks the condition, since a waiter may wake without a signal.
+ *     Signal while holding the mutex the waiters use, and use one condition for each 
+ *     thing waited for.
+ */
+class _DLL_EXPORT Condition {
+public:
+	/*!
+	 * @brief
+	 *     Constructor.
+	 */
+	Condition();
+
+	/*!
+	 * @brief
+	 *     Destructor.
+	 */
+	~Condition();
+
+	/*!
+	 * @brief
+	 *     Releases a held mutex, sleeps until signalled and acquires the mutex again.
+	 */
+	void wait(Mutex& mutex);
+
+	/*!
+	 * @brief
+	 *     Wakes one waiting thread.
+	 */
+	void signal();
+
+	/*!
+	 * @brief
+	 *     Wakes every waiting thread.
+	 */
+	void broadcast();
+
+private:
+	/*! @brief Copying a condition is not supported. */
+	Condition(const Condition&);
+
+	/*! @brief Copying a condition is not supported. */
+	Condition& operator=(const Condition&);
+
+	/*! @brief The platform condition. */
+	void* handle;
+
+	/*! @brief The number of threads waiting. Only used on Win32. */
+	unsigned int waiters;
+};
+
+/*!
+ * @brief
+ *     A thread of execution.
+ * @remarks
+ *     Derive from this class and implement run(). The thread must be joined before the 
+ *     object is destroyed.
+ */
+class _DLL_EXPORT Thread abstract {
+public:
+	/*!
+	 * @brief
+	 *     Constructor.
+	 */
+	Thread() : handle(0) {}
+
+	/*!
+	 * @brief
+	 *     Destructor.
+	 */
+	virtual ~Thread() {}
+
+	/*!
+	 * @brief
+	 *     Starts the thread.
+	 * @return
+	 *     False if the thread could not be started.
+	 */
+	bool start();
+
+	/*!
+	 * @brief
+	 *     Waits for the thread to finish. Does nothing if the thread was never started.
+	 */
+	void join();
+
+	/*!
+	 * @brief
+	 *     Gets the number of threads the hardware can run at once.
+	 */
+	static unsigned int getHardwareThreadCount();
+
+protected:
+	/*!
+	 * @brief
+	 *     The work of the thread.
+	 */
+	virtual void run() = 0;
+
+private:
+	/*! @brief Copying a thread is not supported. */
+	Thread(const Thread&);
+
+	/*! @brief Copying a thread is not supported. */
+	Thread& operator=(const Thread&);
+
+	/*! @brief The entry point handed to the platform. */
+	static void* entryPoint(void* thread);
+
+#if defined( _WIN32 )
+	/*! @brief The entry point handed to Win32. */
+	static unsigned long __stdcall win32EntryPoint(void* thread);
+#endif
+
+	/*! @brief The platform thread. */
+	void* handle;
+};
+
+} // namespace I43D
+#endif  // _I43D_THREADING_H_
@@ -0,0 +1,255 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+#ifndef _I43D_TIMER_H_
+#define _I43D_TIMER_H_
+
+#include "I43DCommon.h"
+
+/*!
+ * @file
+ *     This file contains the timing facilities shared by all of the input devices. This
+ *     includes the monotonic input clock and a timer wheel used to schedule events that
+ *     are generated by the library itself, such as key repeats.
+ * @author Robert Eugene Simmons Jr. (Kraythe)
+ */
+
+namespace I43D {
+
+// ---- Forward Declarations
+class _DLL_EXPORT TimerEntry;
+class _DLL_EXPORT TimerWheel;
+
+/*!
+ * @brief
+ *     A point in time on the input clock measured in microseconds.
+ * @remarks
+ *     The input clock is monotonic and has an unspecified epoch so timestamps are only
+ *     meaningful relative to each other.
+ */
+typedef unsigned long long Timestamp;
+
+/*!
+ * @brief
+ *     Gets the current time on the input clock.
+ * @remarks
+ *     Uses the high resolution performance counter on Win32 and the monotonic clock on
+ *     other platforms.
+ */
+_DLL_EXPORT Timestamp getTimestamp();
+
+/*!
+ * @brief
+ *     An entry that can be scheduled on a TimerWheel.
+ * @remarks
+ *     Entries are intrusive so scheduling and cancelling a timer never allocates. An entry
+ *     can be scheduled on only one wheel at a time and is removed from the wheel before its
+ *     timerExpired() method is called, which means that the method is free to schedule the
+ *     entry again.
+ */
+class _DLL_EXPORT TimerEntry abstract {
+public:
+	/*!
+	 * @brief
+	 *     Constructor.
+	 */
+	TimerEntry() : wheel(0), next(0), prev(0), slot(0), deadline(0), expiring(false) {}
+
+	/*!
+	 * @brief
+	 *     Destructor. Cancels the entry if it is still scheduled.
+	 */
+	virtual ~TimerEntry();
+
+	/*!
+	 * @brief
+	 *     Called when the deadline of the entry has been reached.
+	 * @param deadline
+	 *     The exact time that the entry was scheduled for.
+	 * @param now
+	 *     The time that the wheel was advanced to. This will be equal to or later than the
+	 *     deadline depending on how often the wheel is advanced.
+	 */
+	virtual void timerExpired(const Timestamp deadline, const Timestamp now) = 0;
+
+	/*!
+	 * @brief
+	 *     Determines if the entry is currently scheduled on a wheel.
+	 */
+	inline bool isScheduled() const {
+		return this->wheel != 0;
+	}
+
+	/*!
+	 * @brief
+	 *     Gets the time the entry is scheduled for.
+	 */
+	inline Timestamp getDeadline() const {
+		return this->deadline;
+	}
+
+private:
+	friend class TimerWheel;
+
+	/*! @brief The wheel the entry is scheduled on or NULL if it is not scheduled. */
+	TimerWheel* wheel;
+
+	/*! @brief The next entry in the same slot. */
+	TimerEntry* next;
+
+	/*! @brief The previous entry in the same slot. */
+	TimerEntry* prev;
+
+	/*! @brief The slot of the wheel the entry is stored in. */
+	unsigned int slot;
+
+	/*! @brief The time the entry is scheduled for. */
+	Timestamp deadline;
+
+	/*! @brief Whether the entry was collected by an advance and waits to be called. */
+	bool expiring;
+};
+
+/*!
+ * @brief
+ *     A hashed timer wheel for scheduling input timing.
+ * @remarks
+ *     The wheel is divided into a fixed number of slots each covering one tick of the
+ *     configured resolution. Scheduling and cancelling are constant time and advancing the
+ *     wheel only visits the slots for the ticks that have passed. The resolution only
+ *     controls which slot an entry is stored in; entries always expire with their exact
+ *     deadline so users of the wheel can generate precisely timed events no matter how
+ *     often the wheel is advanced. No thread is involved; the owner of the wheel advances
+ *     it, usually once per frame.
+ */
+class _DLL_EXPORT TimerWheel {
+public:
+	/*!
+	 * @brief
+	 *     Constructor.
+	 * @param resolution
+	 *     The length of a tick in microseconds.
+	 */
+	TimerWheel(const Timestamp resolution = 1000);
+
+	/*!
+	 * @brief
+	 *     Destructor. Cancels all entries still scheduled on the wheel.
+	 */
+	~TimerWheel();
+
+	/*!
+	 * @brief
+	 *     Schedules an entry.
+	 * @remarks
+	 *     If the entry is already scheduled it is rescheduled. Deadlines in the past will
+	 *     expire on the next call to advance().
+	 * @param entry
+	 *     The entry to schedule.
+	 * @param deadline
+	 *     The time at which the entry should expire.
+	 */
+	void schedule(TimerEntry* entry, const Timestamp deadline);
+
+	/*!
+	 * @brief
+	 *     Cancels an entry. Entries that are not scheduled on this wheel are ignored.
+	 * @param entry
+	 *     The entry to cancel.
+	 */
+	void cancel(TimerEntry* entry);
+
+	/*!
+	 * @brief
+	 *     Advances the wheel, expiring all entries with a deadline at or before the given time.
+	 * @remarks
+	 *     Entries are expired in the order of their deadlines.
+	 * @param now
+	 *     The current time on the input clock.
+	 */
+	void advance(const Timestamp now);
+
+	/*!
+	 * @brief
+	 *     Gets the earliest deadline of all of the scheduled entries.
+	 * @param deadline
+	 *     Receives the deadline if there is one.
+	 * @return
+	 *     True if there is a scheduled entry, false if the wheel is empty.
+	 */
+	bool getNextDeadline(Timestamp& deadline) const;
+
+	/*!
+	 * @brief
+	 *     Gets the number of entries scheduled on the wheel.
+	 */
+	inline unsigned int getEntryCount() const {
+		return this->entryCount;
+	}
+
+private:
+	/*! @brief The number of slots in the wheel. Must be a power of two. */
+	enum { SLOT_COUNT = 256 };
+
+	/*!
+	 * @brief
+	 *     Removes an entry from its slot or the expiring list without changing its wheel.
+	 */
+	void unlink(TimerEntry* entry);
+
+	/*!
+	 * @brief
+	 *     Sorts a list linked through the next pointers by deadline with a merge sort.
+	 * @param list
+	 *     The head of the list.
+	 * @param length
+	 *     The number of entries in the list.
+	 * @return
+	 *     The head of the sorted list.
+	 */
+	static TimerEntry* sortByDeadline(TimerEntry* list, const unsigned int length);
+
+	/*!
+	 * @brief
+	 *     Merges two lists sorted by deadline, taking entries from the first list on ties.
+	 */
+	static TimerEntry* mergeByDeadline(TimerEntry* first, TimerEntry* second);
+
+	/*! @brief The head of the entry list for each slot. */
+	TimerEntry* slots[SLOT_COUNT];
+
+	/*! 
+	 * @brief 
+	 *     The entries collected by advance() that have not been called yet, sorted by 
+	 *     deadline. They stay scheduled so that a callback can still cancel them.
+	 */
+	TimerEntry* expiring;
+
+	/*! @brief The length of a tick in microseconds. */
+	Timestamp resolution;
+
+	/*! @brief The time the wheel was last advanced to. */
+	Timestamp current;
+
+	/*! @brief The number of entries scheduled on the wheel. */
+	unsigned int entryCount;
+};
+
+} // namespace I43D
+#endif  // _I43D_TIMER_H_
\ No newline at end of file
@@ -20,11 +20,13 @@ http://www.gnu.org/copyleft/lesser.txt.
 #ifndef _I43D_TOUCH_SCREEN_H_
 #define _I43D_TOUCH_SCREEN_H_
 
-#include "I43DPlatform.h"
+#include "I43DCommon.h"
+#include "I43DTimer.h"
+#include <set>
 
 /*!
  * @file
- *     This file contains classes relevant to the reception of graphics tablet events. 
+ *     This file contains classes relevant to the reception of touch screen events. 
  *     This includes a listener class and an interface to the actual device on the 
  *     operating system.
  * @author Robert Eugene Simmons Jr. (Kraythe)
@@ -33,25 +35,231 @@ http://www.gnu.org/copyleft/lesser.txt.
 namespace I43D {
 
 // ---- Forward Declarations
+struct _DLL_EXPORT TouchContacts;
+class _DLL_EXPORT TouchListener;
+class _DLL_EXPORT TouchScreen;
 
-// ---- Forward Declarations
-class _DLL_EXPORT GameControllerListener;
-class _DLL_EXPORT GameController;
+/*!
+ * @brief
+ *     The contacts on a touch screen at the end of a frame.
+ * @remarks
+ *     Contacts live in fixed slots in the manner of the Linux multi-touch protocol B: a 
+ *     contact keeps its slot from the moment it touches down until it lifts, and each 
+ *     property is stored in its own array indexed by slot. Bit masks tell which slots hold
+ *     a contact and which changed during the frame. A contact that lifted keeps its last
+ *     values in its slot for the frame it lifted in.
+ *     <br><br>
+ *     Positions and sizes are fractions of the width and height of the surface and 
+ *     pressure runs from 0 to 1.
+ */
+struct _DLL_EXPORT TouchContacts {
+	/*! @brief The number of slots. */
+	enum { MAX_SLOTS = 16 };
+
+	/*! @brief The time of the frame. */
+	Timestamp time;
+
+	/*! @brief A bit for each slot that holds a contact. */
+	unsigned int activeMask;
+
+	/*! @brief A bit for each slot whose contact touched down during the frame. */
+	unsigned int beganMask;
+
+	/*! @brief A bit for each slot whose contact moved or changed during the frame. */
+	unsigned int movedMask;
+
+	/*! @brief A bit for each slot whose contact lifted during the frame. */
+	unsigned int endedMask;
+
+	/*! @brief The id of the contact in each slot, unique while the contact lasts. */
+	int id[MAX_SLOTS];
+
+	/*! @brief The horizontal position of each contact. */
+	float x[MAX_SLOTS];
+
+	/*! @brief The vertical position of each contact. */
+	float y[MAX_SLOTS];
+
+	/*! @brief The pressure of each contact. */
+	float pressure[MAX_SLOTS];
+
+	/*! @brief The length of the major axis of each contact area. */
+	float touchMajor[MAX_SLOTS];
+
+	/*! @brief The length of the minor axis of each contact area. */
+	float touchMinor[MAX_SLOTS];
+
+	/*!
+	 * @brief
+	 *     Gets the number of contacts on the surface.
+	 */
+	unsigned int getContactCount() const;
+
+	/*!
+	 * @brief
+	 *     Finds the slot of a contact.
+	 * @return
+	 *     The slot or MAX_SLOTS if no active contact has the id.
+	 */
+	unsigned int findSlot(const int contactId) const;
+};
 
 /*!
  * @brief
- *     Implements a listener to graphics tablet input. 
+ *     Implements a listener to touch screen input. 
  */
-class _DLL_EXPORT TabletListener abstract {
+class _DLL_EXPORT TouchListener abstract {
+public:
+	/*!
+	 * @brief
+	 *     Destructor.
+	 */
+	virtual ~TouchListener() {}
+
+	/*!
+	 * @brief
+	 *     Called once at the end of each frame in which any contact changed.
+	 * @param source
+	 *     The touch screen that generated the event.
+	 * @param contacts
+	 *     All of the contacts with masks of the ones that changed.
+	 */
+	virtual void contactsChanged(const TouchScreen* source, const TouchContacts& contacts) {}
 };
 
 /*!
  * @brief
- *     A graphics tablet that allows input of data through using a pen and
- *     special pad.
+ *     A touch screen that tracks multiple contacts.
+ * @remarks
+ *     Platform implementations report contacts the way the Linux multi-touch protocol B 
+ *     does: select a slot, give it a contact id or -1 when the contact lifts, set its
+ *     properties and end each frame with commitFrame(). Nothing is allocated while 
+ *     tracking, so the screen keeps up with many contacts at high report rates.
  */
-class _DLL_EXPORT Tablet abstract {
-}
+class _DLL_EXPORT TouchScreen abstract {
+public:
+	/*!
+	 * @brief
+	 *     Constructor.
+	 */
+	TouchScreen();
+
+	/*!
+	 * @brief
+	 *     Destructor.
+	 */
+	virtual ~TouchScreen() {
+	}
+
+	/*!
+	 * @brief
+	 *     Reads the pending input of the device and dispatches it.
+	 * @param now
+	 *     The current time on the input clock.
+	 */
+	virtual void update(const Timestamp now) = 0;
+
+	/*!
+	 * @brief
+	 *     Gets the contacts as of the last completed frame.
+	 */
+	inline const TouchContacts& getContacts() const {
+		return this->contacts;
+	}
+
+	/*!
+	 * @brief 
+	 *     Adds a new Touch listener.
+	 * @param listener
+	 *     The listener to add.
+	 * @see I43D::TouchScreen::removeTouchListener(TouchListener*)
+	 */
+	inline void addTouchListener(TouchListener* listener) {
+		this->listeners.insert(listener);
+	}
+
+	/*!
+	 * @brief 
+	 *     Remove a Touch listener. 
+	 * @remarks 
+	 *     Make sure you call this method before deleting the listener or you will get access
+	 *     violation exceptions all over. 
+	 * @param listener
+	 *     The listener to remove.
+	 * @see I43D::TouchScreen::addTouchListener(TouchListener*)
+	 */
+	inline void removeTouchListener(TouchListener* listener) {
+		this->listeners.erase(listener);
+	}
+
+protected:
+	/*!
+	 * @brief
+	 *     Selects the slot that the following calls change.
+	 */
+	inline void selectSlot(const unsigned int slot) {
+		this->slot = slot < TouchContacts::MAX_SLOTS 
+			? slot : static_cast<unsigned int>(TouchContacts::MAX_SLOTS);
+	}
+
+	/*!
+	 * @brief
+	 *     Starts a contact in the selected slot or lifts it.
+	 * @param contactId
+	 *     The id of the new contact or -1 to lift the contact in the slot.
+	 * @param time
+	 *     The time of the frame in case a frame must be completed early because a slot is
+	 *     reused within a frame.
+	 */
+	void setContactId(const int contactId, const Timestamp time);
+
+	/*!
+	 * @brief
+	 *     Sets the position of the contact in the selected slot.
+	 */
+	void setPosition(const float x, const float y);
+
+	/*!
+	 * @brief
+	 *     Sets the pressure of the contact in the selected slot.
+	 */
+	void setPressure(const float pressure);
+
+	/*!
+	 * @brief
+	 *     Sets the size of the contact area in the selected slot.
+	 */
+	void setTouchSize(const float touchMajor, const float touchMinor);
+
+	/*!
+	 * @brief
+	 *     Completes a frame, dispatching it if anything changed.
+	 * @param time
+	 *     The time of the frame.
+	 */
+	void commitFrame(const Timestamp time);
+
+private:
+	/*!
+	 * @brief
+	 *     Marks the contact in the selected slot as moved.
+	 * @return
+	 *     False if no contact is in the slot.
+	 */
+	bool touchSlot();
+
+	/*! @brief The contacts. */
+	TouchContacts contacts;
+
+	/*! @brief The selected slot or MAX_SLOTS if the selection is out of range. */
+	unsigned int slot;
+
+	/*!
+	 * @brief
+	 *     Stores the listeners to the touch screen.
+	 */
+	std::set<TouchListener*> listeners;
+};
 
 } // namespace I43D 
-#endif  // _I43D_TOUCH_SCREEN_H_
\ No newline at end of file
+#endif  // _I43D_TOUCH_SCREEN_H_
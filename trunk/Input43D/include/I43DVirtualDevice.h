@@ -0,0 +1,266 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+#ifndef _I43D_VIRTUAL_DEVICE_H_
+#define _I43D_VIRTUAL_DEVICE_H_
+
+#include "I43DEvent.h"
+#include <vector>
+
+/*!
+ * @file
+ *     This file contains devices that are driven by input events instead of hardware, for
+ *     example input received from another machine or played back by a test rig.
+ * @author Robert Eugene Simmons Jr. (Kraythe)
+ */
+
+namespace I43D {
+
+// ---- Forward Declarations
+class _DLL_EXPORT VirtualMouse;
+class _DLL_EXPORT VirtualKeyboard;
+class _DLL_EXPORT VirtualGameController;
+
+/*!
+ * @brief
+ *     A mouse driven by input events.
+ * @remarks
+ *     Mouse events pushed to the mouse are dispatched to its listeners as if a platform 
+ *     mouse had read them. Other events are refused. Cursor changes are accepted and 
+ *     ignored.
+ *     <br><br>
+ *     The class is final and its state accessors are inline, so code that polls through 
+ *     a VirtualMouse reference instead of a Mouse reference pays no virtual call.
+ */
+class _DLL_EXPORT VirtualMouse I43D_FINAL : public Mouse, public InputEventSink {
+public:
+	/*!
+	 * @brief
+	 *     Constructor.
+	 */
+	VirtualMouse();
+
+	/*!
+	 * @brief
+	 *     Destructor.
+	 */
+	virtual ~VirtualMouse() {}
+
+	/*!
+	 * @brief
+	 *     Dispatches a mouse event.
+	 * @return
+	 *     False if the event is not a mouse event.
+	 */
+	virtual bool pushEvent(const InputEvent& event);
+
+	/*! @see I43D::Mouse:: */
+	virtual void enableEvents(const bool flag);
+
+	/*! @see I43D::Mouse:: */
+	virtual unsigned int getX() {
+		return this->x;
+	}
+
+	/*! @see I43D::Mouse:: */
+	virtual unsigned int getY() {
+		return this->y;
+	}
+
+	/*! @see I43D::Mouse:: */
+	virtual bool isInClientArea() {
+		return true;
+	}
+
+	/*! @see I43D::Mouse:: */
+	virtual bool isButtonPressed(const unsigned short buttonNum) {
+		return buttonNum >= 1 && buttonNum <= 32 && (this->buttons & (1u << (buttonNum - 1))) != 0;
+	}
+
+	/*! @see I43D::Mouse:: */
+	virtual void setStandardCursor(const StandardCursorID cursorID);
+
+	/*! @see I43D::Mouse:: */
+	virtual void hideMouseCursor(const bool flag);
+
+	/*! @see I43D::Mouse:: */
+	virtual void captureMouse(const bool flag);
+
+private:
+	/*! @brief Whether events are dispatched. */
+	bool eventsEnabled;
+
+	/*! @brief The x coordinate of the mouse. */
+	unsigned int x;
+
+	/*! @brief The y coordinate of the mouse. */
+	unsigned int y;
+
+	/*! @brief A bit for each button that is down; bit 0 is button 1. */
+	unsigned int buttons;
+};
+
+/*!
+ * @brief
+ *     A keyboard driven by input events.
+ * @remarks
+ *     Key and character events pushed to the keyboard are dispatched to its listeners as 
+ *     if a platform keyboard had read them. The keyboard takes its repeats from the 
+ *     events, so its own repeat settings start out disabled for every class of keys. 
+ *     Scan codes are learned from the events; non-printing keys are not known since the
+ *     events do not carry them. Call update() once per frame to deliver the typed text.
+ *     <br><br>
+ *     Like VirtualMouse the class is final with inline state accessors.
+ */
+class _DLL_EXPORT VirtualKeyboard I43D_FINAL : public Keyboard, public InputEventSink {
+public:
+	/*! @brief The number of keys tracked. */
+	enum { MAX_KEYS = 512 };
+
+	/*!
+	 * @brief
+	 *     Constructor.
+	 */
+	VirtualKeyboard();
+
+	/*!
+	 * @brief
+	 *     Destructor.
+	 */
+	virtual ~VirtualKeyboard() {}
+
+	/*!
+	 * @brief
+	 *     Dispatches a key or character event.
+	 * @return
+	 *     False if the event is not a keyboard event.
+	 */
+	virtual bool pushEvent(const InputEvent& event);
+
+	/*! @see I43D::Keyboard:: */
+	virtual const std::wstring getLayoutName();
+
+	/*! @see I43D::Keyboard:: */
+	virtual void enableEvents(const bool flag);
+
+	/*! @see I43D::Keyboard:: */
+	virtual bool isKeyPressed(const unsigned short keyNum) {
+		return keyNum < MAX_KEYS && (this->keys[keyNum >> 5] & (1u << (keyNum & 31))) != 0;
+	}
+
+	/*! @see I43D::Keyboard:: */
+	virtual unsigned int getScanCodeForKeyNum(const unsigned short keyNum) {
+		return keyNum < MAX_KEYS ? this->scanCodes[keyNum] : 0;
+	}
+
+	/*! @see I43D::Keyboard:: */
+	virtual unsigned short getKeyNumForScanCode(const unsigned int scanCode);
+
+	/*! @see I43D::Keyboard:: */
+	virtual NPKeyID getNPKForKeyNum(const unsigned short keyNum) {
+		return NPK_NONE;
+	}
+
+	/*! @see I43D::Keyboard:: */
+	virtual unsigned short getKeyNumForNPK(const NPKeyID npk) {
+		return 0;
+	}
+
+private:
+	/*! @brief Whether events are dispatched. */
+	bool eventsEnabled;
+
+	/*! @brief A bit for each key that is down. */
+	unsigned int keys[MAX_KEYS / 32];
+
+	/*! @brief The scan code last seen for each key. */
+	unsigned int scanCodes[MAX_KEYS];
+};
+
+/*!
+ * @brief
+ *     A game controller driven by input events.
+ * @remarks
+ *     Button events pushed to the controller are dispatched to its listeners at once. 
+ *     Axis events carry raw positions that are kept until the next update(), which 
+ *     reports every one of them as a sample and processes the axes like a platform 
+ *     controller would, so deadzones and response curves apply as usual.
+ */
+class _DLL_EXPORT VirtualGameController I43D_FINAL : public GameController, public InputEventSink {
+public:
+	/*!
+	 * @brief
+	 *     Constructor.
+	 * @param axisCount
+	 *     The number of axes the controller reports.
+	 * @param buttonCount
+	 *     The number of buttons the controller reports.
+	 */
+	VirtualGameController(const unsigned short axisCount = 6, const unsigned short buttonCount = 16);
+
+	/*!
+	 * @brief
+	 *     Destructor.
+	 */
+	virtual ~VirtualGameController() {}
+
+	/*!
+	 * @brief
+	 *     Dispatches a button event or stores an axis position.
+	 * @return
+	 *     False if the event is not a controller event.
+	 */
+	virtual bool pushEvent(const InputEvent& event);
+
+	/*! @see I43D::GameController:: */
+	virtual unsigned short getAxisCount() {
+		return this->axisCount;
+	}
+
+	/*! @see I43D::GameController:: */
+	virtual unsigned short getButtonCount() {
+		return this->buttonCount;
+	}
+
+protected:
+	/*! @see I43D::GameController:: */
+	virtual void poll(const Timestamp now);
+
+private:
+	/*!
+	 * @brief
+	 *     An axis position waiting for the next update.
+	 */
+	struct AxisSample {
+		unsigned short axis;
+		int position;
+	};
+
+	/*! @brief The number of axes. */
+	const unsigned short axisCount;
+
+	/*! @brief The number of buttons. */
+	const unsigned short buttonCount;
+
+	/*! @brief The axis positions pushed since the last update. */
+	std::vector<AxisSample> pending;
+};
+
+} // namespace I43D
+#endif  // _I43D_VIRTUAL_DEVICE_H_
@@ -0,0 +1,223 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+#ifndef _I43D_WORKER_POOL_H_
+#define _I43D_WORKER_POOL_H_
+
+#include "I43DAtomic.h"
+#include "I43DThreading.h"
+#include <vector>
+
+/*!
+ * @file
+ *     This file contains a pool of worker threads that balance their work by stealing
+ *     tasks from each other.
+ * @author Robert Eugene Simmons Jr. (Kraythe)
+ */
+
+namespace I43D {
+
+// ---- Forward Declarations
+class _DLL_EXPORT PoolTask;
+class _DLL_EXPORT WorkerPool;
+
+/*!
+ * @brief
+ *     A piece of work run by a WorkerPool.
+ * @remarks
+ *     The task is linked into the queue of a thread while it waits, so queueing it does 
+ *     not allocate. A task can wait in one queue at a time; it may be submitted again once
+ *     it has started running. Copies of a task start out unqueued.
+ */
+class _DLL_EXPORT PoolTask abstract {
+public:
+	/*!
+	 * @brief
+	 *     Constructor.
+	 */
+	PoolTask() : older(0), newer(0) {}
+
+	/*!
+	 * @brief
+	 *     Copy constructor. The copy is not queued.
+	 */
+	PoolTask(const PoolTask&) : older(0), newer(0) {}
+
+	/*!
+	 * @brief
+	 *     Destructor.
+	 */
+	virtual ~PoolTask() {}
+
+	/*!
+	 * @brief
+	 *     Assignment. Does not change where the task is queued.
+	 */
+	PoolTask& operator=(const PoolTask&) {
+		return *this;
+	}
+
+	/*!
+	 * @brief
+	 *     Does the work. Called on one of the threads of the pool.
+	 */
+	virtual void run() = 0;
+
+private:
+	friend class WorkerPool;
+
+	/*! @brief The task queued before this one on the same thread, or 0. */
+	PoolTask* older;
+
+	/*! @brief The task queued after this one on the same thread, or 0. */
+	PoolTask* newer;
+};
+
+/*!
+ * @brief
+ *     Runs tasks on a fixed number of threads.
+ * @remarks
+ *     Each thread has its own queue of tasks. Submitted tasks are dealt to the queues in
+ *     turn; a thread runs the newest task of its own queue and, when that is empty, steals
+ *     the oldest task of another thread, so a thread stuck with an expensive task does not
+ *     hold up the tasks behind it. Threads with nothing to do sleep until a task arrives.
+ *     <br><br>
+ *     The pool does not own its tasks and runs them in no particular order. Use a 
+ *     ParallelEventDispatcher, or a strand of your own, for work that must stay in order.
+ */
+class _DLL_EXPORT WorkerPool {
+public:
+	/*!
+	 * @brief
+	 *     Constructor. Starts the threads.
+	 * @param threadCount
+	 *     The number of threads, or 0 for one per hardware thread.
+	 */
+	explicit WorkerPool(const unsigned int threadCount = 0);
+
+	/*!
+	 * @brief
+	 *     Destructor. Runs the remaining tasks and stops the threads.
+	 */
+	~WorkerPool();
+
+	/*!
+	 * @brief
+	 *     Queues a task. Safe on any thread, including the threads of the pool.
+	 * @param task
+	 *     The task. It must stay alive until it has run and must not be waiting already.
+	 */
+	void submit(PoolTask* task);
+
+	/*!
+	 * @brief
+	 *     Waits until every submitted task has run. Must not be called from a task.
+	 */
+	void wait();
+
+	/*!
+	 * @brief
+	 *     Gets the number of threads of the pool.
+	 */
+	inline unsigned int getThreadCount() const {
+		return static_cast<unsigned int>(this->workers.size());
+	}
+
+	/*!
+	 * @brief
+	 *     Gets the number of tasks taken from the queue of another thread, for tuning.
+	 */
+	inline unsigned int getStealCount() const {
+		return atomicLoad(this->stealCount);
+	}
+
+private:
+	/*! @brief Copying a pool is not supported. */
+	WorkerPool(const WorkerPool&);
+
+	/*! @brief Copying a pool is not supported. */
+	WorkerPool& operator=(const WorkerPool&);
+
+	class Worker;
+	friend class Worker;
+
+	/*!
+	 * @brief
+	 *     The tasks of one thread, linked through the tasks themselves.
+	 */
+	struct TaskQueue {
+		TaskQueue() : oldest(0), newest(0) {}
+
+		Mutex lock;
+		PoolTask* oldest;
+		PoolTask* newest;
+	};
+
+	/*!
+	 * @brief
+	 *     Runs tasks until the pool stops. The loop of each thread.
+	 * @param index
+	 *     The index of the thread.
+	 */
+	void work(const unsigned int index);
+
+	/*!
+	 * @brief
+	 *     Takes a task from the own queue of a thread or steals one from another.
+	 * @return
+	 *     The task, or 0 if every queue is empty.
+	 */
+	PoolTask* take(const unsigned int index);
+
+	/*! @brief The threads. */
+	std::vector<Worker*> workers;
+
+	/*! @brief The queues of the threads, by index. */
+	std::vector<TaskQueue*> queues;
+
+	/*! @brief The queue the next submitted task goes to. */
+	volatile unsigned int nextQueue;
+
+	/*! @brief The tasks waiting in the queues. */
+	volatile unsigned int queued;
+
+	/*! @brief The tasks submitted that have not finished. */
+	volatile unsigned int outstanding;
+
+	/*! @brief The tasks stolen. */
+	volatile unsigned int stealCount;
+
+	/*! @brief Guards sleeping and waking. */
+	Mutex idleLock;
+
+	/*! @brief Signalled when a task is queued or the pool stops. */
+	Condition workAvailable;
+
+	/*! @brief Signalled when the last outstanding task finishes. */
+	Condition allDone;
+
+	/*! @brief The number of threads sleeping. Guarded by idleLock. */
+	unsigned int sleepers;
+
+	/*! @brief Whether the pool is stopping. Guarded by idleLock. */
+	bool stopping;
+};
+
+} // namespace I43D
+#endif  // _I43D_WORKER_POOL_H_
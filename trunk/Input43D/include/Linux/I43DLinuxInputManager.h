@@ -0,0 +1,144 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+#ifndef _I43D_LINUX_INPUT_MANAGER_H_
+#define _I43D_LINUX_INPUT_MANAGER_H_
+
+#include "I43DInputManager.h"
+#include "I43DThreading.h"
+
+/*!
+ * @file
+ *     This file contains the headers for the Linux evdev implementation of 
+ *     I43D::InputManager.
+ * @author Robert Eugene Simmons Jr. (Kraythe)
+ */
+
+namespace I43D {
+
+/*!
+ * @brief
+ *     Discovers the evdev devices in /dev/input and watches the directory with inotify.
+ * @remarks
+ *     Devices are probed in parallel on a few short lived threads so that one slow device
+ *     does not hold up the others. The capabilities of each model of device are cached by
+ *     bus, vendor, product, version and name; once a model has been seen, probing another 
+ *     device of that model only reads its identity. The cache can be saved to a file so 
+ *     later runs skip the capability queries altogether.
+ */
+class _DLL_EXPORT LinuxInputManager : public I43D::InputManager {
+public:
+	/*!
+	 * @brief
+	 *     Constructor. Starts watching the device directory.
+	 * @param directory
+	 *     The directory that holds the event device nodes.
+	 */
+	LinuxInputManager(const std::string& directory = "/dev/input");
+
+	/*!
+	 * @brief
+	 *     Destructor.
+	 */
+	virtual ~LinuxInputManager();
+
+	/*! @see I43D::InputManager:: */
+	virtual void enumerateDevices();
+
+	/*! @see I43D::InputManager:: */
+	virtual void update();
+
+	/*!
+	 * @brief
+	 *     Gets the inotify descriptor that becomes readable when devices come and go.
+	 * @remarks
+	 *     Applications that sleep in poll() or epoll can add this descriptor to their set
+	 *     and call update() when it is readable. Returns -1 if the watch could not be set up.
+	 */
+	inline int getNotificationHandle() const {
+		return this->notifyHandle;
+	}
+
+	/*!
+	 * @brief
+	 *     Loads device capabilities saved by saveCapabilityCache().
+	 * @param path
+	 *     The path of the cache file.
+	 * @return
+	 *     False if the file could not be read.
+	 */
+	bool loadCapabilityCache(const std::string& path);
+
+	/*!
+	 * @brief
+	 *     Saves the capabilities of all device models seen so far.
+	 * @param path
+	 *     The path of the cache file.
+	 * @return
+	 *     False if the file could not be written.
+	 */
+	bool saveCapabilityCache(const std::string& path) const;
+
+	/*!
+	 * @brief
+	 *     Probes a device node.
+	 * @remarks
+	 *     This is safe to call from several threads at once.
+	 * @param path
+	 *     The path of the event device node.
+	 * @param device
+	 *     Receives the description of the device.
+	 * @return
+	 *     False if the node could not be opened or is not a device the library handles.
+	 */
+	bool probeDevice(const std::string& path, DeviceInfo& device);
+
+private:
+	/*!
+	 * @brief
+	 *     The capabilities of a model of device.
+	 */
+	struct ModelCapabilities {
+		DeviceType type;
+		unsigned int capabilities;
+		unsigned short buttonCount;
+		unsigned short axisCount;
+	};
+
+	/*!
+	 * @brief
+	 *     Probes a set of device nodes in parallel and adds the ones that are devices.
+	 */
+	void probeAndAdd(const std::vector<std::string>& paths);
+
+	/*! @brief The directory that holds the event device nodes. */
+	std::string directory;
+
+	/*! @brief The inotify descriptor or -1. */
+	int notifyHandle;
+
+	/*! @brief The capabilities of each model seen so far, by model key. */
+	std::map<std::string, ModelCapabilities> modelCache;
+
+	/*! @brief Guards the model cache while probing in parallel. */
+	mutable Mutex cacheLock;
+};
+
+} // namespace I43D
+#endif  // _I43D_LINUX_INPUT_MANAGER_H_
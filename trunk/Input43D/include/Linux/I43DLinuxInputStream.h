@@ -0,0 +1,334 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+#ifndef _I43D_LINUX_INPUT_STREAM_H_
+#define _I43D_LINUX_INPUT_STREAM_H_
+
+#include "I43DEventCodec.h"
+#include "I43DVirtualDevice.h"
+#include <string>
+
+/*!
+ * @file
+ *     This file contains the classes that stream input to another process or machine over
+ *     a socket.
+ * @author Robert Eugene Simmons Jr. (Kraythe)
+ */
+
+namespace I43D {
+
+// ---- Forward Declarations
+struct _DLL_EXPORT StreamLatency;
+class _DLL_EXPORT LinuxInputStreamSender;
+class _DLL_EXPORT LinuxInputStreamReceiver;
+
+/*!
+ * @brief
+ *     Statistics of the time input took from the device to the receiver.
+ */
+struct _DLL_EXPORT StreamLatency {
+	/*! @brief The number of events measured. */
+	unsigned int count;
+
+	/*! @brief The shortest latency in microseconds. */
+	Timestamp minimum;
+
+	/*! @brief The longest latency in microseconds. */
+	Timestamp maximum;
+
+	/*! @brief The sum of all latencies in microseconds. */
+	Timestamp total;
+
+	/*!
+	 * @brief
+	 *     Gets the mean latency in microseconds.
+	 */
+	inline Timestamp getAverage() const {
+		return this->count > 0 ? this->total / this->count : 0;
+	}
+};
+
+/*!
+ * @brief
+ *     Sends input events over a socket.
+ * @remarks
+ *     Events pushed to the sender are encoded into a packet that goes out when it is full
+ *     or when flush() is called, which should be done once per frame. Batching a frame of
+ *     events into one packet keeps the number of writes down, and Nagle's algorithm is 
+ *     disabled on TCP so the packet leaves at once.
+ *     <br><br>
+ *     Addresses are written unix:/path/of/socket or tcp:host:port.
+ */
+class _DLL_EXPORT LinuxInputStreamSender : public InputEventSink {
+public:
+	/*!
+	 * @brief
+	 *     Constructor. The sender starts disconnected.
+	 */
+	LinuxInputStreamSender();
+
+	/*!
+	 * @brief
+	 *     Constructor. Connects to a receiver.
+	 * @param address
+	 *     The address of the receiver.
+	 * @throws I43DException
+	 *     If the address is malformed or the connection fails. Builds without exceptions 
+	 *     report to the startup error handler and abort, so a receiver that may not be 
+	 *     running is better reached with connect().
+	 */
+	explicit LinuxInputStreamSender(const std::string& address);
+
+	/*!
+	 * @brief
+	 *     Destructor. Sends the pending events and disconnects.
+	 */
+	virtual ~LinuxInputStreamSender();
+
+	/*!
+	 * @brief
+	 *     Connects to a receiver. A connection that is up is flushed and closed first.
+	 * @param address
+	 *     The address of the receiver.
+	 * @return
+	 *     RESULT_INCOMPATIBLE if the address is malformed or RESULT_SYSTEM_ERROR if the 
+	 *     connection fails, for example because no receiver listens.
+	 */
+	ResultCode connect(const std::string& address);
+
+	/*!
+	 * @brief
+	 *     Adds an event to the packet being built, sending the packet first if it is full.
+	 * @return
+	 *     False if the connection was lost.
+	 */
+	virtual bool pushEvent(const InputEvent& event);
+
+	/*!
+	 * @brief
+	 *     Sends the pending events.
+	 * @return
+	 *     False if the connection was lost.
+	 */
+	bool flush();
+
+	/*!
+	 * @brief
+	 *     Determines if the connection is still up.
+	 */
+	inline bool isConnected() const {
+		return this->handle >= 0;
+	}
+
+private:
+	/*! @brief Copying a sender is not supported. */
+	LinuxInputStreamSender(const LinuxInputStreamSender&);
+
+	/*! @brief Copying a sender is not supported. */
+	LinuxInputStreamSender& operator=(const LinuxInputStreamSender&);
+
+	/*! @brief The connected socket or -1. */
+	int handle;
+
+	/*! @brief The packet being built. */
+	EventPacketWriter writer;
+};
+
+/*!
+ * @brief
+ *     Receives input events sent by a LinuxInputStreamSender and plays them on virtual 
+ *     devices.
+ * @remarks
+ *     The receiver listens on an address and serves one sender at a time. Mouse and 
+ *     keyboard events drive the virtual mouse and keyboard of the receiver, which can be 
+ *     used like any other mouse and keyboard. All events are also passed on to an optional
+ *     sink. When a sender disconnects, the keys and buttons it held are released.
+ *     <br><br>
+ *     Latency is measured for every event from its time stamp on the sender to the update
+ *     that received it. Both ends must share a clock for that, as processes on the same 
+ *     machine do; for another machine set the offset between the clocks.
+ */
+class _DLL_EXPORT LinuxInputStreamReceiver {
+public:
+	/*!
+	 * @brief
+	 *     Constructor. Starts listening.
+	 * @param address
+	 *     The address to listen on, in the form used by LinuxInputStreamSender. An old 
+	 *     socket file at a unix address is replaced.
+	 * @throws I43DException
+	 *     If the address is malformed or can not be listened on.
+	 */
+	explicit LinuxInputStreamReceiver(const std::string& address);
+
+	/*!
+	 * @brief
+	 *     Destructor. Stops listening.
+	 */
+	~LinuxInputStreamReceiver();
+
+	/*!
+	 * @brief
+	 *     Accepts a sender if none is connected and plays the events that arrived.
+	 * @param now
+	 *     The current time on the input clock.
+	 */
+	void update(const Timestamp now);
+
+	/*!
+	 * @brief
+	 *     Gets the mouse driven by the stream.
+	 */
+	inline VirtualMouse& getMouse() {
+		return this->mouse;
+	}
+
+	/*!
+	 * @brief
+	 *     Gets the keyboard driven by the stream.
+	 */
+	inline VirtualKeyboard& getKeyboard() {
+		return this->keyboard;
+	}
+
+	/*!
+	 * @brief
+	 *     Sets a sink that receives every event of the stream, or NULL for none.
+	 */
+	inline void setEventSink(InputEventSink* sink) {
+		this->dispatcher.sink = sink;
+	}
+
+	/*!
+	 * @brief
+	 *     Sets how far the clock of the sender is behind the clock of the receiver.
+	 */
+	inline void setClockOffset(const long long offset) {
+		this->dispatcher.clockOffset = offset;
+	}
+
+	/*!
+	 * @brief
+	 *     Gets the latency measured since the last reset.
+	 */
+	inline const StreamLatency& getLatency() const {
+		return this->dispatcher.latency;
+	}
+
+	/*!
+	 * @brief
+	 *     Starts the latency measurement over.
+	 */
+	void resetLatency();
+
+	/*!
+	 * @brief
+	 *     Gets the number of packets the connected sender sent that never arrived. The count
+	 *     starts over when a sender connects.
+	 */
+	inline unsigned int getLostPacketCount() const {
+		return this->reader.getLostPacketCount();
+	}
+
+	/*!
+	 * @brief
+	 *     Determines if a sender is connected.
+	 */
+	inline bool isConnected() const {
+		return this->connection >= 0;
+	}
+
+private:
+	/*!
+	 * @brief
+	 *     Routes decoded events to the devices and measures their latency.
+	 */
+	class _DLL_EXPORT Dispatcher : public InputEventSink {
+	public:
+		/*! @brief Constructor. */
+		Dispatcher(LinuxInputStreamReceiver& receiver) 
+			: receiver(receiver), sink(0), clockOffset(0), now(0) {}
+
+		/*! @see I43D::InputEventSink::pushEvent(const InputEvent&) */
+		virtual bool pushEvent(const InputEvent& event);
+
+		/*! @brief The receiver that owns the dispatcher. */
+		LinuxInputStreamReceiver& receiver;
+
+		/*! @brief The sink that receives every event, or NULL. */
+		InputEventSink* sink;
+
+		/*! @brief How far the clock of the sender is behind. */
+		long long clockOffset;
+
+		/*! @brief The time of the update being run. */
+		Timestamp now;
+
+		/*! @brief The latency measured so far. */
+		StreamLatency latency;
+
+	private:
+		Dispatcher& operator=(const Dispatcher&);
+	};
+
+	/*! @brief Copying a receiver is not supported. */
+	LinuxInputStreamReceiver(const LinuxInputStreamReceiver&);
+
+	/*! @brief Copying a receiver is not supported. */
+	LinuxInputStreamReceiver& operator=(const LinuxInputStreamReceiver&);
+
+	/*!
+	 * @brief
+	 *     Closes the connection and releases what the sender held.
+	 */
+	void disconnect(const Timestamp now);
+
+	/*! @brief The size of the receive buffer, enough for two whole packets. */
+	enum { BUFFER_SIZE = 2 * EventPacketWriter::MAX_PACKET_SIZE };
+
+	/*! @brief The listening socket. */
+	int listener;
+
+	/*! @brief The connected socket or -1. */
+	int connection;
+
+	/*! @brief The path of the socket file of a unix address, to remove it again. */
+	std::string path;
+
+	/*! @brief The bytes received that do not form a whole packet yet. */
+	unsigned char buffer[BUFFER_SIZE];
+
+	/*! @brief The number of bytes in the buffer. */
+	unsigned int buffered;
+
+	/*! @brief Decodes the packets. */
+	EventPacketReader reader;
+
+	/*! @brief Routes the events. */
+	Dispatcher dispatcher;
+
+	/*! @brief The mouse driven by the stream. */
+	VirtualMouse mouse;
+
+	/*! @brief The keyboard driven by the stream. */
+	VirtualKeyboard keyboard;
+};
+
+} // namespace I43D
+#endif  // _I43D_LINUX_INPUT_STREAM_H_
@@ -0,0 +1,121 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+#ifndef _I43D_LINUX_SCRIPT_RUNNER_H_
+#define _I43D_LINUX_SCRIPT_RUNNER_H_
+
+#include "I43DAtomic.h"
+#include "I43DInputScript.h"
+#include "I43DThreading.h"
+#include <vector>
+
+/*!
+ * @file
+ *     This file contains the runner that plays many input script bots on a few threads,
+ *     timed by Linux timer file descriptors.
+ * @author Robert Eugene Simmons Jr. (Kraythe)
+ */
+
+namespace I43D {
+
+// ---- Forward Declarations
+class _DLL_EXPORT LinuxScriptRunner;
+
+/*!
+ * @brief
+ *     Plays ScriptBot objects on a small number of threads.
+ * @remarks
+ *     Each thread owns a TimerWheel and a timerfd. The timerfd is armed with the absolute
+ *     time of the earliest deadline on the wheel, so a thread sleeps in the kernel until 
+ *     exactly the moment the next bot is due, however many bots it serves, and the timer 
+ *     slack of the threads is reduced to keep wakeups well under a millisecond late. 
+ *     Bots are dealt to the threads in turn. A bot, its devices and their listeners are
+ *     only ever called on the thread the bot was dealt to.
+ *     <br><br>
+ *     Stop the runner before destroying any bot it plays.
+ */
+class _DLL_EXPORT LinuxScriptRunner {
+public:
+	/*!
+	 * @brief
+	 *     Constructor. Starts the threads.
+	 * @param threadCount
+	 *     The number of threads, or 0 for one per hardware thread.
+	 * @param resolution
+	 *     The tick of the wheels in microseconds. It only affects how the bots are stored;
+	 *     they always run at their exact deadlines.
+	 */
+	explicit LinuxScriptRunner(const unsigned int threadCount = 0, 
+	                           const Timestamp resolution = 250);
+
+	/*!
+	 * @brief
+	 *     Destructor. Stops the threads.
+	 */
+	~LinuxScriptRunner();
+
+	/*!
+	 * @brief
+	 *     Starts a bot on one of the threads. Safe on any thread.
+	 * @param bot
+	 *     The bot. It must not be playing already.
+	 * @param startTime
+	 *     The time of its first step on the input clock.
+	 */
+	void addBot(ScriptBot* bot, const Timestamp startTime);
+
+	/*!
+	 * @brief
+	 *     Stops the threads. Bots still playing are cancelled where they are.
+	 */
+	void stop();
+
+	/*!
+	 * @brief
+	 *     Gets the number of threads.
+	 */
+	inline unsigned int getThreadCount() const {
+		return static_cast<unsigned int>(this->lanes.size());
+	}
+
+	/*!
+	 * @brief
+	 *     Gets the number of bots that have not finished their script, as of the last 
+	 *     wakeup of each thread.
+	 */
+	unsigned int getActiveBotCount() const;
+
+private:
+	/*! @brief Copying a runner is not supported. */
+	LinuxScriptRunner(const LinuxScriptRunner&);
+
+	/*! @brief Copying a runner is not supported. */
+	LinuxScriptRunner& operator=(const LinuxScriptRunner&);
+
+	class Lane;
+
+	/*! @brief The threads with their wheels. */
+	std::vector<Lane*> lanes;
+
+	/*! @brief The thread the next bot is dealt to. */
+	volatile unsigned int nextLane;
+};
+
+} // namespace I43D
+#endif  // _I43D_LINUX_SCRIPT_RUNNER_H_
@@ -0,0 +1,274 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+#ifndef _I43D_LINUX_SHARED_INPUT_H_
+#define _I43D_LINUX_SHARED_INPUT_H_
+
+#include "I43DSeat.h"
+#include <string>
+
+/*!
+ * @file
+ *     This file contains the classes that broadcast input from one process to others 
+ *     through POSIX shared memory.
+ * @author Robert Eugene Simmons Jr. (Kraythe)
+ */
+
+namespace I43D {
+
+// ---- Forward Declarations
+struct _DLL_EXPORT SharedInputHeader;
+class _DLL_EXPORT LinuxSharedInputPublisher;
+class _DLL_EXPORT LinuxSharedInputReader;
+
+/*!
+ * @brief
+ *     The start of a shared input segment. The events follow it.
+ * @remarks
+ *     The publisher never waits for readers: the count of published events only grows, 
+ *     each reader keeps its own position in its own memory and a reader that falls more 
+ *     than the capacity behind loses the oldest events. The state is a sequence lock 
+ *     snapshot like the one of a seat.
+ */
+struct _DLL_EXPORT SharedInputHeader {
+	/*! @brief The size of a cache line, used to keep the fields apart. */
+	enum { CACHE_LINE = 64 };
+
+	/*! @brief Identifies a shared input segment. */
+	unsigned int magic;
+
+	/*! @brief The version of the layout. */
+	unsigned int version;
+
+	/*! @brief The size of an event, to catch readers built differently. */
+	unsigned int eventSize;
+
+	/*! @brief The size of the state, to catch readers built differently. */
+	unsigned int stateSize;
+
+	/*! @brief The number of events in the ring, a power of two. */
+	unsigned int capacity;
+
+	/*! @brief Set when the publisher has gone away. */
+	volatile unsigned int closed;
+
+	/*! @brief Keeps the count off the line of the fields above. */
+	char countPadding[CACHE_LINE];
+
+	/*! @brief The number of events published, wrapping around. */
+	volatile unsigned int count;
+
+	/*! @brief Keeps the state off the line of the count. */
+	char statePadding[CACHE_LINE];
+
+	/*! @brief Odd while the state is being written. */
+	volatile unsigned int sequence;
+
+	/*! @brief The state as of the latest event. */
+	SeatState state;
+};
+
+/*!
+ * @brief
+ *     Publishes input into a shared memory segment for other processes to read.
+ * @remarks
+ *     One process opens the devices and routes their events to the publisher, for example
+ *     with the translators in I43DEvent.h. Events must be pushed from a single thread.
+ *     Readers in other processes then see every event and the state of all devices 
+ *     without opening the devices themselves.
+ */
+class _DLL_EXPORT LinuxSharedInputPublisher : public InputEventSink {
+public:
+	/*!
+	 * @brief
+	 *     Constructor. Creates the segment, replacing any segment left with the same name.
+	 * @param name
+	 *     The name of the segment, starting with a slash, for example /i43d-input.
+	 * @param capacity
+	 *     The number of events the ring holds. Rounded up to a power of two.
+	 * @throws I43DException
+	 *     If the segment can not be created.
+	 */
+	LinuxSharedInputPublisher(const std::string& name, const unsigned int capacity = 4096);
+
+	/*!
+	 * @brief
+	 *     Destructor. Marks the segment closed and removes its name.
+	 */
+	virtual ~LinuxSharedInputPublisher();
+
+	/*!
+	 * @brief
+	 *     Publishes an event and brings the shared state up to date with it.
+	 * @return
+	 *     Always true; readers that fall behind lose events instead.
+	 */
+	virtual bool pushEvent(const InputEvent& event);
+
+private:
+	/*! @brief Copying a publisher is not supported. */
+	LinuxSharedInputPublisher(const LinuxSharedInputPublisher&);
+
+	/*! @brief Copying a publisher is not supported. */
+	LinuxSharedInputPublisher& operator=(const LinuxSharedInputPublisher&);
+
+	/*! @brief The name of the segment. */
+	const std::string name;
+
+	/*! @brief The mapped segment. */
+	SharedInputHeader* header;
+
+	/*! @brief The ring of events following the header. */
+	InputEvent* events;
+
+	/*! @brief The size of the mapping in bytes. */
+	size_t size;
+};
+
+/*!
+ * @brief
+ *     Reads the input a publisher in another process broadcasts.
+ * @remarks
+ *     The segment is mapped read only. Reading events and the state takes no system 
+ *     calls and takes no lock, so any number of readers can follow one publisher. Each 
+ *     reader starts with the events published after it attached. A reader must only be 
+ *     used from one thread.
+ */
+class _DLL_EXPORT LinuxSharedInputReader {
+public:
+	/*!
+	 * @brief
+	 *     Constructor. The reader starts detached; it reads no events and an empty state.
+	 */
+	LinuxSharedInputReader();
+
+	/*!
+	 * @brief
+	 *     Constructor. Attaches to a segment.
+	 * @param name
+	 *     The name the publisher was created with.
+	 * @throws I43DException
+	 *     If the segment does not exist or was published by an incompatible build. Builds 
+	 *     without exceptions report to the startup error handler and abort, so a publisher
+	 *     that may not be running yet is better attached to with open().
+	 */
+	explicit LinuxSharedInputReader(const std::string& name);
+
+	/*!
+	 * @brief
+	 *     Destructor. Detaches from the segment.
+	 */
+	~LinuxSharedInputReader();
+
+	/*!
+	 * @brief
+	 *     Attaches to a segment, detaching from the one attached to.
+	 * @param name
+	 *     The name the publisher was created with.
+	 * @return
+	 *     RESULT_SYSTEM_ERROR if the segment does not exist or can not be mapped, or 
+	 *     RESULT_INCOMPATIBLE if it is not set up yet or was published by an incompatible 
+	 *     build.
+	 */
+	ResultCode open(const std::string& name);
+
+	/*!
+	 * @brief
+	 *     Detaches from the segment.
+	 */
+	void close();
+
+	/*!
+	 * @brief
+	 *     Determines if the reader is attached to a segment.
+	 */
+	inline bool isOpen() const {
+		return this->header != 0;
+	}
+
+	/*!
+	 * @brief
+	 *     Reads the next event.
+	 * @param event
+	 *     Receives the event.
+	 * @return
+	 *     False if no event is pending.
+	 */
+	bool popEvent(InputEvent& event);
+
+	/*!
+	 * @brief
+	 *     Reads up to a number of pending events at once.
+	 * @param events
+	 *     Receives the events.
+	 * @param maxCount
+	 *     The number of events the array can hold.
+	 * @return
+	 *     The number of events read.
+	 */
+	unsigned int popEvents(InputEvent* events, const unsigned int maxCount);
+
+	/*!
+	 * @brief
+	 *     Copies the state of the devices as of the latest published event.
+	 */
+	void getState(SeatState& state) const;
+
+	/*!
+	 * @brief
+	 *     Gets the number of events this reader lost by falling behind.
+	 */
+	inline unsigned int getLostCount() const {
+		return this->lostCount;
+	}
+
+	/*!
+	 * @brief
+	 *     Determines if the publisher has gone away or the reader is not attached. Pending
+	 *     events can still be read.
+	 */
+	inline bool isClosed() const {
+		return this->header == 0 || atomicLoad(this->header->closed) != 0;
+	}
+
+private:
+	/*! @brief Copying a reader is not supported. */
+	LinuxSharedInputReader(const LinuxSharedInputReader&);
+
+	/*! @brief Copying a reader is not supported. */
+	LinuxSharedInputReader& operator=(const LinuxSharedInputReader&);
+
+	/*! @brief The mapped segment or NULL. */
+	const SharedInputHeader* header;
+
+	/*! @brief The ring of events following the header. */
+	const InputEvent* events;
+
+	/*! @brief The size of the mapping in bytes. */
+	size_t size;
+
+	/*! @brief The number of the next event to read. */
+	unsigned int position;
+
+	/*! @brief The number of events lost by falling behind. */
+	unsigned int lostCount;
+};
+
+} // namespace I43D
+#endif  // _I43D_LINUX_SHARED_INPUT_H_
@@ -0,0 +1,203 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+#ifndef _I43D_LINUX_TABLET_H_
+#define _I43D_LINUX_TABLET_H_
+
+#include "I43DTablet.h"
+#include <string>
+
+/*!
+ * @file
+ *     This file contains the headers for the Linux evdev implementation of I43D::Tablet.
+ * @author Robert Eugene Simmons Jr. (Kraythe)
+ */
+
+namespace I43D {
+
+/*!
+ * @brief
+ *     A graphics tablet read from an evdev device.
+ * @remarks
+ *     The device reports on the monotonic clock so samples carry the exact time the kernel
+ *     saw them on the input clock. Every report of the device becomes one sample.
+ */
+class _DLL_EXPORT LinuxTablet : public I43D::Tablet {
+public:
+	/*!
+	 * @brief
+	 *     Constructor. The tablet starts closed.
+	 */
+	LinuxTablet();
+
+	/*!
+	 * @brief
+	 *     Constructor. Opens the device.
+	 * @param path
+	 *     The path of the event device, for example /dev/input/event7.
+	 * @throws I43DException
+	 *     If the device can not be opened or does not report pressure. Builds without 
+	 *     exceptions report to the startup error handler and abort, so hot plugged 
+	 *     devices that may vanish are better opened with open().
+	 */
+	LinuxTablet(const std::string& path);
+
+	/*!
+	 * @brief
+	 *     Destructor. Closes the device.
+	 */
+	virtual ~LinuxTablet();
+
+	/*!
+	 * @brief
+	 *     Opens a device, closing the one that was open.
+	 * @param path
+	 *     The path of the event device, for example /dev/input/event7.
+	 * @return
+	 *     RESULT_SYSTEM_ERROR if the device can not be opened, which happens when it was 
+	 *     unplugged, or RESULT_INCOMPATIBLE if it does not report pressure.
+	 */
+	ResultCode open(const std::string& path);
+
+	/*!
+	 * @brief
+	 *     Closes the device. Updates do nothing until a device is opened again.
+	 */
+	void close();
+
+	/*!
+	 * @brief
+	 *     Determines if a device is open.
+	 */
+	inline bool isOpen() const {
+		return this->handle >= 0;
+	}
+
+	/*! @see I43D::Tablet::update(const Timestamp) */
+	virtual void update(const Timestamp now);
+
+	/*!
+	 * @brief
+	 *     Gets the descriptor of the device so it can be waited on with poll() or epoll.
+	 */
+	inline int getHandle() const {
+		return this->handle;
+	}
+
+private:
+	/*!
+	 * @brief
+	 *     The mapping of a device axis to the units of a pen sample.
+	 */
+	struct AxisRange {
+		/*! @brief The value that maps to 0. */
+		int origin;
+
+		/*! @brief The size of one unit of the device in sample units. */
+		float scale;
+
+		AxisRange() : origin(0), scale(1.0f) {}
+
+		inline float map(const int value) const {
+			return (value - this->origin) * this->scale;
+		}
+	};
+
+	/*! @brief Copying a device is not supported. */
+	LinuxTablet(const LinuxTablet&);
+
+	/*! @brief Copying a device is not supported. */
+	LinuxTablet& operator=(const LinuxTablet&);
+
+	/*!
+	 * @brief
+	 *     Reads a device axis that maps to a fraction of its range.
+	 */
+	void readRange(const unsigned int code, AxisRange& range);
+
+	/*!
+	 * @brief
+	 *     Reads a device axis that maps to an angle.
+	 * @param fullTurn
+	 *     Whether the axis covers a whole turn, as the barrel rotation does.
+	 */
+	void readAngle(const unsigned int code, const bool fullTurn, AxisRange& range);
+
+	/*!
+	 * @brief
+	 *     Reads the whole state of the pen from the device.
+	 * @remarks
+	 *     Used when the device is opened and after the kernel dropped events.
+	 */
+	void readState();
+
+	/*!
+	 * @brief
+	 *     Applies a key event to the pen.
+	 */
+	void setKey(const unsigned int code, const bool pressed);
+
+	/*!
+	 * @brief
+	 *     Applies an axis event to the pen.
+	 */
+	void setAxis(const unsigned int code, const int value);
+
+	/*! @brief The descriptor of the device or -1. */
+	int handle;
+
+	/*! @brief Whether events are discarded until the next report because some were dropped. */
+	bool dropping;
+
+	/*! @brief The tools in proximity, one bit per tool. */
+	unsigned int tools;
+
+	/*! @brief The horizontal axis. */
+	AxisRange xRange;
+
+	/*! @brief The vertical axis. */
+	AxisRange yRange;
+
+	/*! @brief The pressure axis. */
+	AxisRange pressureRange;
+
+	/*! @brief The horizontal tilt axis. */
+	AxisRange tiltXRange;
+
+	/*! @brief The vertical tilt axis. */
+	AxisRange tiltYRange;
+
+	/*! @brief The barrel rotation axis. */
+	AxisRange rotationRange;
+
+	/*! @brief The last x reported. The coordinates arrive separately. */
+	int lastX;
+
+	/*! @brief The last y reported. */
+	int lastY;
+
+	/*! @brief The last horizontal tilt reported. */
+	int lastTiltX;
+
+	/*! @brief The last vertical tilt reported. */
+	int lastTiltY;
+};
+
+} // namespace I43D
+#endif  // _I43D_LINUX_TABLET_H_
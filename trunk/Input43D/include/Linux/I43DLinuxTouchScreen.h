@@ -0,0 +1,199 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+#ifndef _I43D_LINUX_TOUCH_SCREEN_H_
+#define _I43D_LINUX_TOUCH_SCREEN_H_
+
+#include "I43DTouchScreen.h"
+#include <string>
+
+/*!
+ * @file
+ *     This file contains the headers for the Linux evdev implementation of 
+ *     I43D::TouchScreen.
+ * @author Robert Eugene Simmons Jr. (Kraythe)
+ */
+
+namespace I43D {
+
+/*!
+ * @brief
+ *     A touch screen read from an evdev device that speaks the multi-touch protocol B.
+ * @remarks
+ *     The device reports on the monotonic clock so contacts carry the exact time the 
+ *     kernel saw them on the input clock.
+ */
+class _DLL_EXPORT LinuxTouchScreen : public I43D::TouchScreen {
+public:
+	/*!
+	 * @brief
+	 *     Constructor. The touch screen starts closed.
+	 */
+	LinuxTouchScreen();
+
+	/*!
+	 * @brief
+	 *     Constructor. Opens the device.
+	 * @param path
+	 *     The path of the event device, for example /dev/input/event5.
+	 * @throws I43DException
+	 *     If the device can not be opened or does not report multi-touch slots. Builds 
+	 *     without exceptions report to the startup error handler and abort, so hot plugged
+	 *     devices that may vanish are better opened with open().
+	 */
+	LinuxTouchScreen(const std::string& path);
+
+	/*!
+	 * @brief
+	 *     Destructor. Closes the device.
+	 */
+	virtual ~LinuxTouchScreen();
+
+	/*!
+	 * @brief
+	 *     Opens a device, closing the one that was open.
+	 * @param path
+	 *     The path of the event device, for example /dev/input/event5.
+	 * @return
+	 *     RESULT_SYSTEM_ERROR if the device can not be opened, which happens when it was 
+	 *     unplugged, or RESULT_INCOMPATIBLE if it does not report multi-touch slots.
+	 */
+	ResultCode open(const std::string& path);
+
+	/*!
+	 * @brief
+	 *     Closes the device and lifts the contacts it held. Updates do nothing until a 
+	 *     device is opened again.
+	 */
+	void close();
+
+	/*!
+	 * @brief
+	 *     Determines if a device is open.
+	 */
+	inline bool isOpen() const {
+		return this->handle >= 0;
+	}
+
+	/*! @see I43D::TouchScreen:: */
+	virtual void update(const Timestamp now);
+
+	/*!
+	 * @brief
+	 *     Gets the descriptor of the device so it can be waited on with poll() or epoll.
+	 */
+	inline int getHandle() const {
+		return this->handle;
+	}
+
+private:
+	/*!
+	 * @brief
+	 *     The mapping of a device axis to a fraction of its range.
+	 */
+	struct AxisRange {
+		/*! @brief The smallest value the device reports. */
+		int minimum;
+
+		/*! @brief The reciprocal of the span of the values the device reports. */
+		float scale;
+
+		AxisRange() : minimum(0), scale(1.0f) {}
+
+		inline float map(const int value) const {
+			return (value - this->minimum) * this->scale;
+		}
+	};
+
+	/*! @brief Copying a device is not supported. */
+	LinuxTouchScreen(const LinuxTouchScreen&);
+
+	/*! @brief Copying a device is not supported. */
+	LinuxTouchScreen& operator=(const LinuxTouchScreen&);
+
+	/*!
+	 * @brief
+	 *     Reads the range of a device axis.
+	 */
+	void readRange(const unsigned int code, AxisRange& range);
+
+	/*!
+	 * @brief
+	 *     Lifts every contact after the kernel dropped events and the device could not 
+	 *     report its slots.
+	 */
+	void liftAll(const Timestamp time);
+
+	/*!
+	 * @brief
+	 *     Reads the value of an axis for every slot from the device.
+	 * @param code
+	 *     The ABS_MT_ code of the axis.
+	 * @param values
+	 *     Receives TouchContacts::MAX_SLOTS values. Slots the device does not have read -1.
+	 * @return
+	 *     False if the device does not report the axis.
+	 */
+	bool readSlotValues(const unsigned int code, int* values);
+
+	/*!
+	 * @brief
+	 *     Brings the contacts up to date with the slots of the device after the kernel 
+	 *     dropped events.
+	 * @return
+	 *     False if the device can not report its slots.
+	 */
+	bool readSlots(const Timestamp time);
+
+	/*! @brief The descriptor of the device or -1. */
+	int handle;
+
+	/*! @brief Whether events are discarded until the next frame because some were dropped. */
+	bool dropping;
+
+	/*! @brief The horizontal axis. */
+	AxisRange xRange;
+
+	/*! @brief The vertical axis. */
+	AxisRange yRange;
+
+	/*! @brief The pressure axis. */
+	AxisRange pressureRange;
+
+	/*! @brief The contact size axes. Sizes are measured in the units of the horizontal axis. */
+	float sizeScale;
+
+	/*! @brief The last x reported for each slot. The two coordinates arrive separately. */
+	int lastX[TouchContacts::MAX_SLOTS];
+
+	/*! @brief The last y reported for each slot. */
+	int lastY[TouchContacts::MAX_SLOTS];
+
+	/*! @brief The last major axis reported for each slot. */
+	int lastMajor[TouchContacts::MAX_SLOTS];
+
+	/*! @brief The last minor axis reported for each slot. */
+	int lastMinor[TouchContacts::MAX_SLOTS];
+
+	/*! @brief The selected slot. */
+	unsigned int currentSlot;
+};
+
+} // namespace I43D
+#endif  // _I43D_LINUX_TOUCH_SCREEN_H_
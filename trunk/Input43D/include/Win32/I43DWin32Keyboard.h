@@ -32,7 +32,7 @@ http://www.gnu.org/copyleft/lesser.txt.
 
 namespace I43D {
 
-class _DLL_EXPORT Win32Keyboard : public I43D::Keyboard {
+class _DLL_EXPORT Win32Keyboard I43D_FINAL : public I43D::Keyboard {
 public:
 	/*!
 	 * @brief
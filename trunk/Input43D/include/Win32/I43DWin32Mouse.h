@@ -35,7 +35,7 @@ namespace I43D {
  * @brief
  *     Implements the basis mouse system. 
  */
-class _DLL_EXPORT Win32Mouse : public I43D::Mouse {
+class _DLL_EXPORT Win32Mouse I43D_FINAL : public I43D::Mouse {
 public:
 	/*!
 	 * @brief
@@ -68,8 +68,8 @@ public:
 	virtual void setStandardCursor(const StandardCursorID cursorID);
 
 	/*! @see I43D::Mouse:: */
-	virtual void setCustomCursor(const void* cursorID) {
-		throw I43DException(L"Not Implemented in this class", __WFILE__, __LINE__);
+	virtual ResultCode setCustomCursor(const void* cursorID) {
+		return RESULT_NOT_IMPLEMENTED;
 	}
 
 	/*! @see I43D::Mouse:: */
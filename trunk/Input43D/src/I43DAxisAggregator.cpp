@@ -0,0 +1,61 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+
+#include "I43DAxisAggregator.h"
+
+namespace I43D {
+
+AxisAggregator::AxisAggregator(const unsigned int axisCount) {
+	this->setAxisCount(axisCount);
+}
+
+void AxisAggregator::setAxisCount(const unsigned int axisCount) {
+	this->first.assign(axisCount, 0);
+	this->last.assign(axisCount, 0);
+	this->minimum.assign(axisCount, 0);
+	this->maximum.assign(axisCount, 0);
+	this->sum.assign(axisCount, 0);
+	this->count.assign(axisCount, 0);
+}
+
+void AxisAggregator::beginFrame() {
+	const unsigned int axisCount = this->getAxisCount();
+	for (unsigned int axis = 0; axis < axisCount; ++axis) {
+		const int held = this->last[axis];
+		this->first[axis] = held;
+		this->minimum[axis] = held;
+		this->maximum[axis] = held;
+		this->sum[axis] = 0;
+		this->count[axis] = 0;
+	}
+}
+
+AxisSummary AxisAggregator::getSummary(const unsigned int axis) const {
+	AxisSummary summary;
+	summary.first = this->first[axis];
+	summary.last = this->last[axis];
+	summary.minimum = this->minimum[axis];
+	summary.maximum = this->maximum[axis];
+	summary.mean = this->getMean(axis);
+	summary.count = this->count[axis];
+	return summary;
+}
+
+} // namespace I43D
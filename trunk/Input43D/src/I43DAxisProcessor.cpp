@@ -0,0 +1,163 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+
+#include "I43DAxisProcessor.h"
+#include <cmath>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#	define I43D_AXIS_SSE2
+#	include <emmintrin.h>
+#endif
+
+namespace I43D {
+
+/*!
+ * @brief
+ *     Applies the deadzone and response curve to a single lane.
+ */
+static inline float shapeLane(const float deflection, const float pairedDeflection, 
+                              const float radial, const float deadzone, const float liveScale,
+                              const float curve) {
+	const float magnitude = sqrtf(deflection * deflection + 
+	                              radial * pairedDeflection * pairedDeflection);
+	if (magnitude <= 0.0f) {
+		return 0.0f;
+	}
+	float live = (magnitude - deadzone) * liveScale;
+	live = live < 0.0f ? 0.0f : (live > 1.0f ? 1.0f : live);
+	live += curve * (live * live * live - live);
+	return deflection * live / magnitude;
+}
+
+AxisProcessor::AxisProcessor(const unsigned int laneCount) : laneCount(0) {
+	this->setLaneCount(laneCount);
+}
+
+void AxisProcessor::setLaneCount(const unsigned int laneCount) {
+	// -- Pad to whole vectors. Padding lanes have no scale so they always read as zero.
+	const unsigned int padded = (laneCount + 3) & ~3u;
+	this->laneCount = laneCount;
+	this->center.assign(padded, 0.0f);
+	this->scale.assign(padded, 0.0f);
+	this->deadzone.assign(padded, 0.0f);
+	this->liveScale.assign(padded, 1.0f);
+	this->curve.assign(padded, 0.0f);
+	this->radial.assign(padded, 0.0f);
+	this->paired.assign(padded, 0);
+	this->deflection.assign(padded, 0.0f);
+	this->pairedDeflection.assign(padded, 0.0f);
+	const AxisSettings defaults;
+	for (unsigned int lane = 0; lane < laneCount; ++lane) {
+		this->setLane(lane, defaults, lane);
+	}
+}
+
+ResultCode AxisProcessor::setLane(const unsigned int lane, const AxisSettings& settings, 
+                                  const unsigned int pairedLane) {
+	if (lane >= this->laneCount) {
+		I43D_FAIL(RESULT_OUT_OF_RANGE, L"Lane out of range");
+	}
+	// -- The center is rounded to a raw position so an axis at rest reads as exactly zero and
+	// -- the shorter side sets the range so both extremes reach full deflection.
+	const double minimum = settings.minimum;
+	const double maximum = settings.maximum;
+	double center = minimum;
+	double range = maximum - minimum;
+	if (settings.centered) {
+		center = floor((minimum + maximum + 1.0) * 0.5);
+		range = maximum - center < center - minimum ? maximum - center : center - minimum;
+	}
+	this->center[lane] = static_cast<float>(center);
+	this->scale[lane] = range > 0.0 ? static_cast<float>(1.0 / range) : 0.0f;
+	this->deadzone[lane] = settings.deadzone;
+	const float live = settings.saturation - settings.deadzone;
+	this->liveScale[lane] = live > 0.0f ? 1.0f / live : 1.0e6f;
+	this->curve[lane] = settings.curve;
+	const bool isRadial = settings.shape == DEADZONE_RADIAL && pairedLane < this->laneCount && 
+	                      pairedLane != lane;
+	this->radial[lane] = isRadial ? 1.0f : 0.0f;
+	this->paired[lane] = isRadial ? pairedLane : lane;
+	return RESULT_OK;
+}
+
+void AxisProcessor::process(const int* raw, float* normalized) {
+	const unsigned int count = this->laneCount;
+	if (count == 0) {
+		return;
+	}
+	float* deflection = &this->deflection[0];
+	float* pairedDeflection = &this->pairedDeflection[0];
+	const float* center = &this->center[0];
+	const float* scale = &this->scale[0];
+	const float* deadzone = &this->deadzone[0];
+	const float* liveScale = &this->liveScale[0];
+	const float* curve = &this->curve[0];
+	const float* radial = &this->radial[0];
+	unsigned int lane = 0;
+
+	// -- Pass 1: map the raw positions to a unit deflection.
+#if defined( I43D_AXIS_SSE2 )
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 minusOne = _mm_set1_ps(-1.0f);
+	const __m128 zero = _mm_setzero_ps();
+	for (; lane + 4 <= count; lane += 4) {
+		__m128 value = _mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(raw + lane)));
+		value = _mm_mul_ps(_mm_sub_ps(value, _mm_loadu_ps(center + lane)), _mm_loadu_ps(scale + lane));
+		value = _mm_max_ps(_mm_min_ps(value, one), minusOne);
+		_mm_storeu_ps(deflection + lane, value);
+	}
+#endif
+	for (; lane < count; ++lane) {
+		float value = (static_cast<float>(raw[lane]) - center[lane]) * scale[lane];
+		deflection[lane] = value < -1.0f ? -1.0f : (value > 1.0f ? 1.0f : value);
+	}
+
+	// -- Pass 2: gather the deflection of the paired axes for the radial deadzones.
+	for (lane = 0; lane < count; ++lane) {
+		pairedDeflection[lane] = deflection[this->paired[lane]];
+	}
+
+	// -- Pass 3: apply the deadzones and response curves.
+	lane = 0;
+#if defined( I43D_AXIS_SSE2 )
+	for (; lane + 4 <= count; lane += 4) {
+		const __m128 value = _mm_loadu_ps(deflection + lane);
+		const __m128 pairedValue = _mm_loadu_ps(pairedDeflection + lane);
+		const __m128 magnitude = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(value, value), 
+			_mm_mul_ps(_mm_loadu_ps(radial + lane), _mm_mul_ps(pairedValue, pairedValue))));
+		__m128 live = _mm_mul_ps(_mm_sub_ps(magnitude, _mm_loadu_ps(deadzone + lane)), 
+		                         _mm_loadu_ps(liveScale + lane));
+		live = _mm_max_ps(_mm_min_ps(live, one), zero);
+		const __m128 cube = _mm_mul_ps(live, _mm_mul_ps(live, live));
+		live = _mm_add_ps(live, _mm_mul_ps(_mm_loadu_ps(curve + lane), _mm_sub_ps(cube, live)));
+		// -- Lanes at rest would divide by zero so they are masked to zero.
+		const __m128 moving = _mm_cmpgt_ps(magnitude, zero);
+		const __m128 result = _mm_div_ps(_mm_mul_ps(value, live), _mm_or_ps(magnitude, 
+		                                 _mm_andnot_ps(moving, one)));
+		_mm_storeu_ps(normalized + lane, _mm_and_ps(result, moving));
+	}
+#endif
+	for (; lane < count; ++lane) {
+		normalized[lane] = shapeLane(deflection[lane], pairedDeflection[lane], radial[lane], 
+		                             deadzone[lane], liveScale[lane], curve[lane]);
+	}
+}
+
+} // namespace I43D
@@ -0,0 +1,44 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+#include "I43DCommon.h"
+#include <cstdlib>
+
+namespace I43D {
+
+namespace {
+
+/*! @brief The handler told about failed constructors. */
+StartupErrorHandler startupErrorHandler = 0;
+
+} // namespace
+
+void setStartupErrorHandler(StartupErrorHandler handler) {
+	startupErrorHandler = handler;
+}
+
+void failStartup(const ResultCode code, const wchar_t* detail, const wchar_t* file, 
+                 const unsigned int line) {
+	if (startupErrorHandler != 0) {
+		startupErrorHandler(code, detail, file, line);
+	}
+	std::abort();
+}
+
+} // namespace I43D
@@ -0,0 +1,639 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+
+#include "I43DComposeTable.h"
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <map>
+
+namespace I43D {
+
+namespace {
+
+/*! @brief Identifies a compose table cache file. Reads 'I43C' on little endian machines. */
+const unsigned int CACHE_MAGIC = 0x43333449;
+
+/*! @brief The version of the cache file layout. */
+const unsigned int CACHE_VERSION = 1;
+
+/*! @brief The number of 32 bit words in the cache file header. */
+const unsigned int HEADER_WORDS = 8;
+
+/*! @brief The position of each field in the cache file header. */
+enum HeaderField {
+	HEADER_MAGIC, HEADER_VERSION, HEADER_SOURCE_SIZE, HEADER_SOURCE_TIME,
+	HEADER_NODE_COUNT, HEADER_EDGE_COUNT, HEADER_POOL_LENGTH, HEADER_SKIPPED_LINES
+};
+
+/*! @brief A keysym name and its value. */
+struct KeysymName {
+	const char* name;
+	ComposeSymbol symbol;
+};
+
+/*! @brief The keysyms that are not characters as well as aliases of character names. */
+const KeysymName SPECIAL_NAMES[] = {
+	{ "Multi_key", COMPOSE_KEYSYM_FLAG | 0xFF20 },
+	{ "dead_grave", COMPOSE_KEYSYM_FLAG | 0xFE50 },
+	{ "dead_acute", COMPOSE_KEYSYM_FLAG | 0xFE51 },
+	{ "dead_circumflex", COMPOSE_KEYSYM_FLAG | 0xFE52 },
+	{ "dead_tilde", COMPOSE_KEYSYM_FLAG | 0xFE53 },
+	{ "dead_perispomeni", COMPOSE_KEYSYM_FLAG | 0xFE53 },
+	{ "dead_macron", COMPOSE_KEYSYM_FLAG | 0xFE54 },
+	{ "dead_breve", COMPOSE_KEYSYM_FLAG | 0xFE55 },
+	{ "dead_abovedot", COMPOSE_KEYSYM_FLAG | 0xFE56 },
+	{ "dead_diaeresis", COMPOSE_KEYSYM_FLAG | 0xFE57 },
+	{ "dead_abovering", COMPOSE_KEYSYM_FLAG | 0xFE58 },
+	{ "dead_doubleacute", COMPOSE_KEYSYM_FLAG | 0xFE59 },
+	{ "dead_caron", COMPOSE_KEYSYM_FLAG | 0xFE5A },
+	{ "dead_cedilla", COMPOSE_KEYSYM_FLAG | 0xFE5B },
+	{ "dead_ogonek", COMPOSE_KEYSYM_FLAG | 0xFE5C },
+	{ "dead_iota", COMPOSE_KEYSYM_FLAG | 0xFE5D },
+	{ "dead_voiced_sound", COMPOSE_KEYSYM_FLAG | 0xFE5E },
+	{ "dead_semivoiced_sound", COMPOSE_KEYSYM_FLAG | 0xFE5F },
+	{ "dead_belowdot", COMPOSE_KEYSYM_FLAG | 0xFE60 },
+	{ "dead_hook", COMPOSE_KEYSYM_FLAG | 0xFE61 },
+	{ "dead_horn", COMPOSE_KEYSYM_FLAG | 0xFE62 },
+	{ "dead_stroke", COMPOSE_KEYSYM_FLAG | 0xFE63 },
+	{ "dead_abovecomma", COMPOSE_KEYSYM_FLAG | 0xFE64 },
+	{ "dead_psili", COMPOSE_KEYSYM_FLAG | 0xFE64 },
+	{ "dead_abovereversedcomma", COMPOSE_KEYSYM_FLAG | 0xFE65 },
+	{ "dead_dasia", COMPOSE_KEYSYM_FLAG | 0xFE65 },
+	{ "dead_doublegrave", COMPOSE_KEYSYM_FLAG | 0xFE66 },
+	{ "dead_belowring", COMPOSE_KEYSYM_FLAG | 0xFE67 },
+	{ "dead_belowmacron", COMPOSE_KEYSYM_FLAG | 0xFE68 },
+	{ "dead_belowcircumflex", COMPOSE_KEYSYM_FLAG | 0xFE69 },
+	{ "dead_belowtilde", COMPOSE_KEYSYM_FLAG | 0xFE6A },
+	{ "dead_belowbreve", COMPOSE_KEYSYM_FLAG | 0xFE6B },
+	{ "dead_belowdiaeresis", COMPOSE_KEYSYM_FLAG | 0xFE6C },
+	{ "dead_invertedbreve", COMPOSE_KEYSYM_FLAG | 0xFE6D },
+	{ "dead_belowcomma", COMPOSE_KEYSYM_FLAG | 0xFE6E },
+	{ "dead_currency", COMPOSE_KEYSYM_FLAG | 0xFE6F },
+	{ "dead_a", COMPOSE_KEYSYM_FLAG | 0xFE80 },
+	{ "dead_A", COMPOSE_KEYSYM_FLAG | 0xFE81 },
+	{ "dead_e", COMPOSE_KEYSYM_FLAG | 0xFE82 },
+	{ "dead_E", COMPOSE_KEYSYM_FLAG | 0xFE83 },
+	{ "dead_i", COMPOSE_KEYSYM_FLAG | 0xFE84 },
+	{ "dead_I", COMPOSE_KEYSYM_FLAG | 0xFE85 },
+	{ "dead_o", COMPOSE_KEYSYM_FLAG | 0xFE86 },
+	{ "dead_O", COMPOSE_KEYSYM_FLAG | 0xFE87 },
+	{ "dead_u", COMPOSE_KEYSYM_FLAG | 0xFE88 },
+	{ "dead_U", COMPOSE_KEYSYM_FLAG | 0xFE89 },
+	{ "dead_small_schwa", COMPOSE_KEYSYM_FLAG | 0xFE8A },
+	{ "dead_capital_schwa", COMPOSE_KEYSYM_FLAG | 0xFE8B },
+	{ "dead_greek", COMPOSE_KEYSYM_FLAG | 0xFE8C },
+	{ "quoteright", 0x27 },
+	{ "quoteleft", 0x60 },
+	{ "guillemetleft", 0xAB },
+	{ "ordmasculine", 0xBA },
+	{ "guillemetright", 0xBB },
+	{ "Eth", 0xD0 },
+	{ "Ooblique", 0xD8 },
+	{ "Thorn", 0xDE },
+	{ "ooblique", 0xF8 }
+};
+
+/*! @brief The keysym names of the printable ASCII characters from space to tilde. */
+const char* const ASCII_NAMES[] = {
+	"space", "exclam", "quotedbl", "numbersign", "dollar", "percent", "ampersand", 
+	"apostrophe", "parenleft", "parenright", "asterisk", "plus", "comma", "minus", "period",
+	"slash", 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, "colon", "semicolon", "less", "equal", "greater",
+	"question", "at", 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+	0, 0, "bracketleft", "backslash", "bracketright", "asciicircum", "underscore", "grave", 
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	"braceleft", "bar", "braceright", "asciitilde"
+};
+
+/*! 
+ * @brief 
+ *     The keysym names of the Latin-1 characters from U+00A0 to U+00DF. The names of the
+ *     lower case letters that follow are the same names in lower case.
+ */
+const char* const LATIN1_NAMES[] = {
+	"nobreakspace", "exclamdown", "cent", "sterling", "currency", "yen", "brokenbar", 
+	"section", "diaeresis", "copyright", "ordfeminine", "guillemotleft", "notsign", "hyphen", 
+	"registered", "macron", "degree", "plusminus", "twosuperior", "threesuperior", "acute", 
+	"mu", "paragraph", "periodcentered", "cedilla", "onesuperior", "masculine", 
+	"guillemotright", "onequarter", "onehalf", "threequarters", "questiondown", "Agrave", 
+	"Aacute", "Acircumflex", "Atilde", "Adiaeresis", "Aring", "AE", "Ccedilla", "Egrave", 
+	"Eacute", "Ecircumflex", "Ediaeresis", "Igrave", "Iacute", "Icircumflex", "Idiaeresis", 
+	"ETH", "Ntilde", "Ograve", "Oacute", "Ocircumflex", "Otilde", "Odiaeresis", "multiply", 
+	"Oslash", "Ugrave", "Uacute", "Ucircumflex", "Udiaeresis", "Yacute", "THORN", "ssharp"
+};
+
+/*!
+ * @brief
+ *     Parses a hexadecimal number.
+ * @return
+ *     False if the text is empty, too long or contains a character that is not a hex digit.
+ */
+bool parseHex(const std::string& text, const size_t start, unsigned int& value) {
+	if (start >= text.size() || text.size() - start > 8) {
+		return false;
+	}
+	value = 0;
+	for (size_t idx = start; idx < text.size(); ++idx) {
+		const char c = text[idx];
+		value <<= 4;
+		if (c >= '0' && c <= '9') {
+			value |= c - '0';
+		} else if (c >= 'a' && c <= 'f') {
+			value |= c - 'a' + 10;
+		} else if (c >= 'A' && c <= 'F') {
+			value |= c - 'A' + 10;
+		} else {
+			return false;
+		}
+	}
+	return true;
+}
+
+/*!
+ * @brief
+ *     Decodes UTF-8 text into code points. Malformed sequences become U+FFFD.
+ */
+void decodeUtf8(const std::string& text, std::vector<UnicodeChar>& out) {
+	size_t idx = 0;
+	while (idx < text.size()) {
+		const unsigned char lead = static_cast<unsigned char>(text[idx]);
+		unsigned int extra = 0;
+		UnicodeChar cp = lead;
+		if (lead >= 0xF0 && lead < 0xF8) {
+			extra = 3;
+			cp = lead & 0x07;
+		} else if (lead >= 0xE0) {
+			extra = 2;
+			cp = lead & 0x0F;
+		} else if (lead >= 0xC0) {
+			extra = 1;
+			cp = lead & 0x1F;
+		} else if (lead >= 0x80) {
+			out.push_back(0xFFFD);
+			++idx;
+			continue;
+		}
+		++idx;
+		for (unsigned int count = 0; count < extra; ++count, ++idx) {
+			if (idx >= text.size() || (static_cast<unsigned char>(text[idx]) & 0xC0) != 0x80) {
+				cp = 0xFFFD;
+				break;
+			}
+			cp = (cp << 6) | (static_cast<unsigned char>(text[idx]) & 0x3F);
+		}
+		out.push_back(cp);
+	}
+}
+
+/*!
+ * @brief
+ *     A node of the trie while it is being built.
+ */
+struct BuildNode {
+	/*! @brief The children of the node keyed and sorted by symbol. */
+	std::map<ComposeSymbol, unsigned int> children;
+
+	/*! @brief The composed characters. */
+	std::vector<UnicodeChar> result;
+
+	/*! @brief Whether a sequence ends at the node. */
+	bool terminal;
+
+	BuildNode() : terminal(false) {}
+};
+
+/*!
+ * @brief
+ *     Parses one line of an X11 Compose file into the trie.
+ * @return
+ *     False if the line holds something that could not be used.
+ */
+bool parseLine(const std::string& line, std::vector<BuildNode>& trie) {
+	size_t pos = 0;
+	const size_t end = line.size();
+	std::vector<ComposeSymbol> sequence;
+	while (pos < end) {
+		while (pos < end && (line[pos] == ' ' || line[pos] == '\t')) {
+			++pos;
+		}
+		if (pos >= end || line[pos] != '<') {
+			break;
+		}
+		const size_t close = line.find('>', pos);
+		if (close == std::string::npos) {
+			return false;
+		}
+		ComposeSymbol symbol;
+		if (ComposeTable::lookupSymbolName(line.substr(pos + 1, close - pos - 1), symbol) == false) {
+			return false;
+		}
+		sequence.push_back(symbol);
+		pos = close + 1;
+	}
+	if (sequence.empty() || pos >= end || line[pos] != ':') {
+		return false;
+	}
+	++pos;
+	while (pos < end && (line[pos] == ' ' || line[pos] == '\t')) {
+		++pos;
+	}
+
+	// -- The result is a quoted string, optionally followed by a keysym, or only a keysym.
+	std::vector<UnicodeChar> result;
+	if (pos < end && line[pos] == '"') {
+		std::string bytes;
+		for (++pos; pos < end && line[pos] != '"'; ++pos) {
+			if (line[pos] != '\\' || pos + 1 >= end) {
+				bytes += line[pos];
+				continue;
+			}
+			const char escaped = line[++pos];
+			if (escaped == 'x' || escaped == 'X') {
+				unsigned int value = 0;
+				unsigned int digit;
+				for (size_t digits = 0; digits < 2 && pos + 1 < end 
+				     && parseHex(line.substr(pos + 1, 1), 0, digit); ++digits, ++pos) {
+					value = (value << 4) | digit;
+				}
+				bytes += static_cast<char>(value);
+			} else if (escaped >= '0' && escaped <= '7') {
+				unsigned int value = escaped - '0';
+				for (size_t digits = 1; digits < 3 && pos + 1 < end && line[pos + 1] >= '0' 
+				     && line[pos + 1] <= '7'; ++digits) {
+					value = (value << 3) | (line[++pos] - '0');
+				}
+				bytes += static_cast<char>(value);
+			} else {
+				bytes += escaped;
+			}
+		}
+		if (pos >= end) {
+			return false;
+		}
+		decodeUtf8(bytes, result);
+	} else {
+		size_t nameEnd = pos;
+		while (nameEnd < end && line[nameEnd] != ' ' && line[nameEnd] != '\t') {
+			++nameEnd;
+		}
+		ComposeSymbol symbol;
+		if (ComposeTable::lookupSymbolName(line.substr(pos, nameEnd - pos), symbol) == false 
+		    || (symbol & COMPOSE_KEYSYM_FLAG) != 0) {
+			return false;
+		}
+		result.push_back(symbol);
+	}
+
+	unsigned int node = 0;
+	for (size_t idx = 0; idx < sequence.size(); ++idx) {
+		std::map<ComposeSymbol, unsigned int>::iterator child = trie[node].children.find(sequence[idx]);
+		if (child == trie[node].children.end()) {
+			trie.push_back(BuildNode());
+			const unsigned int created = static_cast<unsigned int>(trie.size() - 1);
+			trie[node].children[sequence[idx]] = created;
+			node = created;
+		} else {
+			node = child->second;
+		}
+	}
+	trie[node].result = result;
+	trie[node].terminal = true;
+	return true;
+}
+
+} // anonymous namespace
+
+ComposeTable::ComposeTable() 
+	: nodes(0), edgeSymbols(0), edgeTargets(0), pool(0), nodeCount(0), edgeCount(0),
+	  poolLength(0), skippedLines(0) {
+}
+
+bool ComposeTable::open(const std::string& sourcePath, const std::string& cachePath) {
+	unsigned int sourceSize = 0;
+	unsigned int sourceTime = 0;
+	const bool haveSource = MappedFile::getFileStamp(sourcePath, sourceSize, sourceTime);
+	if (this->openCache(cachePath)) {
+		const unsigned int* header = static_cast<const unsigned int*>(this->cacheFile.getData());
+		if (haveSource == false || (header[HEADER_SOURCE_SIZE] == sourceSize 
+		                            && header[HEADER_SOURCE_TIME] == sourceTime)) {
+			return true;
+		}
+	}
+	return haveSource && this->compile(sourcePath, cachePath);
+}
+
+bool ComposeTable::openCache(const std::string& cachePath) {
+	this->image.clear();
+	if (this->cacheFile.open(cachePath) == false) {
+		return false;
+	}
+	if (this->attach(this->cacheFile.getData(), this->cacheFile.getSize()) == false) {
+		this->cacheFile.close();
+		return false;
+	}
+	return true;
+}
+
+bool ComposeTable::compile(const std::string& sourcePath, const std::string& cachePath) {
+	FILE* file = fopen(sourcePath.c_str(), "rb");
+	if (file == 0) {
+		return false;
+	}
+	std::string source;
+	char chunk[4096];
+	size_t count;
+	while ((count = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+		source.append(chunk, count);
+	}
+	fclose(file);
+
+	this->compileText(source.data(), source.size());
+	unsigned int sourceSize = 0;
+	unsigned int sourceTime = 0;
+	MappedFile::getFileStamp(sourcePath, sourceSize, sourceTime);
+	this->image[HEADER_SOURCE_SIZE] = sourceSize;
+	this->image[HEADER_SOURCE_TIME] = sourceTime;
+
+	if (cachePath.empty() == false && 
+	    MappedFile::writeFile(cachePath, &this->image[0], this->image.size() * sizeof(unsigned int))) {
+		// -- Prefer the mapping so the memory is shared with other processes.
+		std::vector<unsigned int> built;
+		built.swap(this->image);
+		if (this->openCache(cachePath)) {
+			return true;
+		}
+		this->image.swap(built);
+	}
+	this->attach(&this->image[0], this->image.size() * sizeof(unsigned int));
+	return true;
+}
+
+void ComposeTable::compileText(const char* source, const size_t length) {
+	this->cacheFile.close();
+	std::vector<BuildNode> trie(1);
+	unsigned int skipped = 0;
+
+	size_t lineStart = 0;
+	while (lineStart < length) {
+		size_t lineEnd = lineStart;
+		while (lineEnd < length && source[lineEnd] != '\n') {
+			++lineEnd;
+		}
+		std::string line(source + lineStart, lineEnd - lineStart);
+		lineStart = lineEnd + 1;
+
+		// -- Strip the comment, minding that # may appear inside the result string.
+		bool quoted = false;
+		for (size_t idx = 0; idx < line.size(); ++idx) {
+			if (line[idx] == '\\' && quoted) {
+				++idx;
+			} else if (line[idx] == '"') {
+				quoted = !quoted;
+			} else if (line[idx] == '#' && quoted == false) {
+				line.erase(idx);
+				break;
+			}
+		}
+		const size_t first = line.find_first_not_of(" \t\r");
+		if (first == std::string::npos) {
+			continue;
+		}
+		if (line.compare(first, 7, "include") == 0 || parseLine(line, trie) == false) {
+			++skipped;
+		}
+	}
+
+	// -- Flatten the trie breadth first so the edges of each node are contiguous. The
+	// -- children of a node are already sorted by symbol because they are kept in a map.
+	std::vector<unsigned int> order(1, 0);
+	std::vector<unsigned int> flatIndex(trie.size(), 0);
+	for (size_t idx = 0; idx < order.size(); ++idx) {
+		std::map<ComposeSymbol, unsigned int>::const_iterator child;
+		for (child = trie[order[idx]].children.begin(); child != trie[order[idx]].children.end(); ++child) {
+			flatIndex[child->second] = static_cast<unsigned int>(order.size());
+			order.push_back(child->second);
+		}
+	}
+	unsigned int totalEdges = 0;
+	unsigned int totalPool = 0;
+	for (size_t idx = 0; idx < trie.size(); ++idx) {
+		totalEdges += static_cast<unsigned int>(trie[idx].children.size());
+		totalPool += static_cast<unsigned int>(trie[idx].result.size());
+	}
+	const unsigned int totalNodes = static_cast<unsigned int>(trie.size());
+
+	std::vector<unsigned int> built(HEADER_WORDS + totalNodes * 4 + totalEdges * 2 + totalPool, 0);
+	built[HEADER_MAGIC] = CACHE_MAGIC;
+	built[HEADER_VERSION] = CACHE_VERSION;
+	built[HEADER_NODE_COUNT] = totalNodes;
+	built[HEADER_EDGE_COUNT] = totalEdges;
+	built[HEADER_POOL_LENGTH] = totalPool;
+	built[HEADER_SKIPPED_LINES] = skipped;
+	unsigned int* nodeWords = &built[HEADER_WORDS];
+	unsigned int* symbolWords = nodeWords + totalNodes * 4;
+	unsigned int* targetWords = symbolWords + totalEdges;
+	unsigned int* poolWords = targetWords + totalEdges;
+	unsigned int edge = 0;
+	unsigned int poolUsed = 0;
+	for (size_t idx = 0; idx < order.size(); ++idx) {
+		const BuildNode& node = trie[order[idx]];
+		unsigned int* out = nodeWords + idx * 4;
+		out[0] = edge;
+		out[1] = static_cast<unsigned int>(node.children.size());
+		out[2] = poolUsed;
+		out[3] = static_cast<unsigned int>(node.result.size());
+		std::map<ComposeSymbol, unsigned int>::const_iterator child;
+		for (child = node.children.begin(); child != node.children.end(); ++child, ++edge) {
+			symbolWords[edge] = child->first;
+			targetWords[edge] = flatIndex[child->second];
+		}
+		for (size_t chr = 0; chr < node.result.size(); ++chr) {
+			poolWords[poolUsed++] = node.result[chr];
+		}
+	}
+
+	this->image.swap(built);
+	this->attach(&this->image[0], this->image.size() * sizeof(unsigned int));
+}
+
+bool ComposeTable::attach(const void* data, const size_t size) {
+	const unsigned int* words = static_cast<const unsigned int*>(data);
+	const size_t wordCount = size / sizeof(unsigned int);
+	if (wordCount < HEADER_WORDS || words[HEADER_MAGIC] != CACHE_MAGIC 
+	    || words[HEADER_VERSION] != CACHE_VERSION || words[HEADER_NODE_COUNT] == 0) {
+		return false;
+	}
+	// -- Counted in 64 bits so that huge counts in a corrupt header can not wrap around.
+	const unsigned long long needed = HEADER_WORDS 
+		+ static_cast<unsigned long long>(words[HEADER_NODE_COUNT]) * 4 
+		+ static_cast<unsigned long long>(words[HEADER_EDGE_COUNT]) * 2 + words[HEADER_POOL_LENGTH];
+	if (needed > wordCount) {
+		return false;
+	}
+	const unsigned int totalNodes = words[HEADER_NODE_COUNT];
+	const unsigned int totalEdges = words[HEADER_EDGE_COUNT];
+	const unsigned int totalPool = words[HEADER_POOL_LENGTH];
+	const Node* const nodeTable = reinterpret_cast<const Node*>(words + HEADER_WORDS);
+	const unsigned int* const targets = words + HEADER_WORDS + totalNodes * 4 + totalEdges;
+
+	// -- The cache is only trusted by its stamp, so check every index once here instead of
+	// -- on each lookup. A corrupt cache is then recompiled like a stale one.
+	for (unsigned int idx = 0; idx < totalNodes; ++idx) {
+		const Node& node = nodeTable[idx];
+		if (static_cast<size_t>(node.firstEdge) + node.edgeCount > totalEdges 
+		    || static_cast<size_t>(node.resultOffset) + node.resultLength > totalPool) {
+			return false;
+		}
+	}
+	for (unsigned int idx = 0; idx < totalEdges; ++idx) {
+		if (targets[idx] == 0 || targets[idx] >= totalNodes) {
+			return false;
+		}
+	}
+
+	this->nodeCount = totalNodes;
+	this->edgeCount = totalEdges;
+	this->poolLength = totalPool;
+	this->skippedLines = words[HEADER_SKIPPED_LINES];
+	this->nodes = nodeTable;
+	this->edgeSymbols = words + HEADER_WORDS + this->nodeCount * 4;
+	this->edgeTargets = this->edgeSymbols + this->edgeCount;
+	this->pool = this->edgeTargets + this->edgeCount;
+	return true;
+}
+
+unsigned int ComposeTable::getSequenceCount() const {
+	unsigned int count = 0;
+	for (unsigned int idx = 0; idx < this->nodeCount; ++idx) {
+		if (this->nodes[idx].edgeCount == 0 && idx != 0) {
+			++count;
+		}
+	}
+	return count;
+}
+
+unsigned int ComposeTable::follow(const unsigned int node, const ComposeSymbol symbol) const {
+	const Node& current = this->nodes[node];
+	unsigned int low = current.firstEdge;
+	unsigned int high = current.firstEdge + current.edgeCount;
+	while (low < high) {
+		const unsigned int mid = low + (high - low) / 2;
+		if (this->edgeSymbols[mid] < symbol) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+	if (low < current.firstEdge + current.edgeCount && this->edgeSymbols[low] == symbol) {
+		return this->edgeTargets[low];
+	}
+	return 0;
+}
+
+bool ComposeTable::lookupSymbolName(const std::string& name, ComposeSymbol& symbol) {
+	if (name.size() == 1 && name[0] > ' ' && name[0] < 0x7F) {
+		symbol = static_cast<unsigned char>(name[0]);
+		return true;
+	}
+	unsigned int value;
+	if (name.size() > 1 && name[0] == 'U' && parseHex(name, 1, value)) {
+		symbol = value;
+		return value <= 0x10FFFF;
+	}
+	if (name.size() > 2 && name[0] == '0' && (name[1] == 'x' || name[1] == 'X') 
+	    && parseHex(name, 2, value)) {
+		// -- Keysyms 0x01000000 and up are unicode characters, those below 0x100 are Latin-1
+		// -- and everything else is a keysym that is not a character.
+		if (value >= 0x01000000 && value <= 0x0110FFFF) {
+			symbol = value - 0x01000000;
+		} else if (value < 0x100) {
+			symbol = value;
+		} else if (value < 0x10000) {
+			symbol = COMPOSE_KEYSYM_FLAG | value;
+		} else {
+			return false;
+		}
+		return true;
+	}
+	for (size_t idx = 0; idx < sizeof(SPECIAL_NAMES) / sizeof(SPECIAL_NAMES[0]); ++idx) {
+		if (name == SPECIAL_NAMES[idx].name) {
+			symbol = SPECIAL_NAMES[idx].symbol;
+			return true;
+		}
+	}
+	for (size_t idx = 0; idx < sizeof(ASCII_NAMES) / sizeof(ASCII_NAMES[0]); ++idx) {
+		if (ASCII_NAMES[idx] != 0 && name == ASCII_NAMES[idx]) {
+			symbol = static_cast<ComposeSymbol>(0x20 + idx);
+			return true;
+		}
+	}
+	for (size_t idx = 0; idx < sizeof(LATIN1_NAMES) / sizeof(LATIN1_NAMES[0]); ++idx) {
+		if (name == LATIN1_NAMES[idx]) {
+			symbol = static_cast<ComposeSymbol>(0xA0 + idx);
+			return true;
+		}
+		// -- The lower case letters share their names with the upper case letters. 
+		if (idx >= 0x20 && idx != 0x37 && idx != 0x3F && name.size() == strlen(LATIN1_NAMES[idx])) {
+			bool same = true;
+			for (size_t chr = 0; chr < name.size() && same; ++chr) {
+				same = name[chr] == static_cast<char>(tolower(LATIN1_NAMES[idx][chr]));
+			}
+			if (same) {
+				symbol = static_cast<ComposeSymbol>(0xC0 + idx);
+				return true;
+			}
+		}
+	}
+	if (name == "division") {
+		symbol = 0xF7;
+		return true;
+	}
+	if (name == "ydiaeresis") {
+		symbol = 0xFF;
+		return true;
+	}
+	return false;
+}
+
+ComposeResult ComposeState::feed(const ComposeSymbol symbol, const UnicodeChar*& text, 
+                                 unsigned int& length) {
+	if (this->table == 0 || this->table->nodeCount == 0) {
+		return COMPOSE_IGNORED;
+	}
+	const unsigned int next = this->table->follow(this->node, symbol);
+	if (next == 0) {
+		if (this->node == 0) {
+			return COMPOSE_IGNORED;
+		}
+		this->node = 0;
+		return COMPOSE_CANCELLED;
+	}
+	const ComposeTable::Node& reached = this->table->nodes[next];
+	if (reached.edgeCount > 0) {
+		this->node = next;
+		return COMPOSE_PENDING;
+	}
+	this->node = 0;
+	text = this->table->pool + reached.resultOffset;
+	length = reached.resultLength;
+	return COMPOSE_COMPLETE;
+}
+
+} // namespace I43D 
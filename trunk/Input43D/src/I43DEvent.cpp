@@ -0,0 +1,104 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+
+#include "I43DEvent.h"
+#include "I43DInstrumentation.h"
+
+namespace I43D {
+
+void KeyboardEventTranslator::keyPressed(const Keyboard* source, const unsigned short keyNum, 
+                                         const unsigned int scanCode) {
+	this->sink.pushEvent(makeInputEvent(getTimestamp(), this->device, IEVT_KEY_PRESSED, keyNum, 
+	                                    static_cast<int>(scanCode)));
+}
+
+void KeyboardEventTranslator::keyReleased(const Keyboard* source, const unsigned short keyNum, 
+                                          const unsigned int scanCode) {
+	this->sink.pushEvent(makeInputEvent(getTimestamp(), this->device, IEVT_KEY_RELEASED, keyNum, 
+	                                    static_cast<int>(scanCode)));
+}
+
+void KeyboardEventTranslator::keyRepeated(const Keyboard* source, const unsigned short keyNum, 
+                                          const unsigned int scanCode, 
+                                          const unsigned int repeatCount, const Timestamp time) {
+	this->sink.pushEvent(makeInputEvent(time, this->device, IEVT_KEY_REPEATED, keyNum, 
+	                                    static_cast<int>(scanCode), static_cast<int>(repeatCount)));
+}
+
+void KeyboardEventTranslator::textInput(const Keyboard* source, const TextInput& text) {
+	const Timestamp now = getTimestamp();
+	for (unsigned int idx = 0; idx < text.length; ++idx) {
+		this->sink.pushEvent(makeInputEvent(now, this->device, IEVT_CHAR_TYPED, 0, 
+		                                    static_cast<int>(text.utf32[idx])));
+	}
+}
+
+void MouseEventTranslator::moved(const Mouse* source, const unsigned int x, const unsigned int y) {
+	this->sink.pushEvent(makeInputEvent(getTimestamp(), this->device, IEVT_MOUSE_MOVED, 0, 
+	                                    static_cast<int>(x), static_cast<int>(y)));
+}
+
+void MouseEventTranslator::buttonPressed(const Mouse* source, const unsigned short buttonNum) {
+	this->sink.pushEvent(makeInputEvent(getTimestamp(), this->device, IEVT_MOUSE_BUTTON_PRESSED, 
+	                                    buttonNum));
+}
+
+void MouseEventTranslator::buttonReleased(const Mouse* source, const unsigned short buttonNum) {
+	this->sink.pushEvent(makeInputEvent(getTimestamp(), this->device, IEVT_MOUSE_BUTTON_RELEASED, 
+	                                    buttonNum));
+}
+
+void MouseEventTranslator::scrollUp(const Mouse* source, const MouseScrollDirection direction) {
+	this->sink.pushEvent(makeInputEvent(getTimestamp(), this->device, IEVT_MOUSE_SCROLLED, 
+	                                    static_cast<unsigned short>(direction)));
+}
+
+void GameControllerEventTranslator::buttonPressed(const GameController* source, 
+                                                  const unsigned short buttonNum) {
+	this->sink.pushEvent(makeInputEvent(getTimestamp(), this->device, 
+	                                    IEVT_CONTROLLER_BUTTON_PRESSED, buttonNum));
+}
+
+void GameControllerEventTranslator::buttonReleased(const GameController* source, 
+                                                   const unsigned short buttonNum) {
+	this->sink.pushEvent(makeInputEvent(getTimestamp(), this->device, 
+	                                    IEVT_CONTROLLER_BUTTON_RELEASED, buttonNum));
+}
+
+void GameControllerEventTranslator::axesChanged(const GameController* source, 
+                                                const ControllerState& state, 
+                                                const unsigned int changedAxes) {
+	for (unsigned short axis = 0; axis < ControllerState::MAX_AXES; ++axis) {
+		if ((changedAxes & (1u << axis)) != 0) {
+#if defined( I43D_INSTRUMENTATION )
+			// -- Every sample of the frame past the first is folded into this one event.
+			const unsigned int samples = source->getAxisSamples().getSummary(axis).count;
+			if (samples > 1) {
+				instrumentCoalesced(this->device, samples - 1);
+			}
+#endif
+			this->sink.pushEvent(makeInputEvent(state.time, this->device, 
+			                                    IEVT_CONTROLLER_AXIS_MOVED, axis, 
+			                                    state.raw[axis], state.getFixedAxis(axis)));
+		}
+	}
+}
+
+} // namespace I43D 
@@ -0,0 +1,230 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+
+#include "I43DEventCodec.h"
+#include <cstring>
+
+namespace I43D {
+
+namespace {
+
+/*! @brief The bits of the tag that hold the event type. There are fewer than 32 types. */
+const unsigned char TAG_TYPE_MASK = 0x1F;
+
+/*! @brief The tag bit set when the device differs from the previous event. */
+const unsigned char TAG_DEVICE = 0x20;
+
+/*! @brief The tag bit set when the first value changed. */
+const unsigned char TAG_VALUE = 0x40;
+
+/*! @brief The tag bit set when the second value changed. */
+const unsigned char TAG_VALUE2 = 0x80;
+
+/*!
+ * @brief
+ *     Writes a number little endian.
+ */
+inline void writeFixed(unsigned char* data, unsigned long long value, const unsigned int bytes) {
+	for (unsigned int idx = 0; idx < bytes; ++idx) {
+		data[idx] = static_cast<unsigned char>(value);
+		value >>= 8;
+	}
+}
+
+/*!
+ * @brief
+ *     Reads a little endian number.
+ */
+inline unsigned long long readFixed(const unsigned char* data, const unsigned int bytes) {
+	unsigned long long value = 0;
+	for (unsigned int idx = bytes; idx > 0; --idx) {
+		value = (value << 8) | data[idx - 1];
+	}
+	return value;
+}
+
+/*!
+ * @brief
+ *     Undoes the zigzag encoding of a signed number.
+ */
+inline long long decodeSigned(const unsigned long long value) {
+	return static_cast<long long>(value >> 1) ^ -static_cast<long long>(value & 1);
+}
+
+} // anonymous namespace
+
+EventPacketWriter::EventPacketWriter() : sequence(0) {
+	this->reset();
+}
+
+void EventPacketWriter::reset() {
+	this->size = HEADER_SIZE;
+	this->eventCount = 0;
+	++this->sequence;
+	this->lastTime = 0;
+	this->lastDevice = INVALID_DEVICE_ID;
+	memset(this->lastValue, 0, sizeof(this->lastValue));
+	memset(this->lastValue2, 0, sizeof(this->lastValue2));
+}
+
+void EventPacketWriter::writeVarint(unsigned long long value) {
+	while (value >= 0x80) {
+		this->buffer[this->size++] = static_cast<unsigned char>(value | 0x80);
+		value >>= 7;
+	}
+	this->buffer[this->size++] = static_cast<unsigned char>(value);
+}
+
+bool EventPacketWriter::addEvent(const InputEvent& event) {
+	if (this->size + MAX_EVENT_SIZE > MAX_PACKET_SIZE || event.type >= IEVT_COUNT) {
+		return false;
+	}
+	const unsigned int type = event.type;
+	unsigned char tag = static_cast<unsigned char>(type);
+	if (event.device != this->lastDevice) {
+		tag |= TAG_DEVICE;
+	}
+	if (event.value != this->lastValue[type]) {
+		tag |= TAG_VALUE;
+	}
+	if (event.value2 != this->lastValue2[type]) {
+		tag |= TAG_VALUE2;
+	}
+	this->buffer[this->size++] = tag;
+	if ((tag & TAG_DEVICE) != 0) {
+		this->writeVarint(event.device);
+	}
+	this->writeSigned(static_cast<long long>(event.time - this->lastTime));
+	this->writeVarint(event.code);
+	if ((tag & TAG_VALUE) != 0) {
+		this->writeSigned(static_cast<long long>(event.value) - this->lastValue[type]);
+	}
+	if ((tag & TAG_VALUE2) != 0) {
+		this->writeSigned(static_cast<long long>(event.value2) - this->lastValue2[type]);
+	}
+	this->lastTime = event.time;
+	this->lastDevice = event.device;
+	this->lastValue[type] = event.value;
+	this->lastValue2[type] = event.value2;
+	++this->eventCount;
+	return true;
+}
+
+const unsigned char* EventPacketWriter::finish(const Timestamp sendTime, unsigned int& size) {
+	writeFixed(this->buffer, this->size - 2, 2);
+	writeFixed(this->buffer + 2, this->sequence, 4);
+	writeFixed(this->buffer + 6, sendTime, 8);
+	size = this->size;
+	return this->buffer;
+}
+
+EventPacketReader::EventPacketReader() 
+	: sendTime(0), nextSequence(0), started(false), lostCount(0) {
+}
+
+bool EventPacketReader::readVarint(const unsigned char*& data, const unsigned char* end, 
+                                   unsigned long long& value) {
+	value = 0;
+	for (unsigned int shift = 0; shift < 64; shift += 7) {
+		if (data == end) {
+			return false;
+		}
+		const unsigned char byte = *data++;
+		value |= static_cast<unsigned long long>(byte & 0x7F) << shift;
+		if ((byte & 0x80) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void EventPacketReader::reset() {
+	this->sendTime = 0;
+	this->nextSequence = 0;
+	this->started = false;
+	this->lostCount = 0;
+}
+
+bool EventPacketReader::readPacket(const unsigned char* data, const unsigned int size, 
+                                   InputEventSink& sink) {
+	if (size < EventPacketWriter::HEADER_SIZE || getPacketSize(data) != size) {
+		return false;
+	}
+	const unsigned int sequence = static_cast<unsigned int>(readFixed(data + 2, 4));
+	if (this->started && sequence != this->nextSequence) {
+		this->lostCount += sequence - this->nextSequence;
+	}
+	this->started = true;
+	this->nextSequence = sequence + 1;
+	this->sendTime = readFixed(data + 6, 8);
+
+	Timestamp lastTime = 0;
+	DeviceID lastDevice = INVALID_DEVICE_ID;
+	int lastValue[IEVT_COUNT];
+	int lastValue2[IEVT_COUNT];
+	memset(lastValue, 0, sizeof(lastValue));
+	memset(lastValue2, 0, sizeof(lastValue2));
+	const unsigned char* end = data + size;
+	data += EventPacketWriter::HEADER_SIZE;
+	while (data < end) {
+		const unsigned char tag = *data++;
+		const unsigned int type = tag & TAG_TYPE_MASK;
+		unsigned long long value;
+		if (type >= IEVT_COUNT) {
+			return false;
+		}
+		if ((tag & TAG_DEVICE) != 0) {
+			if (this->readVarint(data, end, value) == false) {
+				return false;
+			}
+			lastDevice = static_cast<DeviceID>(value);
+		}
+		if (this->readVarint(data, end, value) == false) {
+			return false;
+		}
+		lastTime += static_cast<Timestamp>(decodeSigned(value));
+		InputEvent event;
+		event.time = lastTime;
+		event.device = lastDevice;
+		event.type = static_cast<unsigned short>(type);
+		if (this->readVarint(data, end, value) == false) {
+			return false;
+		}
+		event.code = static_cast<unsigned short>(value);
+		if ((tag & TAG_VALUE) != 0) {
+			if (this->readVarint(data, end, value) == false) {
+				return false;
+			}
+			lastValue[type] = static_cast<int>(lastValue[type] + decodeSigned(value));
+		}
+		if ((tag & TAG_VALUE2) != 0) {
+			if (this->readVarint(data, end, value) == false) {
+				return false;
+			}
+			lastValue2[type] = static_cast<int>(lastValue2[type] + decodeSigned(value));
+		}
+		event.value = lastValue[type];
+		event.value2 = lastValue2[type];
+		sink.pushEvent(event);
+	}
+	return true;
+}
+
+} // namespace I43D
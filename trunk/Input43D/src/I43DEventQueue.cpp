@@ -0,0 +1,296 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+
+#include "I43DEventQueue.h"
+#include "I43DInstrumentation.h"
+#include <cstring>
+
+namespace I43D {
+
+EventQueue::EventQueue(const unsigned int capacity) : head(0), tail(0), droppedCount(0), notifier(0) {
+	unsigned int rounded = 1;
+	while (rounded < capacity) {
+		rounded <<= 1;
+	}
+	this->events = new InputEvent[rounded];
+	this->mask = rounded - 1;
+	this->enqueueTimes = 0;
+	I43D_INSTRUMENT(this->enqueueTimes = new Timestamp[rounded]);
+}
+
+EventQueue::~EventQueue() {
+	delete[] this->events;
+	delete[] this->enqueueTimes;
+}
+
+bool EventQueue::pushEvent(const InputEvent& event) {
+	const unsigned int position = this->tail;
+	if (position - atomicLoad(this->head) > this->mask) {
+		atomicStore(this->droppedCount, this->droppedCount + 1);
+		I43D_INSTRUMENT(instrumentDropped(event.device));
+		return false;
+	}
+	this->events[position & this->mask] = event;
+#if defined( I43D_INSTRUMENTATION )
+	const Timestamp now = getTimestamp();
+	this->enqueueTimes[position & this->mask] = now;
+	instrumentEvent(event.device, event.time, now, position + 1 - atomicLoad(this->head));
+#endif
+	atomicStore(this->tail, position + 1);
+	if (this->notifier != 0) {
+		this->notifier->notify(event);
+	}
+	return true;
+}
+
+bool EventQueue::popEvent(InputEvent& event) {
+	const unsigned int position = this->head;
+	if (position == atomicLoad(this->tail)) {
+		return false;
+	}
+	event = this->events[position & this->mask];
+	I43D_INSTRUMENT(instrumentLatency(LATENCY_DISPATCH, 
+	                                  getTimestamp() - this->enqueueTimes[position & this->mask]));
+	atomicStore(this->head, position + 1);
+	return true;
+}
+
+unsigned int EventQueue::popEvents(InputEvent* events, const unsigned int maxCount) {
+	const unsigned int position = this->head;
+	unsigned int count = atomicLoad(this->tail) - position;
+	if (count > maxCount) {
+		count = maxCount;
+	}
+	for (unsigned int idx = 0; idx < count; ++idx) {
+		events[idx] = this->events[(position + idx) & this->mask];
+	}
+#if defined( I43D_INSTRUMENTATION )
+	const Timestamp now = getTimestamp();
+	for (unsigned int idx = 0; idx < count; ++idx) {
+		instrumentLatency(LATENCY_DISPATCH, now - this->enqueueTimes[(position + idx) & this->mask]);
+	}
+#endif
+	atomicStore(this->head, position + count);
+	return count;
+}
+
+PriorityEventQueue::PriorityEventQueue(const unsigned int motionCapacity, 
+                                       const unsigned int priorityCapacity) 
+	: nextSequence(0), defaultPolicy(OVERFLOW_DROP_NEWEST), waitingProducers(0), 
+	  notifier(0) {
+	const unsigned int capacities[LANE_COUNT] = { motionCapacity, priorityCapacity };
+	for (unsigned int lane = 0; lane < LANE_COUNT; ++lane) {
+		unsigned int rounded = 1;
+		while (rounded < capacities[lane]) {
+			rounded <<= 1;
+		}
+		Ring& ring = this->lanes[lane];
+		ring.slots = new Slot[rounded];
+		ring.capacity = rounded;
+		ring.head = 0;
+		ring.size = 0;
+		memset(&ring.counters, 0, sizeof(ring.counters));
+	}
+}
+
+PriorityEventQueue::~PriorityEventQueue() {
+	for (unsigned int lane = 0; lane < LANE_COUNT; ++lane) {
+		delete[] this->lanes[lane].slots;
+	}
+}
+
+PriorityEventQueue::Lane PriorityEventQueue::getLane(const InputEventType type) {
+	return type == IEVT_MOUSE_MOVED || type == IEVT_CONTROLLER_AXIS_MOVED ? 
+		LANE_MOTION : LANE_PRIORITY;
+}
+
+void PriorityEventQueue::setDefaultOverflowPolicy(const OverflowPolicy policy) {
+	ScopedLock guard(this->lock);
+	this->defaultPolicy = policy;
+}
+
+void PriorityEventQueue::setOverflowPolicy(const DeviceID device, const OverflowPolicy policy) {
+	ScopedLock guard(this->lock);
+	this->policies[device] = policy;
+}
+
+OverflowPolicy PriorityEventQueue::getOverflowPolicy(const DeviceID device) const {
+	ScopedLock guard(this->lock);
+	std::map<DeviceID, OverflowPolicy>::const_iterator found = this->policies.find(device);
+	return found != this->policies.end() ? found->second : this->defaultPolicy;
+}
+
+bool PriorityEventQueue::pushEvent(const InputEvent& event) {
+	ScopedLock guard(this->lock);
+	const Lane lane = getLane(static_cast<InputEventType>(event.type));
+	Ring& ring = this->lanes[lane];
+	if (ring.size == ring.capacity) {
+		// -- The priority lane never drops. Policies are only looked up on overflow.
+		OverflowPolicy policy = OVERFLOW_BLOCK;
+		if (lane == LANE_MOTION) {
+			std::map<DeviceID, OverflowPolicy>::const_iterator found = 
+				this->policies.find(event.device);
+			policy = found != this->policies.end() ? found->second : this->defaultPolicy;
+		}
+		switch (policy) {
+			case OVERFLOW_DROP_NEWEST:
+				++ring.counters.dropped;
+				I43D_INSTRUMENT(instrumentDropped(event.device));
+				return false;
+			case OVERFLOW_COALESCE:
+			case OVERFLOW_DROP_OLDEST:
+				if (policy == OVERFLOW_COALESCE && this->coalesce(ring, event)) {
+					++ring.counters.coalesced;
+					I43D_INSTRUMENT(instrumentCoalesced(event.device, 1));
+					return true;
+				}
+				// -- Coalescing with nothing to fold into makes room the same way.
+				I43D_INSTRUMENT(instrumentDropped(ring.slots[ring.head].event.device));
+				ring.head = (ring.head + 1) & (ring.capacity - 1);
+				--ring.size;
+				++ring.counters.dropped;
+				break;
+			case OVERFLOW_BLOCK:
+				++ring.counters.blocked;
+				++this->waitingProducers;
+				while (ring.size == ring.capacity) {
+					this->roomAvailable.wait(this->lock);
+				}
+				--this->waitingProducers;
+				break;
+		}
+	}
+	this->append(ring, event);
+	if (lane == LANE_PRIORITY) {
+		this->prioritySequences[event.device] = this->nextSequence - 1;
+	}
+	if (this->notifier != 0) {
+		this->notifier->notify(event);
+	}
+	return true;
+}
+
+bool PriorityEventQueue::popEvent(InputEvent& event) {
+	ScopedLock guard(this->lock);
+	if (this->take(event) == false) {
+		return false;
+	}
+	if (this->waitingProducers > 0) {
+		this->roomAvailable.broadcast();
+	}
+	return true;
+}
+
+unsigned int PriorityEventQueue::popEvents(InputEvent* events, const unsigned int maxCount) {
+	ScopedLock guard(this->lock);
+	unsigned int count = 0;
+	while (count < maxCount && this->take(events[count])) {
+		++count;
+	}
+	if (count > 0 && this->waitingProducers > 0) {
+		this->roomAvailable.broadcast();
+	}
+	return count;
+}
+
+unsigned int PriorityEventQueue::getSize(const Lane lane) const {
+	ScopedLock guard(this->lock);
+	return this->lanes[lane].size;
+}
+
+LaneCounters PriorityEventQueue::getCounters(const Lane lane) const {
+	ScopedLock guard(this->lock);
+	return this->lanes[lane].counters;
+}
+
+void PriorityEventQueue::resetCounters() {
+	ScopedLock guard(this->lock);
+	for (unsigned int lane = 0; lane < LANE_COUNT; ++lane) {
+		memset(&this->lanes[lane].counters, 0, sizeof(LaneCounters));
+	}
+}
+
+void PriorityEventQueue::append(Ring& ring, const InputEvent& event) {
+	Slot& slot = ring.slots[(ring.head + ring.size) & (ring.capacity - 1)];
+	slot.event = event;
+	slot.sequence = this->nextSequence++;
+	++ring.size;
+	if (ring.size > ring.counters.highWater) {
+		ring.counters.highWater = ring.size;
+	}
+}
+
+bool PriorityEventQueue::coalesce(Ring& ring, const InputEvent& event) {
+	// -- Motion of the device queued before one of its presses that is still queued must
+	// -- stay before it. A press already popped took everything before it along.
+	bool fenced = false;
+	unsigned int fence = 0;
+	const Ring& priority = this->lanes[LANE_PRIORITY];
+	std::map<DeviceID, unsigned int>::const_iterator found = 
+		this->prioritySequences.find(event.device);
+	if (found != this->prioritySequences.end() && priority.size > 0) {
+		const unsigned int oldest = priority.slots[priority.head].sequence;
+		fenced = found->second - oldest < this->nextSequence - oldest;
+		fence = found->second;
+	}
+
+	// -- Search from the newest event since the last sample of a device is usually near 
+	// -- the end. The sequence numbers wrap, so compare their difference.
+	for (unsigned int idx = ring.size; idx > 0; --idx) {
+		Slot& slot = ring.slots[(ring.head + idx - 1) & (ring.capacity - 1)];
+		if (fenced && static_cast<int>(slot.sequence - fence) < 0) {
+			break;
+		}
+		InputEvent& queued = slot.event;
+		if (queued.device == event.device && queued.type == event.type && 
+		    queued.code == event.code) {
+			queued.time = event.time;
+			queued.value = event.value;
+			queued.value2 = event.value2;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool PriorityEventQueue::take(InputEvent& event) {
+	Ring& motion = this->lanes[LANE_MOTION];
+	Ring& priority = this->lanes[LANE_PRIORITY];
+	Ring* ring = 0;
+	if (motion.size == 0) {
+		ring = &priority;
+	} else if (priority.size == 0) {
+		ring = &motion;
+	} else {
+		// -- The sequence numbers wrap, so compare their difference.
+		const int order = static_cast<int>(motion.slots[motion.head].sequence - 
+		                                   priority.slots[priority.head].sequence);
+		ring = order < 0 ? &motion : &priority;
+	}
+	if (ring->size == 0) {
+		return false;
+	}
+	event = ring->slots[ring->head].event;
+	ring->head = (ring->head + 1) & (ring->capacity - 1);
+	--ring->size;
+	return true;
+}
+
+} // namespace I43D 
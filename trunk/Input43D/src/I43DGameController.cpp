@@ -0,0 +1,163 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+
+#include "I43DGameController.h"
+#include "I43DInstrumentation.h"
+#include <algorithm>
+#include <cstring>
+
+namespace I43D {
+
+GameController::GameController() 
+	: samples(ControllerState::MAX_AXES), processor(ControllerState::MAX_AXES), settingsChanged(true) {
+	memset(&this->state, 0, sizeof(this->state));
+}
+
+GameController::~GameController() {
+}
+
+ResultCode GameController::setAxisSettings(const unsigned short axisNum, 
+                                           const AxisSettings& settings) {
+	if (axisNum >= ControllerState::MAX_AXES) {
+		I43D_FAIL(RESULT_OUT_OF_RANGE, L"Axis out of range");
+	}
+	this->settings[axisNum] = settings;
+	this->settingsChanged = true;
+	return RESULT_OK;
+}
+
+void GameController::update(const Timestamp now) {
+	this->samples.beginFrame();
+	this->poll(now);
+	if (this->settingsChanged) {
+		for (unsigned short axis = 0; axis < ControllerState::MAX_AXES; ++axis) {
+			this->processor.setLane(axis, this->settings[axis], this->settings[axis].pairedAxis);
+		}
+		this->settingsChanged = false;
+	}
+	float axes[ControllerState::MAX_AXES];
+	this->processor.process(this->state.raw, axes);
+	this->publishAxes(axes, now);
+}
+
+void GameController::publishAxes(const float* axes, const Timestamp now) {
+	unsigned int changedAxes = 0;
+	for (unsigned int axis = 0; axis < ControllerState::MAX_AXES; ++axis) {
+		if (axes[axis] != this->state.axes[axis]) {
+			changedAxes |= 1u << axis;
+			this->state.axes[axis] = axes[axis];
+		}
+	}
+	this->state.time = now;
+	if (changedAxes != 0) {
+		std::set<GameControllerListener*>::iterator iter;
+		for (iter = this->listeners.begin(); iter != this->listeners.end(); ++iter) {
+			I43D_TIME_LISTENER(*iter);
+			(*iter)->axesChanged(this, this->state, changedAxes);
+		}
+	}
+}
+
+void GameController::fireButtonPressed(const unsigned short buttonNum) {
+	if (buttonNum < 1 || buttonNum > ControllerState::MAX_BUTTONS || 
+	    this->state.isButtonPressed(buttonNum)) {
+		return;
+	}
+	this->state.buttons |= 1u << (buttonNum - 1);
+	std::set<GameControllerListener*>::iterator iter;
+	for (iter = this->listeners.begin(); iter != this->listeners.end(); ++iter) {
+		I43D_TIME_LISTENER(*iter);
+		(*iter)->buttonPressed(this, buttonNum);
+	}
+}
+
+void GameController::fireButtonReleased(const unsigned short buttonNum) {
+	if (this->state.isButtonPressed(buttonNum) == false) {
+		return;
+	}
+	this->state.buttons &= ~(1u << (buttonNum - 1));
+	std::set<GameControllerListener*>::iterator iter;
+	for (iter = this->listeners.begin(); iter != this->listeners.end(); ++iter) {
+		I43D_TIME_LISTENER(*iter);
+		(*iter)->buttonReleased(this, buttonNum);
+	}
+}
+
+GameControllerGroup::GameControllerGroup() : layoutChanged(true) {
+}
+
+void GameControllerGroup::addController(GameController* controller) {
+	if (std::find(this->controllers.begin(), this->controllers.end(), controller) == 
+	    this->controllers.end()) {
+		this->controllers.push_back(controller);
+		this->layoutChanged = true;
+	}
+}
+
+void GameControllerGroup::removeController(GameController* controller) {
+	std::vector<GameController*>::iterator iter = 
+		std::find(this->controllers.begin(), this->controllers.end(), controller);
+	if (iter != this->controllers.end()) {
+		this->controllers.erase(iter);
+		this->layoutChanged = true;
+	}
+}
+
+void GameControllerGroup::update(const Timestamp now) {
+	const unsigned int count = static_cast<unsigned int>(this->controllers.size());
+	const unsigned int axisCount = ControllerState::MAX_AXES;
+	bool reconfigure = this->layoutChanged;
+	for (unsigned int idx = 0; idx < count; ++idx) {
+		this->controllers[idx]->samples.beginFrame();
+		this->controllers[idx]->poll(now);
+		reconfigure = reconfigure || this->controllers[idx]->settingsChanged;
+	}
+	if (count == 0) {
+		return;
+	}
+
+	// -- Each controller owns a run of lanes so the paired axis of a lane is in the same run.
+	if (reconfigure) {
+		this->processor.setLaneCount(count * axisCount);
+		this->raw.resize(count * axisCount);
+		this->normalized.resize(count * axisCount);
+		for (unsigned int idx = 0; idx < count; ++idx) {
+			GameController* controller = this->controllers[idx];
+			for (unsigned int axis = 0; axis < axisCount; ++axis) {
+				const AxisSettings& settings = controller->settings[axis];
+				const unsigned int paired = settings.pairedAxis < axisCount ? settings.pairedAxis : axis;
+				this->processor.setLane(idx * axisCount + axis, settings, idx * axisCount + paired);
+			}
+			controller->settingsChanged = false;
+		}
+		this->layoutChanged = false;
+	}
+
+	for (unsigned int idx = 0; idx < count; ++idx) {
+		memcpy(&this->raw[idx * axisCount], this->controllers[idx]->state.raw, 
+		       sizeof(int) * axisCount);
+	}
+	this->processor.process(&this->raw[0], &this->normalized[0]);
+	for (unsigned int idx = 0; idx < count; ++idx) {
+		this->controllers[idx]->publishAxes(&this->normalized[idx * axisCount], now);
+	}
+}
+
+} // namespace I43D
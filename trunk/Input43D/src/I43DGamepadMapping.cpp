@@ -0,0 +1,683 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+
+#include "I43DGamepadMapping.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+
+namespace I43D {
+
+namespace {
+
+/*! @brief Identifies a mapping table cache file. Reads 'I43G' on little endian machines. */
+const unsigned int CACHE_MAGIC = 0x47333449;
+
+/*! @brief The version of the cache file layout. */
+const unsigned int CACHE_VERSION = 1;
+
+/*! @brief The number of 32 bit words in the cache file header. */
+const unsigned int HEADER_WORDS = 10;
+
+/*! @brief The position of each field in the cache file header. */
+enum HeaderField {
+	HEADER_MAGIC, HEADER_VERSION, HEADER_SOURCE_SIZE, HEADER_SOURCE_TIME, HEADER_BUCKET_COUNT,
+	HEADER_SLOT_COUNT, HEADER_MAPPING_COUNT, HEADER_NAMES_LENGTH, HEADER_SKIPPED_LINES, 
+	HEADER_MAPPING_WORDS
+};
+
+/*! @brief The number of words in a key. */
+const unsigned int KEY_WORDS = 4;
+
+/*! @brief The number of words in a slot: the key followed by the index of the mapping. */
+const unsigned int SLOT_WORDS = KEY_WORDS + 1;
+
+/*! @brief The mapping index of an empty slot. */
+const unsigned int EMPTY_SLOT = 0xFFFFFFFF;
+
+/*! @brief The first word of the keys that hold only a vendor and product. */
+const unsigned int VENDOR_PRODUCT_KEY = 0xFFFFFFFF;
+
+/*! @brief The number of words in a mapping. */
+const unsigned int MAPPING_WORDS = sizeof(GamepadMapping) / sizeof(unsigned int);
+
+/*! @brief The platform name that selects lines of the mapping format. */
+#if defined( _WIN32 )
+const char* const PLATFORM_NAME = "Windows";
+#elif defined( __APPLE__ )
+const char* const PLATFORM_NAME = "Mac OS X";
+#else
+const char* const PLATFORM_NAME = "Linux";
+#endif
+
+/*! @brief The names of the buttons of the layout in GamepadButton order. */
+const char* const BUTTON_NAMES[GPB_COUNT] = {
+	"a", "b", "x", "y", "back", "guide", "start", "leftstick", "rightstick", "leftshoulder",
+	"rightshoulder", "dpup", "dpdown", "dpleft", "dpright", "misc1", "paddle1", "paddle2", 
+	"paddle3", "paddle4", "touchpad"
+};
+
+/*! @brief The names of the axes of the layout in GamepadAxis order. */
+const char* const AXIS_NAMES[GPA_COUNT] = {
+	"leftx", "lefty", "rightx", "righty", "lefttrigger", "righttrigger"
+};
+
+/*!
+ * @brief
+ *     Rotates a word to the left.
+ */
+inline unsigned int rotateLeft(const unsigned int value, const unsigned int count) {
+	return (value << count) | (value >> (32 - count));
+}
+
+/*!
+ * @brief
+ *     Hashes a key with a seed.
+ */
+unsigned int hashKey(const unsigned int* key, const unsigned int seed) {
+	unsigned int hash = seed ^ 0x9E3779B9;
+	for (unsigned int idx = 0; idx < KEY_WORDS; ++idx) {
+		hash ^= rotateLeft(key[idx] * 0xCC9E2D51, 15) * 0x1B873593;
+		hash = rotateLeft(hash, 13) * 5 + 0xE6546B64;
+	}
+	hash ^= hash >> 16;
+	hash *= 0x85EBCA6B;
+	hash ^= hash >> 13;
+	hash *= 0xC2B2AE35;
+	hash ^= hash >> 16;
+	return hash;
+}
+
+/*!
+ * @brief
+ *     Copies a GUID into a key.
+ */
+void makeGuidKey(const ControllerGUID& guid, unsigned int* key) {
+	memcpy(key, guid.data, sizeof(guid.data));
+}
+
+/*!
+ * @brief
+ *     Builds the key that finds a mapping by vendor and product.
+ */
+void makeVendorProductKey(const ControllerGUID& guid, unsigned int* key) {
+	key[0] = VENDOR_PRODUCT_KEY;
+	key[1] = guid.data[4] | (guid.data[5] << 8) | (guid.data[8] << 16) | (guid.data[9] << 24);
+	key[2] = 0;
+	key[3] = 0;
+}
+
+/*!
+ * @brief
+ *     Parses a decimal number that makes up all of a string from a position.
+ */
+bool parseNumber(const std::string& text, const size_t start, unsigned int& value) {
+	if (start >= text.size() || text.size() - start > 3) {
+		return false;
+	}
+	value = 0;
+	for (size_t idx = start; idx < text.size(); ++idx) {
+		if (text[idx] < '0' || text[idx] > '9') {
+			return false;
+		}
+		value = value * 10 + (text[idx] - '0');
+	}
+	return value <= 255;
+}
+
+/*!
+ * @brief
+ *     Parses the source side of a binding, for example "b3", "-a1", "a2~" or "h0.4".
+ */
+bool parseBinding(std::string text, GamepadBinding& binding) {
+	binding.kind = GPBIND_NONE;
+	binding.detail = GPRANGE_FULL;
+	if (text.empty() == false && (text[0] == '+' || text[0] == '-')) {
+		binding.detail |= text[0] == '+' ? GPRANGE_POSITIVE : GPRANGE_NEGATIVE;
+		text.erase(0, 1);
+	}
+	if (text.empty() == false && text[text.size() - 1] == '~') {
+		binding.detail |= GPRANGE_INVERTED;
+		text.erase(text.size() - 1);
+	}
+	if (text.empty()) {
+		return false;
+	}
+	unsigned int index = 0;
+	if (text[0] == 'b' && binding.detail == GPRANGE_FULL && parseNumber(text, 1, index)) {
+		binding.kind = GPBIND_BUTTON;
+	} else if (text[0] == 'a' && parseNumber(text, 1, index)) {
+		binding.kind = GPBIND_AXIS;
+	} else if (text[0] == 'h' && binding.detail == GPRANGE_FULL) {
+		const size_t dot = text.find('.');
+		unsigned int mask = 0;
+		if (dot == std::string::npos || parseNumber(text.substr(0, dot), 1, index) == false || 
+		    parseNumber(text, dot + 1, mask) == false) {
+			return false;
+		}
+		binding.kind = GPBIND_HAT;
+		binding.detail = static_cast<unsigned char>(mask);
+	} else {
+		return false;
+	}
+	binding.index = static_cast<unsigned char>(index);
+	return true;
+}
+
+/*!
+ * @brief
+ *     Parses one line of the mapping format.
+ * @param line
+ *     The line.
+ * @param guid
+ *     Receives the GUID.
+ * @param name
+ *     Receives the name.
+ * @param mapping
+ *     Receives the bindings.
+ * @param otherPlatform
+ *     Set to true if the line is for another platform.
+ * @return
+ *     False if the line could not be used.
+ */
+bool parseLine(const std::string& line, ControllerGUID& guid, std::string& name, 
+               GamepadMapping& mapping, bool& otherPlatform) {
+	std::vector<std::string> fields;
+	size_t start = 0;
+	while (start <= line.size()) {
+		size_t end = line.find(',', start);
+		if (end == std::string::npos) {
+			end = line.size();
+		}
+		fields.push_back(line.substr(start, end - start));
+		start = end + 1;
+	}
+	if (fields.size() < 2 || GamepadMappingTable::parseGUID(fields[0], guid) == false) {
+		return false;
+	}
+	name = fields[1];
+	memset(&mapping, 0, sizeof(mapping));
+	for (size_t idx = 2; idx < fields.size(); ++idx) {
+		const std::string& field = fields[idx];
+		const size_t colon = field.find(':');
+		if (colon == std::string::npos) {
+			continue;
+		}
+		std::string target = field.substr(0, colon);
+		const std::string source = field.substr(colon + 1);
+		if (target == "platform") {
+			otherPlatform = source != PLATFORM_NAME;
+			continue;
+		}
+		unsigned char outputRange = GPRANGE_FULL;
+		if (target.empty() == false && (target[0] == '+' || target[0] == '-')) {
+			outputRange = target[0] == '+' ? GPRANGE_POSITIVE : GPRANGE_NEGATIVE;
+			target.erase(0, 1);
+		}
+		GamepadBinding* binding = 0;
+		for (unsigned int button = 0; button < GPB_COUNT && binding == 0; ++button) {
+			if (target == BUTTON_NAMES[button]) {
+				binding = &mapping.buttons[button];
+			}
+		}
+		for (unsigned int axis = 0; axis < GPA_COUNT && binding == 0; ++axis) {
+			if (target == AXIS_NAMES[axis]) {
+				binding = outputRange == GPRANGE_NEGATIVE ? &mapping.negativeAxes[axis] : 
+				                                            &mapping.axes[axis];
+			}
+		}
+		// -- Fields the layout does not use, like hints and checksums, are ignored.
+		if (binding != 0) {
+			if (parseBinding(source, *binding) == false) {
+				return false;
+			}
+			binding->outputRange = outputRange;
+		}
+	}
+	return true;
+}
+
+/*!
+ * @brief
+ *     Reads a binding as a button.
+ */
+bool readButton(const GamepadBinding& binding, const ControllerState& controller) {
+	switch (binding.kind) {
+		case GPBIND_BUTTON:
+			return controller.isButtonPressed(static_cast<unsigned short>(binding.index + 1));
+		case GPBIND_AXIS:
+			if (binding.index < ControllerState::MAX_AXES) {
+				float value = controller.axes[binding.index];
+				if ((binding.detail & GPRANGE_INVERTED) != 0) {
+					value = -value;
+				}
+				if ((binding.detail & GPRANGE_POSITIVE) != 0) {
+					return value > 0.5f;
+				}
+				if ((binding.detail & GPRANGE_NEGATIVE) != 0) {
+					return value < -0.5f;
+				}
+				return value > 0.0f;
+			}
+			return false;
+		case GPBIND_HAT:
+			return binding.index < ControllerState::MAX_HATS && 
+			       (controller.hats[binding.index] & binding.detail) != 0;
+		default:
+			return false;
+	}
+}
+
+/*!
+ * @brief
+ *     Reads a binding as an axis of the layout.
+ * @param trigger
+ *     Whether the axis of the layout is a trigger, which runs from 0 to 1 rather than 
+ *     from -1 to 1.
+ */
+float readAxis(const GamepadBinding& binding, const ControllerState& controller, 
+               const bool trigger) {
+	float value = 0.0f;
+	bool halfInput = true;
+	if (binding.kind == GPBIND_AXIS) {
+		if (binding.index < ControllerState::MAX_AXES) {
+			value = controller.axes[binding.index];
+		}
+		if ((binding.detail & GPRANGE_INVERTED) != 0) {
+			value = -value;
+		}
+		if ((binding.detail & GPRANGE_POSITIVE) != 0) {
+			value = value > 0.0f ? value : 0.0f;
+		} else if ((binding.detail & GPRANGE_NEGATIVE) != 0) {
+			value = value < 0.0f ? -value : 0.0f;
+		} else {
+			halfInput = false;
+		}
+	} else if (binding.kind != GPBIND_NONE) {
+		value = readButton(binding, controller) ? 1.0f : 0.0f;
+	}
+
+	// -- Stretch or squeeze the input to the range of the axis of the layout.
+	if (binding.outputRange == GPRANGE_NEGATIVE) {
+		return -value;
+	}
+	if (halfInput == false && trigger) {
+		return (value + 1.0f) * 0.5f;
+	}
+	if (halfInput && trigger == false && binding.outputRange == GPRANGE_FULL && 
+	    binding.kind == GPBIND_AXIS) {
+		return value * 2.0f - 1.0f;
+	}
+	return value;
+}
+
+} // anonymous namespace
+
+void GamepadMapping::apply(const ControllerState& controller, GamepadState& gamepad) const {
+	gamepad.buttons = 0;
+	for (unsigned int button = 0; button < GPB_COUNT; ++button) {
+		if (readButton(this->buttons[button], controller)) {
+			gamepad.buttons |= 1u << button;
+		}
+	}
+	for (unsigned int axis = 0; axis < GPA_COUNT; ++axis) {
+		const bool trigger = axis == GPA_LEFT_TRIGGER || axis == GPA_RIGHT_TRIGGER;
+		gamepad.axes[axis] = readAxis(this->axes[axis], controller, trigger) + 
+		                     readAxis(this->negativeAxes[axis], controller, trigger);
+	}
+}
+
+GamepadMappingTable::GamepadMappingTable() 
+	: seeds(0), slots(0), mappings(0), names(0), bucketCount(0), slotCount(0), mappingCount(0),
+	  namesLength(0), skippedLines(0) {
+}
+
+bool GamepadMappingTable::open(const std::string& sourcePath, const std::string& cachePath) {
+	unsigned int sourceSize = 0;
+	unsigned int sourceTime = 0;
+	const bool haveSource = MappedFile::getFileStamp(sourcePath, sourceSize, sourceTime);
+	if (this->openCache(cachePath)) {
+		const unsigned int* header = static_cast<const unsigned int*>(this->cacheFile.getData());
+		if (haveSource == false || (header[HEADER_SOURCE_SIZE] == sourceSize 
+		                            && header[HEADER_SOURCE_TIME] == sourceTime)) {
+			return true;
+		}
+	}
+	return haveSource && this->compile(sourcePath, cachePath);
+}
+
+bool GamepadMappingTable::openCache(const std::string& cachePath) {
+	this->image.clear();
+	if (this->cacheFile.open(cachePath) == false) {
+		return false;
+	}
+	if (this->attach(this->cacheFile.getData(), this->cacheFile.getSize()) == false) {
+		this->cacheFile.close();
+		return false;
+	}
+	return true;
+}
+
+bool GamepadMappingTable::compile(const std::string& sourcePath, const std::string& cachePath) {
+	unsigned int sourceSize = 0;
+	unsigned int sourceTime = 0;
+	if (MappedFile::getFileStamp(sourcePath, sourceSize, sourceTime) == false) {
+		return false;
+	}
+	// -- The source is parsed straight out of a mapping, which fails for empty files.
+	MappedFile source;
+	if (source.open(sourcePath)) {
+		this->compileText(static_cast<const char*>(source.getData()), source.getSize());
+	} else if (sourceSize == 0) {
+		this->compileText("", 0);
+	} else {
+		return false;
+	}
+	this->image[HEADER_SOURCE_SIZE] = sourceSize;
+	this->image[HEADER_SOURCE_TIME] = sourceTime;
+
+	if (cachePath.empty() == false && 
+	    MappedFile::writeFile(cachePath, &this->image[0], this->image.size() * sizeof(unsigned int))) {
+		// -- Prefer the mapping so the memory is shared with other processes.
+		std::vector<unsigned int> built;
+		built.swap(this->image);
+		if (this->openCache(cachePath)) {
+			return true;
+		}
+		this->image.swap(built);
+	}
+	this->attach(&this->image[0], this->image.size() * sizeof(unsigned int));
+	return true;
+}
+
+void GamepadMappingTable::compileText(const char* source, const size_t length) {
+	this->cacheFile.close();
+	std::vector<GamepadMapping> parsed;
+	std::string namePool;
+	std::map<std::vector<unsigned int>, unsigned int> keys;
+	unsigned int skipped = 0;
+
+	size_t lineStart = 0;
+	while (lineStart < length) {
+		size_t lineEnd = lineStart;
+		while (lineEnd < length && source[lineEnd] != '\n') {
+			++lineEnd;
+		}
+		std::string line(source + lineStart, lineEnd - lineStart);
+		lineStart = lineEnd + 1;
+		const size_t first = line.find_first_not_of(" \t\r");
+		if (first == std::string::npos || line[first] == '#') {
+			continue;
+		}
+		const size_t last = line.find_last_not_of(" \t\r,");
+		line = line.substr(first, last - first + 1);
+
+		ControllerGUID guid;
+		std::string name;
+		GamepadMapping mapping;
+		bool otherPlatform = false;
+		if (parseLine(line, guid, name, mapping, otherPlatform) == false) {
+			++skipped;
+			continue;
+		}
+		if (otherPlatform) {
+			continue;
+		}
+		mapping.nameOffset = static_cast<unsigned int>(namePool.size());
+		namePool.append(name);
+		namePool.push_back('\0');
+		const unsigned int index = static_cast<unsigned int>(parsed.size());
+		parsed.push_back(mapping);
+
+		// -- A repeated GUID replaces the earlier mapping. The vendor and product key 
+		// -- keeps the first mapping seen so the most common revision is the fallback.
+		std::vector<unsigned int> key(KEY_WORDS);
+		makeGuidKey(guid, &key[0]);
+		keys[key] = index;
+		makeVendorProductKey(guid, &key[0]);
+		if (keys.find(key) == keys.end()) {
+			keys[key] = index;
+		}
+	}
+
+	// -- Build the perfect hash by hash and displace: keys are grouped into buckets and the
+	// -- largest buckets are placed first, each searching for a seed that sends all of its
+	// -- keys to free slots.
+	const unsigned int keyCount = static_cast<unsigned int>(keys.size());
+	unsigned int buckets = keyCount / 4 + 1;
+	unsigned int slotTotal = keyCount + keyCount / 4 + 1;
+	std::vector<unsigned int> bucketSeeds;
+	std::vector<unsigned int> slotWords;
+	for (;;) {
+		std::vector<std::vector<const std::vector<unsigned int>*> > members(buckets);
+		std::map<std::vector<unsigned int>, unsigned int>::const_iterator iter;
+		for (iter = keys.begin(); iter != keys.end(); ++iter) {
+			members[hashKey(&iter->first[0], 0) % buckets].push_back(&iter->first);
+		}
+		std::vector<std::pair<unsigned int, unsigned int> > order;
+		for (unsigned int bucket = 0; bucket < buckets; ++bucket) {
+			order.push_back(std::make_pair(static_cast<unsigned int>(members[bucket].size()), bucket));
+		}
+		std::sort(order.rbegin(), order.rend());
+
+		bucketSeeds.assign(buckets, 0);
+		slotWords.assign(slotTotal * SLOT_WORDS, 0);
+		for (unsigned int slot = 0; slot < slotTotal; ++slot) {
+			slotWords[slot * SLOT_WORDS + KEY_WORDS] = EMPTY_SLOT;
+		}
+		bool placedAll = true;
+		std::vector<unsigned int> chosen;
+		for (size_t idx = 0; idx < order.size() && placedAll && order[idx].first > 0; ++idx) {
+			const std::vector<const std::vector<unsigned int>*>& bucket = members[order[idx].second];
+			bool placed = false;
+			for (unsigned int seed = 1; seed < 100000 && placed == false; ++seed) {
+				chosen.clear();
+				placed = true;
+				for (size_t member = 0; member < bucket.size() && placed; ++member) {
+					const unsigned int slot = hashKey(&(*bucket[member])[0], seed) % slotTotal;
+					placed = slotWords[slot * SLOT_WORDS + KEY_WORDS] == EMPTY_SLOT && 
+					         std::find(chosen.begin(), chosen.end(), slot) == chosen.end();
+					chosen.push_back(slot);
+				}
+				if (placed) {
+					bucketSeeds[order[idx].second] = seed;
+					for (size_t member = 0; member < bucket.size(); ++member) {
+						unsigned int* out = &slotWords[chosen[member] * SLOT_WORDS];
+						memcpy(out, &(*bucket[member])[0], KEY_WORDS * sizeof(unsigned int));
+						out[KEY_WORDS] = keys.find(*bucket[member])->second;
+					}
+				}
+			}
+			placedAll = placed;
+		}
+		if (placedAll) {
+			break;
+		}
+		// -- Practically unreachable, but a roomier table always succeeds eventually.
+		slotTotal += slotTotal / 2 + 1;
+	}
+
+	const unsigned int mappingTotal = static_cast<unsigned int>(parsed.size());
+	const unsigned int nameWords = static_cast<unsigned int>(namePool.size() + 3) / 4;
+	std::vector<unsigned int> built(HEADER_WORDS + buckets + slotTotal * SLOT_WORDS + 
+	                                mappingTotal * MAPPING_WORDS + nameWords, 0);
+	built[HEADER_MAGIC] = CACHE_MAGIC;
+	built[HEADER_VERSION] = CACHE_VERSION;
+	built[HEADER_BUCKET_COUNT] = buckets;
+	built[HEADER_SLOT_COUNT] = slotTotal;
+	built[HEADER_MAPPING_COUNT] = mappingTotal;
+	built[HEADER_NAMES_LENGTH] = static_cast<unsigned int>(namePool.size());
+	built[HEADER_SKIPPED_LINES] = skipped;
+	built[HEADER_MAPPING_WORDS] = MAPPING_WORDS;
+	unsigned int* out = &built[HEADER_WORDS];
+	memcpy(out, &bucketSeeds[0], buckets * sizeof(unsigned int));
+	out += buckets;
+	memcpy(out, &slotWords[0], slotWords.size() * sizeof(unsigned int));
+	out += slotWords.size();
+	if (mappingTotal > 0) {
+		memcpy(out, &parsed[0], mappingTotal * sizeof(GamepadMapping));
+		out += mappingTotal * MAPPING_WORDS;
+	}
+	if (namePool.empty() == false) {
+		memcpy(out, namePool.data(), namePool.size());
+	}
+
+	this->image.swap(built);
+	this->attach(&this->image[0], this->image.size() * sizeof(unsigned int));
+}
+
+bool GamepadMappingTable::attach(const void* data, const size_t size) {
+	const unsigned int* words = static_cast<const unsigned int*>(data);
+	const size_t wordCount = size / sizeof(unsigned int);
+	if (wordCount < HEADER_WORDS || words[HEADER_MAGIC] != CACHE_MAGIC 
+	    || words[HEADER_VERSION] != CACHE_VERSION || words[HEADER_MAPPING_WORDS] != MAPPING_WORDS
+	    || words[HEADER_BUCKET_COUNT] == 0 || words[HEADER_SLOT_COUNT] == 0) {
+		return false;
+	}
+	// -- Counted in 64 bits so that huge counts in a corrupt header can not wrap around.
+	const unsigned long long needed = HEADER_WORDS 
+		+ static_cast<unsigned long long>(words[HEADER_BUCKET_COUNT]) 
+		+ static_cast<unsigned long long>(words[HEADER_SLOT_COUNT]) * SLOT_WORDS 
+		+ static_cast<unsigned long long>(words[HEADER_MAPPING_COUNT]) * MAPPING_WORDS 
+		+ (static_cast<unsigned long long>(words[HEADER_NAMES_LENGTH]) + 3) / 4;
+	if (needed > wordCount) {
+		return false;
+	}
+	const unsigned int totalBuckets = words[HEADER_BUCKET_COUNT];
+	const unsigned int totalSlots = words[HEADER_SLOT_COUNT];
+	const unsigned int totalMappings = words[HEADER_MAPPING_COUNT];
+	const unsigned int totalNames = words[HEADER_NAMES_LENGTH];
+	const unsigned int* const slotWords = words + HEADER_WORDS + totalBuckets;
+	const GamepadMapping* const mappingTable = 
+		reinterpret_cast<const GamepadMapping*>(slotWords + totalSlots * SLOT_WORDS);
+	const char* const namePool = reinterpret_cast<const char*>(
+		slotWords + totalSlots * SLOT_WORDS + totalMappings * MAPPING_WORDS);
+
+	// -- The cache is only trusted by its stamp, so check every index once here instead of
+	// -- on each lookup. A corrupt cache is then recompiled like a stale one. The seeds 
+	// -- need no check because lookups reduce the hash modulo the slot count.
+	for (unsigned int slot = 0; slot < totalSlots; ++slot) {
+		const unsigned int mapping = slotWords[slot * SLOT_WORDS + KEY_WORDS];
+		if (mapping != EMPTY_SLOT && mapping >= totalMappings) {
+			return false;
+		}
+	}
+	// -- Every name ends with a terminator inside the pool so getName() can not run off it.
+	if (totalMappings > 0 && (totalNames == 0 || namePool[totalNames - 1] != '\0')) {
+		return false;
+	}
+	for (unsigned int mapping = 0; mapping < totalMappings; ++mapping) {
+		if (mappingTable[mapping].nameOffset >= totalNames) {
+			return false;
+		}
+	}
+
+	this->bucketCount = totalBuckets;
+	this->slotCount = totalSlots;
+	this->mappingCount = totalMappings;
+	this->namesLength = totalNames;
+	this->skippedLines = words[HEADER_SKIPPED_LINES];
+	this->seeds = words + HEADER_WORDS;
+	this->slots = slotWords;
+	this->mappings = mappingTable;
+	this->names = namePool;
+	return true;
+}
+
+const GamepadMapping* GamepadMappingTable::lookup(const unsigned int* key) const {
+	if (this->slotCount == 0) {
+		return 0;
+	}
+	const unsigned int seed = this->seeds[hashKey(key, 0) % this->bucketCount];
+	const unsigned int* slot = this->slots + (hashKey(key, seed) % this->slotCount) * SLOT_WORDS;
+	if (slot[KEY_WORDS] == EMPTY_SLOT || memcmp(slot, key, KEY_WORDS * sizeof(unsigned int)) != 0) {
+		return 0;
+	}
+	return this->mappings + slot[KEY_WORDS];
+}
+
+const GamepadMapping* GamepadMappingTable::find(const ControllerGUID& guid) const {
+	unsigned int key[KEY_WORDS];
+	makeGuidKey(guid, key);
+	return this->lookup(key);
+}
+
+const GamepadMapping* GamepadMappingTable::find(const unsigned short busType, 
+                                                const unsigned short vendor, 
+                                                const unsigned short product, 
+                                                const unsigned short version) const {
+	const ControllerGUID guid = makeGUID(busType, vendor, product, version);
+	const GamepadMapping* mapping = this->find(guid);
+	if (mapping == 0) {
+		unsigned int key[KEY_WORDS];
+		makeVendorProductKey(guid, key);
+		mapping = this->lookup(key);
+	}
+	return mapping;
+}
+
+const char* GamepadMappingTable::getName(const GamepadMapping& mapping) const {
+	return mapping.nameOffset < this->namesLength ? this->names + mapping.nameOffset : "";
+}
+
+ControllerGUID GamepadMappingTable::makeGUID(const unsigned short busType, 
+                                             const unsigned short vendor, 
+                                             const unsigned short product, 
+                                             const unsigned short version) {
+	ControllerGUID guid;
+	memset(guid.data, 0, sizeof(guid.data));
+	guid.data[0] = static_cast<unsigned char>(busType);
+	guid.data[1] = static_cast<unsigned char>(busType >> 8);
+	guid.data[4] = static_cast<unsigned char>(vendor);
+	guid.data[5] = static_cast<unsigned char>(vendor >> 8);
+	guid.data[8] = static_cast<unsigned char>(product);
+	guid.data[9] = static_cast<unsigned char>(product >> 8);
+	guid.data[12] = static_cast<unsigned char>(version);
+	guid.data[13] = static_cast<unsigned char>(version >> 8);
+	return guid;
+}
+
+bool GamepadMappingTable::parseGUID(const std::string& text, ControllerGUID& guid) {
+	if (text.size() != 32) {
+		return false;
+	}
+	for (unsigned int idx = 0; idx < 16; ++idx) {
+		unsigned int byte = 0;
+		for (unsigned int digit = 0; digit < 2; ++digit) {
+			const char c = text[idx * 2 + digit];
+			byte <<= 4;
+			if (c >= '0' && c <= '9') {
+				byte |= c - '0';
+			} else if (c >= 'a' && c <= 'f') {
+				byte |= c - 'a' + 10;
+			} else if (c >= 'A' && c <= 'F') {
+				byte |= c - 'A' + 10;
+			} else {
+				return false;
+			}
+		}
+		guid.data[idx] = static_cast<unsigned char>(byte);
+	}
+	return true;
+}
+
+} // namespace I43D
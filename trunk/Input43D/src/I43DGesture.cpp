@@ -0,0 +1,554 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+
+#include "I43DGesture.h"
+#include "I43DInstrumentation.h"
+#include <cmath>
+#include <cstring>
+
+namespace I43D {
+
+namespace {
+
+/*! @brief Pi, used to wrap angles. */
+const float PI = 3.14159265f;
+
+/*! @brief A pause after which the contacts are treated as having stopped, in microseconds. */
+const Timestamp STOP_INTERVAL = 100000;
+
+/*! @brief How far apart in multiples of the allowed movement taps in a row may be. */
+const float REPEAT_DISTANCE = 4.0f;
+
+/*!
+ * @brief
+ *     Wraps an angle to the range -pi to pi.
+ */
+inline float wrapAngle(float angle) {
+	while (angle > PI) {
+		angle -= 2.0f * PI;
+	}
+	while (angle < -PI) {
+		angle += 2.0f * PI;
+	}
+	return angle;
+}
+
+/*!
+ * @brief
+ *     Gets the length of a vector.
+ */
+inline float length(const float x, const float y) {
+	return sqrtf(x * x + y * y);
+}
+
+} // anonymous namespace
+
+void GestureRecognizer::fillEvent(const GestureFrame& frame, GestureEvent& event) {
+	event.contactCount = frame.contactCount > 0 ? frame.contactCount : frame.maxContactCount;
+	event.x = frame.x;
+	event.y = frame.y;
+	event.translationX = frame.translationX;
+	event.translationY = frame.translationY;
+	event.scale = frame.scale;
+	event.rotation = frame.rotation;
+	event.velocityX = frame.velocityX;
+	event.velocityY = frame.velocityY;
+	event.tapCount = 0;
+}
+
+TapRecognizer::TapRecognizer(const unsigned int contactCount, const unsigned int requiredTaps, 
+                             const Timestamp maxDuration, const float maxMovement, 
+                             const Timestamp repeatInterval)
+	: GestureRecognizer(GESTURE_TAP), contactCount(contactCount), 
+	  requiredTaps(requiredTaps > 0 ? requiredTaps : 1), maxDuration(maxDuration), 
+	  maxMovement(maxMovement), repeatInterval(repeatInterval), lastTapTime(0), lastTapX(0.0f),
+	  lastTapY(0.0f), tapCount(0) {
+}
+
+bool TapRecognizer::isWaiting() const {
+	return this->tapCount % this->requiredTaps != 0;
+}
+
+GestureStep TapRecognizer::update(const GestureFrame& frame, const bool active, 
+                                  GestureEvent& event) {
+	// -- Between touches the only thing that can happen is running out of time.
+	if (frame.contactCount == 0 && frame.contactsChanged == false) {
+		if (this->tapCount > 0 && frame.time - this->lastTapTime > this->repeatInterval) {
+			const bool waiting = this->isWaiting();
+			this->tapCount = 0;
+			return waiting ? GSTEP_FAIL : GSTEP_NONE;
+		}
+		return GSTEP_NONE;
+	}
+	if (frame.maxContactCount > this->contactCount || 
+	    length(frame.translationX, frame.translationY) > this->maxMovement ||
+	    frame.time - frame.startTime > this->maxDuration) {
+		this->tapCount = 0;
+		return GSTEP_FAIL;
+	}
+	if (frame.contactCount > 0) {
+		return GSTEP_NONE;
+	}
+	if (frame.maxContactCount < this->contactCount) {
+		this->tapCount = 0;
+		return GSTEP_FAIL;
+	}
+
+	// -- The fingers lifted: count the tap, starting a new series if it is too late or too
+	// -- far from the last one.
+	if (this->tapCount > 0 && (frame.startTime - this->lastTapTime > this->repeatInterval || 
+	    length(frame.x - this->lastTapX, frame.y - this->lastTapY) > 
+	    this->maxMovement * REPEAT_DISTANCE)) {
+		this->tapCount = 0;
+	}
+	++this->tapCount;
+	this->lastTapTime = frame.time;
+	this->lastTapX = frame.x;
+	this->lastTapY = frame.y;
+	if (this->isWaiting()) {
+		return GSTEP_NONE;
+	}
+	fillEvent(frame, event);
+	event.tapCount = this->tapCount;
+	return GSTEP_RECOGNIZE;
+}
+
+PanRecognizer::PanRecognizer(const float minDistance, const unsigned int minContacts, 
+                             const unsigned int maxContacts)
+	: GestureRecognizer(GESTURE_PAN), minDistance(minDistance), minContacts(minContacts), 
+	  maxContacts(maxContacts) {
+}
+
+GestureStep PanRecognizer::update(const GestureFrame& frame, const bool active, 
+                                  GestureEvent& event) {
+	const bool inRange = frame.contactCount >= this->minContacts && 
+	                     frame.contactCount <= this->maxContacts;
+	if (active) {
+		fillEvent(frame, event);
+		return inRange ? GSTEP_CHANGE : GSTEP_END;
+	}
+	if (frame.contactCount == 0) {
+		return GSTEP_FAIL;
+	}
+	if (inRange && length(frame.translationX, frame.translationY) >= this->minDistance) {
+		fillEvent(frame, event);
+		return GSTEP_BEGIN;
+	}
+	return GSTEP_NONE;
+}
+
+PinchRecognizer::PinchRecognizer(const float minScale) 
+	: GestureRecognizer(GESTURE_PINCH), minScale(minScale) {
+}
+
+GestureStep PinchRecognizer::update(const GestureFrame& frame, const bool active, 
+                                    GestureEvent& event) {
+	if (active) {
+		fillEvent(frame, event);
+		return frame.contactCount >= 2 ? GSTEP_CHANGE : GSTEP_END;
+	}
+	if (frame.contactCount == 0) {
+		return GSTEP_FAIL;
+	}
+	if (frame.contactCount >= 2 && fabsf(frame.scale - 1.0f) >= this->minScale) {
+		fillEvent(frame, event);
+		return GSTEP_BEGIN;
+	}
+	return GSTEP_NONE;
+}
+
+RotateRecognizer::RotateRecognizer(const float minAngle) 
+	: GestureRecognizer(GESTURE_ROTATE), minAngle(minAngle) {
+}
+
+GestureStep RotateRecognizer::update(const GestureFrame& frame, const bool active, 
+                                     GestureEvent& event) {
+	if (active) {
+		fillEvent(frame, event);
+		return frame.contactCount >= 2 ? GSTEP_CHANGE : GSTEP_END;
+	}
+	if (frame.contactCount == 0) {
+		return GSTEP_FAIL;
+	}
+	if (frame.contactCount >= 2 && fabsf(frame.rotation) >= this->minAngle) {
+		fillEvent(frame, event);
+		return GSTEP_BEGIN;
+	}
+	return GSTEP_NONE;
+}
+
+SwipeRecognizer::SwipeRecognizer(const float minDistance, const float minSpeed, 
+                                 const Timestamp maxDuration)
+	: GestureRecognizer(GESTURE_SWIPE), minDistance(minDistance), minSpeed(minSpeed), 
+	  maxDuration(maxDuration) {
+}
+
+GestureStep SwipeRecognizer::update(const GestureFrame& frame, const bool active, 
+                                    GestureEvent& event) {
+	if (frame.time - frame.startTime > this->maxDuration) {
+		return GSTEP_FAIL;
+	}
+	if (frame.contactCount > 0) {
+		return GSTEP_NONE;
+	}
+	if (length(frame.translationX, frame.translationY) >= this->minDistance && 
+	    length(frame.velocityX, frame.velocityY) >= this->minSpeed) {
+		fillEvent(frame, event);
+		return GSTEP_RECOGNIZE;
+	}
+	return GSTEP_FAIL;
+}
+
+GestureEngine::GestureEngine() : source(0) {
+	memset(&this->frame, 0, sizeof(this->frame));
+	this->frame.scale = 1.0f;
+	this->angleSlots[0] = TouchContacts::MAX_SLOTS;
+	this->angleSlots[1] = TouchContacts::MAX_SLOTS;
+}
+
+ResultCode GestureEngine::addRecognizer(GestureRecognizer* recognizer) {
+	if (this->findEntry(recognizer) < this->entries.size()) {
+		return RESULT_OK;
+	}
+	if (this->entries.size() >= MAX_RECOGNIZERS) {
+		I43D_FAIL(RESULT_FULL, L"Too many gesture recognizers");
+	}
+	Entry entry;
+	memset(&entry, 0, sizeof(entry));
+	entry.recognizer = recognizer;
+	entry.state = this->frame.contactCount > 0 ? STATE_FAILED : STATE_POSSIBLE;
+	this->entries.push_back(entry);
+	return RESULT_OK;
+}
+
+void GestureEngine::removeRecognizer(GestureRecognizer* recognizer) {
+	const unsigned int index = this->findEntry(recognizer);
+	if (index >= this->entries.size()) {
+		return;
+	}
+	this->entries.erase(this->entries.begin() + index);
+	// -- Close the gap in the masks of the remaining entries.
+	const unsigned int below = (1u << index) - 1;
+	for (unsigned int idx = 0; idx < this->entries.size(); ++idx) {
+		Entry& entry = this->entries[idx];
+		entry.simultaneousMask = (entry.simultaneousMask & below) | 
+		                         ((entry.simultaneousMask >> 1) & ~below);
+		entry.failureMask = (entry.failureMask & below) | ((entry.failureMask >> 1) & ~below);
+	}
+}
+
+ResultCode GestureEngine::setSimultaneous(GestureRecognizer* first, GestureRecognizer* second, 
+                                          const bool flag) {
+	const unsigned int firstIndex = this->findEntry(first);
+	const unsigned int secondIndex = this->findEntry(second);
+	if (firstIndex >= this->entries.size() || secondIndex >= this->entries.size()) {
+		I43D_FAIL(RESULT_NOT_FOUND, L"Recognizer not added to the engine");
+	}
+	if (flag) {
+		this->entries[firstIndex].simultaneousMask |= 1u << secondIndex;
+		this->entries[secondIndex].simultaneousMask |= 1u << firstIndex;
+	} else {
+		this->entries[firstIndex].simultaneousMask &= ~(1u << secondIndex);
+		this->entries[secondIndex].simultaneousMask &= ~(1u << firstIndex);
+	}
+	return RESULT_OK;
+}
+
+ResultCode GestureEngine::requireFailure(GestureRecognizer* recognizer, GestureRecognizer* other) {
+	const unsigned int index = this->findEntry(recognizer);
+	const unsigned int otherIndex = this->findEntry(other);
+	if (index >= this->entries.size() || otherIndex >= this->entries.size()) {
+		I43D_FAIL(RESULT_NOT_FOUND, L"Recognizer not added to the engine");
+	}
+	this->entries[index].failureMask |= 1u << otherIndex;
+	return RESULT_OK;
+}
+
+unsigned int GestureEngine::findEntry(const GestureRecognizer* recognizer) const {
+	unsigned int index = 0;
+	while (index < this->entries.size() && this->entries[index].recognizer != recognizer) {
+		++index;
+	}
+	return index;
+}
+
+void GestureEngine::updateFrame(const TouchContacts& contacts) {
+	GestureFrame& frame = this->frame;
+	const unsigned int previousCount = frame.contactCount;
+	const Timestamp previousTime = frame.time;
+	if (previousCount == 0 && contacts.beganMask != 0) {
+		frame.startTime = contacts.time;
+		frame.maxContactCount = 0;
+		frame.translationX = frame.translationY = 0.0f;
+		frame.velocityX = frame.velocityY = 0.0f;
+		frame.scale = 1.0f;
+		frame.rotation = 0.0f;
+		this->angleSlots[0] = this->angleSlots[1] = TouchContacts::MAX_SLOTS;
+	}
+	frame.time = contacts.time;
+	frame.contactsChanged = (contacts.beganMask | contacts.endedMask) != 0;
+
+	// -- One pass for the center and the pair of contacts that measure the angle.
+	unsigned int count = 0;
+	float sumX = 0.0f;
+	float sumY = 0.0f;
+	unsigned int pair[2] = { TouchContacts::MAX_SLOTS, TouchContacts::MAX_SLOTS };
+	for (unsigned int slot = 0; slot < TouchContacts::MAX_SLOTS; ++slot) {
+		if ((contacts.activeMask & (1u << slot)) != 0) {
+			if (count < 2) {
+				pair[count] = slot;
+			}
+			++count;
+			sumX += contacts.x[slot];
+			sumY += contacts.y[slot];
+		}
+	}
+	frame.contactCount = count;
+	if (count > frame.maxContactCount) {
+		frame.maxContactCount = count;
+	}
+	if (count == 0) {
+		return;
+	}
+	const float centerX = sumX / count;
+	const float centerY = sumY / count;
+
+	// -- A second pass for the spread, which needs the center.
+	float spread = 0.0f;
+	for (unsigned int slot = 0; slot < TouchContacts::MAX_SLOTS; ++slot) {
+		if ((contacts.activeMask & (1u << slot)) != 0) {
+			spread += length(contacts.x[slot] - centerX, contacts.y[slot] - centerY);
+		}
+	}
+	spread /= count;
+	float angle = frame.angle;
+	if (count >= 2) {
+		angle = atan2f(contacts.y[pair[1]] - contacts.y[pair[0]], 
+		               contacts.x[pair[1]] - contacts.x[pair[0]]);
+	}
+
+	// -- Accumulate only across frames with the same contacts.
+	if (frame.contactsChanged == false && previousCount == count) {
+		const float deltaX = centerX - frame.x;
+		const float deltaY = centerY - frame.y;
+		frame.translationX += deltaX;
+		frame.translationY += deltaY;
+		const Timestamp elapsed = frame.time - previousTime;
+		if (elapsed > STOP_INTERVAL) {
+			frame.velocityX = frame.velocityY = 0.0f;
+		} else if (elapsed > 0) {
+			const float seconds = elapsed / 1000000.0f;
+			frame.velocityX = 0.5f * frame.velocityX + 0.5f * deltaX / seconds;
+			frame.velocityY = 0.5f * frame.velocityY + 0.5f * deltaY / seconds;
+		}
+		if (count >= 2) {
+			if (frame.spread > 0.0001f) {
+				frame.scale *= spread / frame.spread;
+			}
+			if (pair[0] == this->angleSlots[0] && pair[1] == this->angleSlots[1]) {
+				frame.rotation += wrapAngle(angle - frame.angle);
+			}
+		}
+	}
+	frame.x = centerX;
+	frame.y = centerY;
+	frame.spread = spread;
+	frame.angle = angle;
+	this->angleSlots[0] = pair[0];
+	this->angleSlots[1] = pair[1];
+}
+
+void GestureEngine::contactsChanged(const TouchScreen* source, const TouchContacts& contacts) {
+	const bool starting = this->frame.contactCount == 0 && contacts.beganMask != 0;
+	this->source = source;
+	this->updateFrame(contacts);
+	if (starting) {
+		for (unsigned int idx = 0; idx < this->entries.size(); ++idx) {
+			Entry& entry = this->entries[idx];
+			// -- Held gestures keep waiting on their own, undisturbed by the new touches.
+			if (entry.state != STATE_HELD) {
+				entry.state = STATE_POSSIBLE;
+			}
+			entry.recognizer->beginSequence(this->frame);
+		}
+	}
+	this->stepRecognizers(true);
+	if (this->frame.contactCount == 0) {
+		for (unsigned int idx = 0; idx < this->entries.size(); ++idx) {
+			const Entry& entry = this->entries[idx];
+			if (entry.state == STATE_ACTIVE || 
+			    (entry.state == STATE_POSSIBLE && entry.recognizer->isWaiting() == false)) {
+				this->fail(idx);
+			}
+		}
+	}
+	this->releaseHeld();
+}
+
+void GestureEngine::update(const Timestamp now) {
+	if (this->frame.contactCount == 0 && now > this->frame.time) {
+		this->frame.time = now;
+		this->frame.contactsChanged = false;
+		this->stepRecognizers(false);
+		this->releaseHeld();
+	}
+}
+
+void GestureEngine::stepRecognizers(const bool activeToo) {
+	for (unsigned int idx = 0; idx < this->entries.size(); ++idx) {
+		Entry& entry = this->entries[idx];
+		const bool active = entry.state == STATE_ACTIVE;
+		if (entry.state != STATE_POSSIBLE && (active == false || activeToo == false)) {
+			continue;
+		}
+		GestureEvent event;
+		memset(&event, 0, sizeof(event));
+		event.recognizer = entry.recognizer;
+		event.type = entry.recognizer->getType();
+		event.time = this->frame.time;
+		GestureStep step = entry.recognizer->update(this->frame, active, event);
+		if (step == GSTEP_BEGIN && active) {
+			step = GSTEP_CHANGE;
+		}
+
+		// -- A gesture may only begin if no conflicting gesture is active.
+		bool conflict = false;
+		bool blocked = false;
+		if (step == GSTEP_BEGIN || step == GSTEP_RECOGNIZE) {
+			for (unsigned int other = 0; other < this->entries.size(); ++other) {
+				const RecognizerState state = this->entries[other].state;
+				if (other != idx && state == STATE_ACTIVE && 
+				    (entry.simultaneousMask & (1u << other)) == 0) {
+					conflict = true;
+				}
+				if ((entry.failureMask & (1u << other)) != 0 && state != STATE_FAILED) {
+					blocked = true;
+				}
+			}
+		}
+		switch (step) {
+			case GSTEP_FAIL:
+				this->fail(idx);
+				break;
+			case GSTEP_BEGIN:
+				if (conflict) {
+					this->fail(idx);
+				} else if (blocked == false) {
+					// -- Blocked continuous gestures simply try again on the next frame.
+					event.phase = GESTURE_BEGAN;
+					entry.state = STATE_ACTIVE;
+					this->dispatch(event);
+					this->succeed(idx);
+				}
+				break;
+			case GSTEP_CHANGE:
+				if (active) {
+					event.phase = GESTURE_CHANGED;
+					this->dispatch(event);
+				}
+				break;
+			case GSTEP_END:
+				if (active) {
+					event.phase = GESTURE_ENDED;
+					entry.state = STATE_DONE;
+					this->dispatch(event);
+				} else {
+					this->fail(idx);
+				}
+				break;
+			case GSTEP_RECOGNIZE:
+				event.phase = GESTURE_RECOGNIZED;
+				if (conflict) {
+					this->fail(idx);
+				} else if (blocked) {
+					entry.held = event;
+					entry.state = STATE_HELD;
+				} else {
+					entry.state = STATE_DONE;
+					this->dispatch(event);
+					this->succeed(idx);
+				}
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+void GestureEngine::fail(const unsigned int index) {
+	Entry& entry = this->entries[index];
+	const bool wasActive = entry.state == STATE_ACTIVE;
+	entry.state = STATE_FAILED;
+	if (wasActive) {
+		GestureEvent event;
+		memset(&event, 0, sizeof(event));
+		GestureRecognizer::fillEvent(this->frame, event);
+		event.recognizer = entry.recognizer;
+		event.type = entry.recognizer->getType();
+		event.phase = GESTURE_CANCELLED;
+		event.time = this->frame.time;
+		this->dispatch(event);
+	}
+}
+
+void GestureEngine::succeed(const unsigned int index) {
+	for (unsigned int idx = 0; idx < this->entries.size(); ++idx) {
+		if ((this->entries[idx].failureMask & (1u << index)) != 0 && 
+		    this->entries[idx].state != STATE_DONE) {
+			this->fail(idx);
+		}
+	}
+}
+
+void GestureEngine::releaseHeld() {
+	bool released = true;
+	while (released) {
+		released = false;
+		for (unsigned int idx = 0; idx < this->entries.size(); ++idx) {
+			Entry& entry = this->entries[idx];
+			if (entry.state != STATE_HELD) {
+				continue;
+			}
+			bool waiting = false;
+			for (unsigned int other = 0; other < this->entries.size(); ++other) {
+				if ((entry.failureMask & (1u << other)) != 0 && 
+				    this->entries[other].state != STATE_FAILED) {
+					waiting = true;
+				}
+			}
+			if (waiting == false) {
+				entry.state = STATE_DONE;
+				this->dispatch(entry.held);
+				this->succeed(idx);
+				released = true;
+			}
+		}
+	}
+}
+
+void GestureEngine::dispatch(const GestureEvent& event) {
+	std::set<GestureListener*>::iterator iter;
+	for (iter = this->listeners.begin(); iter != this->listeners.end(); ++iter) {
+		I43D_TIME_LISTENER(*iter);
+		(*iter)->gesture(this->source, event);
+	}
+}
+
+} // namespace I43D
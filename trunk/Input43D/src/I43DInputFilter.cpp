@@ -0,0 +1,164 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+#include "I43DInputFilter.h"
+#include <algorithm>
+
+namespace I43D {
+
+/*!
+ * @brief
+ *     Converts a deadzone from 0 to 1 to the units of the normalized axis values.
+ */
+static int toAxisUnits(const float deadzone) {
+	const float clamped = deadzone < 0.0f ? 0.0f : (deadzone > 0.99f ? 0.99f : deadzone);
+	return static_cast<int>(clamped * 32767.0f + 0.5f);
+}
+
+void DeadzoneFilter::setDefaultDeadzone(const float deadzone) {
+	this->defaultDeadzone = toAxisUnits(deadzone);
+}
+
+void DeadzoneFilter::setDeadzone(const DeviceID device, const float deadzone) {
+	bool created = false;
+	this->deadzones.get(makeFilterKey(device, 0, 0), created) = toAxisUnits(deadzone);
+}
+
+SmoothingFilter::SmoothingFilter(const float factor) {
+	this->setFactor(factor);
+}
+
+void SmoothingFilter::setFactor(const float factor) {
+	const float clamped = factor < 0.0f ? 0.0f : (factor > 1.0f ? 1.0f : factor);
+	this->weight = static_cast<long long>((1.0f - clamped) * static_cast<float>(ONE) + 0.5f);
+}
+
+void RemapFilter::setMapping(const DeviceID device, const InputEventType type, 
+                             const unsigned short from, const unsigned short to) {
+	this->mappings[makeFilterKey(device, getKind(static_cast<unsigned short>(type)), from)] = to;
+}
+
+void RemapFilter::removeMapping(const DeviceID device, const InputEventType type, 
+                                const unsigned short from) {
+	this->mappings.erase(makeFilterKey(device, getKind(static_cast<unsigned short>(type)), from));
+}
+
+void InvertFilter::setInverted(const DeviceID device, const unsigned short axis, 
+                               const bool inverted) {
+	if (axis >= 32) {
+		return;
+	}
+	bool created = false;
+	unsigned int& mask = this->axes.get(makeFilterKey(device, 0, 0), created);
+	if (created) {
+		mask = 0;
+	}
+	if (inverted) {
+		mask |= 1u << axis;
+	} else {
+		mask &= ~(1u << axis);
+		if (mask == 0) {
+			this->axes.remove(makeFilterKey(device, 0, 0));
+		}
+	}
+}
+
+bool RateLimitFilter::release(const Timestamp now, InputEvent& event, FilterBatch& batch) {
+	for (std::vector<InputEvent>::iterator iter = this->held.begin(); iter != this->held.end(); 
+	     ++iter) {
+		State* state = this->states.find(makeFilterKey(iter->device, iter->type, iter->code));
+		if (state != 0 && now - state->last >= this->interval) {
+			event = *iter;
+			this->held.erase(iter);
+			state->holding = false;
+			state->last = now;
+			return true;
+		}
+	}
+	return false;
+}
+
+void RateLimitFilter::hold(const InputEvent& event, State& state) {
+	if (state.holding) {
+		for (std::vector<InputEvent>::iterator iter = this->held.begin(); 
+		     iter != this->held.end(); ++iter) {
+			if (iter->device == event.device && iter->type == event.type && 
+			    iter->code == event.code) {
+				*iter = event;
+				return;
+			}
+		}
+	}
+	this->held.push_back(event);
+	state.holding = true;
+}
+
+void RateLimitFilter::dropHeld(const InputEvent& event) {
+	for (std::vector<InputEvent>::iterator iter = this->held.begin(); iter != this->held.end(); 
+	     ++iter) {
+		if (iter->device == event.device && iter->type == event.type && 
+		    iter->code == event.code) {
+			this->held.erase(iter);
+			return;
+		}
+	}
+}
+
+void RateLimitFilter::removeHeld(const DeviceID device) {
+	std::vector<InputEvent>::iterator iter = this->held.begin();
+	while (iter != this->held.end()) {
+		if (iter->device == device) {
+			iter = this->held.erase(iter);
+		} else {
+			++iter;
+		}
+	}
+}
+
+bool DynamicFilterChain::release(const Timestamp now, InputEvent& event, FilterBatch& batch) {
+	for (std::vector<InputFilter*>::iterator iter = this->filters.begin(); 
+	     iter != this->filters.end(); ++iter) {
+		while ((*iter)->release(now, event, batch)) {
+			// -- What a filter lets go of has only run the filters up to that one.
+			std::vector<InputFilter*>::iterator next = iter + 1;
+			while (next != this->filters.end() && (*next)->filter(event, batch)) {
+				++next;
+			}
+			if (next == this->filters.end()) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+ResultCode DynamicFilterChain::insertFilter(const unsigned int position, InputFilter* filter) {
+	if (position > this->filters.size()) {
+		I43D_FAIL(RESULT_OUT_OF_RANGE, L"The position is past the end of the filter chain");
+	}
+	this->filters.insert(this->filters.begin() + position, filter);
+	return RESULT_OK;
+}
+
+void DynamicFilterChain::removeFilter(InputFilter* filter) {
+	this->filters.erase(std::remove(this->filters.begin(), this->filters.end(), filter), 
+	                    this->filters.end());
+}
+
+} // namespace I43D
@@ -0,0 +1,283 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+
+#include "I43DInputFrame.h"
+#include <cstring>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#	define I43D_FRAME_SSE2
+#	include <emmintrin.h>
+#endif
+
+namespace I43D {
+
+namespace {
+
+// -- The frame is compared and encoded as raw words so it must have no padding.
+typedef char FrameSizeCheck[sizeof(InputFrame) == InputFrame::WORD_COUNT * 4 ? 1 : -1];
+
+/*! @brief The number of 16 byte blocks in a frame. */
+const unsigned int BLOCK_COUNT = InputFrame::WORD_COUNT / 4;
+
+/*!
+ * @brief
+ *     Writes bit fields into a zeroed buffer, lowest bits first.
+ */
+class BitWriter {
+public:
+	BitWriter(unsigned char* data) : data(data), position(0) {}
+
+	void write(unsigned int value, unsigned int bits) {
+		while (bits > 0) {
+			const unsigned int shift = this->position & 7;
+			const unsigned int taken = bits < 8 - shift ? bits : 8 - shift;
+			this->data[this->position >> 3] |= 
+				static_cast<unsigned char>((value & ((1u << taken) - 1)) << shift);
+			value >>= taken;
+			bits -= taken;
+			this->position += taken;
+		}
+	}
+
+	unsigned int getByteCount() const {
+		return (this->position + 7) >> 3;
+	}
+
+private:
+	unsigned char* data;
+	unsigned int position;
+};
+
+/*!
+ * @brief
+ *     Reads bit fields written by a BitWriter.
+ */
+class BitReader {
+public:
+	BitReader(const unsigned char* data, const unsigned int size) 
+		: data(data), bitCount(size * 8), position(0) {}
+
+	bool read(unsigned int& value, const unsigned int bits) {
+		if (this->position + bits > this->bitCount) {
+			return false;
+		}
+		value = 0;
+		unsigned int done = 0;
+		while (done < bits) {
+			const unsigned int shift = this->position & 7;
+			const unsigned int taken = bits - done < 8 - shift ? bits - done : 8 - shift;
+			const unsigned int field = (this->data[this->position >> 3] >> shift) & ((1u << taken) - 1);
+			value |= field << done;
+			done += taken;
+			this->position += taken;
+		}
+		return true;
+	}
+
+	unsigned int getByteCount() const {
+		return (this->position + 7) >> 3;
+	}
+
+private:
+	const unsigned char* data;
+	unsigned int bitCount;
+	unsigned int position;
+};
+
+/*!
+ * @brief
+ *     Counts the bits that are set.
+ */
+inline unsigned int countBits(unsigned int value) {
+	unsigned int count = 0;
+	for (; value != 0; value &= value - 1) {
+		++count;
+	}
+	return count;
+}
+
+} // anonymous namespace
+
+void InputFrame::clear() {
+	memset(this, 0, sizeof(*this));
+}
+
+void InputFrame::setKey(const unsigned short keyNum, const bool down) {
+	if (keyNum < MAX_KEYS) {
+		const unsigned int bit = 1u << (keyNum & 31);
+		if (down) {
+			this->keys[keyNum >> 5] |= bit;
+		} else {
+			this->keys[keyNum >> 5] &= ~bit;
+		}
+	}
+}
+
+void InputFrame::captureSeat(const SeatState& state) {
+	const size_t size = sizeof(this->keys) < sizeof(state.keys) ? sizeof(this->keys) : sizeof(state.keys);
+	memcpy(this->keys, state.keys, size);
+	this->mouseButtons = state.mouseButtons;
+}
+
+void InputFrame::captureController(const ControllerState& state) {
+	this->controllerButtons = state.buttons;
+	memcpy(this->hats, state.hats, sizeof(this->hats));
+	for (unsigned short axis = 0; axis < MAX_AXES; ++axis) {
+		const int value = state.getFixedAxis(axis);
+		this->axes[axis] = static_cast<short>(value < -32767 ? -32767 : (value > 32767 ? 32767 : value));
+	}
+}
+
+bool InputFrame::equals(const InputFrame& other) const {
+#if defined( I43D_FRAME_SSE2 )
+	const __m128i* first = reinterpret_cast<const __m128i*>(this);
+	const __m128i* second = reinterpret_cast<const __m128i*>(&other);
+	__m128i difference = _mm_setzero_si128();
+	for (unsigned int block = 0; block < BLOCK_COUNT; ++block) {
+		difference = _mm_or_si128(difference, _mm_xor_si128(_mm_loadu_si128(first + block), 
+		                                                    _mm_loadu_si128(second + block)));
+	}
+	return _mm_movemask_epi8(_mm_cmpeq_epi8(difference, _mm_setzero_si128())) == 0xFFFF;
+#else
+	return memcmp(this, &other, sizeof(*this)) == 0;
+#endif
+}
+
+unsigned int InputFrame::getChangedWords(const InputFrame& other) const {
+	unsigned int changed = 0;
+#if defined( I43D_FRAME_SSE2 )
+	const __m128i* first = reinterpret_cast<const __m128i*>(this);
+	const __m128i* second = reinterpret_cast<const __m128i*>(&other);
+	for (unsigned int block = 0; block < BLOCK_COUNT; ++block) {
+		// -- Equal words set all four of their bytes in the byte mask; keep one bit each.
+		const unsigned int bytes = _mm_movemask_epi8(_mm_cmpeq_epi32(
+			_mm_loadu_si128(first + block), _mm_loadu_si128(second + block)));
+		const unsigned int equal = (bytes & 1) | ((bytes >> 3) & 2) | ((bytes >> 6) & 4) | 
+		                           ((bytes >> 9) & 8);
+		changed |= (equal ^ 0xF) << (block * 4);
+	}
+#else
+	unsigned int first[WORD_COUNT];
+	unsigned int second[WORD_COUNT];
+	memcpy(first, this, sizeof(first));
+	memcpy(second, &other, sizeof(second));
+	for (unsigned int word = 0; word < WORD_COUNT; ++word) {
+		if (first[word] != second[word]) {
+			changed |= 1u << word;
+		}
+	}
+#endif
+	return changed;
+}
+
+unsigned int InputFrame::encodeDelta(const InputFrame& previous, unsigned char* buffer) const {
+	memset(buffer, 0, MAX_DELTA_SIZE);
+	BitWriter writer(buffer);
+	const unsigned int changed = this->getChangedWords(previous);
+	for (unsigned int block = 0; block < BLOCK_COUNT; ++block) {
+		writer.write(((changed >> (block * 4)) & 0xF) != 0 ? 1 : 0, 1);
+	}
+	for (unsigned int block = 0; block < BLOCK_COUNT; ++block) {
+		const unsigned int words = (changed >> (block * 4)) & 0xF;
+		if (words != 0) {
+			writer.write(words, 4);
+		}
+	}
+	if (changed == 0) {
+		return writer.getByteCount();
+	}
+
+	unsigned int current[WORD_COUNT];
+	unsigned int before[WORD_COUNT];
+	memcpy(current, this, sizeof(current));
+	memcpy(before, &previous, sizeof(before));
+	for (unsigned int word = 0; word < WORD_COUNT; ++word) {
+		if ((changed & (1u << word)) == 0) {
+			continue;
+		}
+		// -- Keys and buttons flip a bit or two at a time, so send their positions.
+		const unsigned int flipped = current[word] ^ before[word];
+		const unsigned int count = countBits(flipped);
+		if (count <= 3) {
+			writer.write(count, 2);
+			for (unsigned int bit = 0; bit < 32; ++bit) {
+				if ((flipped & (1u << bit)) != 0) {
+					writer.write(bit, 5);
+				}
+			}
+		} else {
+			writer.write(0, 2);
+			writer.write(flipped, 32);
+		}
+	}
+	return writer.getByteCount();
+}
+
+unsigned int InputFrame::decodeDelta(const InputFrame& previous, const unsigned char* data, 
+                                     const unsigned int size) {
+	BitReader reader(data, size);
+	unsigned int blocks = 0;
+	unsigned int value;
+	for (unsigned int block = 0; block < BLOCK_COUNT; ++block) {
+		if (reader.read(value, 1) == false) {
+			return 0;
+		}
+		blocks |= value << block;
+	}
+	unsigned int changed = 0;
+	for (unsigned int block = 0; block < BLOCK_COUNT; ++block) {
+		if ((blocks & (1u << block)) != 0) {
+			if (reader.read(value, 4) == false || value == 0) {
+				return 0;
+			}
+			changed |= value << (block * 4);
+		}
+	}
+
+	unsigned int words[WORD_COUNT];
+	memcpy(words, &previous, sizeof(words));
+	for (unsigned int word = 0; word < WORD_COUNT; ++word) {
+		if ((changed & (1u << word)) == 0) {
+			continue;
+		}
+		unsigned int count;
+		if (reader.read(count, 2) == false) {
+			return 0;
+		}
+		unsigned int flipped = 0;
+		if (count == 0) {
+			if (reader.read(flipped, 32) == false) {
+				return 0;
+			}
+		} else {
+			for (unsigned int idx = 0; idx < count; ++idx) {
+				if (reader.read(value, 5) == false) {
+					return 0;
+				}
+				flipped |= 1u << value;
+			}
+		}
+		words[word] ^= flipped;
+	}
+	memcpy(this, words, sizeof(words));
+	return reader.getByteCount();
+}
+
+} // namespace I43D
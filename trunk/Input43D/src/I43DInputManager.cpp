@@ -0,0 +1,114 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+
+#include "I43DInputManager.h"
+#include "I43DInstrumentation.h"
+#include <cstdio>
+
+namespace I43D {
+
+const DeviceInfo* InputManager::getDevice(const DeviceID id) const {
+	std::map<DeviceID, DeviceInfo>::const_iterator found = this->devices.find(id);
+	return found == this->devices.end() ? 0 : &found->second;
+}
+
+void InputManager::getDevices(const DeviceType type, std::vector<DeviceID>& ids) const {
+	ids.clear();
+	std::map<DeviceID, DeviceInfo>::const_iterator iter;
+	for (iter = this->devices.begin(); iter != this->devices.end(); ++iter) {
+		if (type == DEVICE_UNKNOWN || iter->second.type == type) {
+			ids.push_back(iter->first);
+		}
+	}
+}
+
+DeviceID InputManager::addDevice(const DeviceInfo& device) {
+	// -- Two identical devices without serials in the same location can only happen with
+	// -- broken firmware, but they still need different ids so a counter is appended.
+	const std::string identity = InputManager::getIdentity(device);
+	std::string key = identity;
+	DeviceID id = INVALID_DEVICE_ID;
+	for (unsigned int duplicate = 1; ; ++duplicate) {
+		std::map<std::string, DeviceID>::const_iterator known = this->knownIdentities.find(key);
+		if (known == this->knownIdentities.end()) {
+			id = this->nextID++;
+			this->knownIdentities[key] = id;
+			break;
+		}
+		if (this->devices.find(known->second) == this->devices.end()) {
+			id = known->second;
+			break;
+		}
+		char suffix[16];
+		sprintf(suffix, "#%u", duplicate);
+		key = identity + suffix;
+	}
+
+	DeviceInfo& added = this->devices[id];
+	added = device;
+	added.id = id;
+
+	std::set<InputManagerListener*>::const_iterator iter;
+	for (iter = this->listeners.begin(); iter != this->listeners.end(); ++iter) {
+		I43D_TIME_LISTENER(*iter);
+		(*iter)->deviceAdded(this, added);
+	}
+	return id;
+}
+
+bool InputManager::removeDevice(const std::string& path) {
+	std::map<DeviceID, DeviceInfo>::iterator found;
+	for (found = this->devices.begin(); found != this->devices.end(); ++found) {
+		if (found->second.path == path) {
+			break;
+		}
+	}
+	if (found == this->devices.end()) {
+		return false;
+	}
+	const DeviceInfo removed = found->second;
+	this->devices.erase(found);
+
+	std::set<InputManagerListener*>::const_iterator iter;
+	for (iter = this->listeners.begin(); iter != this->listeners.end(); ++iter) {
+		I43D_TIME_LISTENER(*iter);
+		(*iter)->deviceRemoved(this, removed);
+	}
+	return true;
+}
+
+bool InputManager::hasDevice(const std::string& path) const {
+	std::map<DeviceID, DeviceInfo>::const_iterator iter;
+	for (iter = this->devices.begin(); iter != this->devices.end(); ++iter) {
+		if (iter->second.path == path) {
+			return true;
+		}
+	}
+	return false;
+}
+
+std::string InputManager::getIdentity(const DeviceInfo& device) {
+	char ids[32];
+	sprintf(ids, "%04x:%04x:%04x:%04x", device.busType, device.vendor, device.product, 
+	        device.version);
+	return std::string(ids) + "|" + device.location + "|" + device.serial + "|" + device.name;
+}
+
+} // namespace I43D 
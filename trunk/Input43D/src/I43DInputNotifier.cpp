@@ -0,0 +1,129 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+#include "I43DInputNotifier.h"
+
+#if defined( _WIN32 )
+#	define WIN32_LEAN_AND_MEAN
+#	include <windows.h>
+#else
+#	include <fcntl.h>
+#	include <poll.h>
+#	include <unistd.h>
+#	if defined( __linux__ )
+#		include <sys/eventfd.h>
+#	endif
+#endif
+
+namespace I43D {
+
+#if defined( _WIN32 )
+
+InputNotifier::InputNotifier() : writeHandle(-1), threshold(1), typeMask(ALL_EVENTS), pending(0) {
+	this->handle = CreateEvent(NULL, TRUE, FALSE, NULL);
+	if (this->handle == NULL) {
+		I43D_FAIL_STARTUP(RESULT_SYSTEM_ERROR, L"Could not create the input notification event");
+	}
+}
+
+InputNotifier::~InputNotifier() {
+	CloseHandle(this->handle);
+}
+
+void InputNotifier::signal() {
+	SetEvent(this->handle);
+}
+
+bool InputNotifier::wait(const Timestamp timeout) {
+	const DWORD milliseconds = static_cast<DWORD>((timeout + 999) / 1000);
+	return WaitForSingleObject(this->handle, milliseconds) == WAIT_OBJECT_0;
+}
+
+#else
+
+InputNotifier::InputNotifier() : writeHandle(-1), threshold(1), typeMask(ALL_EVENTS), pending(0) {
+#if defined( __linux__ )
+	this->handle = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (this->handle < 0) {
+		I43D_FAIL_STARTUP(RESULT_SYSTEM_ERROR, L"Could not create the input notification eventfd");
+	}
+#else
+	int ends[2];
+	if (pipe(ends) != 0) {
+		I43D_FAIL_STARTUP(RESULT_SYSTEM_ERROR, L"Could not create the input notification pipe");
+	}
+	for (unsigned int idx = 0; idx < 2; ++idx) {
+		fcntl(ends[idx], F_SETFL, fcntl(ends[idx], F_GETFL) | O_NONBLOCK);
+		fcntl(ends[idx], F_SETFD, FD_CLOEXEC);
+	}
+	this->handle = ends[0];
+	this->writeHandle = ends[1];
+#endif
+}
+
+InputNotifier::~InputNotifier() {
+	close(this->handle);
+	if (this->writeHandle >= 0) {
+		close(this->writeHandle);
+	}
+}
+
+void InputNotifier::signal() {
+#if defined( __linux__ )
+	const unsigned long long one = 1;
+	const ssize_t written = write(this->handle, &one, sizeof(one));
+#else
+	const char one = 1;
+	const ssize_t written = write(this->writeHandle, &one, sizeof(one));
+#endif
+	// -- A full counter or pipe is already readable, which is all a signal needs.
+	(void)written;
+}
+
+bool InputNotifier::wait(const Timestamp timeout) {
+	struct pollfd request;
+	request.fd = this->handle;
+	request.events = POLLIN;
+	request.revents = 0;
+	const int milliseconds = timeout >= 0x7FFFFFFFull * 1000 ? 
+		0x7FFFFFFF : static_cast<int>((timeout + 999) / 1000);
+	return poll(&request, 1, milliseconds) > 0;
+}
+
+#endif
+
+unsigned int InputNotifier::reset() {
+	// -- Clear the handle before the count. An event counted in between signals again, 
+	// -- which at worst wakes the application once for nothing; the other order could lose
+	// -- the signal of an event that reached the threshold in between.
+#if defined( _WIN32 )
+	ResetEvent(this->handle);
+#else
+	char buffer[64];
+	while (read(this->handle, buffer, sizeof(buffer)) > 0) {
+	}
+#endif
+	unsigned int count = atomicLoad(this->pending);
+	while (atomicCompareExchange(this->pending, count, 0) == false) {
+		count = atomicLoad(this->pending);
+	}
+	return count;
+}
+
+} // namespace I43D
@@ -0,0 +1,432 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+#include "I43DInputScript.h"
+#include <cstdlib>
+
+namespace I43D {
+
+namespace {
+
+/*!
+ * @brief
+ *     Splits a line of a script into words, leaving out any comment.
+ */
+void splitWords(const std::string& line, std::vector<std::string>& words) {
+	words.clear();
+	std::string word;
+	for (size_t idx = 0; idx <= line.size(); ++idx) {
+		const char c = idx < line.size() ? line[idx] : ' ';
+		if (c == '#') {
+			break;
+		}
+		if (c == ' ' || c == '\t' || c == '\r') {
+			if (word.empty() == false) {
+				words.push_back(word);
+				word.clear();
+			}
+		} else {
+			word += c;
+		}
+	}
+	if (word.empty() == false) {
+		words.push_back(word);
+	}
+}
+
+/*!
+ * @brief
+ *     Parses a whole decimal number.
+ * @return
+ *     False if the text is not a number.
+ */
+bool parseInteger(const std::string& text, long& value) {
+	if (text.empty()) {
+		return false;
+	}
+	char* end = 0;
+	value = strtol(text.c_str(), &end, 10);
+	return *end == 0;
+}
+
+/*!
+ * @brief
+ *     Parses a time with an optional suffix of us, ms or s into microseconds.
+ * @return
+ *     False if the text is not a time.
+ */
+bool parseTime(const std::string& text, Timestamp& value) {
+	if (text.empty() || text[0] < '0' || text[0] > '9') {
+		return false;
+	}
+	char* end = 0;
+	const unsigned long number = strtoul(text.c_str(), &end, 10);
+	const std::string suffix(end);
+	if (suffix.empty() || suffix == "us") {
+		value = number;
+	} else if (suffix == "ms") {
+		value = static_cast<Timestamp>(number) * 1000;
+	} else if (suffix == "s") {
+		value = static_cast<Timestamp>(number) * 1000000;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+/*!
+ * @brief
+ *     Parses the direction of a key or button.
+ * @return
+ *     False if the text is neither down nor up.
+ */
+bool parsePressed(const std::string& text, bool& pressed) {
+	pressed = text == "down";
+	return pressed || text == "up";
+}
+
+} // anonymous namespace
+
+ScriptStep& InputScript::addStep(const ScriptOp op) {
+	ScriptStep step;
+	step.op = static_cast<unsigned short>(op);
+	step.type = IEVT_NONE;
+	step.code = 0;
+	step.steps = 0;
+	step.value = 0;
+	step.value2 = 0;
+	step.duration = 0;
+	step.jitter = 0;
+	this->steps.push_back(step);
+	return this->steps.back();
+}
+
+void InputScript::addEvent(const InputEventType type, const unsigned short code, 
+                           const int value, const int value2) {
+	ScriptStep& step = this->addStep(SCRIPT_EVENT);
+	step.type = static_cast<unsigned short>(type);
+	step.code = code;
+	step.value = value;
+	step.value2 = value2;
+}
+
+void InputScript::addWait(const Timestamp duration, const Timestamp jitter) {
+	ScriptStep& step = this->addStep(SCRIPT_WAIT);
+	step.duration = static_cast<unsigned int>(duration);
+	step.jitter = static_cast<unsigned int>(jitter < duration ? jitter : duration);
+}
+
+void InputScript::addMove(const int x, const int y, const Timestamp duration, 
+                          const unsigned short steps, const unsigned int jitter) {
+	ScriptStep& step = this->addStep(SCRIPT_MOVE);
+	step.value = x;
+	step.value2 = y;
+	step.duration = static_cast<unsigned int>(duration);
+	step.steps = steps > 0 ? steps : 1;
+	step.jitter = jitter;
+}
+
+ResultCode InputScript::beginLoop(const unsigned int count) {
+	if (this->openLoops >= MAX_LOOP_DEPTH) {
+		I43D_FAIL(RESULT_FULL, L"The loops of the script are nested too deeply");
+	}
+	this->addStep(SCRIPT_LOOP).value = static_cast<int>(count);
+	++this->openLoops;
+	return RESULT_OK;
+}
+
+ResultCode InputScript::endLoop() {
+	if (this->openLoops == 0) {
+		I43D_FAIL(RESULT_INCOMPATIBLE, L"The script has no loop to end");
+	}
+	this->addStep(SCRIPT_END_LOOP);
+	--this->openLoops;
+	return RESULT_OK;
+}
+
+ResultCode InputScript::parse(const std::string& text, unsigned int* errorLine) {
+	unsigned int lineNumber = 1;
+	size_t start = 0;
+	while (start <= text.size()) {
+		size_t end = text.find('\n', start);
+		if (end == std::string::npos) {
+			end = text.size();
+		}
+		if (this->parseLine(text.substr(start, end - start)) == false) {
+			if (errorLine != 0) {
+				*errorLine = lineNumber;
+			}
+			I43D_FAIL(RESULT_INCOMPATIBLE, L"A line of the input script could not be parsed");
+		}
+		start = end + 1;
+		++lineNumber;
+	}
+	return RESULT_OK;
+}
+
+bool InputScript::parseLine(const std::string& line) {
+	std::vector<std::string> words;
+	splitWords(line, words);
+	if (words.empty()) {
+		return true;
+	}
+	const std::string& command = words[0];
+	long number = 0;
+	long number2 = 0;
+	bool pressed = false;
+	if (command == "key" || command == "button" || command == "pad") {
+		if (words.size() != 3 || parseInteger(words[1], number) == false || number < 0 || 
+		    number > 0xFFFF || parsePressed(words[2], pressed) == false) {
+			return false;
+		}
+		InputEventType type = pressed ? IEVT_KEY_PRESSED : IEVT_KEY_RELEASED;
+		if (command == "button") {
+			type = pressed ? IEVT_MOUSE_BUTTON_PRESSED : IEVT_MOUSE_BUTTON_RELEASED;
+		} else if (command == "pad") {
+			type = pressed ? IEVT_CONTROLLER_BUTTON_PRESSED : IEVT_CONTROLLER_BUTTON_RELEASED;
+		}
+		this->addEvent(type, static_cast<unsigned short>(number));
+	} else if (command == "char") {
+		if (words.size() != 2 || parseInteger(words[1], number) == false || number < 0) {
+			return false;
+		}
+		this->addEvent(IEVT_CHAR_TYPED, 0, static_cast<int>(number));
+	} else if (command == "scroll") {
+		static const char* const DIRECTIONS[] = { "up", "down", "left", "right" };
+		static const MouseScrollDirection VALUES[] = { UP, DOWN, LEFT, RIGHT };
+		if (words.size() != 2) {
+			return false;
+		}
+		unsigned int idx = 0;
+		while (idx < 4 && words[1] != DIRECTIONS[idx]) {
+			++idx;
+		}
+		if (idx == 4) {
+			return false;
+		}
+		this->addEvent(IEVT_MOUSE_SCROLLED, static_cast<unsigned short>(VALUES[idx]));
+	} else if (command == "axis") {
+		if (words.size() != 3 || parseInteger(words[1], number) == false || number < 0 || 
+		    number > 0xFFFF || parseInteger(words[2], number2) == false) {
+			return false;
+		}
+		this->addEvent(IEVT_CONTROLLER_AXIS_MOVED, static_cast<unsigned short>(number), 
+		               static_cast<int>(number2));
+	} else if (command == "move") {
+		if (words.size() < 3 || (words.size() & 1) == 0 || 
+		    parseInteger(words[1], number) == false || parseInteger(words[2], number2) == false) {
+			return false;
+		}
+		Timestamp duration = 0;
+		long steps = 1;
+		long jitter = 0;
+		for (size_t idx = 3; idx < words.size(); idx += 2) {
+			bool valid = false;
+			if (words[idx] == "over") {
+				valid = parseTime(words[idx + 1], duration);
+			} else if (words[idx] == "steps") {
+				valid = parseInteger(words[idx + 1], steps) && steps > 0 && steps <= 0xFFFF;
+			} else if (words[idx] == "jitter") {
+				valid = parseInteger(words[idx + 1], jitter) && jitter >= 0;
+			}
+			if (valid == false) {
+				return false;
+			}
+		}
+		this->addMove(static_cast<int>(number), static_cast<int>(number2), duration, 
+		              static_cast<unsigned short>(steps), static_cast<unsigned int>(jitter));
+	} else if (command == "wait") {
+		Timestamp duration = 0;
+		Timestamp jitter = 0;
+		if ((words.size() != 2 && words.size() != 4) || parseTime(words[1], duration) == false ||
+		    (words.size() == 4 && (words[2] != "jitter" || parseTime(words[3], jitter) == false))) {
+			return false;
+		}
+		this->addWait(duration, jitter);
+	} else if (command == "loop") {
+		if (words.size() > 2 || this->openLoops >= MAX_LOOP_DEPTH || 
+		    (words.size() == 2 && (parseInteger(words[1], number) == false || number < 0))) {
+			return false;
+		}
+		this->beginLoop(static_cast<unsigned int>(number));
+	} else if (command == "end") {
+		if (words.size() != 1 || this->openLoops == 0) {
+			return false;
+		}
+		this->endLoop();
+	} else {
+		return false;
+	}
+	return true;
+}
+
+ScriptBot::ScriptBot(const InputScript& script, const unsigned int seed, const DeviceID device) 
+	: script(script), seed(seed), device(device), mouse(0), keyboard(0), controller(0), 
+	  wheel(0), position(0), loopDepth(0), moveIndex(0), moveStart(0), moveFromX(0), 
+	  moveFromY(0), mouseX(0), mouseY(0), random(0), eventCount(0), droppedCount(0), 
+	  maxLateness(0), finished(true) {
+}
+
+void ScriptBot::start(TimerWheel& wheel, const Timestamp startTime) {
+	this->wheel = &wheel;
+	this->position = 0;
+	this->loopDepth = 0;
+	this->moveIndex = 0;
+	this->mouseX = 0;
+	this->mouseY = 0;
+	// -- Xorshift can not leave the all zero state, so a zero seed is replaced.
+	this->random = this->seed != 0 ? this->seed : 0x9E3779B9u;
+	this->finished = this->script.getStepCount() == 0;
+	if (this->finished == false) {
+		wheel.schedule(this, startTime);
+	}
+}
+
+int ScriptBot::getRandomOffset(const unsigned int range) {
+	if (range == 0) {
+		return 0;
+	}
+	this->random ^= this->random << 13;
+	this->random ^= this->random >> 17;
+	this->random ^= this->random << 5;
+	const unsigned int limited = range < 0x3FFFFFFF ? range : 0x3FFFFFFF;
+	return static_cast<int>(this->random % (limited * 2 + 1)) - static_cast<int>(limited);
+}
+
+void ScriptBot::send(const InputEvent& event) {
+	InputEventSink* sink = 0;
+	switch (event.type) {
+		case IEVT_KEY_PRESSED:
+		case IEVT_KEY_RELEASED:
+		case IEVT_KEY_REPEATED:
+		case IEVT_CHAR_TYPED:
+			sink = this->keyboard;
+			break;
+		case IEVT_MOUSE_MOVED:
+		case IEVT_MOUSE_BUTTON_PRESSED:
+		case IEVT_MOUSE_BUTTON_RELEASED:
+		case IEVT_MOUSE_SCROLLED:
+			sink = this->mouse;
+			break;
+		case IEVT_CONTROLLER_BUTTON_PRESSED:
+		case IEVT_CONTROLLER_BUTTON_RELEASED:
+		case IEVT_CONTROLLER_AXIS_MOVED:
+			sink = this->controller;
+			break;
+		default:
+			break;
+	}
+	if (sink != 0) {
+		sink->pushEvent(event);
+		++this->eventCount;
+	} else {
+		++this->droppedCount;
+	}
+}
+
+void ScriptBot::timerExpired(const Timestamp deadline, const Timestamp now) {
+	if (now - deadline > this->maxLateness) {
+		this->maxLateness = now - deadline;
+	}
+	const ScriptStep* steps = this->script.getSteps();
+	const unsigned int stepCount = this->script.getStepCount();
+	const Timestamp time = deadline;
+	for (unsigned int run = 0; run < MAX_STEPS_PER_RUN; ++run) {
+		if (this->position >= stepCount) {
+			this->finished = true;
+			return;
+		}
+		const ScriptStep& step = steps[this->position];
+		switch (step.op) {
+			case SCRIPT_EVENT:
+				this->send(makeInputEvent(time, this->device, 
+				                          static_cast<InputEventType>(step.type), step.code, 
+				                          step.value, step.value2));
+				++this->position;
+				break;
+			case SCRIPT_WAIT: {
+				const long long offset = this->getRandomOffset(step.jitter);
+				++this->position;
+				this->wheel->schedule(this, time + static_cast<Timestamp>(step.duration + offset));
+				return;
+			}
+			case SCRIPT_MOVE: {
+				if (this->moveIndex == 0) {
+					this->moveFromX = this->mouseX;
+					this->moveFromY = this->mouseY;
+					this->moveStart = time;
+					this->moveIndex = step.duration > 0 ? 1 : step.steps;
+					if (step.duration > 0) {
+						this->wheel->schedule(this, time + step.duration / step.steps);
+						return;
+					}
+				}
+				// -- Positions are interpolated from the start so rounding does not add up.
+				const long long index = this->moveIndex;
+				int x = this->moveFromX + static_cast<int>(
+					(step.value - this->moveFromX) * index / step.steps);
+				int y = this->moveFromY + static_cast<int>(
+					(step.value2 - this->moveFromY) * index / step.steps);
+				if (this->moveIndex < step.steps) {
+					x += this->getRandomOffset(step.jitter);
+					y += this->getRandomOffset(step.jitter);
+				}
+				this->mouseX = x > 0 ? x : 0;
+				this->mouseY = y > 0 ? y : 0;
+				this->send(makeInputEvent(time, this->device, IEVT_MOUSE_MOVED, 0, this->mouseX, 
+				                          this->mouseY));
+				if (this->moveIndex < step.steps) {
+					++this->moveIndex;
+					this->wheel->schedule(this, this->moveStart + 
+						static_cast<Timestamp>(step.duration) * this->moveIndex / step.steps);
+					return;
+				}
+				this->moveIndex = 0;
+				++this->position;
+				break;
+			}
+			case SCRIPT_LOOP:
+				if (this->loopDepth < InputScript::MAX_LOOP_DEPTH) {
+					LoopFrame& frame = this->loops[this->loopDepth++];
+					frame.start = this->position + 1;
+					frame.remaining = static_cast<unsigned int>(step.value);
+				}
+				++this->position;
+				break;
+			case SCRIPT_END_LOOP:
+				if (this->loopDepth > 0) {
+					LoopFrame& frame = this->loops[this->loopDepth - 1];
+					if (frame.remaining == 0 || --frame.remaining > 0) {
+						this->position = frame.start;
+						break;
+					}
+					--this->loopDepth;
+				}
+				++this->position;
+				break;
+			default:
+				++this->position;
+				break;
+		}
+	}
+	// -- A loop without waits would never give the other bots a turn.
+	this->wheel->schedule(this, time);
+}
+
+} // namespace I43D
@@ -0,0 +1,106 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+#include "I43DInputWait.h"
+
+namespace I43D {
+
+void InputWaiter::cancel() {
+	if (this->next != 0) {
+		this->previous->next = this->next;
+		this->next->previous = this->previous;
+		this->next = 0;
+		this->previous = 0;
+		if (this->table != 0) {
+			--this->table->waiterCount;
+			this->table = 0;
+		}
+	}
+}
+
+InputWaitTable::Sentinel::~Sentinel() {
+	InputWaitTable::cancelAll(*this);
+}
+
+InputWaitTable::~InputWaitTable() {
+	// -- The sentinels unlink their waiters as the map destroys them.
+}
+
+void InputWaitTable::makeEmpty(InputWaiter& sentinel) {
+	sentinel.next = &sentinel;
+	sentinel.previous = &sentinel;
+}
+
+void InputWaitTable::cancelAll(InputWaiter& sentinel) {
+	while (sentinel.next != &sentinel) {
+		sentinel.next->cancel();
+	}
+}
+
+void InputWaitTable::add(const unsigned int code, InputWaiter& waiter) {
+	waiter.cancel();
+	Sentinel& list = this->lists[code];
+	waiter.next = &list;
+	waiter.previous = list.previous;
+	list.previous->next = &waiter;
+	list.previous = &waiter;
+	waiter.table = this;
+	++this->waiterCount;
+}
+
+void InputWaitTable::wake(const unsigned int code) {
+	if (this->waiterCount == 0) {
+		return;
+	}
+	// -- Detach both lists before resuming anyone. A waiter resumed for the code that 
+	// -- waits again for any code must not be woken a second time by the same event.
+	Sentinel keyWaiters;
+	Sentinel anyWaiters;
+	this->detachList(code, keyWaiters);
+	if (code != ANY) {
+		this->detachList(ANY, anyWaiters);
+	}
+	resumeList(keyWaiters, code);
+	resumeList(anyWaiters, code);
+}
+
+void InputWaitTable::detachList(const unsigned int listCode, Sentinel& pending) {
+	std::map<unsigned int, Sentinel>::iterator found = this->lists.find(listCode);
+	if (found == this->lists.end()) {
+		return;
+	}
+	Sentinel& list = found->second;
+	if (list.next != &list) {
+		pending.next = list.next;
+		pending.previous = list.previous;
+		pending.next->previous = &pending;
+		pending.previous->next = &pending;
+		makeEmpty(list);
+	}
+}
+
+void InputWaitTable::resumeList(Sentinel& pending, const unsigned int code) {
+	while (pending.next != &pending) {
+		InputWaiter* waiter = pending.next;
+		waiter->cancel();
+		waiter->inputArrived(code);
+	}
+}
+
+} // namespace I43D
@@ -0,0 +1,310 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+#include "I43DInstrumentation.h"
+#include "I43DAtomic.h"
+#include "I43DThreading.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#if defined( _MSC_VER )
+#	define I43D_THREAD_LOCAL __declspec( thread )
+#else
+#	define I43D_THREAD_LOCAL __thread
+#endif
+
+namespace I43D {
+
+unsigned int LatencyHistogram::getCount() const {
+	unsigned int count = 0;
+	for (unsigned int bucket = 0; bucket < BUCKET_COUNT; ++bucket) {
+		count += this->buckets[bucket];
+	}
+	return count;
+}
+
+Timestamp LatencyHistogram::getPercentile(const float fraction) const {
+	const unsigned int count = this->getCount();
+	if (count == 0) {
+		return 0;
+	}
+	const double wanted = static_cast<double>(fraction) * count;
+	unsigned int seen = 0;
+	for (unsigned int bucket = 0; bucket < BUCKET_COUNT; ++bucket) {
+		seen += this->buckets[bucket];
+		if (seen >= wanted && seen != 0) {
+			return static_cast<Timestamp>(1) << bucket;
+		}
+	}
+	return static_cast<Timestamp>(1) << (BUCKET_COUNT - 1);
+}
+
+double InstrumentationSnapshot::getEventRate(const InstrumentationSnapshot& earlier, 
+                                             const DeviceID device) const {
+	if (device >= MAX_DEVICES || this->time <= earlier.time) {
+		return 0.0;
+	}
+	const unsigned int events = this->devices[device].events - earlier.devices[device].events;
+	return events * 1000000.0 / static_cast<double>(this->time - earlier.time);
+}
+
+#if defined( I43D_INSTRUMENTATION )
+
+namespace {
+
+/*!
+ * @brief
+ *     The counters recorded by one thread.
+ * @remarks
+ *     Only the owning thread writes a buffer. The 32 bit counters are published with 
+ *     release stores; the listener table holds 64 bit times, so writes to it are 
+ *     bracketed by a sequence number the snapshot checks, like a seqlock.
+ */
+struct ThreadBuffer {
+	DeviceCounters devices[InstrumentationSnapshot::MAX_DEVICES];
+	DeviceCounters otherDevices;
+	LatencyHistogram latency[LATENCY_STAGE_COUNT];
+	ListenerTiming listeners[InstrumentationSnapshot::MAX_LISTENERS];
+	ListenerTiming otherListeners;
+	volatile unsigned int sequence;
+	ThreadBuffer* next;
+};
+
+/*! @brief Guards the list of buffers. */
+Mutex buffersLock;
+
+/*! @brief Every buffer ever created. Buffers outlive their threads so no count is lost. */
+ThreadBuffer* buffers = 0;
+
+/*! @brief The buffer of the calling thread. */
+I43D_THREAD_LOCAL ThreadBuffer* threadBuffer = 0;
+
+ThreadBuffer& getThreadBuffer() {
+	ThreadBuffer* buffer = threadBuffer;
+	if (buffer == 0) {
+		buffer = new ThreadBuffer;
+		memset(buffer, 0, sizeof(ThreadBuffer));
+		ScopedLock lock(buffersLock);
+		buffer->next = buffers;
+		buffers = buffer;
+		threadBuffer = buffer;
+	}
+	return *buffer;
+}
+
+/*!
+ * @brief
+ *     Adds one to a counter that only the calling thread writes.
+ */
+inline void increment(unsigned int& counter) {
+	volatile unsigned int& shared = counter;
+	atomicStore(shared, shared + 1);
+}
+
+inline unsigned int read(const unsigned int& counter) {
+	return atomicLoad(counter);
+}
+
+/*!
+ * @brief
+ *     Orders listener timings by total time, longest first.
+ */
+bool slowerListener(const ListenerTiming& left, const ListenerTiming& right) {
+	return left.totalTime > right.totalTime;
+}
+
+inline DeviceCounters& getDevice(ThreadBuffer& buffer, const DeviceID device) {
+	return device < InstrumentationSnapshot::MAX_DEVICES 
+		? buffer.devices[device] : buffer.otherDevices;
+}
+
+/*!
+ * @brief
+ *     Adds the counters of a thread to those of a snapshot.
+ */
+void addCounters(DeviceCounters& target, const DeviceCounters& source) {
+	target.events += read(source.events);
+	target.coalesced += read(source.coalesced);
+	target.dropped += read(source.dropped);
+	target.queueHighWater = std::max(target.queueHighWater, read(source.queueHighWater));
+}
+
+} // namespace
+
+void instrumentEvent(const DeviceID device, const Timestamp eventTime, const Timestamp now, 
+                     const unsigned int queueSize) {
+	ThreadBuffer& buffer = getThreadBuffer();
+	DeviceCounters& counters = getDevice(buffer, device);
+	increment(counters.events);
+	if (queueSize > counters.queueHighWater) {
+		volatile unsigned int& highWater = counters.queueHighWater;
+		atomicStore(highWater, queueSize);
+	}
+	// -- Events stamped on another clock or synthesized without a time are not timed.
+	if (eventTime != 0 && eventTime <= now) {
+		instrumentLatency(LATENCY_ENQUEUE, now - eventTime);
+	}
+}
+
+void instrumentCoalesced(const DeviceID device, const unsigned int count) {
+	volatile unsigned int& coalesced = getDevice(getThreadBuffer(), device).coalesced;
+	atomicStore(coalesced, coalesced + count);
+}
+
+void instrumentDropped(const DeviceID device) {
+	increment(getDevice(getThreadBuffer(), device).dropped);
+}
+
+void instrumentLatency(const LatencyStage stage, const Timestamp elapsed) {
+	unsigned int bucket = 0;
+	Timestamp remaining = elapsed;
+	while (remaining != 0 && bucket < LatencyHistogram::BUCKET_COUNT - 1) {
+		remaining >>= 1;
+		++bucket;
+	}
+	increment(getThreadBuffer().latency[stage].buckets[bucket]);
+}
+
+void instrumentListener(const void* listener, const Timestamp elapsed) {
+	ThreadBuffer& buffer = getThreadBuffer();
+	const unsigned int mask = InstrumentationSnapshot::MAX_LISTENERS - 1;
+	const size_t key = reinterpret_cast<size_t>(listener);
+	unsigned int slot = static_cast<unsigned int>((key >> 4) * 2654435761u) & mask;
+	ListenerTiming* timing = &buffer.otherListeners;
+	for (unsigned int probe = 0; probe <= mask; ++probe) {
+		ListenerTiming& candidate = buffer.listeners[(slot + probe) & mask];
+		if (candidate.listener == listener || candidate.listener == 0) {
+			timing = &candidate;
+			break;
+		}
+	}
+	atomicAdd(buffer.sequence, 1);
+	timing->listener = timing == &buffer.otherListeners ? 0 : listener;
+	timing->calls++;
+	timing->totalTime += elapsed;
+	if (elapsed > timing->maximumTime) {
+		timing->maximumTime = elapsed;
+	}
+	atomicAdd(buffer.sequence, 1);
+}
+
+void getInstrumentationSnapshot(InstrumentationSnapshot& snapshot) {
+	memset(&snapshot, 0, sizeof(snapshot));
+	snapshot.time = getTimestamp();
+	std::vector<ListenerTiming> listeners;
+	ListenerTiming other;
+	memset(&other, 0, sizeof(other));
+
+	ScopedLock lock(buffersLock);
+	for (ThreadBuffer* buffer = buffers; buffer != 0; buffer = buffer->next) {
+		for (unsigned int device = 0; device < InstrumentationSnapshot::MAX_DEVICES; ++device) {
+			addCounters(snapshot.devices[device], buffer->devices[device]);
+		}
+		addCounters(snapshot.otherDevices, buffer->otherDevices);
+		for (unsigned int stage = 0; stage < LATENCY_STAGE_COUNT; ++stage) {
+			for (unsigned int bucket = 0; bucket < LatencyHistogram::BUCKET_COUNT; ++bucket) {
+				snapshot.latency[stage].buckets[bucket] += 
+					read(buffer->latency[stage].buckets[bucket]);
+			}
+		}
+
+		// -- Copy the listener table whole so its 64 bit times are consistent.
+		ListenerTiming table[InstrumentationSnapshot::MAX_LISTENERS + 1];
+		for (;;) {
+			const unsigned int before = atomicLoad(buffer->sequence);
+			if ((before & 1) == 0) {
+				memcpy(table, buffer->listeners, sizeof(buffer->listeners));
+				table[InstrumentationSnapshot::MAX_LISTENERS] = buffer->otherListeners;
+				atomicFence();
+				if (atomicLoad(buffer->sequence) == before) {
+					break;
+				}
+			}
+		}
+		for (unsigned int idx = 0; idx <= InstrumentationSnapshot::MAX_LISTENERS; ++idx) {
+			const ListenerTiming& timing = table[idx];
+			if (timing.calls == 0) {
+				continue;
+			}
+			ListenerTiming* target = &other;
+			if (timing.listener != 0) {
+				target = 0;
+				for (size_t found = 0; found < listeners.size(); ++found) {
+					if (listeners[found].listener == timing.listener) {
+						target = &listeners[found];
+						break;
+					}
+				}
+				if (target == 0) {
+					listeners.push_back(timing);
+					continue;
+				}
+			}
+			target->calls += timing.calls;
+			target->totalTime += timing.totalTime;
+			target->maximumTime = std::max(target->maximumTime, timing.maximumTime);
+		}
+	}
+
+	// -- Keep the slowest listeners and fold the rest into one entry without a listener.
+	std::sort(listeners.begin(), listeners.end(), slowerListener);
+	const unsigned int kept = other.calls != 0 || 
+		listeners.size() > InstrumentationSnapshot::MAX_LISTENERS ? 
+		InstrumentationSnapshot::MAX_LISTENERS - 1 : static_cast<unsigned int>(listeners.size());
+	for (size_t idx = kept; idx < listeners.size(); ++idx) {
+		other.calls += listeners[idx].calls;
+		other.totalTime += listeners[idx].totalTime;
+		other.maximumTime = std::max(other.maximumTime, listeners[idx].maximumTime);
+	}
+	const unsigned int count = std::min(kept, static_cast<unsigned int>(listeners.size()));
+	std::copy(listeners.begin(), listeners.begin() + count, snapshot.listeners);
+	snapshot.listenerCount = count;
+	if (other.calls != 0) {
+		other.listener = 0;
+		snapshot.listeners[snapshot.listenerCount++] = other;
+	}
+}
+
+#else
+
+void instrumentEvent(const DeviceID device, const Timestamp eventTime, const Timestamp now, 
+                     const unsigned int queueSize) {
+}
+
+void instrumentCoalesced(const DeviceID device, const unsigned int count) {
+}
+
+void instrumentDropped(const DeviceID device) {
+}
+
+void instrumentLatency(const LatencyStage stage, const Timestamp elapsed) {
+}
+
+void instrumentListener(const void* listener, const Timestamp elapsed) {
+}
+
+void getInstrumentationSnapshot(InstrumentationSnapshot& snapshot) {
+	memset(&snapshot, 0, sizeof(snapshot));
+	snapshot.time = getTimestamp();
+}
+
+#endif
+
+} // namespace I43D
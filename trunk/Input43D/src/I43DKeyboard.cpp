@@ -0,0 +1,269 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+
+#include "I43DKeyboard.h"
+#include "I43DInstrumentation.h"
+
+namespace I43D {
+
+Keyboard::Keyboard() : repeatTimer(*this), charEventsEnabled(true) {
+	KeyRepeatSettings repeat;
+	repeat.enabled = true;
+	repeat.delay = 500000;
+	repeat.interval = 33333;
+	KeyRepeatSettings noRepeat = repeat;
+	noRepeat.enabled = false;
+	for (unsigned int idx = 0; idx < KEYCLASS_COUNT; ++idx) {
+		this->repeatSettings[idx] = noRepeat;
+	}
+	this->repeatSettings[KEYCLASS_PRINTABLE] = repeat;
+	this->repeatSettings[KEYCLASS_EDITING] = repeat;
+	this->repeatSettings[KEYCLASS_NAVIGATION] = repeat;
+	for (unsigned int idx = 0; idx < MAX_TRACKED_KEYS / 32; ++idx) {
+		this->keysDown[idx] = 0;
+	}
+}
+
+KeyClass Keyboard::getKeyClass(const unsigned short keyNum) {
+	switch (this->getNPKForKeyNum(keyNum)) {
+		case NPK_NONE:
+			return KEYCLASS_PRINTABLE;
+		case NPK_ENTER: case NPK_BACKSPACE: case NPK_INSERT: case NPK_DELETE:
+		case NPK_NUMPAD_INSERT: case NPK_NUMPAD_DELETE:
+			return KEYCLASS_EDITING;
+		case NPK_UP: case NPK_DOWN: case NPK_LEFT: case NPK_RIGHT:
+		case NPK_HOME: case NPK_END: case NPK_PGUP: case NPK_PGDOWN:
+		case NPK_NUMPAD_HOME: case NPK_NUMPAD_UP: case NPK_NUMPAD_PGUP: case NPK_NUMPAD_LEFT:
+		case NPK_NUMPAD_CENTER: case NPK_NUMPAD_RIGHT: case NPK_NUMPAD_END: 
+		case NPK_NUMPAD_DOWN: case NPK_NUMPAD_PGDN:
+			return KEYCLASS_NAVIGATION;
+		case NPK_LCONTROL: case NPK_RCONTROL: case NPK_LSHIFT: case NPK_RSHIFT:
+		case NPK_RALT: case NPK_LALT: case NPK_LOS: case NPK_ROS:
+		case NPK_CAPSLOCK: case NPK_NUMLOCK: case NPK_SCROLL_LOCK:
+			return KEYCLASS_MODIFIER;
+		case NPK_POWER: case NPK_SLEEP: case NPK_WAKE: 
+		case NPK_SYSRQ: case NPK_PAUSE: case NPK_BREAK:
+			return KEYCLASS_SYSTEM;
+		case NPK_F1: case NPK_F2: case NPK_F3: case NPK_F4: case NPK_F5: case NPK_F6: 
+		case NPK_F7: case NPK_F8: case NPK_F9: case NPK_F10: case NPK_F11: case NPK_F12: 
+		case NPK_F13: case NPK_F14: case NPK_F15: case NPK_ESCAPE: case NPK_APPS:
+			return KEYCLASS_FUNCTION;
+		default:
+			return KEYCLASS_MEDIA;
+	}
+}
+
+void Keyboard::setKeyRepeat(const KeyClass keyClass, const KeyRepeatSettings& settings) {
+	this->repeatSettings[keyClass] = settings;
+}
+
+void Keyboard::update(const Timestamp now) {
+	this->timerWheel.advance(now);
+	this->flushTextInput();
+}
+
+void Keyboard::flushTextInput() {
+	if (this->textBuffer.isEmpty()) {
+		return;
+	}
+	const TextInput text = this->textBuffer.getText();
+	std::set<KeyboardListener*>::const_iterator iter;
+	for (iter = this->listeners.begin(); iter != this->listeners.end(); ++iter) {
+		I43D_TIME_LISTENER(*iter);
+		(*iter)->textInput(this, text);
+	}
+	this->textBuffer.clear();
+}
+
+bool Keyboard::fireKeyPressed(const unsigned short keyNum, const unsigned int scanCode, 
+                              const Timestamp time) {
+	if (this->isKeyDown(keyNum)) {
+		return false;
+	}
+	if (keyNum < MAX_TRACKED_KEYS) {
+		this->keysDown[keyNum >> 5] |= 1u << (keyNum & 31);
+	}
+
+	// -- Only the key pressed last repeats. Modifiers do not interrupt the repeat so that
+	// -- pressing shift while holding a key keeps it repeating.
+	const KeyClass keyClass = this->getKeyClass(keyNum);
+	const KeyRepeatSettings& settings = this->repeatSettings[keyClass];
+	if (settings.enabled) {
+		this->repeatTimer.keyNum = keyNum;
+		this->repeatTimer.scanCode = scanCode;
+		this->repeatTimer.repeatChar = 0;
+		this->repeatTimer.npk = this->getNPKForKeyNum(keyNum);
+		this->repeatTimer.repeatCount = 0;
+		this->repeatTimer.interval = settings.interval;
+		this->timerWheel.schedule(&this->repeatTimer, time + settings.delay);
+	} else if (keyClass != KEYCLASS_MODIFIER) {
+		this->timerWheel.cancel(&this->repeatTimer);
+	}
+
+	std::set<KeyboardListener*>::const_iterator iter;
+	for (iter = this->listeners.begin(); iter != this->listeners.end(); ++iter) {
+		I43D_TIME_LISTENER(*iter);
+		(*iter)->keyPressed(this, keyNum, scanCode);
+	}
+	this->pressWaits.wake(keyNum);
+	return true;
+}
+
+void Keyboard::fireKeyReleased(const unsigned short keyNum, const unsigned int scanCode) {
+	if (keyNum < MAX_TRACKED_KEYS) {
+		this->keysDown[keyNum >> 5] &= ~(1u << (keyNum & 31));
+	}
+	if (this->repeatTimer.keyNum == keyNum) {
+		this->timerWheel.cancel(&this->repeatTimer);
+	}
+
+	std::set<KeyboardListener*>::const_iterator iter;
+	for (iter = this->listeners.begin(); iter != this->listeners.end(); ++iter) {
+		I43D_TIME_LISTENER(*iter);
+		(*iter)->keyReleased(this, keyNum, scanCode);
+	}
+	this->releaseWaits.wake(keyNum);
+}
+
+void Keyboard::fireKeyRepeated(const unsigned short keyNum, const unsigned int scanCode, 
+                               const unsigned int repeatCount, const Timestamp time) {
+	std::set<KeyboardListener*>::const_iterator iter;
+	for (iter = this->listeners.begin(); iter != this->listeners.end(); ++iter) {
+		I43D_TIME_LISTENER(*iter);
+		(*iter)->keyRepeated(this, keyNum, scanCode, repeatCount, time);
+	}
+}
+
+void Keyboard::fireCharTyped(const wchar_t typedChar) {
+	// -- Surrogate halves can not be repeated on their own so they are not remembered.
+	if (this->repeatTimer.isScheduled() && this->repeatTimer.repeatCount == 0
+	    && (sizeof(wchar_t) > 2 || typedChar < 0xD800 || typedChar > 0xDFFF)) {
+		this->repeatTimer.repeatChar = static_cast<UnicodeChar>(typedChar);
+	}
+
+	if (this->textBuffer.appendWide(typedChar) == false) {
+		this->flushTextInput();
+		this->textBuffer.appendWide(typedChar);
+	}
+	if (this->charEventsEnabled) {
+		std::set<KeyboardListener*>::const_iterator iter;
+		for (iter = this->listeners.begin(); iter != this->listeners.end(); ++iter) {
+			I43D_TIME_LISTENER(*iter);
+			(*iter)->charTyped(this, typedChar);
+		}
+	}
+}
+
+void Keyboard::fireText(const wchar_t* text, const unsigned int length) {
+	for (unsigned int idx = 0; idx < length; ++idx) {
+		if (this->textBuffer.appendWide(text[idx]) == false) {
+			this->flushTextInput();
+			this->textBuffer.appendWide(text[idx]);
+		}
+	}
+	if (this->charEventsEnabled) {
+		for (unsigned int idx = 0; idx < length; ++idx) {
+			std::set<KeyboardListener*>::const_iterator iter;
+			for (iter = this->listeners.begin(); iter != this->listeners.end(); ++iter) {
+				I43D_TIME_LISTENER(*iter);
+				(*iter)->charTyped(this, text[idx]);
+			}
+		}
+	}
+}
+
+void Keyboard::fireKeySymbol(const ComposeSymbol symbol) {
+	const UnicodeChar* text = 0;
+	unsigned int length = 0;
+	switch (this->composeState.feed(symbol, text, length)) {
+		case COMPOSE_IGNORED:
+			if ((symbol & COMPOSE_KEYSYM_FLAG) == 0) {
+				if (this->repeatTimer.isScheduled() && this->repeatTimer.repeatCount == 0) {
+					this->repeatTimer.repeatChar = symbol;
+				}
+				this->fireCodePoint(symbol);
+			}
+			break;
+		case COMPOSE_COMPLETE:
+			for (unsigned int idx = 0; idx < length; ++idx) {
+				this->fireCodePoint(text[idx]);
+			}
+			break;
+		default:
+			break;
+	}
+}
+
+void Keyboard::fireCodePoint(const UnicodeChar codePoint) {
+	if (this->textBuffer.append(codePoint) == false) {
+		this->flushTextInput();
+		this->textBuffer.append(codePoint);
+	}
+	if (this->charEventsEnabled == false) {
+		return;
+	}
+	// -- Where wchar_t is 16 bits wide characters beyond the BMP are passed as surrogates.
+	wchar_t units[2];
+	unsigned int unitCount = 1;
+	if (sizeof(wchar_t) == 2 && codePoint > 0xFFFF && codePoint <= 0x10FFFF) {
+		units[0] = static_cast<wchar_t>(0xD800 + ((codePoint - 0x10000) >> 10));
+		units[1] = static_cast<wchar_t>(0xDC00 + ((codePoint - 0x10000) & 0x3FF));
+		unitCount = 2;
+	} else {
+		units[0] = static_cast<wchar_t>(codePoint);
+	}
+	for (unsigned int idx = 0; idx < unitCount; ++idx) {
+		std::set<KeyboardListener*>::const_iterator iter;
+		for (iter = this->listeners.begin(); iter != this->listeners.end(); ++iter) {
+			I43D_TIME_LISTENER(*iter);
+			(*iter)->charTyped(this, units[idx]);
+		}
+	}
+}
+
+void Keyboard::fireNonPrintKeyTyped(const NPKeyID typedKey) {
+	std::set<KeyboardListener*>::const_iterator iter;
+	for (iter = this->listeners.begin(); iter != this->listeners.end(); ++iter) {
+		I43D_TIME_LISTENER(*iter);
+		(*iter)->nonPrintKeyTyped(this, typedKey);
+	}
+}
+
+void Keyboard::RepeatTimer::timerExpired(const Timestamp deadline, const Timestamp now) {
+	// -- Catch up on all of the repeats that were due since the last update, each with its
+	// -- own exact time, so the repeat rate does not depend on the frame rate.
+	Timestamp due = deadline;
+	do {
+		++this->repeatCount;
+		this->keyboard.fireKeyRepeated(this->keyNum, this->scanCode, this->repeatCount, due);
+		if (this->repeatChar != 0) {
+			this->keyboard.fireCodePoint(this->repeatChar);
+		} else if (this->npk != NPK_NONE) {
+			this->keyboard.fireNonPrintKeyTyped(this->npk);
+		}
+		due += this->interval;
+	} while (due <= now && this->interval > 0);
+
+	if (this->interval > 0) {
+		this->keyboard.timerWheel.schedule(this, due);
+	}
+}
+
+} // namespace I43D 
@@ -0,0 +1,186 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+
+#include "I43DMappedFile.h"
+#include <cstdio>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#if defined( _WIN32 )
+#	define WIN32_LEAN_AND_MEAN
+#	include <windows.h>
+#else
+#	include <fcntl.h>
+#	include <stdlib.h>
+#	include <sys/mman.h>
+#	include <unistd.h>
+#endif
+
+namespace I43D {
+
+MappedFile::MappedFile() : data(0), size(0) {
+#if defined( _WIN32 )
+	this->mapping = 0;
+#endif
+}
+
+MappedFile::~MappedFile() {
+	this->close();
+}
+
+bool MappedFile::open(const std::string& path) {
+	this->close();
+#if defined( _WIN32 )
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, 
+	                          FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	const DWORD fileSize = GetFileSize(file, NULL);
+	if (fileSize == 0 || fileSize == INVALID_FILE_SIZE) {
+		CloseHandle(file);
+		return false;
+	}
+	// -- The mapping keeps the file open so the file handle is not needed any more.
+	HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	CloseHandle(file);
+	if (mapping == NULL) {
+		return false;
+	}
+	const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (view == NULL) {
+		CloseHandle(mapping);
+		return false;
+	}
+	this->mapping = mapping;
+	this->data = view;
+	this->size = fileSize;
+#else
+	const int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return false;
+	}
+	struct stat info;
+	if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+		::close(fd);
+		return false;
+	}
+	// -- The mapping keeps the file open so the descriptor is not needed any more.
+	void* view = mmap(0, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (view == MAP_FAILED) {
+		return false;
+	}
+	this->data = view;
+	this->size = static_cast<size_t>(info.st_size);
+#endif
+	return true;
+}
+
+void MappedFile::close() {
+	if (this->data == 0) {
+		return;
+	}
+#if defined( _WIN32 )
+	UnmapViewOfFile(this->data);
+	CloseHandle(this->mapping);
+	this->mapping = 0;
+#else
+	munmap(const_cast<void*>(this->data), this->size);
+#endif
+	this->data = 0;
+	this->size = 0;
+}
+
+bool MappedFile::getFileStamp(const std::string& path, unsigned int& size, unsigned int& time) {
+#if defined( _WIN32 )
+	struct _stat info;
+	if (_stat(path.c_str(), &info) != 0) {
+		return false;
+	}
+#else
+	struct stat info;
+	if (stat(path.c_str(), &info) != 0) {
+		return false;
+	}
+#endif
+	size = static_cast<unsigned int>(info.st_size);
+	time = static_cast<unsigned int>(info.st_mtime);
+	return true;
+}
+
+bool MappedFile::writeFile(const std::string& path, const void* contents, const size_t size) {
+	// -- Every writer gets its own temporary file so processes regenerating the same file 
+	// -- at once do not write into each other's copy. The last rename wins.
+#if defined( _WIN32 )
+	static volatile LONG counter = 0;
+	char suffix[64];
+	_snprintf(suffix, sizeof(suffix), ".%lu.%lu.%ld.tmp", GetCurrentProcessId(), 
+	          GetCurrentThreadId(), InterlockedIncrement(&counter));
+	suffix[sizeof(suffix) - 1] = 0;
+	const std::string tempPath = path + suffix;
+	HANDLE file = CreateFileA(tempPath.c_str(), GENERIC_WRITE, 0, NULL, CREATE_NEW, 
+	                          FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	const char* bytes = static_cast<const char*>(contents);
+	size_t done = 0;
+	while (done < size) {
+		DWORD wrote = 0;
+		const DWORD chunk = (size - done > 0x10000000) 
+			? 0x10000000 : static_cast<DWORD>(size - done);
+		if (WriteFile(file, bytes + done, chunk, &wrote, NULL) == FALSE || wrote == 0) {
+			break;
+		}
+		done += wrote;
+	}
+	if (CloseHandle(file) == FALSE || done != size
+	    || MoveFileExA(tempPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) == FALSE) {
+		DeleteFileA(tempPath.c_str());
+		return false;
+	}
+	return true;
+#else
+	std::string tempPath = path + ".XXXXXX";
+	const int fd = mkstemp(&tempPath[0]);
+	if (fd < 0) {
+		return false;
+	}
+	// -- mkstemp creates the file readable by its owner only but the file is shared.
+	fchmod(fd, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+	const char* bytes = static_cast<const char*>(contents);
+	size_t done = 0;
+	while (done < size) {
+		const ssize_t wrote = ::write(fd, bytes + done, size - done);
+		if (wrote <= 0) {
+			break;
+		}
+		done += static_cast<size_t>(wrote);
+	}
+	if (::close(fd) != 0 || done != size || rename(tempPath.c_str(), path.c_str()) != 0) {
+		unlink(tempPath.c_str());
+		return false;
+	}
+	return true;
+#endif
+}
+
+} // namespace I43D 
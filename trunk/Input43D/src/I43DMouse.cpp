@@ -0,0 +1,84 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+
+#include "I43DMouse.h"
+#include "I43DInstrumentation.h"
+
+namespace I43D {
+
+void Mouse::fireMoved(const unsigned int x, const unsigned int y) {
+	std::set<MouseListener*>::const_iterator iter;
+	for (iter = this->listeners.begin(); iter != this->listeners.end(); ++iter) {
+		I43D_TIME_LISTENER(*iter);
+		(*iter)->moved(this, x, y);
+	}
+}
+
+void Mouse::fireButtonPressed(const unsigned short buttonNum) {
+	std::set<MouseListener*>::const_iterator iter;
+	for (iter = this->listeners.begin(); iter != this->listeners.end(); ++iter) {
+		I43D_TIME_LISTENER(*iter);
+		(*iter)->buttonPressed(this, buttonNum);
+	}
+	this->pressWaits.wake(buttonNum);
+}
+
+void Mouse::fireButtonReleased(const unsigned short buttonNum) {
+	std::set<MouseListener*>::const_iterator iter;
+	for (iter = this->listeners.begin(); iter != this->listeners.end(); ++iter) {
+		I43D_TIME_LISTENER(*iter);
+		(*iter)->buttonReleased(this, buttonNum);
+	}
+}
+
+void Mouse::fireButtonClicked(const unsigned short buttonNum, const unsigned short clickCount) {
+	std::set<MouseListener*>::const_iterator iter;
+	for (iter = this->listeners.begin(); iter != this->listeners.end(); ++iter) {
+		I43D_TIME_LISTENER(*iter);
+		(*iter)->buttonClicked(this, buttonNum, clickCount);
+	}
+	this->clickWaits.wake(buttonNum);
+}
+
+void Mouse::fireScrolled(const MouseScrollDirection direction) {
+	std::set<MouseListener*>::const_iterator iter;
+	for (iter = this->listeners.begin(); iter != this->listeners.end(); ++iter) {
+		I43D_TIME_LISTENER(*iter);
+		(*iter)->scrollUp(this, direction);
+	}
+}
+
+void Mouse::fireEntered() {
+	std::set<MouseListener*>::const_iterator iter;
+	for (iter = this->listeners.begin(); iter != this->listeners.end(); ++iter) {
+		I43D_TIME_LISTENER(*iter);
+		(*iter)->entered(this);
+	}
+}
+
+void Mouse::fireExited() {
+	std::set<MouseListener*>::const_iterator iter;
+	for (iter = this->listeners.begin(); iter != this->listeners.end(); ++iter) {
+		I43D_TIME_LISTENER(*iter);
+		(*iter)->exited(this);
+	}
+}
+
+} // namespace I43D 
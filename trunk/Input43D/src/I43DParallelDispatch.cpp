@@ -0,0 +1,239 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+#include "I43DParallelDispatch.h"
+#include "I43DInstrumentation.h"
+
+namespace I43D {
+
+/*!
+ * @brief
+ *     Runs the batches of one listener in order, one at a time.
+ * @remarks
+ *     The strand is submitted to the pool when it receives a batch while idle and runs
+ *     until it has no batches left, so at most one thread ever works for the listener.
+ *     <br><br>
+ *     The batches wait in a ring that only grows when more of them are waiting than ever
+ *     before. A batch is shared by the strands of all listeners, so it can not be linked
+ *     into their queues itself.
+ */
+class ParallelEventDispatcher::Strand : public PoolTask {
+public:
+	Strand(ParallelEventDispatcher& dispatcher, InputBatchListener* listener) 
+		: dispatcher(dispatcher), listener(listener), queue(INITIAL_CAPACITY), head(0), 
+		  size(0), scheduled(false) {}
+
+	/*!
+	 * @brief
+	 *     Queues a batch for the listener.
+	 */
+	void post(Batch* batch) {
+		bool schedule = false;
+		{
+			ScopedLock guard(this->lock);
+			const unsigned int capacity = static_cast<unsigned int>(this->queue.size());
+			if (this->size == capacity) {
+				std::vector<Batch*> larger(capacity * 2);
+				for (unsigned int idx = 0; idx < this->size; ++idx) {
+					larger[idx] = this->queue[(this->head + idx) & (capacity - 1)];
+				}
+				this->queue.swap(larger);
+				this->head = 0;
+			}
+			const unsigned int mask = static_cast<unsigned int>(this->queue.size()) - 1;
+			this->queue[(this->head + this->size) & mask] = batch;
+			++this->size;
+			schedule = this->scheduled == false;
+			this->scheduled = true;
+		}
+		if (schedule) {
+			this->dispatcher.pool->submit(this);
+		}
+	}
+
+	/*!
+	 * @brief
+	 *     Hands a batch to the listener.
+	 */
+	void deliver(Batch* batch) {
+		if (batch->events.empty() == false) {
+			I43D_TIME_LISTENER(this->listener);
+			this->listener->eventsReceived(&batch->events[0], 
+			                               static_cast<unsigned int>(batch->events.size()));
+		}
+	}
+
+	/*!
+	 * @brief
+	 *     Points the strand at another listener. Only while it is idle.
+	 */
+	inline void setListener(InputBatchListener* listener) {
+		this->listener = listener;
+	}
+
+protected:
+	virtual void run() {
+		for (;;) {
+			Batch* batch = 0;
+			{
+				ScopedLock guard(this->lock);
+				if (this->size == 0) {
+					this->scheduled = false;
+					return;
+				}
+				batch = this->queue[this->head];
+				this->head = (this->head + 1) & (static_cast<unsigned int>(this->queue.size()) - 1);
+				--this->size;
+			}
+			this->deliver(batch);
+			this->dispatcher.finish(batch);
+		}
+	}
+
+private:
+	/*! @brief The batches the ring holds at first. A power of two. */
+	enum { INITIAL_CAPACITY = 4 };
+
+	Strand& operator=(const Strand&);
+
+	ParallelEventDispatcher& dispatcher;
+	InputBatchListener* listener;
+	Mutex lock;
+	std::vector<Batch*> queue;
+	unsigned int head;
+	unsigned int size;
+	bool scheduled;
+};
+
+ParallelEventDispatcher::ParallelEventDispatcher(WorkerPool* pool) : pool(pool), pending(0) {
+	this->current = this->acquire();
+}
+
+ParallelEventDispatcher::~ParallelEventDispatcher() {
+	this->join();
+	if (this->pool != 0) {
+		this->pool->wait();
+	}
+	for (std::map<InputBatchListener*, Strand*>::iterator iter = this->strands.begin(); 
+	     iter != this->strands.end(); ++iter) {
+		delete iter->second;
+	}
+	for (unsigned int idx = 0; idx < this->retired.size(); ++idx) {
+		delete this->retired[idx];
+	}
+	for (unsigned int idx = 0; idx < this->batches.size(); ++idx) {
+		delete this->batches[idx];
+	}
+}
+
+bool ParallelEventDispatcher::pushEvent(const InputEvent& event) {
+	this->current->events.push_back(event);
+	return true;
+}
+
+void ParallelEventDispatcher::dispatch() {
+	if (this->current->events.empty() || this->strands.empty()) {
+		this->current->events.clear();
+		return;
+	}
+	std::map<InputBatchListener*, Strand*>::iterator iter;
+	if (this->pool == 0) {
+		for (iter = this->strands.begin(); iter != this->strands.end(); ++iter) {
+			iter->second->deliver(this->current);
+		}
+		this->current->events.clear();
+		return;
+	}
+	Batch* batch = this->current;
+	const unsigned int count = static_cast<unsigned int>(this->strands.size());
+	batch->references = count;
+	atomicAdd(this->pending, count);
+	this->current = this->acquire();
+	for (iter = this->strands.begin(); iter != this->strands.end(); ++iter) {
+		iter->second->post(batch);
+	}
+}
+
+void ParallelEventDispatcher::join() {
+	ScopedLock guard(this->joinLock);
+	while (atomicLoad(this->pending) != 0) {
+		this->finished.wait(this->joinLock);
+	}
+}
+
+void ParallelEventDispatcher::setPool(WorkerPool* pool) {
+	this->join();
+	this->pool = pool;
+}
+
+void ParallelEventDispatcher::addListener(InputBatchListener* listener) {
+	if (this->strands.find(listener) != this->strands.end()) {
+		return;
+	}
+	Strand* strand = 0;
+	if (this->retired.empty() == false) {
+		strand = this->retired.back();
+		this->retired.pop_back();
+		strand->setListener(listener);
+	} else {
+		strand = new Strand(*this, listener);
+	}
+	this->strands[listener] = strand;
+}
+
+void ParallelEventDispatcher::removeListener(InputBatchListener* listener) {
+	std::map<InputBatchListener*, Strand*>::iterator found = this->strands.find(listener);
+	if (found == this->strands.end()) {
+		return;
+	}
+	this->join();
+	// -- The strand may still be returning from its last task, so it is kept for reuse 
+	// -- instead of being deleted while a thread of the pool could touch it.
+	this->retired.push_back(found->second);
+	this->strands.erase(found);
+}
+
+void ParallelEventDispatcher::finish(Batch* batch) {
+	if (atomicAdd(batch->references, static_cast<unsigned int>(-1)) == 0) {
+		batch->events.clear();
+		ScopedLock guard(this->recycleLock);
+		this->recycled.push_back(batch);
+	}
+	if (atomicAdd(this->pending, static_cast<unsigned int>(-1)) == 0) {
+		ScopedLock guard(this->joinLock);
+		this->finished.broadcast();
+	}
+}
+
+ParallelEventDispatcher::Batch* ParallelEventDispatcher::acquire() {
+	{
+		ScopedLock guard(this->recycleLock);
+		if (this->recycled.empty() == false) {
+			Batch* batch = this->recycled.back();
+			this->recycled.pop_back();
+			return batch;
+		}
+	}
+	Batch* batch = new Batch();
+	batch->references = 0;
+	this->batches.push_back(batch);
+	return batch;
+}
+
+} // namespace I43D
@@ -0,0 +1,290 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+
+#include "I43DSeat.h"
+#include <cstring>
+
+namespace I43D {
+
+unsigned int SeatState::getControllerSlot(const DeviceID device, const bool claim) {
+	unsigned int freeSlot = MAX_CONTROLLERS;
+	for (unsigned int slot = 0; slot < MAX_CONTROLLERS; ++slot) {
+		if (this->controllers[slot] == device) {
+			return slot;
+		}
+		if (freeSlot == MAX_CONTROLLERS && this->controllers[slot] == INVALID_DEVICE_ID) {
+			freeSlot = slot;
+		}
+	}
+	if (claim && freeSlot < MAX_CONTROLLERS) {
+		this->controllers[freeSlot] = device;
+	}
+	return claim ? freeSlot : static_cast<unsigned int>(MAX_CONTROLLERS);
+}
+
+void SeatState::applyEvent(const InputEvent& event) {
+	this->time = event.time;
+	unsigned int slot;
+	switch (event.type) {
+		case IEVT_KEY_PRESSED:
+		case IEVT_KEY_RELEASED:
+			if (event.code < MAX_KEYS) {
+				const unsigned int bit = 1u << (event.code & 31);
+				if (event.type == IEVT_KEY_PRESSED) {
+					this->keys[event.code >> 5] |= bit;
+				} else {
+					this->keys[event.code >> 5] &= ~bit;
+				}
+			}
+			break;
+		case IEVT_MOUSE_MOVED:
+			this->mouseX = event.value;
+			this->mouseY = event.value2;
+			break;
+		case IEVT_MOUSE_BUTTON_PRESSED:
+		case IEVT_MOUSE_BUTTON_RELEASED:
+			if (event.code >= 1 && event.code <= 32) {
+				const unsigned int bit = 1u << (event.code - 1);
+				if (event.type == IEVT_MOUSE_BUTTON_PRESSED) {
+					this->mouseButtons |= bit;
+				} else {
+					this->mouseButtons &= ~bit;
+				}
+			}
+			break;
+		case IEVT_CONTROLLER_BUTTON_PRESSED:
+		case IEVT_CONTROLLER_BUTTON_RELEASED:
+			slot = this->getControllerSlot(event.device, true);
+			if (slot < MAX_CONTROLLERS && event.code >= 1 && event.code <= 32) {
+				const unsigned int bit = 1u << (event.code - 1);
+				if (event.type == IEVT_CONTROLLER_BUTTON_PRESSED) {
+					this->controllerButtons[slot] |= bit;
+				} else {
+					this->controllerButtons[slot] &= ~bit;
+				}
+			}
+			break;
+		case IEVT_CONTROLLER_AXIS_MOVED:
+			slot = this->getControllerSlot(event.device, true);
+			if (slot < MAX_CONTROLLERS && event.code < MAX_AXES) {
+				this->controllerAxes[slot][event.code] = event.value;
+			}
+			break;
+		case IEVT_DEVICE_CONNECTED:
+			if (event.code == DEVICE_GAME_CONTROLLER) {
+				this->getControllerSlot(event.device, true);
+			}
+			break;
+		case IEVT_DEVICE_DISCONNECTED:
+			slot = this->getControllerSlot(event.device, false);
+			if (slot < MAX_CONTROLLERS) {
+				this->controllers[slot] = INVALID_DEVICE_ID;
+				this->controllerButtons[slot] = 0;
+				memset(this->controllerAxes[slot], 0, sizeof(this->controllerAxes[slot]));
+			}
+			break;
+		default:
+			break;
+	}
+}
+
+Seat::Seat(const unsigned int index, const unsigned int queueCapacity) 
+	: index(index), queue(queueCapacity), sequence(0) {
+	memset(&this->state, 0, sizeof(this->state));
+}
+
+Seat::~Seat() {
+	while (this->keyboards.empty() == false) {
+		this->unbindKeyboard(this->keyboards.begin()->first);
+	}
+	while (this->mice.empty() == false) {
+		this->unbindMouse(this->mice.begin()->first);
+	}
+	while (this->controllers.empty() == false) {
+		this->unbindGameController(this->controllers.begin()->first);
+	}
+}
+
+void Seat::bindKeyboard(Keyboard* keyboard, const DeviceID device) {
+	this->unbindKeyboard(keyboard);
+	KeyboardEventTranslator* translator = new KeyboardEventTranslator(*this, device);
+	this->keyboards[keyboard] = translator;
+	keyboard->addKeyboardListener(translator);
+}
+
+void Seat::unbindKeyboard(Keyboard* keyboard) {
+	std::map<Keyboard*, KeyboardEventTranslator*>::iterator iter = this->keyboards.find(keyboard);
+	if (iter != this->keyboards.end()) {
+		keyboard->removeKeyboardListener(iter->second);
+		delete iter->second;
+		this->keyboards.erase(iter);
+	}
+}
+
+void Seat::bindMouse(Mouse* mouse, const DeviceID device) {
+	this->unbindMouse(mouse);
+	MouseEventTranslator* translator = new MouseEventTranslator(*this, device);
+	this->mice[mouse] = translator;
+	mouse->addMouseListener(translator);
+}
+
+void Seat::unbindMouse(Mouse* mouse) {
+	std::map<Mouse*, MouseEventTranslator*>::iterator iter = this->mice.find(mouse);
+	if (iter != this->mice.end()) {
+		mouse->removeMouseListener(iter->second);
+		delete iter->second;
+		this->mice.erase(iter);
+	}
+}
+
+void Seat::bindGameController(GameController* controller, const DeviceID device) {
+	this->unbindGameController(controller);
+	GameControllerEventTranslator* translator = new GameControllerEventTranslator(*this, device);
+	this->controllers[controller] = translator;
+	controller->addGameControllerListener(translator);
+}
+
+void Seat::unbindGameController(GameController* controller) {
+	std::map<GameController*, GameControllerEventTranslator*>::iterator iter = 
+		this->controllers.find(controller);
+	if (iter != this->controllers.end()) {
+		controller->removeGameControllerListener(iter->second);
+		delete iter->second;
+		this->controllers.erase(iter);
+	}
+}
+
+bool Seat::pushEvent(const InputEvent& event) {
+	// -- Odd sequence numbers tell readers that the state is being written.
+	atomicAdd(this->sequence, 1);
+	this->state.applyEvent(event);
+	atomicAdd(this->sequence, 1);
+	return this->queue.pushEvent(event);
+}
+
+void Seat::getState(SeatState& state) const {
+	for (;;) {
+		const unsigned int before = atomicLoad(this->sequence);
+		if ((before & 1) == 0) {
+			memcpy(&state, &this->state, sizeof(state));
+			atomicFence();
+			if (atomicLoad(this->sequence) == before) {
+				return;
+			}
+		}
+	}
+}
+
+SeatManager::SeatManager(const unsigned int seatCount, const unsigned int queueCapacity) {
+	this->seats.reserve(seatCount);
+	for (unsigned int idx = 0; idx < seatCount; ++idx) {
+		this->seats.push_back(new Seat(idx, queueCapacity));
+	}
+}
+
+SeatManager::~SeatManager() {
+	for (unsigned int idx = 0; idx < this->seats.size(); ++idx) {
+		delete this->seats[idx];
+	}
+}
+
+void SeatManager::assignDevice(const DeviceID device, const unsigned int seat) {
+	if (seat < this->seats.size()) {
+		this->assignments[device] = seat;
+	}
+}
+
+void SeatManager::unassignDevice(const DeviceID device) {
+	this->assignments.erase(device);
+	this->deviceTypes.erase(device);
+}
+
+Seat* SeatManager::getSeatOfDevice(const DeviceID device) {
+	std::map<DeviceID, unsigned int>::const_iterator iter = this->assignments.find(device);
+	return iter == this->assignments.end() ? 0 : this->seats[iter->second];
+}
+
+bool SeatManager::bindKeyboard(Keyboard* keyboard, const DeviceID device) {
+	Seat* seat = this->getSeatOfDevice(device);
+	if (seat == 0) {
+		return false;
+	}
+	seat->bindKeyboard(keyboard, device);
+	return true;
+}
+
+bool SeatManager::bindMouse(Mouse* mouse, const DeviceID device) {
+	Seat* seat = this->getSeatOfDevice(device);
+	if (seat == 0) {
+		return false;
+	}
+	seat->bindMouse(mouse, device);
+	return true;
+}
+
+bool SeatManager::bindGameController(GameController* controller, const DeviceID device) {
+	Seat* seat = this->getSeatOfDevice(device);
+	if (seat == 0) {
+		return false;
+	}
+	seat->bindGameController(controller, device);
+	return true;
+}
+
+void SeatManager::deviceAdded(const InputManager* source, const DeviceInfo& device) {
+	if (this->seats.empty()) {
+		return;
+	}
+	Seat* seat = this->getSeatOfDevice(device.id);
+	if (seat == 0) {
+		// -- Give the device to the first seat without a device of the same type.
+		std::vector<bool> taken(this->seats.size(), false);
+		std::map<DeviceID, unsigned int>::const_iterator iter;
+		for (iter = this->assignments.begin(); iter != this->assignments.end(); ++iter) {
+			std::map<DeviceID, DeviceType>::const_iterator type = this->deviceTypes.find(iter->first);
+			if (type != this->deviceTypes.end() && type->second == device.type) {
+				taken[iter->second] = true;
+			}
+		}
+		unsigned int index = 0;
+		while (index < taken.size() && taken[index]) {
+			++index;
+		}
+		if (index == taken.size()) {
+			index = 0;
+		}
+		this->assignments[device.id] = index;
+		seat = this->seats[index];
+	}
+	this->deviceTypes[device.id] = device.type;
+	seat->pushEvent(makeInputEvent(getTimestamp(), device.id, IEVT_DEVICE_CONNECTED, 
+	                               static_cast<unsigned short>(device.type)));
+}
+
+void SeatManager::deviceRemoved(const InputManager* source, const DeviceInfo& device) {
+	// -- The assignment is kept so the device returns to the same seat when reconnected.
+	Seat* seat = this->getSeatOfDevice(device.id);
+	if (seat != 0) {
+		seat->pushEvent(makeInputEvent(getTimestamp(), device.id, IEVT_DEVICE_DISCONNECTED, 
+		                               static_cast<unsigned short>(device.type)));
+	}
+}
+
+} // namespace I43D
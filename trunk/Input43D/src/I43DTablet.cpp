@@ -0,0 +1,174 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+
+#include "I43DTablet.h"
+#include "I43DInstrumentation.h"
+#include <cstring>
+
+namespace I43D {
+
+namespace {
+
+/*! @brief Pi, used to wrap angles. */
+const float PI = 3.14159265f;
+
+/*! @brief The longest gap between reports that resampling fills, in microseconds. */
+const Timestamp MAX_GAP = 100000;
+
+/*! @brief The number of samples the buffers are sized for up front. */
+const unsigned int INITIAL_CAPACITY = 256;
+
+/*!
+ * @brief
+ *     Interpolates between two samples at a time between them.
+ */
+void interpolate(const PenSample& from, const PenSample& to, const Timestamp time, 
+                 PenSample& result) {
+	const float t = static_cast<float>(time - from.time) / static_cast<float>(to.time - from.time);
+	result.time = time;
+	result.x = from.x + (to.x - from.x) * t;
+	result.y = from.y + (to.y - from.y) * t;
+	result.pressure = from.pressure + (to.pressure - from.pressure) * t;
+	result.tiltX = from.tiltX + (to.tiltX - from.tiltX) * t;
+	result.tiltY = from.tiltY + (to.tiltY - from.tiltY) * t;
+
+	// -- Turn the short way around when the barrel crosses from pi to -pi.
+	float turn = to.rotation - from.rotation;
+	if (turn > PI) {
+		turn -= 2.0f * PI;
+	} else if (turn < -PI) {
+		turn += 2.0f * PI;
+	}
+	float rotation = from.rotation + turn * t;
+	if (rotation > PI) {
+		rotation -= 2.0f * PI;
+	} else if (rotation < -PI) {
+		rotation += 2.0f * PI;
+	}
+	result.rotation = rotation;
+	result.buttons = from.buttons;
+	result.flags = from.flags;
+}
+
+} // anonymous namespace
+
+Tablet::Tablet() : interval(0), hasPrevious(false), nextTime(0) {
+	memset(&this->pen, 0, sizeof(this->pen));
+	memset(&this->previous, 0, sizeof(this->previous));
+	this->batch.reserve(INITIAL_CAPACITY);
+	this->output.reserve(INITIAL_CAPACITY);
+}
+
+void Tablet::setResampleInterval(const Timestamp interval) {
+	this->interval = interval;
+	this->hasPrevious = false;
+}
+
+void Tablet::setButton(const unsigned int button, const bool pressed) {
+	if (button >= 8 * sizeof(this->pen.buttons)) {
+		return;
+	}
+	const unsigned short bit = static_cast<unsigned short>(1u << button);
+	if (pressed) {
+		this->pen.buttons |= bit;
+	} else {
+		this->pen.buttons &= ~bit;
+	}
+}
+
+void Tablet::setFlag(const PenFlags flag, const bool set) {
+	if (set) {
+		this->pen.flags |= flag;
+	} else {
+		this->pen.flags &= ~flag;
+	}
+}
+
+void Tablet::commitSample(const Timestamp time) {
+	this->pen.time = time;
+	this->batch.push_back(this->pen);
+}
+
+void Tablet::flushSamples() {
+	if (this->batch.empty()) {
+		return;
+	}
+	const std::vector<PenSample>* samples = &this->batch;
+	if (this->interval > 0) {
+		this->resample();
+		samples = &this->output;
+	}
+	if (samples->empty() == false) {
+		const unsigned int count = static_cast<unsigned int>(samples->size());
+		std::set<TabletListener*>::iterator iter;
+		for (iter = this->listeners.begin(); iter != this->listeners.end(); ++iter) {
+			I43D_TIME_LISTENER(*iter);
+			(*iter)->samplesReceived(this, &(*samples)[0], count);
+		}
+	}
+	// -- Clearing keeps the capacity so steady use allocates nothing.
+	this->batch.clear();
+	this->output.clear();
+}
+
+void Tablet::resample() {
+	const Timestamp interval = this->interval;
+	for (size_t idx = 0; idx < this->batch.size(); ++idx) {
+		const PenSample& sample = this->batch[idx];
+		const PenSample& previous = this->previous;
+		const bool inProximity = (sample.flags & PEN_IN_PROXIMITY) != 0;
+		const bool wasInProximity = this->hasPrevious && 
+		                            (previous.flags & PEN_IN_PROXIMITY) != 0;
+		if (inProximity == false || wasInProximity == false || 
+		    sample.time - previous.time > MAX_GAP || sample.time < previous.time) {
+			// -- Deliver the edges of a stroke exactly and start the grid over.
+			if (inProximity || wasInProximity) {
+				this->output.push_back(sample);
+			}
+			this->nextTime = sample.time + interval;
+		} else if (sample.buttons != previous.buttons || sample.flags != previous.flags) {
+			// -- A press or release inside an interval would fall between two grid points,
+			// -- so fill the grid up to it, deliver it exactly and start the grid over.
+			while (this->nextTime < sample.time) {
+				PenSample result;
+				interpolate(previous, sample, this->nextTime, result);
+				this->output.push_back(result);
+				this->nextTime += interval;
+			}
+			this->output.push_back(sample);
+			this->nextTime = sample.time + interval;
+		} else {
+			while (this->nextTime <= sample.time) {
+				PenSample result;
+				if (this->nextTime == sample.time) {
+					result = sample;
+				} else {
+					interpolate(previous, sample, this->nextTime, result);
+				}
+				this->output.push_back(result);
+				this->nextTime += interval;
+			}
+		}
+		this->previous = sample;
+		this->hasPrevious = true;
+	}
+}
+
+} // namespace I43D
@@ -0,0 +1,108 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+
+#include "I43DTextInput.h"
+
+namespace I43D {
+
+bool TextInputBuffer::append(const UnicodeChar codePoint) {
+	if (this->length == CAPACITY) {
+		return false;
+	}
+	UnicodeChar cp = codePoint;
+	if (cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) {
+		cp = 0xFFFD;
+	}
+	this->utf32[this->length++] = cp;
+
+	char* out = this->utf8 + this->utf8Length;
+	if (cp < 0x80) {
+		out[0] = static_cast<char>(cp);
+		this->utf8Length += 1;
+	} else if (cp < 0x800) {
+		out[0] = static_cast<char>(0xC0 | (cp >> 6));
+		out[1] = static_cast<char>(0x80 | (cp & 0x3F));
+		this->utf8Length += 2;
+	} else if (cp < 0x10000) {
+		out[0] = static_cast<char>(0xE0 | (cp >> 12));
+		out[1] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+		out[2] = static_cast<char>(0x80 | (cp & 0x3F));
+		this->utf8Length += 3;
+	} else {
+		out[0] = static_cast<char>(0xF0 | (cp >> 18));
+		out[1] = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+		out[2] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+		out[3] = static_cast<char>(0x80 | (cp & 0x3F));
+		this->utf8Length += 4;
+	}
+	this->utf8[this->utf8Length] = '\0';
+	return true;
+}
+
+bool TextInputBuffer::appendWide(const wchar_t typedChar) {
+	if (sizeof(wchar_t) > 2) {
+		return this->append(static_cast<UnicodeChar>(typedChar));
+	}
+	const UnicodeChar unit = static_cast<UnicodeChar>(typedChar) & 0xFFFF;
+	if (unit >= 0xD800 && unit <= 0xDBFF) {
+		// -- A high surrogate following another one means the first was unpaired.
+		if (this->pendingSurrogate != 0 && this->append(0xFFFD) == false) {
+			return false;
+		}
+		this->pendingSurrogate = typedChar;
+		return true;
+	}
+	if (unit >= 0xDC00 && unit <= 0xDFFF) {
+		if (this->pendingSurrogate == 0) {
+			return this->append(0xFFFD);
+		}
+		const UnicodeChar high = static_cast<UnicodeChar>(this->pendingSurrogate) & 0xFFFF;
+		if (this->append(0x10000 + ((high - 0xD800) << 10) + (unit - 0xDC00)) == false) {
+			return false;
+		}
+		this->pendingSurrogate = 0;
+		return true;
+	}
+	if (this->pendingSurrogate != 0) {
+		if (this->length + 2 > CAPACITY) {
+			return false;
+		}
+		this->append(0xFFFD);
+		this->pendingSurrogate = 0;
+	}
+	return this->append(unit);
+}
+
+void TextInputBuffer::clear() {
+	this->length = 0;
+	this->utf8Length = 0;
+	this->utf8[0] = '\0';
+}
+
+TextInput TextInputBuffer::getText() const {
+	TextInput text;
+	text.utf32 = this->utf32;
+	text.length = this->length;
+	text.utf8 = this->utf8;
+	text.utf8Length = this->utf8Length;
+	return text;
+}
+
+} // namespace I43D 
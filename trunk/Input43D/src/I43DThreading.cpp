@@ -0,0 +1,177 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+
+#include "I43DThreading.h"
+
+#if defined( _WIN32 )
+#	define WIN32_LEAN_AND_MEAN
+#	include <windows.h>
+#else
+#	include <pthread.h>
+#	include <unistd.h>
+#endif
+
+namespace I43D {
+
+#if defined( _WIN32 )
+
+Mutex::Mutex() : handle(new CRITICAL_SECTION) {
+	InitializeCriticalSection(static_cast<CRITICAL_SECTION*>(this->handle));
+}
+
+Mutex::~Mutex() {
+	DeleteCriticalSection(static_cast<CRITICAL_SECTION*>(this->handle));
+	delete static_cast<CRITICAL_SECTION*>(this->handle);
+}
+
+void Mutex::lock() {
+	EnterCriticalSection(static_cast<CRITICAL_SECTION*>(this->handle));
+}
+
+void Mutex::unlock() {
+	LeaveCriticalSection(static_cast<CRITICAL_SECTION*>(this->handle));
+}
+
+// -- Condition variables need Windows Vista, so a semaphore counts the wake ups instead. 
+// -- The waiter count is guarded by the mutex the waiters use.
+Condition::Condition() : handle(CreateSemaphore(NULL, 0, 0x7FFFFFFF, NULL)), waiters(0) {
+}
+
+Condition::~Condition() {
+	CloseHandle(this->handle);
+}
+
+void Condition::wait(Mutex& mutex) {
+	++this->waiters;
+	mutex.unlock();
+	WaitForSingleObject(this->handle, INFINITE);
+	mutex.lock();
+}
+
+void Condition::signal() {
+	if (this->waiters > 0) {
+		--this->waiters;
+		ReleaseSemaphore(this->handle, 1, NULL);
+	}
+}
+
+void Condition::broadcast() {
+	if (this->waiters > 0) {
+		ReleaseSemaphore(this->handle, static_cast<LONG>(this->waiters), NULL);
+		this->waiters = 0;
+	}
+}
+
+bool Thread::start() {
+	this->handle = CreateThread(NULL, 0, &Thread::win32EntryPoint, this, 0, NULL);
+	return this->handle != 0;
+}
+
+void Thread::join() {
+	if (this->handle != 0) {
+		WaitForSingleObject(this->handle, INFINITE);
+		CloseHandle(this->handle);
+		this->handle = 0;
+	}
+}
+
+unsigned long __stdcall Thread::win32EntryPoint(void* thread) {
+	Thread::entryPoint(thread);
+	return 0;
+}
+
+unsigned int Thread::getHardwareThreadCount() {
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwNumberOfProcessors > 0 ? info.dwNumberOfProcessors : 1;
+}
+
+#else
+
+Mutex::Mutex() : handle(new pthread_mutex_t) {
+	pthread_mutex_init(static_cast<pthread_mutex_t*>(this->handle), 0);
+}
+
+Mutex::~Mutex() {
+	pthread_mutex_destroy(static_cast<pthread_mutex_t*>(this->handle));
+	delete static_cast<pthread_mutex_t*>(this->handle);
+}
+
+void Mutex::lock() {
+	pthread_mutex_lock(static_cast<pthread_mutex_t*>(this->handle));
+}
+
+void Mutex::unlock() {
+	pthread_mutex_unlock(static_cast<pthread_mutex_t*>(this->handle));
+}
+
+Condition::Condition() : handle(new pthread_cond_t), waiters(0) {
+	pthread_cond_init(static_cast<pthread_cond_t*>(this->handle), 0);
+}
+
+Condition::~Condition() {
+	pthread_cond_destroy(static_cast<pthread_cond_t*>(this->handle));
+	delete static_cast<pthread_cond_t*>(this->handle);
+}
+
+void Condition::wait(Mutex& mutex) {
+	pthread_cond_wait(static_cast<pthread_cond_t*>(this->handle), 
+	                  static_cast<pthread_mutex_t*>(mutex.handle));
+}
+
+void Condition::signal() {
+	pthread_cond_signal(static_cast<pthread_cond_t*>(this->handle));
+}
+
+void Condition::broadcast() {
+	pthread_cond_broadcast(static_cast<pthread_cond_t*>(this->handle));
+}
+
+bool Thread::start() {
+	pthread_t* thread = new pthread_t;
+	if (pthread_create(thread, 0, &Thread::entryPoint, this) != 0) {
+		delete thread;
+		return false;
+	}
+	this->handle = thread;
+	return true;
+}
+
+void Thread::join() {
+	if (this->handle != 0) {
+		pthread_join(*static_cast<pthread_t*>(this->handle), 0);
+		delete static_cast<pthread_t*>(this->handle);
+		this->handle = 0;
+	}
+}
+
+unsigned int Thread::getHardwareThreadCount() {
+	const long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return count > 0 ? static_cast<unsigned int>(count) : 1;
+}
+
+#endif
+
+void* Thread::entryPoint(void* thread) {
+	static_cast<Thread*>(thread)->run();
+	return 0;
+}
+
+} // namespace I43D 
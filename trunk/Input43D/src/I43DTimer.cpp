@@ -0,0 +1,247 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+
+#include "I43DTimer.h"
+
+#if defined( _WIN32 )
+#	define WIN32_LEAN_AND_MEAN
+#	include <windows.h>
+#else
+#	include <time.h>
+#endif
+
+namespace I43D {
+
+Timestamp getTimestamp() {
+#if defined( _WIN32 )
+	static LARGE_INTEGER frequency = { 0 };
+	if (frequency.QuadPart == 0) {
+		QueryPerformanceFrequency(&frequency);
+	}
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+	// -- Split the conversion so that the multiplication can not overflow.
+	const Timestamp ticks = static_cast<Timestamp>(counter.QuadPart);
+	const Timestamp perSecond = static_cast<Timestamp>(frequency.QuadPart);
+	return (ticks / perSecond) * 1000000 + ((ticks % perSecond) * 1000000) / perSecond;
+#else
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return static_cast<Timestamp>(now.tv_sec) * 1000000 + now.tv_nsec / 1000;
+#endif
+}
+
+TimerEntry::~TimerEntry() {
+	if (this->wheel != 0) {
+		this->wheel->cancel(this);
+	}
+}
+
+TimerWheel::TimerWheel(const Timestamp resolution) 
+	: expiring(0), resolution(resolution > 0 ? resolution : 1), current(getTimestamp()), 
+	  entryCount(0) {
+	for (unsigned int idx = 0; idx < SLOT_COUNT; ++idx) {
+		this->slots[idx] = 0;
+	}
+}
+
+TimerWheel::~TimerWheel() {
+	for (unsigned int idx = 0; idx < SLOT_COUNT; ++idx) {
+		while (this->slots[idx] != 0) {
+			this->cancel(this->slots[idx]);
+		}
+	}
+	while (this->expiring != 0) {
+		this->cancel(this->expiring);
+	}
+}
+
+void TimerWheel::schedule(TimerEntry* entry, const Timestamp deadline) {
+	if (entry->wheel != 0) {
+		entry->wheel->cancel(entry);
+	}
+	// -- Deadlines in the past go in the current slot so the next advance expires them.
+	const Timestamp tick = (deadline > this->current ? deadline : this->current) / this->resolution;
+	entry->slot = static_cast<unsigned int>(tick & (SLOT_COUNT - 1));
+	TimerEntry*& head = this->slots[entry->slot];
+	entry->wheel = this;
+	entry->deadline = deadline;
+	entry->prev = 0;
+	entry->next = head;
+	if (head != 0) {
+		head->prev = entry;
+	}
+	head = entry;
+	++this->entryCount;
+}
+
+void TimerWheel::cancel(TimerEntry* entry) {
+	if (entry->wheel != this) {
+		return;
+	}
+	this->unlink(entry);
+	entry->expiring = false;
+	entry->wheel = 0;
+	--this->entryCount;
+}
+
+void TimerWheel::unlink(TimerEntry* entry) {
+	if (entry->prev != 0) {
+		entry->prev->next = entry->next;
+	} else if (entry->expiring) {
+		this->expiring = entry->next;
+	} else {
+		this->slots[entry->slot] = entry->next;
+	}
+	if (entry->next != 0) {
+		entry->next->prev = entry->prev;
+	}
+	entry->next = 0;
+	entry->prev = 0;
+}
+
+TimerEntry* TimerWheel::mergeByDeadline(TimerEntry* first, TimerEntry* second) {
+	TimerEntry* head = 0;
+	TimerEntry** tail = &head;
+	while (first != 0 && second != 0) {
+		if (second->deadline < first->deadline) {
+			*tail = second;
+			second = second->next;
+		} else {
+			*tail = first;
+			first = first->next;
+		}
+		tail = &(*tail)->next;
+	}
+	*tail = (first != 0) ? first : second;
+	return head;
+}
+
+TimerEntry* TimerWheel::sortByDeadline(TimerEntry* list, const unsigned int length) {
+	if (length < 2) {
+		return list;
+	}
+	const unsigned int half = length / 2;
+	TimerEntry* last = list;
+	for (unsigned int idx = 1; idx < half; ++idx) {
+		last = last->next;
+	}
+	TimerEntry* second = last->next;
+	last->next = 0;
+	return mergeByDeadline(sortByDeadline(list, half), sortByDeadline(second, length - half));
+}
+
+void TimerWheel::advance(const Timestamp now) {
+	if (now < this->current || this->entryCount == 0) {
+		if (now > this->current) {
+			this->current = now;
+		}
+		return;
+	}
+	const Timestamp firstTick = this->current / this->resolution;
+	const Timestamp lastTick = now / this->resolution;
+	const unsigned int tickCount = (lastTick - firstTick >= SLOT_COUNT) 
+		? static_cast<unsigned int>(SLOT_COUNT) 
+		: static_cast<unsigned int>(lastTick - firstTick) + 1;
+
+	// -- Collect the expired entries before calling any of them so that entries which 
+	// -- reschedule themselves do not disturb the scan, then sort them once.
+	TimerEntry* collected = 0;
+	TimerEntry** collectedTail = &collected;
+	unsigned int collectedCount = 0;
+	for (unsigned int idx = 0; idx < tickCount; ++idx) {
+		TimerEntry* entry = this->slots[(firstTick + idx) & (SLOT_COUNT - 1)];
+		while (entry != 0) {
+			TimerEntry* const next = entry->next;
+			if (entry->deadline <= now) {
+				this->unlink(entry);
+				entry->expiring = true;
+				*collectedTail = entry;
+				collectedTail = &entry->next;
+				++collectedCount;
+			}
+			entry = next;
+		}
+	}
+	this->current = now;
+	if (collectedCount == 0) {
+		return;
+	}
+
+	// -- Entries wait on the expiring list, still scheduled, until they are called so a 
+	// -- callback can cancel or reschedule an entry that expired in the same advance. An 
+	// -- advance from inside a callback merges into the list of the outer one.
+	this->expiring = mergeByDeadline(this->expiring, sortByDeadline(collected, collectedCount));
+	TimerEntry* prev = 0;
+	for (TimerEntry* entry = this->expiring; entry != 0; entry = entry->next) {
+		entry->prev = prev;
+		prev = entry;
+	}
+
+	while (this->expiring != 0) {
+		TimerEntry* const entry = this->expiring;
+		this->unlink(entry);
+		entry->expiring = false;
+		entry->wheel = 0;
+		--this->entryCount;
+		entry->timerExpired(entry->deadline, now);
+	}
+}
+
+bool TimerWheel::getNextDeadline(Timestamp& deadline) const {
+	if (this->entryCount == 0) {
+		return false;
+	}
+	// -- Entries waiting to be called by advance() are due already.
+	if (this->expiring != 0) {
+		deadline = this->expiring->deadline;
+		return true;
+	}
+	// -- Walk the slots from the current tick. The first slot holding an entry due within
+	// -- this revolution holds the earliest deadline, so busy wheels are rarely searched 
+	// -- in full; entries scheduled in the past sit in the current slot.
+	const Timestamp firstTick = this->current / this->resolution;
+	bool found = false;
+	for (unsigned int idx = 0; idx < SLOT_COUNT; ++idx) {
+		const TimerEntry* entry = this->slots[(firstTick + idx) & (SLOT_COUNT - 1)];
+		for (; entry != 0; entry = entry->next) {
+			if (entry->deadline / this->resolution <= firstTick + idx && 
+			    (found == false || entry->deadline < deadline)) {
+				deadline = entry->deadline;
+				found = true;
+			}
+		}
+		if (found) {
+			return true;
+		}
+	}
+	// -- Every entry is at least a revolution away.
+	for (unsigned int idx = 0; idx < SLOT_COUNT; ++idx) {
+		for (const TimerEntry* entry = this->slots[idx]; entry != 0; entry = entry->next) {
+			if (found == false || entry->deadline < deadline) {
+				deadline = entry->deadline;
+				found = true;
+			}
+		}
+	}
+	return found;
+}
+
+} // namespace I43D 
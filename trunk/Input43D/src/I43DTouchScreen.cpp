@@ -0,0 +1,133 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+
+#include "I43DTouchScreen.h"
+#include "I43DInstrumentation.h"
+#include <cstring>
+
+namespace I43D {
+
+unsigned int TouchContacts::getContactCount() const {
+	unsigned int count = 0;
+	for (unsigned int mask = this->activeMask; mask != 0; mask &= mask - 1) {
+		++count;
+	}
+	return count;
+}
+
+unsigned int TouchContacts::findSlot(const int contactId) const {
+	for (unsigned int slot = 0; slot < MAX_SLOTS; ++slot) {
+		if ((this->activeMask & (1u << slot)) != 0 && this->id[slot] == contactId) {
+			return slot;
+		}
+	}
+	return MAX_SLOTS;
+}
+
+TouchScreen::TouchScreen() : slot(0) {
+	memset(&this->contacts, 0, sizeof(this->contacts));
+	for (unsigned int idx = 0; idx < TouchContacts::MAX_SLOTS; ++idx) {
+		this->contacts.id[idx] = -1;
+	}
+}
+
+void TouchScreen::setContactId(const int contactId, const Timestamp time) {
+	if (this->slot >= TouchContacts::MAX_SLOTS) {
+		return;
+	}
+	TouchContacts& contacts = this->contacts;
+	const unsigned int bit = 1u << this->slot;
+	if (contactId < 0) {
+		if ((contacts.activeMask & bit) != 0) {
+			contacts.activeMask &= ~bit;
+			contacts.endedMask |= bit;
+		}
+		return;
+	}
+	if ((contacts.activeMask & bit) != 0) {
+		if (contacts.id[this->slot] == contactId) {
+			return;
+		}
+		// -- A new contact replaced the old one without a lift so the old one ends here.
+		contacts.activeMask &= ~bit;
+		contacts.endedMask |= bit;
+	}
+	// -- A slot that lifted earlier in this frame still holds the lifted contact. Deliver
+	// -- the frame now so listeners see the lift before the slot is reused.
+	if ((contacts.endedMask & bit) != 0) {
+		this->commitFrame(time);
+	}
+	contacts.activeMask |= bit;
+	contacts.beganMask |= bit;
+	contacts.id[this->slot] = contactId;
+	contacts.pressure[this->slot] = 0.0f;
+	contacts.touchMajor[this->slot] = 0.0f;
+	contacts.touchMinor[this->slot] = 0.0f;
+}
+
+bool TouchScreen::touchSlot() {
+	if (this->slot >= TouchContacts::MAX_SLOTS) {
+		return false;
+	}
+	const unsigned int bit = 1u << this->slot;
+	if ((this->contacts.activeMask & bit) == 0) {
+		return false;
+	}
+	this->contacts.movedMask |= bit;
+	return true;
+}
+
+void TouchScreen::setPosition(const float x, const float y) {
+	if (this->touchSlot()) {
+		this->contacts.x[this->slot] = x;
+		this->contacts.y[this->slot] = y;
+	}
+}
+
+void TouchScreen::setPressure(const float pressure) {
+	if (this->touchSlot()) {
+		this->contacts.pressure[this->slot] = pressure;
+	}
+}
+
+void TouchScreen::setTouchSize(const float touchMajor, const float touchMinor) {
+	if (this->touchSlot()) {
+		this->contacts.touchMajor[this->slot] = touchMajor;
+		this->contacts.touchMinor[this->slot] = touchMinor;
+	}
+}
+
+void TouchScreen::commitFrame(const Timestamp time) {
+	TouchContacts& contacts = this->contacts;
+	if ((contacts.beganMask | contacts.movedMask | contacts.endedMask) == 0) {
+		return;
+	}
+	contacts.time = time;
+	std::set<TouchListener*>::iterator iter;
+	for (iter = this->listeners.begin(); iter != this->listeners.end(); ++iter) {
+		I43D_TIME_LISTENER(*iter);
+		(*iter)->contactsChanged(this, contacts);
+	}
+	contacts.beganMask = 0;
+	contacts.movedMask = 0;
+	contacts.endedMask = 0;
+}
+
+} // namespace I43D
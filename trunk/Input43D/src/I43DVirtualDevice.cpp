@@ -0,0 +1,192 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+
+#include "I43DVirtualDevice.h"
+#include <cstring>
+
+namespace I43D {
+
+VirtualMouse::VirtualMouse() : eventsEnabled(true), x(0), y(0), buttons(0) {
+}
+
+bool VirtualMouse::pushEvent(const InputEvent& event) {
+	switch (event.type) {
+		case IEVT_MOUSE_MOVED:
+			this->x = static_cast<unsigned int>(event.value);
+			this->y = static_cast<unsigned int>(event.value2);
+			if (this->eventsEnabled) {
+				this->fireMoved(this->x, this->y);
+			}
+			return true;
+		case IEVT_MOUSE_BUTTON_PRESSED:
+		case IEVT_MOUSE_BUTTON_RELEASED:
+			if (event.code >= 1 && event.code <= 32) {
+				const unsigned int bit = 1u << (event.code - 1);
+				if (event.type == IEVT_MOUSE_BUTTON_PRESSED) {
+					this->buttons |= bit;
+				} else {
+					this->buttons &= ~bit;
+				}
+			}
+			if (this->eventsEnabled) {
+				if (event.type == IEVT_MOUSE_BUTTON_PRESSED) {
+					this->fireButtonPressed(event.code);
+				} else {
+					this->fireButtonReleased(event.code);
+				}
+			}
+			return true;
+		case IEVT_MOUSE_SCROLLED:
+			if (this->eventsEnabled) {
+				this->fireScrolled(static_cast<MouseScrollDirection>(event.code));
+			}
+			return true;
+		default:
+			return false;
+	}
+}
+
+void VirtualMouse::enableEvents(const bool flag) {
+	this->eventsEnabled = flag;
+}
+
+void VirtualMouse::setStandardCursor(const StandardCursorID cursorID) {
+}
+
+void VirtualMouse::hideMouseCursor(const bool flag) {
+}
+
+void VirtualMouse::captureMouse(const bool flag) {
+}
+
+VirtualKeyboard::VirtualKeyboard() : eventsEnabled(true) {
+	memset(this->keys, 0, sizeof(this->keys));
+	memset(this->scanCodes, 0, sizeof(this->scanCodes));
+	KeyRepeatSettings noRepeat = this->getKeyRepeat(KEYCLASS_PRINTABLE);
+	noRepeat.enabled = false;
+	for (unsigned int idx = 0; idx < KEYCLASS_COUNT; ++idx) {
+		this->setKeyRepeat(static_cast<KeyClass>(idx), noRepeat);
+	}
+}
+
+bool VirtualKeyboard::pushEvent(const InputEvent& event) {
+	const unsigned short keyNum = event.code;
+	const unsigned int scanCode = static_cast<unsigned int>(event.value);
+	switch (event.type) {
+		case IEVT_KEY_PRESSED:
+		case IEVT_KEY_RELEASED:
+			if (keyNum < MAX_KEYS) {
+				const unsigned int bit = 1u << (keyNum & 31);
+				if (event.type == IEVT_KEY_PRESSED) {
+					this->keys[keyNum >> 5] |= bit;
+				} else {
+					this->keys[keyNum >> 5] &= ~bit;
+				}
+				this->scanCodes[keyNum] = scanCode;
+			}
+			if (this->eventsEnabled) {
+				if (event.type == IEVT_KEY_PRESSED) {
+					this->fireKeyPressed(keyNum, scanCode, event.time);
+				} else {
+					this->fireKeyReleased(keyNum, scanCode);
+				}
+			}
+			return true;
+		case IEVT_KEY_REPEATED:
+			if (this->eventsEnabled) {
+				this->fireKeyRepeated(keyNum, scanCode, static_cast<unsigned int>(event.value2), 
+				                      event.time);
+			}
+			return true;
+		case IEVT_CHAR_TYPED:
+			if (this->eventsEnabled) {
+				const unsigned int codePoint = static_cast<unsigned int>(event.value);
+				if (sizeof(wchar_t) == 2 && codePoint > 0xFFFF) {
+					// -- Where wchar_t is 16 bits the character needs a surrogate pair.
+					const unsigned int offset = codePoint - 0x10000;
+					const wchar_t pair[2] = { 
+						static_cast<wchar_t>(0xD800 + (offset >> 10)), 
+						static_cast<wchar_t>(0xDC00 + (offset & 0x3FF)) 
+					};
+					this->fireText(pair, 2);
+				} else {
+					this->fireCharTyped(static_cast<wchar_t>(codePoint));
+				}
+			}
+			return true;
+		default:
+			return false;
+	}
+}
+
+const std::wstring VirtualKeyboard::getLayoutName() {
+	return L"Virtual";
+}
+
+void VirtualKeyboard::enableEvents(const bool flag) {
+	this->eventsEnabled = flag;
+}
+
+unsigned short VirtualKeyboard::getKeyNumForScanCode(const unsigned int scanCode) {
+	for (unsigned short keyNum = 0; keyNum < MAX_KEYS; ++keyNum) {
+		if (this->scanCodes[keyNum] == scanCode && scanCode != 0) {
+			return keyNum;
+		}
+	}
+	return 0;
+}
+
+VirtualGameController::VirtualGameController(const unsigned short axisCount, 
+                                             const unsigned short buttonCount) 
+	: axisCount(axisCount < ControllerState::MAX_AXES ? 
+	            axisCount : static_cast<unsigned int>(ControllerState::MAX_AXES)),
+	  buttonCount(buttonCount < ControllerState::MAX_BUTTONS ? 
+	              buttonCount : static_cast<unsigned int>(ControllerState::MAX_BUTTONS)) {
+}
+
+bool VirtualGameController::pushEvent(const InputEvent& event) {
+	switch (event.type) {
+		case IEVT_CONTROLLER_BUTTON_PRESSED:
+			this->fireButtonPressed(event.code);
+			return true;
+		case IEVT_CONTROLLER_BUTTON_RELEASED:
+			this->fireButtonReleased(event.code);
+			return true;
+		case IEVT_CONTROLLER_AXIS_MOVED:
+			if (event.code < this->axisCount) {
+				AxisSample sample;
+				sample.axis = event.code;
+				sample.position = event.value;
+				this->pending.push_back(sample);
+			}
+			return true;
+		default:
+			return false;
+	}
+}
+
+void VirtualGameController::poll(const Timestamp now) {
+	for (unsigned int idx = 0; idx < this->pending.size(); ++idx) {
+		this->setRawAxis(this->pending[idx].axis, this->pending[idx].position);
+	}
+	this->pending.clear();
+}
+
+} // namespace I43D
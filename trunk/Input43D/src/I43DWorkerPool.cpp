@@ -0,0 +1,174 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+#include "I43DWorkerPool.h"
+
+namespace I43D {
+
+/*!
+ * @brief
+ *     A thread of the pool.
+ */
+class WorkerPool::Worker : public Thread {
+public:
+	Worker(WorkerPool& pool, const unsigned int index) : pool(pool), index(index) {}
+
+protected:
+	virtual void run() {
+		this->pool.work(this->index);
+	}
+
+private:
+	Worker& operator=(const Worker&);
+
+	WorkerPool& pool;
+	const unsigned int index;
+};
+
+WorkerPool::WorkerPool(const unsigned int threadCount) 
+	: nextQueue(0), queued(0), outstanding(0), stealCount(0), sleepers(0), stopping(false) {
+	unsigned int count = threadCount > 0 ? threadCount : Thread::getHardwareThreadCount();
+	if (count == 0) {
+		count = 1;
+	}
+	for (unsigned int idx = 0; idx < count; ++idx) {
+		this->queues.push_back(new TaskQueue());
+	}
+	for (unsigned int idx = 0; idx < count; ++idx) {
+		Worker* worker = new Worker(*this, idx);
+		if (worker->start() == false) {
+			delete worker;
+			break;
+		}
+		this->workers.push_back(worker);
+	}
+	if (this->workers.empty()) {
+		for (unsigned int idx = 0; idx < this->queues.size(); ++idx) {
+			delete this->queues[idx];
+		}
+		I43D_FAIL_STARTUP(RESULT_SYSTEM_ERROR, L"Could not start the threads of the worker pool");
+	}
+	// -- Tasks dealt to the queue of a thread that did not start are stolen by the others.
+}
+
+WorkerPool::~WorkerPool() {
+	{
+		ScopedLock guard(this->idleLock);
+		this->stopping = true;
+		this->workAvailable.broadcast();
+	}
+	for (unsigned int idx = 0; idx < this->workers.size(); ++idx) {
+		this->workers[idx]->join();
+		delete this->workers[idx];
+	}
+	for (unsigned int idx = 0; idx < this->queues.size(); ++idx) {
+		delete this->queues[idx];
+	}
+}
+
+void WorkerPool::submit(PoolTask* task) {
+	atomicAdd(this->outstanding, 1);
+	const unsigned int index = atomicAdd(this->nextQueue, 1) % this->queues.size();
+	{
+		TaskQueue& queue = *this->queues[index];
+		ScopedLock guard(queue.lock);
+		task->older = queue.newest;
+		task->newer = 0;
+		if (queue.newest != 0) {
+			queue.newest->newer = task;
+		} else {
+			queue.oldest = task;
+		}
+		queue.newest = task;
+	}
+	// -- Counted before the idle lock is taken, so a thread that checks the count under the
+	// -- lock either sees the task or is already waiting for the signal.
+	atomicAdd(this->queued, 1);
+	ScopedLock guard(this->idleLock);
+	if (this->sleepers > 0) {
+		this->workAvailable.signal();
+	}
+}
+
+void WorkerPool::wait() {
+	ScopedLock guard(this->idleLock);
+	while (atomicLoad(this->outstanding) != 0) {
+		this->allDone.wait(this->idleLock);
+	}
+}
+
+PoolTask* WorkerPool::take(const unsigned int index) {
+	const unsigned int count = static_cast<unsigned int>(this->queues.size());
+	for (unsigned int offset = 0; offset < count; ++offset) {
+		TaskQueue& queue = *this->queues[(index + offset) % count];
+		ScopedLock guard(queue.lock);
+		if (queue.newest != 0) {
+			PoolTask* task = 0;
+			if (offset == 0) {
+				// -- The newest own task is the most likely to still be in the cache.
+				task = queue.newest;
+				queue.newest = task->older;
+				if (queue.newest != 0) {
+					queue.newest->newer = 0;
+				} else {
+					queue.oldest = 0;
+				}
+			} else {
+				task = queue.oldest;
+				queue.oldest = task->newer;
+				if (queue.oldest != 0) {
+					queue.oldest->older = 0;
+				} else {
+					queue.newest = 0;
+				}
+				atomicAdd(this->stealCount, 1);
+			}
+			task->older = 0;
+			task->newer = 0;
+			atomicAdd(this->queued, static_cast<unsigned int>(-1));
+			return task;
+		}
+	}
+	return 0;
+}
+
+void WorkerPool::work(const unsigned int index) {
+	for (;;) {
+		PoolTask* task = this->take(index);
+		if (task != 0) {
+			task->run();
+			if (atomicAdd(this->outstanding, static_cast<unsigned int>(-1)) == 0) {
+				ScopedLock guard(this->idleLock);
+				this->allDone.broadcast();
+			}
+			continue;
+		}
+		ScopedLock guard(this->idleLock);
+		while (atomicLoad(this->queued) == 0 && this->stopping == false) {
+			++this->sleepers;
+			this->workAvailable.wait(this->idleLock);
+			--this->sleepers;
+		}
+		if (this->stopping && atomicLoad(this->queued) == 0) {
+			return;
+		}
+	}
+}
+
+} // namespace I43D
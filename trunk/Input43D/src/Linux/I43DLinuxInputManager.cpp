@@ -0,0 +1,396 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+
+#include "Linux/I43DLinuxInputManager.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/input.h>
+#include <sys/inotify.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+namespace I43D {
+
+namespace {
+
+/*! @brief The most threads used to probe devices at once. */
+const unsigned int MAX_PROBE_THREADS = 16;
+
+/*! @brief The number of longs needed to hold a bit for each code up to max. */
+#define I43D_BIT_LONGS(max) ((max) / (8 * sizeof(unsigned long)) + 1)
+
+/*!
+ * @brief
+ *     Tests a bit in an evdev capability mask.
+ */
+inline bool testBit(const unsigned long* bits, const unsigned int bit) {
+	return (bits[bit / (8 * sizeof(unsigned long))] >> (bit % (8 * sizeof(unsigned long)))) & 1;
+}
+
+/*!
+ * @brief
+ *     Counts the bits set in an evdev capability mask.
+ */
+unsigned short countBits(const unsigned long* bits, const unsigned int longs) {
+	unsigned short count = 0;
+	for (unsigned int idx = 0; idx < longs; ++idx) {
+		for (unsigned long value = bits[idx]; value != 0; value &= value - 1) {
+			++count;
+		}
+	}
+	return count;
+}
+
+/*!
+ * @brief
+ *     Determines if a directory entry is an event device node.
+ */
+bool isEventNode(const char* name) {
+	return strncmp(name, "event", 5) == 0 && name[5] >= '0' && name[5] <= '9';
+}
+
+/*!
+ * @brief
+ *     Orders event nodes by their number so event2 comes before event10.
+ */
+bool compareEventNodes(const std::string& left, const std::string& right) {
+	return left.size() != right.size() ? left.size() < right.size() : left < right;
+}
+
+/*!
+ * @brief
+ *     Probes a slice of a list of device nodes.
+ */
+class ProbeThread : public Thread {
+public:
+	ProbeThread(LinuxInputManager& manager, const std::vector<std::string>& paths, 
+	            std::vector<DeviceInfo>& devices, std::vector<char>& probed, 
+	            unsigned int& nextIndex, Mutex& indexLock) 
+		: manager(manager), paths(paths), devices(devices), probed(probed), 
+		  nextIndex(nextIndex), indexLock(indexLock) {}
+
+	/*!
+	 * @brief
+	 *     Probes devices from the shared list until there are none left.
+	 */
+	void probeAll() {
+		for (;;) {
+			unsigned int index;
+			{
+				ScopedLock lock(this->indexLock);
+				index = this->nextIndex++;
+			}
+			if (index >= this->paths.size()) {
+				return;
+			}
+			this->probed[index] = this->manager.probeDevice(this->paths[index], this->devices[index]);
+		}
+	}
+
+protected:
+	virtual void run() {
+		this->probeAll();
+	}
+
+private:
+	ProbeThread& operator=(const ProbeThread&);
+
+	LinuxInputManager& manager;
+	const std::vector<std::string>& paths;
+	std::vector<DeviceInfo>& devices;
+	std::vector<char>& probed;
+	unsigned int& nextIndex;
+	Mutex& indexLock;
+};
+
+} // anonymous namespace
+
+LinuxInputManager::LinuxInputManager(const std::string& directory) 
+	: directory(directory), notifyHandle(-1) {
+	this->notifyHandle = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (this->notifyHandle >= 0) {
+		// -- Nodes are often created before udev grants access to them, so attribute changes
+		// -- are watched as well to pick up devices that could not be opened at first.
+		const uint32_t mask = IN_CREATE | IN_DELETE | IN_ATTRIB | IN_MOVED_TO | IN_MOVED_FROM;
+		if (inotify_add_watch(this->notifyHandle, directory.c_str(), mask) < 0) {
+			close(this->notifyHandle);
+			this->notifyHandle = -1;
+		}
+	}
+}
+
+LinuxInputManager::~LinuxInputManager() {
+	if (this->notifyHandle >= 0) {
+		close(this->notifyHandle);
+	}
+}
+
+void LinuxInputManager::enumerateDevices() {
+	DIR* dir = opendir(this->directory.c_str());
+	if (dir == 0) {
+		return;
+	}
+	std::vector<std::string> names;
+	for (struct dirent* entry = readdir(dir); entry != 0; entry = readdir(dir)) {
+		if (isEventNode(entry->d_name)) {
+			names.push_back(entry->d_name);
+		}
+	}
+	closedir(dir);
+	std::sort(names.begin(), names.end(), compareEventNodes);
+
+	std::vector<std::string> paths;
+	for (size_t idx = 0; idx < names.size(); ++idx) {
+		const std::string path = this->directory + "/" + names[idx];
+		if (this->hasDevice(path) == false) {
+			paths.push_back(path);
+		}
+	}
+	this->probeAndAdd(paths);
+}
+
+void LinuxInputManager::update() {
+	if (this->notifyHandle < 0) {
+		return;
+	}
+	std::vector<std::string> added;
+	char buffer[4096] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+	for (;;) {
+		const ssize_t length = read(this->notifyHandle, buffer, sizeof(buffer));
+		if (length <= 0) {
+			break;
+		}
+		for (ssize_t offset = 0; offset < length; ) {
+			const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(buffer + offset);
+			offset += sizeof(struct inotify_event) + event->len;
+			if (event->len == 0 || isEventNode(event->name) == false) {
+				continue;
+			}
+			const std::string path = this->directory + "/" + event->name;
+			if ((event->mask & (IN_DELETE | IN_MOVED_FROM)) != 0) {
+				added.erase(std::remove(added.begin(), added.end(), path), added.end());
+				this->removeDevice(path);
+			} else if (this->hasDevice(path) == false 
+			           && std::find(added.begin(), added.end(), path) == added.end()) {
+				added.push_back(path);
+			}
+		}
+	}
+	this->probeAndAdd(added);
+}
+
+void LinuxInputManager::probeAndAdd(const std::vector<std::string>& paths) {
+	if (paths.empty()) {
+		return;
+	}
+	std::vector<DeviceInfo> devices(paths.size());
+	std::vector<char> probed(paths.size(), 0);
+	unsigned int nextIndex = 0;
+	Mutex indexLock;
+
+	unsigned int threadCount = static_cast<unsigned int>(paths.size());
+	if (threadCount > MAX_PROBE_THREADS) {
+		threadCount = MAX_PROBE_THREADS;
+	}
+	if (threadCount == 1) {
+		probed[0] = this->probeDevice(paths[0], devices[0]);
+	} else {
+		std::vector<ProbeThread*> threads;
+		for (unsigned int idx = 1; idx < threadCount; ++idx) {
+			ProbeThread* thread = new ProbeThread(*this, paths, devices, probed, nextIndex, indexLock);
+			if (thread->start()) {
+				threads.push_back(thread);
+			} else {
+				delete thread;
+			}
+		}
+		// -- The calling thread probes too, which also covers thread creation failing.
+		ProbeThread(*this, paths, devices, probed, nextIndex, indexLock).probeAll();
+		for (size_t idx = 0; idx < threads.size(); ++idx) {
+			threads[idx]->join();
+			delete threads[idx];
+		}
+	}
+
+	// -- Devices are added in path order so the ids do not depend on thread timing.
+	for (size_t idx = 0; idx < paths.size(); ++idx) {
+		if (probed[idx]) {
+			this->addDevice(devices[idx]);
+		}
+	}
+}
+
+bool LinuxInputManager::probeDevice(const std::string& path, DeviceInfo& device) {
+	const int fd = open(path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+	if (fd < 0) {
+		return false;
+	}
+	struct input_id id;
+	char name[256] = "";
+	char location[256] = "";
+	char serial[256] = "";
+	if (ioctl(fd, EVIOCGID, &id) < 0) {
+		close(fd);
+		return false;
+	}
+	ioctl(fd, EVIOCGNAME(sizeof(name) - 1), name);
+	ioctl(fd, EVIOCGPHYS(sizeof(location) - 1), location);
+	ioctl(fd, EVIOCGUNIQ(sizeof(serial) - 1), serial);
+
+	device.path = path;
+	device.name = name;
+	device.location = location;
+	device.serial = serial;
+	device.busType = id.bustype;
+	device.vendor = id.vendor;
+	device.product = id.product;
+	device.version = id.version;
+
+	char modelKey[288];
+	snprintf(modelKey, sizeof(modelKey), "%04x:%04x:%04x:%04x:%s", id.bustype, id.vendor, 
+	         id.product, id.version, name);
+	{
+		ScopedLock lock(this->cacheLock);
+		std::map<std::string, ModelCapabilities>::const_iterator cached = this->modelCache.find(modelKey);
+		if (cached != this->modelCache.end()) {
+			close(fd);
+			device.type = cached->second.type;
+			device.capabilities = cached->second.capabilities;
+			device.buttonCount = cached->second.buttonCount;
+			device.axisCount = cached->second.axisCount;
+			return device.type != DEVICE_UNKNOWN;
+		}
+	}
+
+	unsigned long eventBits[I43D_BIT_LONGS(EV_MAX)];
+	unsigned long keyBits[I43D_BIT_LONGS(KEY_MAX)];
+	unsigned long relBits[I43D_BIT_LONGS(REL_MAX)];
+	unsigned long absBits[I43D_BIT_LONGS(ABS_MAX)];
+	unsigned long propBits[I43D_BIT_LONGS(INPUT_PROP_MAX)];
+	memset(eventBits, 0, sizeof(eventBits));
+	memset(keyBits, 0, sizeof(keyBits));
+	memset(relBits, 0, sizeof(relBits));
+	memset(absBits, 0, sizeof(absBits));
+	memset(propBits, 0, sizeof(propBits));
+	ioctl(fd, EVIOCGBIT(0, sizeof(eventBits)), eventBits);
+	ioctl(fd, EVIOCGBIT(EV_KEY, sizeof(keyBits)), keyBits);
+	ioctl(fd, EVIOCGBIT(EV_REL, sizeof(relBits)), relBits);
+	ioctl(fd, EVIOCGBIT(EV_ABS, sizeof(absBits)), absBits);
+	ioctl(fd, EVIOCGPROP(sizeof(propBits)), propBits);
+	close(fd);
+
+	ModelCapabilities model;
+	model.capabilities = 0;
+	model.capabilities |= testBit(eventBits, EV_KEY) ? DEVCAP_KEYS : 0;
+	model.capabilities |= testBit(eventBits, EV_REL) ? DEVCAP_RELATIVE_AXES : 0;
+	model.capabilities |= testBit(eventBits, EV_ABS) ? DEVCAP_ABSOLUTE_AXES : 0;
+	model.capabilities |= testBit(eventBits, EV_FF) ? DEVCAP_FORCE_FEEDBACK : 0;
+	model.capabilities |= testBit(absBits, ABS_MT_POSITION_X) ? DEVCAP_MULTI_TOUCH : 0;
+	model.capabilities |= testBit(keyBits, BTN_TOOL_PEN) || testBit(keyBits, BTN_STYLUS) ? DEVCAP_PEN : 0;
+	model.capabilities |= testBit(propBits, INPUT_PROP_DIRECT) ? DEVCAP_DIRECT : 0;
+	model.buttonCount = countBits(keyBits, I43D_BIT_LONGS(KEY_MAX));
+	model.axisCount = countBits(relBits, I43D_BIT_LONGS(REL_MAX)) 
+	                  + countBits(absBits, I43D_BIT_LONGS(ABS_MAX));
+
+	// -- The order matters: touch screens and tablets also report buttons and touchpads 
+	// -- report absolute axes, so the most specific kinds are checked first.
+	bool gameButtons = false;
+	for (unsigned int button = BTN_JOYSTICK; button < BTN_DIGI && gameButtons == false; ++button) {
+		gameButtons = testBit(keyBits, button);
+	}
+	if ((model.capabilities & DEVCAP_PEN) != 0) {
+		model.type = DEVICE_TABLET;
+	} else if ((model.capabilities & (DEVCAP_MULTI_TOUCH | DEVCAP_DIRECT)) 
+	           == (DEVCAP_MULTI_TOUCH | DEVCAP_DIRECT)) {
+		model.type = DEVICE_TOUCH_SCREEN;
+	} else if (testBit(keyBits, BTN_LEFT) && ((testBit(relBits, REL_X) && testBit(relBits, REL_Y))
+	           || testBit(keyBits, BTN_TOOL_FINGER))) {
+		model.type = DEVICE_MOUSE;
+	} else if (gameButtons) {
+		model.type = DEVICE_GAME_CONTROLLER;
+	} else if (testBit(keyBits, KEY_A) && testBit(keyBits, KEY_Z) && testBit(keyBits, KEY_SPACE)) {
+		model.type = DEVICE_KEYBOARD;
+	} else {
+		model.type = DEVICE_UNKNOWN;
+	}
+
+	{
+		ScopedLock lock(this->cacheLock);
+		this->modelCache[modelKey] = model;
+	}
+	device.type = model.type;
+	device.capabilities = model.capabilities;
+	device.buttonCount = model.buttonCount;
+	device.axisCount = model.axisCount;
+	return device.type != DEVICE_UNKNOWN;
+}
+
+bool LinuxInputManager::loadCapabilityCache(const std::string& path) {
+	FILE* file = fopen(path.c_str(), "r");
+	if (file == 0) {
+		return false;
+	}
+	char line[512];
+	ScopedLock lock(this->cacheLock);
+	while (fgets(line, sizeof(line), file) != 0) {
+		int type = 0;
+		unsigned int capabilities = 0;
+		unsigned int buttons = 0;
+		unsigned int axes = 0;
+		int keyStart = 0;
+		if (sscanf(line, "%d %x %u %u %n", &type, &capabilities, &buttons, &axes, &keyStart) < 4 
+		    || keyStart == 0) {
+			continue;
+		}
+		std::string key(line + keyStart);
+		while (key.empty() == false && (key[key.size() - 1] == '\n' || key[key.size() - 1] == '\r')) {
+			key.erase(key.size() - 1);
+		}
+		ModelCapabilities model;
+		model.type = static_cast<DeviceType>(type);
+		model.capabilities = capabilities;
+		model.buttonCount = static_cast<unsigned short>(buttons);
+		model.axisCount = static_cast<unsigned short>(axes);
+		this->modelCache[key] = model;
+	}
+	fclose(file);
+	return true;
+}
+
+bool LinuxInputManager::saveCapabilityCache(const std::string& path) const {
+	FILE* file = fopen(path.c_str(), "w");
+	if (file == 0) {
+		return false;
+	}
+	ScopedLock lock(this->cacheLock);
+	std::map<std::string, ModelCapabilities>::const_iterator iter;
+	for (iter = this->modelCache.begin(); iter != this->modelCache.end(); ++iter) {
+		fprintf(file, "%d %x %u %u %s\n", iter->second.type, iter->second.capabilities, 
+		        iter->second.buttonCount, iter->second.axisCount, iter->first.c_str());
+	}
+	return fclose(file) == 0;
+}
+
+} // namespace I43D 
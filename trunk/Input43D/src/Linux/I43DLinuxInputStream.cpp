@@ -0,0 +1,326 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+
+#include "Linux/I43DLinuxInputStream.h"
+#include <cstring>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace I43D {
+
+namespace {
+
+/*!
+ * @brief
+ *     A parsed stream address.
+ */
+struct StreamAddress {
+	/*! @brief The socket address. */
+	struct sockaddr_storage storage;
+
+	/*! @brief The length of the socket address. */
+	socklen_t length;
+
+	/*! @brief The path of a unix address or empty for TCP. */
+	std::string path;
+};
+
+/*!
+ * @brief
+ *     Parses an address of the form unix:/path or tcp:host:port.
+ * @param passive
+ *     Whether the address is to be listened on, which lets the host be left out.
+ * @return
+ *     False if the address is malformed or the host is unknown.
+ */
+bool parseAddress(const std::string& address, const bool passive, StreamAddress& result) {
+	memset(&result.storage, 0, sizeof(result.storage));
+	if (address.compare(0, 5, "unix:") == 0) {
+		struct sockaddr_un* local = reinterpret_cast<struct sockaddr_un*>(&result.storage);
+		result.path = address.substr(5);
+		if (result.path.empty() || result.path.size() >= sizeof(local->sun_path)) {
+			return false;
+		}
+		local->sun_family = AF_UNIX;
+		memcpy(local->sun_path, result.path.c_str(), result.path.size() + 1);
+		result.length = sizeof(struct sockaddr_un);
+		return true;
+	}
+	const std::string::size_type colon = address.rfind(':');
+	if (address.compare(0, 4, "tcp:") != 0 || colon == std::string::npos || colon < 4) {
+		return false;
+	}
+	const std::string host = address.substr(4, colon - 4);
+	const std::string port = address.substr(colon + 1);
+	struct addrinfo hints;
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	hints.ai_flags = passive ? AI_PASSIVE : 0;
+	struct addrinfo* info = 0;
+	if (getaddrinfo(host.empty() ? 0 : host.c_str(), port.c_str(), &hints, &info) != 0) {
+		return false;
+	}
+	memcpy(&result.storage, info->ai_addr, info->ai_addrlen);
+	result.length = info->ai_addrlen;
+	result.path.clear();
+	freeaddrinfo(info);
+	return true;
+}
+
+/*!
+ * @brief
+ *     Turns Nagle's algorithm off on a TCP socket so small packets leave at once.
+ */
+void disableNagle(const int handle, const StreamAddress& address) {
+	if (address.path.empty()) {
+		int flag = 1;
+		setsockopt(handle, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+	}
+}
+
+} // anonymous namespace
+
+LinuxInputStreamSender::LinuxInputStreamSender() : handle(-1) {
+}
+
+LinuxInputStreamSender::LinuxInputStreamSender(const std::string& address) : handle(-1) {
+	const ResultCode result = this->connect(address);
+	if (result != RESULT_OK) {
+		I43D_FAIL_STARTUP(result, L"Could not connect the input stream");
+	}
+}
+
+LinuxInputStreamSender::~LinuxInputStreamSender() {
+	this->flush();
+	if (this->handle >= 0) {
+		close(this->handle);
+	}
+}
+
+ResultCode LinuxInputStreamSender::connect(const std::string& address) {
+	if (this->handle >= 0) {
+		this->flush();
+		close(this->handle);
+		this->handle = -1;
+	}
+	this->writer.reset();
+	StreamAddress target;
+	if (parseAddress(address, false, target) == false) {
+		I43D_FAIL(RESULT_INCOMPATIBLE, L"Malformed or unknown input stream address");
+	}
+	const int socketHandle = socket(target.storage.ss_family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (socketHandle < 0) {
+		I43D_FAIL(RESULT_SYSTEM_ERROR, L"Could not create the input stream socket");
+	}
+	if (::connect(socketHandle, reinterpret_cast<struct sockaddr*>(&target.storage), 
+	              target.length) != 0) {
+		close(socketHandle);
+		I43D_FAIL(RESULT_SYSTEM_ERROR, L"Could not connect the input stream");
+	}
+	disableNagle(socketHandle, target);
+	this->handle = socketHandle;
+	return RESULT_OK;
+}
+
+bool LinuxInputStreamSender::pushEvent(const InputEvent& event) {
+	if (this->writer.addEvent(event) == false) {
+		if (this->flush() == false) {
+			return false;
+		}
+		this->writer.addEvent(event);
+	}
+	return this->handle >= 0;
+}
+
+bool LinuxInputStreamSender::flush() {
+	if (this->handle < 0) {
+		return false;
+	}
+	if (this->writer.getEventCount() == 0) {
+		return true;
+	}
+	unsigned int size;
+	const unsigned char* packet = this->writer.finish(getTimestamp(), size);
+	while (size > 0) {
+		const ssize_t sent = send(this->handle, packet, size, MSG_NOSIGNAL);
+		if (sent < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			close(this->handle);
+			this->handle = -1;
+			return false;
+		}
+		packet += sent;
+		size -= static_cast<unsigned int>(sent);
+	}
+	this->writer.reset();
+	return true;
+}
+
+bool LinuxInputStreamReceiver::Dispatcher::pushEvent(const InputEvent& event) {
+	// -- Events stamped after the update due to clock skew count as no latency.
+	const long long elapsed = static_cast<long long>(this->now - event.time) + this->clockOffset;
+	const Timestamp latency = elapsed > 0 ? static_cast<Timestamp>(elapsed) : 0;
+	StreamLatency& stats = this->latency;
+	if (stats.count == 0 || latency < stats.minimum) {
+		stats.minimum = latency;
+	}
+	if (latency > stats.maximum) {
+		stats.maximum = latency;
+	}
+	stats.total += latency;
+	++stats.count;
+
+	if (this->receiver.mouse.pushEvent(event) == false) {
+		this->receiver.keyboard.pushEvent(event);
+	}
+	if (this->sink != 0) {
+		this->sink->pushEvent(event);
+	}
+	return true;
+}
+
+LinuxInputStreamReceiver::LinuxInputStreamReceiver(const std::string& address) 
+	: connection(-1), buffered(0), dispatcher(*this) {
+	this->resetLatency();
+	StreamAddress local;
+	if (parseAddress(address, true, local) == false) {
+		I43D_FAIL_STARTUP(RESULT_INCOMPATIBLE, L"Malformed or unknown input stream address");
+	}
+	this->listener = socket(local.storage.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (this->listener < 0) {
+		I43D_FAIL_STARTUP(RESULT_SYSTEM_ERROR, L"Could not create the input stream socket");
+	}
+	if (local.path.empty()) {
+		int flag = 1;
+		setsockopt(this->listener, SOL_SOCKET, SO_REUSEADDR, &flag, sizeof(flag));
+	} else {
+		unlink(local.path.c_str());
+	}
+	if (bind(this->listener, reinterpret_cast<struct sockaddr*>(&local.storage), 
+	         local.length) != 0 || listen(this->listener, 1) != 0) {
+		close(this->listener);
+		I43D_FAIL_STARTUP(RESULT_SYSTEM_ERROR, L"Could not listen for an input stream");
+	}
+	this->path = local.path;
+}
+
+LinuxInputStreamReceiver::~LinuxInputStreamReceiver() {
+	if (this->connection >= 0) {
+		close(this->connection);
+	}
+	close(this->listener);
+	if (this->path.empty() == false) {
+		unlink(this->path.c_str());
+	}
+}
+
+void LinuxInputStreamReceiver::resetLatency() {
+	memset(&this->dispatcher.latency, 0, sizeof(this->dispatcher.latency));
+}
+
+void LinuxInputStreamReceiver::disconnect(const Timestamp now) {
+	close(this->connection);
+	this->connection = -1;
+	this->buffered = 0;
+	this->reader.reset();
+
+	// -- Nothing will release what the sender held so release it here.
+	for (unsigned short keyNum = 0; keyNum < VirtualKeyboard::MAX_KEYS; ++keyNum) {
+		if (this->keyboard.isKeyPressed(keyNum)) {
+			this->keyboard.pushEvent(makeInputEvent(now, INVALID_DEVICE_ID, IEVT_KEY_RELEASED, 
+			                                        keyNum, static_cast<int>(
+			                                        this->keyboard.getScanCodeForKeyNum(keyNum))));
+		}
+	}
+	for (unsigned short buttonNum = 1; buttonNum <= 32; ++buttonNum) {
+		if (this->mouse.isButtonPressed(buttonNum)) {
+			this->mouse.pushEvent(makeInputEvent(now, INVALID_DEVICE_ID, 
+			                                     IEVT_MOUSE_BUTTON_RELEASED, buttonNum));
+		}
+	}
+}
+
+void LinuxInputStreamReceiver::update(const Timestamp now) {
+	if (this->connection < 0) {
+		this->connection = accept4(this->listener, 0, 0, SOCK_NONBLOCK | SOCK_CLOEXEC);
+		if (this->connection >= 0) {
+			// -- A new sender starts its own sequence.
+			this->reader.reset();
+		}
+		if (this->connection >= 0 && this->path.empty()) {
+			int flag = 1;
+			setsockopt(this->connection, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+		}
+	}
+	this->dispatcher.now = now;
+	while (this->connection >= 0) {
+		const ssize_t bytes = recv(this->connection, this->buffer + this->buffered, 
+		                           BUFFER_SIZE - this->buffered, 0);
+		if (bytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+			break;
+		}
+		if (bytes < 0 && errno == EINTR) {
+			continue;
+		}
+		if (bytes <= 0) {
+			this->disconnect(now);
+			break;
+		}
+		this->buffered += static_cast<unsigned int>(bytes);
+
+		// -- Play every whole packet and keep the start of the next one.
+		unsigned int offset = 0;
+		bool broken = false;
+		while (this->buffered - offset >= 2) {
+			const unsigned int size = EventPacketReader::getPacketSize(this->buffer + offset);
+			if (size > EventPacketWriter::MAX_PACKET_SIZE || size < EventPacketWriter::HEADER_SIZE) {
+				broken = true;
+				break;
+			}
+			if (this->buffered - offset < size) {
+				break;
+			}
+			if (this->reader.readPacket(this->buffer + offset, size, this->dispatcher) == false) {
+				broken = true;
+				break;
+			}
+			offset += size;
+		}
+		if (broken) {
+			// -- The stream is out of step and can not be recovered.
+			this->disconnect(now);
+			break;
+		}
+		memmove(this->buffer, this->buffer + offset, this->buffered - offset);
+		this->buffered -= offset;
+	}
+	this->keyboard.update(now);
+}
+
+} // namespace I43D
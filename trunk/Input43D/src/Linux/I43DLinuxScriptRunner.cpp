@@ -0,0 +1,228 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+#include "Linux/I43DLinuxScriptRunner.h"
+#include <errno.h>
+#include <stdint.h>
+#include <sys/prctl.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+namespace I43D {
+
+/*!
+ * @brief
+ *     A thread of the runner with its wheel and timer.
+ */
+class LinuxScriptRunner::Lane : public Thread {
+public:
+	Lane(const Timestamp resolution) 
+		: wheel(resolution), timerHandle(-1), activeCount(0), stopping(false) {
+		this->timerHandle = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+		if (this->timerHandle < 0) {
+			I43D_FAIL_STARTUP(RESULT_SYSTEM_ERROR, L"Could not create the timer of a script runner");
+		}
+	}
+
+	virtual ~Lane() {
+		close(this->timerHandle);
+	}
+
+	/*!
+	 * @brief
+	 *     Queues a bot to be started on the thread.
+	 */
+	void addBot(ScriptBot* bot, const Timestamp startTime) {
+		ScopedLock guard(this->lock);
+		PendingBot pending;
+		pending.bot = bot;
+		pending.startTime = startTime;
+		this->pending.push_back(pending);
+		atomicAdd(this->activeCount, 1);
+		this->arm(0);
+	}
+
+	/*!
+	 * @brief
+	 *     Tells the thread to finish.
+	 */
+	void requestStop() {
+		ScopedLock guard(this->lock);
+		this->stopping = true;
+		this->arm(0);
+	}
+
+	/*!
+	 * @brief
+	 *     Gets the number of bots playing or waiting to be started.
+	 */
+	inline unsigned int getActiveCount() const {
+		return atomicLoad(this->activeCount);
+	}
+
+protected:
+	virtual void run() {
+		// -- The default slack of 50 us would be added to every wakeup.
+		prctl(PR_SET_TIMERSLACK, 1UL, 0UL, 0UL, 0UL);
+		std::vector<PendingBot> starting;
+		for (;;) {
+			uint64_t expirations = 0;
+			if (read(this->timerHandle, &expirations, sizeof(expirations)) < 0 && errno != EINTR) {
+				return;
+			}
+			{
+				ScopedLock guard(this->lock);
+				if (this->stopping) {
+					return;
+				}
+				starting.swap(this->pending);
+			}
+			for (unsigned int idx = 0; idx < starting.size(); ++idx) {
+				starting[idx].bot->start(this->wheel, starting[idx].startTime);
+			}
+			starting.clear();
+			this->wheel.advance(getTimestamp());
+
+			ScopedLock guard(this->lock);
+			atomicStore(this->activeCount, this->wheel.getEntryCount() + 
+			                               static_cast<unsigned int>(this->pending.size()));
+			// -- Armed under the lock so a bot added meanwhile can not have its wakeup 
+			// -- replaced by a later deadline.
+			Timestamp deadline = 0;
+			if (this->pending.empty() == false || this->stopping) {
+				this->arm(0);
+			} else if (this->wheel.getNextDeadline(deadline)) {
+				this->arm(deadline);
+			} else {
+				this->disarm();
+			}
+		}
+	}
+
+private:
+	Lane& operator=(const Lane&);
+
+	/*!
+	 * @brief
+	 *     A bot waiting to be started on the thread.
+	 */
+	struct PendingBot {
+		ScriptBot* bot;
+		Timestamp startTime;
+	};
+
+	/*!
+	 * @brief
+	 *     Arms the timer for an absolute time on the input clock; times in the past, 
+	 *     including 0, expire at once.
+	 */
+	void arm(const Timestamp deadline) {
+		struct itimerspec setting;
+		setting.it_interval.tv_sec = 0;
+		setting.it_interval.tv_nsec = 0;
+		// -- A time of zero would disarm the timer, so the earliest time used is 1 ns.
+		setting.it_value.tv_sec = static_cast<time_t>(deadline / 1000000);
+		setting.it_value.tv_nsec = static_cast<long>(deadline % 1000000) * 1000 + 
+		                           (deadline == 0 ? 1 : 0);
+		timerfd_settime(this->timerHandle, TFD_TIMER_ABSTIME, &setting, 0);
+	}
+
+	/*!
+	 * @brief
+	 *     Disarms the timer.
+	 */
+	void disarm() {
+		struct itimerspec setting;
+		setting.it_interval.tv_sec = 0;
+		setting.it_interval.tv_nsec = 0;
+		setting.it_value.tv_sec = 0;
+		setting.it_value.tv_nsec = 0;
+		timerfd_settime(this->timerHandle, 0, &setting, 0);
+	}
+
+	/*! @brief The wheel the bots of the thread run on. Only used by the thread. */
+	TimerWheel wheel;
+
+	/*! @brief The timer the thread sleeps on. */
+	int timerHandle;
+
+	/*! @brief Guards the pending bots, stopping and arming the timer. */
+	Mutex lock;
+
+	/*! @brief The bots waiting to be started. */
+	std::vector<PendingBot> pending;
+
+	/*! @brief The number of bots playing or waiting to be started. */
+	volatile unsigned int activeCount;
+
+	/*! @brief Whether the thread should finish. */
+	bool stopping;
+};
+
+LinuxScriptRunner::LinuxScriptRunner(const unsigned int threadCount, const Timestamp resolution)
+	: nextLane(0) {
+	unsigned int count = threadCount > 0 ? threadCount : Thread::getHardwareThreadCount();
+	if (count == 0) {
+		count = 1;
+	}
+	for (unsigned int idx = 0; idx < count; ++idx) {
+		Lane* lane = new Lane(resolution);
+		if (lane->start() == false) {
+			delete lane;
+			break;
+		}
+		this->lanes.push_back(lane);
+	}
+	if (this->lanes.empty()) {
+		I43D_FAIL_STARTUP(RESULT_SYSTEM_ERROR, L"Could not start the threads of a script runner");
+	}
+}
+
+LinuxScriptRunner::~LinuxScriptRunner() {
+	this->stop();
+}
+
+void LinuxScriptRunner::addBot(ScriptBot* bot, const Timestamp startTime) {
+	if (this->lanes.empty()) {
+		return;
+	}
+	const unsigned int index = atomicAdd(this->nextLane, 1) % this->lanes.size();
+	this->lanes[index]->addBot(bot, startTime);
+}
+
+void LinuxScriptRunner::stop() {
+	for (unsigned int idx = 0; idx < this->lanes.size(); ++idx) {
+		this->lanes[idx]->requestStop();
+	}
+	for (unsigned int idx = 0; idx < this->lanes.size(); ++idx) {
+		this->lanes[idx]->join();
+		delete this->lanes[idx];
+	}
+	this->lanes.clear();
+}
+
+unsigned int LinuxScriptRunner::getActiveBotCount() const {
+	unsigned int count = 0;
+	for (unsigned int idx = 0; idx < this->lanes.size(); ++idx) {
+		count += this->lanes[idx]->getActiveCount();
+	}
+	return count;
+}
+
+} // namespace I43D
@@ -0,0 +1,234 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+
+#include "Linux/I43DLinuxSharedInput.h"
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace I43D {
+
+namespace {
+
+/*! @brief Identifies a shared input segment: 'I43S'. */
+const unsigned int SHARED_INPUT_MAGIC = 0x53333449;
+
+/*! @brief The version of the layout. */
+const unsigned int SHARED_INPUT_VERSION = 1;
+
+/*!
+ * @brief
+ *     Gets the offset of the events from the start of a segment.
+ */
+inline size_t getEventsOffset() {
+	const size_t line = SharedInputHeader::CACHE_LINE;
+	return (sizeof(SharedInputHeader) + line - 1) & ~(line - 1);
+}
+
+} // anonymous namespace
+
+LinuxSharedInputPublisher::LinuxSharedInputPublisher(const std::string& name, 
+                                                     const unsigned int capacity) 
+	: name(name) {
+	unsigned int rounded = 1;
+	while (rounded < capacity) {
+		rounded <<= 1;
+	}
+	this->size = getEventsOffset() + rounded * sizeof(InputEvent);
+
+	// -- A segment left by a publisher that crashed is replaced, not reused.
+	shm_unlink(name.c_str());
+	const int handle = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+	if (handle < 0) {
+		I43D_FAIL_STARTUP(RESULT_SYSTEM_ERROR, L"Could not create the shared input segment");
+	}
+	if (ftruncate(handle, static_cast<off_t>(this->size)) != 0) {
+		close(handle);
+		shm_unlink(name.c_str());
+		I43D_FAIL_STARTUP(RESULT_SYSTEM_ERROR, L"Could not size the shared input segment");
+	}
+	void* memory = mmap(0, this->size, PROT_READ | PROT_WRITE, MAP_SHARED, handle, 0);
+	close(handle);
+	if (memory == MAP_FAILED) {
+		shm_unlink(name.c_str());
+		I43D_FAIL_STARTUP(RESULT_SYSTEM_ERROR, L"Could not map the shared input segment");
+	}
+
+	// -- A new segment is zero filled so only the description needs writing.
+	this->header = static_cast<SharedInputHeader*>(memory);
+	this->events = reinterpret_cast<InputEvent*>(static_cast<char*>(memory) + getEventsOffset());
+	this->header->version = SHARED_INPUT_VERSION;
+	this->header->eventSize = sizeof(InputEvent);
+	this->header->stateSize = sizeof(SeatState);
+	this->header->capacity = rounded;
+	atomicStore(this->header->magic, SHARED_INPUT_MAGIC);
+}
+
+LinuxSharedInputPublisher::~LinuxSharedInputPublisher() {
+	atomicStore(this->header->closed, 1);
+	munmap(this->header, this->size);
+	shm_unlink(this->name.c_str());
+}
+
+bool LinuxSharedInputPublisher::pushEvent(const InputEvent& event) {
+	SharedInputHeader& header = *this->header;
+
+	// -- The full barrier of the first add also keeps the count stored by the previous 
+	// -- event ahead of the slot written below, which is what lets readers trust a slot 
+	// -- whenever the count says it has not been reused.
+	atomicAdd(header.sequence, 1);
+	header.state.applyEvent(event);
+	atomicAdd(header.sequence, 1);
+	const unsigned int position = header.count;
+	this->events[position & (header.capacity - 1)] = event;
+	atomicStore(header.count, position + 1);
+	return true;
+}
+
+LinuxSharedInputReader::LinuxSharedInputReader() 
+	: header(0), events(0), size(0), position(0), lostCount(0) {
+}
+
+LinuxSharedInputReader::LinuxSharedInputReader(const std::string& name) 
+	: header(0), events(0), size(0), position(0), lostCount(0) {
+	const ResultCode result = this->open(name);
+	if (result != RESULT_OK) {
+		I43D_FAIL_STARTUP(result, L"Could not attach to the shared input segment");
+	}
+}
+
+LinuxSharedInputReader::~LinuxSharedInputReader() {
+	this->close();
+}
+
+ResultCode LinuxSharedInputReader::open(const std::string& name) {
+	this->close();
+	const int handle = shm_open(name.c_str(), O_RDONLY, 0);
+	if (handle < 0) {
+		I43D_FAIL(RESULT_SYSTEM_ERROR, L"Could not open the shared input segment");
+	}
+	struct stat info;
+	if (fstat(handle, &info) != 0 || static_cast<size_t>(info.st_size) < getEventsOffset()) {
+		::close(handle);
+		I43D_FAIL(RESULT_INCOMPATIBLE, L"The shared input segment is not ready");
+	}
+	const size_t size = static_cast<size_t>(info.st_size);
+	void* memory = mmap(0, size, PROT_READ, MAP_SHARED, handle, 0);
+	::close(handle);
+	if (memory == MAP_FAILED) {
+		I43D_FAIL(RESULT_SYSTEM_ERROR, L"Could not map the shared input segment");
+	}
+	const SharedInputHeader& header = *static_cast<const SharedInputHeader*>(memory);
+	if (atomicLoad(header.magic) != SHARED_INPUT_MAGIC || 
+	    header.version != SHARED_INPUT_VERSION || header.eventSize != sizeof(InputEvent) || 
+	    header.stateSize != sizeof(SeatState) || 
+	    getEventsOffset() + header.capacity * sizeof(InputEvent) > size) {
+		munmap(memory, size);
+		I43D_FAIL(RESULT_INCOMPATIBLE, L"The shared input segment is not compatible");
+	}
+	this->header = &header;
+	this->events = reinterpret_cast<const InputEvent*>(static_cast<const char*>(memory) + 
+	                                                   getEventsOffset());
+	this->size = size;
+	this->position = atomicLoad(header.count);
+	this->lostCount = 0;
+	return RESULT_OK;
+}
+
+void LinuxSharedInputReader::close() {
+	if (this->header != 0) {
+		munmap(const_cast<SharedInputHeader*>(this->header), this->size);
+		this->header = 0;
+		this->events = 0;
+	}
+}
+
+bool LinuxSharedInputReader::popEvent(InputEvent& event) {
+	return this->popEvents(&event, 1) == 1;
+}
+
+unsigned int LinuxSharedInputReader::popEvents(InputEvent* events, const unsigned int maxCount) {
+	if (this->header == 0) {
+		return 0;
+	}
+	const unsigned int capacity = this->header->capacity;
+	const unsigned int mask = capacity - 1;
+	for (;;) {
+		const unsigned int published = atomicLoad(this->header->count);
+		unsigned int position = this->position;
+		if (published - position > capacity) {
+			// -- The publisher lapped this reader so skip to the oldest event still held.
+			this->lostCount += published - position - capacity;
+			position = published - capacity;
+		}
+		unsigned int count = published - position;
+		if (count > maxCount) {
+			count = maxCount;
+		}
+		if (count == 0) {
+			this->position = position;
+			return 0;
+		}
+		for (unsigned int idx = 0; idx < count; ++idx) {
+			events[idx] = this->events[(position + idx) & mask];
+		}
+
+		// -- A slot may have been rewritten while it was copied once the publisher got 
+		// -- within one lap of it. Those copies are dropped from the front.
+		atomicFence();
+		const unsigned int now = atomicLoad(this->header->count);
+		unsigned int stale = 0;
+		if (now - position >= capacity) {
+			stale = now - position - capacity + 1;
+		}
+		if (stale >= count) {
+			this->lostCount += count;
+			this->position = position + count;
+			continue;
+		}
+		if (stale > 0) {
+			memmove(events, events + stale, (count - stale) * sizeof(InputEvent));
+			this->lostCount += stale;
+		}
+		this->position = position + count;
+		return count - stale;
+	}
+}
+
+void LinuxSharedInputReader::getState(SeatState& state) const {
+	if (this->header == 0) {
+		memset(&state, 0, sizeof(state));
+		return;
+	}
+	for (;;) {
+		const unsigned int before = atomicLoad(this->header->sequence);
+		if ((before & 1) == 0) {
+			memcpy(&state, &this->header->state, sizeof(state));
+			atomicFence();
+			if (atomicLoad(this->header->sequence) == before) {
+				return;
+			}
+		}
+	}
+}
+
+} // namespace I43D
@@ -0,0 +1,269 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+
+#include "Linux/I43DLinuxTablet.h"
+#include <cstring>
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/input.h>
+#include <sys/ioctl.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace I43D {
+
+namespace {
+
+/*! @brief Pi, used for angles. */
+const float PI = 3.14159265f;
+
+/*! @brief The number of bits in a long, for the bit arrays the kernel fills. */
+const unsigned int BITS_PER_LONG = 8 * sizeof(long);
+
+/*!
+ * @brief
+ *     Tests a bit in a bit array filled by the kernel.
+ */
+inline bool testBit(const unsigned long* bits, const unsigned int bit) {
+	return (bits[bit / BITS_PER_LONG] & (1UL << (bit % BITS_PER_LONG))) != 0;
+}
+
+/*!
+ * @brief
+ *     The tools the tablet reports, with the eraser first.
+ */
+const unsigned int TOOL_CODES[] = {
+	BTN_TOOL_RUBBER, BTN_TOOL_PEN, BTN_TOOL_BRUSH, BTN_TOOL_PENCIL, BTN_TOOL_AIRBRUSH
+};
+
+/*! @brief The number of tools. */
+const unsigned int TOOL_COUNT = sizeof(TOOL_CODES) / sizeof(TOOL_CODES[0]);
+
+/*!
+ * @brief
+ *     Finds the index of a tool, or TOOL_COUNT if the code is not a tool.
+ */
+inline unsigned int findTool(const unsigned int code) {
+	unsigned int tool = 0;
+	while (tool < TOOL_COUNT && TOOL_CODES[tool] != code) {
+		++tool;
+	}
+	return tool;
+}
+
+} // anonymous namespace
+
+LinuxTablet::LinuxTablet() 
+	: handle(-1), dropping(false), tools(0), lastX(0), lastY(0), lastTiltX(0), lastTiltY(0) {
+}
+
+LinuxTablet::LinuxTablet(const std::string& path) 
+	: handle(-1), dropping(false), tools(0), lastX(0), lastY(0), lastTiltX(0), lastTiltY(0) {
+	const ResultCode result = this->open(path);
+	if (result != RESULT_OK) {
+		I43D_FAIL_STARTUP(result, L"Could not open the tablet");
+	}
+}
+
+LinuxTablet::~LinuxTablet() {
+	this->close();
+}
+
+ResultCode LinuxTablet::open(const std::string& path) {
+	this->close();
+	const int device = ::open(path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+	if (device < 0) {
+		I43D_FAIL(RESULT_SYSTEM_ERROR, L"Could not open the tablet");
+	}
+	unsigned long absBits[(ABS_CNT + BITS_PER_LONG - 1) / BITS_PER_LONG];
+	memset(absBits, 0, sizeof(absBits));
+	ioctl(device, EVIOCGBIT(EV_ABS, sizeof(absBits)), absBits);
+	if (testBit(absBits, ABS_PRESSURE) == false) {
+		::close(device);
+		I43D_FAIL(RESULT_INCOMPATIBLE, L"The device does not report pressure");
+	}
+	this->handle = device;
+	this->dropping = false;
+
+	// -- Have the kernel stamp events on the same clock as getTimestamp().
+	int clock = CLOCK_MONOTONIC;
+	ioctl(this->handle, EVIOCSCLOCKID, &clock);
+
+	// -- Axes the device lacks keep the default mapping, not that of an earlier device.
+	this->xRange = AxisRange();
+	this->yRange = AxisRange();
+	this->pressureRange = AxisRange();
+	this->tiltXRange = AxisRange();
+	this->tiltYRange = AxisRange();
+	this->rotationRange = AxisRange();
+	this->readRange(ABS_X, this->xRange);
+	this->readRange(ABS_Y, this->yRange);
+	this->readRange(ABS_PRESSURE, this->pressureRange);
+	this->readAngle(ABS_TILT_X, false, this->tiltXRange);
+	this->readAngle(ABS_TILT_Y, false, this->tiltYRange);
+	this->readAngle(ABS_Z, true, this->rotationRange);
+	this->readState();
+	return RESULT_OK;
+}
+
+void LinuxTablet::close() {
+	if (this->handle >= 0) {
+		::close(this->handle);
+		this->handle = -1;
+	}
+}
+
+void LinuxTablet::readRange(const unsigned int code, AxisRange& range) {
+	struct input_absinfo info;
+	if (ioctl(this->handle, EVIOCGABS(code), &info) == 0 && info.maximum > info.minimum) {
+		range.origin = info.minimum;
+		range.scale = 1.0f / static_cast<float>(info.maximum - info.minimum);
+	}
+}
+
+void LinuxTablet::readAngle(const unsigned int code, const bool fullTurn, AxisRange& range) {
+	struct input_absinfo info;
+	if (ioctl(this->handle, EVIOCGABS(code), &info) != 0 || info.maximum <= info.minimum) {
+		return;
+	}
+	if (fullTurn) {
+		// -- The barrel turns once over the range of the axis, centered on its middle.
+		range.origin = info.minimum + (info.maximum - info.minimum + 1) / 2;
+		range.scale = 2.0f * PI / static_cast<float>(info.maximum - info.minimum + 1);
+	} else {
+		// -- Tilt is reported in units per radian, or in degrees by drivers that leave
+		// -- the resolution out.
+		range.origin = 0;
+		range.scale = info.resolution > 0 ? 1.0f / static_cast<float>(info.resolution) : 
+		                                    PI / 180.0f;
+	}
+}
+
+void LinuxTablet::readState() {
+	unsigned long keyBits[(KEY_CNT + BITS_PER_LONG - 1) / BITS_PER_LONG];
+	memset(keyBits, 0, sizeof(keyBits));
+	ioctl(this->handle, EVIOCGKEY(sizeof(keyBits)), keyBits);
+	this->tools = 0;
+	for (unsigned int tool = 0; tool < TOOL_COUNT; ++tool) {
+		this->setKey(TOOL_CODES[tool], testBit(keyBits, TOOL_CODES[tool]));
+	}
+	this->setKey(BTN_TOUCH, testBit(keyBits, BTN_TOUCH));
+	this->setKey(BTN_STYLUS, testBit(keyBits, BTN_STYLUS));
+	this->setKey(BTN_STYLUS2, testBit(keyBits, BTN_STYLUS2));
+
+	const unsigned int axes[] = { ABS_X, ABS_Y, ABS_PRESSURE, ABS_TILT_X, ABS_TILT_Y, ABS_Z };
+	for (unsigned int idx = 0; idx < sizeof(axes) / sizeof(axes[0]); ++idx) {
+		struct input_absinfo info;
+		if (ioctl(this->handle, EVIOCGABS(axes[idx]), &info) == 0) {
+			this->setAxis(axes[idx], info.value);
+		}
+	}
+}
+
+void LinuxTablet::setKey(const unsigned int code, const bool pressed) {
+	const unsigned int tool = findTool(code);
+	if (tool < TOOL_COUNT) {
+		if (pressed) {
+			this->tools |= 1u << tool;
+		} else {
+			this->tools &= ~(1u << tool);
+		}
+		this->setFlag(PEN_IN_PROXIMITY, this->tools != 0);
+		this->setFlag(PEN_ERASER, (this->tools & 1u) != 0);
+		return;
+	}
+	switch (code) {
+		case BTN_TOUCH:
+			this->setFlag(PEN_TOUCHING, pressed);
+			break;
+		case BTN_STYLUS:
+			this->setButton(0, pressed);
+			break;
+		case BTN_STYLUS2:
+			this->setButton(1, pressed);
+			break;
+		default:
+			break;
+	}
+}
+
+void LinuxTablet::setAxis(const unsigned int code, const int value) {
+	switch (code) {
+		case ABS_X:
+		case ABS_Y:
+			(code == ABS_X ? this->lastX : this->lastY) = value;
+			this->setPosition(this->xRange.map(this->lastX), this->yRange.map(this->lastY));
+			break;
+		case ABS_PRESSURE:
+			this->setPressure(this->pressureRange.map(value));
+			break;
+		case ABS_TILT_X:
+		case ABS_TILT_Y:
+			(code == ABS_TILT_X ? this->lastTiltX : this->lastTiltY) = value;
+			this->setTilt(this->tiltXRange.map(this->lastTiltX), 
+			              this->tiltYRange.map(this->lastTiltY));
+			break;
+		case ABS_Z:
+			this->setRotation(this->rotationRange.map(value));
+			break;
+		default:
+			break;
+	}
+}
+
+void LinuxTablet::update(const Timestamp now) {
+	struct input_event events[64];
+	while (this->handle >= 0) {
+		const ssize_t bytes = read(this->handle, events, sizeof(events));
+		if (bytes <= 0) {
+			break;
+		}
+		const size_t count = static_cast<size_t>(bytes) / sizeof(struct input_event);
+		for (size_t idx = 0; idx < count; ++idx) {
+			const struct input_event& event = events[idx];
+			const Timestamp time = static_cast<Timestamp>(event.time.tv_sec) * 1000000 + 
+			                       static_cast<Timestamp>(event.time.tv_usec);
+			if (event.type == EV_SYN) {
+				if (event.code == SYN_DROPPED) {
+					this->dropping = true;
+				} else if (event.code == SYN_REPORT) {
+					if (this->dropping) {
+						// -- Ask the device where the pen is now instead of guessing.
+						this->readState();
+						this->dropping = false;
+					}
+					this->commitSample(time);
+				}
+				continue;
+			}
+			if (this->dropping) {
+				continue;
+			}
+			if (event.type == EV_KEY) {
+				this->setKey(event.code, event.value != 0);
+			} else if (event.type == EV_ABS) {
+				this->setAxis(event.code, event.value);
+			}
+		}
+	}
+	this->flushSamples();
+}
+
+} // namespace I43D
@@ -0,0 +1,240 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+
+#include "Linux/I43DLinuxTouchScreen.h"
+#include <cstring>
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/input.h>
+#include <sys/ioctl.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace I43D {
+
+LinuxTouchScreen::LinuxTouchScreen() 
+	: handle(-1), dropping(false), sizeScale(1.0f), currentSlot(0) {
+	memset(this->lastX, 0, sizeof(this->lastX));
+	memset(this->lastY, 0, sizeof(this->lastY));
+	memset(this->lastMajor, 0, sizeof(this->lastMajor));
+	memset(this->lastMinor, 0, sizeof(this->lastMinor));
+}
+
+LinuxTouchScreen::LinuxTouchScreen(const std::string& path) 
+	: handle(-1), dropping(false), sizeScale(1.0f), currentSlot(0) {
+	memset(this->lastX, 0, sizeof(this->lastX));
+	memset(this->lastY, 0, sizeof(this->lastY));
+	memset(this->lastMajor, 0, sizeof(this->lastMajor));
+	memset(this->lastMinor, 0, sizeof(this->lastMinor));
+	const ResultCode result = this->open(path);
+	if (result != RESULT_OK) {
+		I43D_FAIL_STARTUP(result, L"Could not open the touch screen");
+	}
+}
+
+LinuxTouchScreen::~LinuxTouchScreen() {
+	// -- Nobody can watch the contacts lift any more, so only the descriptor is closed.
+	if (this->handle >= 0) {
+		::close(this->handle);
+	}
+}
+
+ResultCode LinuxTouchScreen::open(const std::string& path) {
+	this->close();
+	const int device = ::open(path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+	if (device < 0) {
+		I43D_FAIL(RESULT_SYSTEM_ERROR, L"Could not open the touch screen");
+	}
+	unsigned long absBits[(ABS_CNT + 8 * sizeof(long) - 1) / (8 * sizeof(long))];
+	memset(absBits, 0, sizeof(absBits));
+	ioctl(device, EVIOCGBIT(EV_ABS, sizeof(absBits)), absBits);
+	const unsigned int bitsPerLong = 8 * sizeof(long);
+	if ((absBits[ABS_MT_SLOT / bitsPerLong] & (1UL << (ABS_MT_SLOT % bitsPerLong))) == 0) {
+		::close(device);
+		I43D_FAIL(RESULT_INCOMPATIBLE, L"The device does not report multi-touch slots");
+	}
+	this->handle = device;
+	this->dropping = false;
+
+	// -- Have the kernel stamp events on the same clock as getTimestamp().
+	int clock = CLOCK_MONOTONIC;
+	ioctl(this->handle, EVIOCSCLOCKID, &clock);
+
+	// -- Axes the device lacks keep the default mapping, not that of an earlier device.
+	this->xRange = AxisRange();
+	this->yRange = AxisRange();
+	this->pressureRange = AxisRange();
+	this->readRange(ABS_MT_POSITION_X, this->xRange);
+	this->readRange(ABS_MT_POSITION_Y, this->yRange);
+	this->readRange(ABS_MT_PRESSURE, this->pressureRange);
+	this->sizeScale = this->xRange.scale;
+	this->currentSlot = 0;
+	struct input_absinfo info;
+	if (ioctl(this->handle, EVIOCGABS(ABS_MT_SLOT), &info) == 0 && info.value >= 0) {
+		this->currentSlot = static_cast<unsigned int>(info.value);
+	}
+	return RESULT_OK;
+}
+
+void LinuxTouchScreen::close() {
+	if (this->handle >= 0) {
+		::close(this->handle);
+		this->handle = -1;
+		this->liftAll(getTimestamp());
+	}
+}
+
+void LinuxTouchScreen::readRange(const unsigned int code, AxisRange& range) {
+	struct input_absinfo info;
+	if (ioctl(this->handle, EVIOCGABS(code), &info) == 0 && info.maximum > info.minimum) {
+		range.minimum = info.minimum;
+		range.scale = 1.0f / static_cast<float>(info.maximum - info.minimum);
+	}
+}
+
+void LinuxTouchScreen::liftAll(const Timestamp time) {
+	for (unsigned int slot = 0; slot < TouchContacts::MAX_SLOTS; ++slot) {
+		this->selectSlot(slot);
+		this->setContactId(-1, time);
+	}
+	this->commitFrame(time);
+	this->selectSlot(this->currentSlot);
+}
+
+bool LinuxTouchScreen::readSlotValues(const unsigned int code, int* values) {
+	// -- EVIOCGMTSLOTS fills the code followed by one value for each slot, up to the size 
+	// -- of the buffer. Slots the device does not have keep the value they start with.
+	int buffer[TouchContacts::MAX_SLOTS + 1];
+	memset(buffer, 0xFF, sizeof(buffer));
+	buffer[0] = static_cast<int>(code);
+	if (ioctl(this->handle, EVIOCGMTSLOTS(sizeof(buffer)), buffer) < 0) {
+		return false;
+	}
+	memcpy(values, buffer + 1, TouchContacts::MAX_SLOTS * sizeof(int));
+	return true;
+}
+
+bool LinuxTouchScreen::readSlots(const Timestamp time) {
+	int ids[TouchContacts::MAX_SLOTS];
+	int xs[TouchContacts::MAX_SLOTS];
+	int ys[TouchContacts::MAX_SLOTS];
+	int pressures[TouchContacts::MAX_SLOTS];
+	if (this->readSlotValues(ABS_MT_TRACKING_ID, ids) == false) {
+		return false;
+	}
+	const bool havePosition = this->readSlotValues(ABS_MT_POSITION_X, xs) && 
+	                          this->readSlotValues(ABS_MT_POSITION_Y, ys);
+	const bool havePressure = this->readSlotValues(ABS_MT_PRESSURE, pressures);
+
+	// -- Contacts that stayed down keep their id, so only the ones that changed begin or 
+	// -- end. Protocol B does not resend the id of a contact that is still down.
+	for (unsigned int slot = 0; slot < TouchContacts::MAX_SLOTS; ++slot) {
+		this->selectSlot(slot);
+		this->setContactId(ids[slot], time);
+		if (ids[slot] < 0) {
+			continue;
+		}
+		if (havePosition) {
+			this->lastX[slot] = xs[slot];
+			this->lastY[slot] = ys[slot];
+			this->setPosition(this->xRange.map(xs[slot]), this->yRange.map(ys[slot]));
+		}
+		if (havePressure) {
+			this->setPressure(this->pressureRange.map(pressures[slot]));
+		}
+	}
+	struct input_absinfo info;
+	if (ioctl(this->handle, EVIOCGABS(ABS_MT_SLOT), &info) == 0 && info.value >= 0) {
+		this->currentSlot = static_cast<unsigned int>(info.value);
+	}
+	this->selectSlot(this->currentSlot);
+	return true;
+}
+
+void LinuxTouchScreen::update(const Timestamp now) {
+	struct input_event events[64];
+	while (this->handle >= 0) {
+		const ssize_t bytes = read(this->handle, events, sizeof(events));
+		if (bytes <= 0) {
+			break;
+		}
+		const size_t count = static_cast<size_t>(bytes) / sizeof(struct input_event);
+		for (size_t idx = 0; idx < count; ++idx) {
+			const struct input_event& event = events[idx];
+			const Timestamp time = static_cast<Timestamp>(event.time.tv_sec) * 1000000 + 
+			                       static_cast<Timestamp>(event.time.tv_usec);
+			if (event.type == EV_SYN) {
+				if (event.code == SYN_DROPPED) {
+					this->dropping = true;
+				} else if (event.code == SYN_REPORT) {
+					if (this->dropping) {
+						// -- Ask the device which contacts are down instead of guessing, and
+						// -- only lift them all if it can not tell.
+						if (this->readSlots(time) == false) {
+							this->liftAll(time);
+						}
+						this->dropping = false;
+					}
+					this->commitFrame(time);
+				}
+				continue;
+			}
+			if (event.type != EV_ABS || this->dropping) {
+				continue;
+			}
+			const unsigned int slot = this->currentSlot;
+			const bool inRange = slot < TouchContacts::MAX_SLOTS;
+			switch (event.code) {
+				case ABS_MT_SLOT:
+					this->currentSlot = event.value < 0 
+						? static_cast<unsigned int>(TouchContacts::MAX_SLOTS) 
+						: static_cast<unsigned int>(event.value);
+					this->selectSlot(this->currentSlot);
+					break;
+				case ABS_MT_TRACKING_ID:
+					this->setContactId(event.value, time);
+					break;
+				case ABS_MT_POSITION_X:
+				case ABS_MT_POSITION_Y:
+					if (inRange) {
+						(event.code == ABS_MT_POSITION_X ? this->lastX : this->lastY)[slot] = event.value;
+						this->setPosition(this->xRange.map(this->lastX[slot]), 
+						                  this->yRange.map(this->lastY[slot]));
+					}
+					break;
+				case ABS_MT_PRESSURE:
+					this->setPressure(this->pressureRange.map(event.value));
+					break;
+				case ABS_MT_TOUCH_MAJOR:
+				case ABS_MT_TOUCH_MINOR:
+					if (inRange) {
+						(event.code == ABS_MT_TOUCH_MAJOR ? this->lastMajor : this->lastMinor)[slot] = event.value;
+						this->setTouchSize(this->lastMajor[slot] * this->sizeScale, 
+						                   this->lastMinor[slot] * this->sizeScale);
+					}
+					break;
+				default:
+					break;
+			}
+		}
+	}
+}
+
+} // namespace I43D
@@ -20,6 +20,9 @@ http://www.gnu.org/copyleft/lesser.txt.
 
 #include "Win32/I43DWin32Keyboard.h"
 
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
 namespace I43D {
 
 Win32Keyboard::Win32Keyboard() {
@@ -29,7 +32,11 @@ Win32Keyboard::~Win32Keyboard() {
 }
 
 const std::wstring Win32Keyboard::getLayoutName() {
-	return NULL;
+	wchar_t name[KL_NAMELENGTH];
+	if (GetKeyboardLayoutNameW(name) == FALSE) {
+		return std::wstring();
+	}
+	return std::wstring(name);
 }
 
 void Win32Keyboard::enableEvents(const bool flag) {
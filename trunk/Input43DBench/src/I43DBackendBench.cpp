@@ -0,0 +1,157 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+#include "I43DBench.h"
+#include "I43DBackend.h"
+#include <cstdio>
+
+/*!
+ * @file
+ *     This file contains the benchmark of the compile time backend. It polls the same 
+ *     devices through the abstract Mouse and Keyboard and through BackendMouse and 
+ *     BackendKeyboard, where the calls are direct and inline.
+ * @author Robert Eugene Simmons Jr. (Kraythe)
+ */
+
+using namespace I43D;
+
+namespace I43DBench {
+
+namespace {
+
+/*! @brief The number of polled frames in each run. */
+const unsigned int FRAME_COUNT = 200000;
+
+/*! @brief The number of keys polled each frame. */
+const unsigned short POLLED_KEYS = 128;
+
+/*! @brief The mouse of the backend. */
+BackendMouse* backendMouse = 0;
+
+/*! @brief The keyboard of the backend. */
+BackendKeyboard* backendKeyboard = 0;
+
+/*! 
+ * @brief 
+ *     The same mouse through its interface. The pointer is volatile so the compiler can 
+ *     not learn the type of the device and turn the calls direct. 
+ */
+Mouse* volatile interfaceMouse = 0;
+
+/*! @brief The same keyboard through its interface. */
+Keyboard* volatile interfaceKeyboard = 0;
+
+/*!
+ * @brief
+ *     Polls what a game polls each frame: the position, five buttons and a block of keys.
+ */
+template <class MouseType, class KeyboardType>
+inline unsigned int pollFrame(MouseType& mouse, KeyboardType& keyboard) {
+	unsigned int result = mouse.getX() + mouse.getY();
+	for (unsigned short buttonNum = 1; buttonNum <= 5; ++buttonNum) {
+		result += mouse.isButtonPressed(buttonNum) ? 1 : 0;
+	}
+	for (unsigned short keyNum = 0; keyNum < POLLED_KEYS; ++keyNum) {
+		result += keyboard.isKeyPressed(keyNum) ? keyNum : 0;
+	}
+	return result;
+}
+
+/*!
+ * @brief
+ *     Translates a block of keys to scan codes, as key binding screens do.
+ */
+template <class KeyboardType>
+inline unsigned int translateKeys(KeyboardType& keyboard) {
+	unsigned int result = 0;
+	for (unsigned short keyNum = 0; keyNum < POLLED_KEYS; ++keyNum) {
+		result += keyboard.getScanCodeForKeyNum(keyNum);
+	}
+	return result;
+}
+
+unsigned int pollThroughInterfaces(const unsigned int iterations) {
+	unsigned int result = 0;
+	for (unsigned int frame = 0; frame < iterations; ++frame) {
+		result += pollFrame(*interfaceMouse, *interfaceKeyboard);
+	}
+	return result;
+}
+
+unsigned int pollThroughBackend(const unsigned int iterations) {
+	unsigned int result = 0;
+	for (unsigned int frame = 0; frame < iterations; ++frame) {
+		result += pollFrame(*backendMouse, *backendKeyboard);
+	}
+	return result;
+}
+
+unsigned int translateThroughInterface(const unsigned int iterations) {
+	unsigned int result = 0;
+	for (unsigned int frame = 0; frame < iterations; ++frame) {
+		result += translateKeys(*interfaceKeyboard);
+	}
+	return result;
+}
+
+unsigned int translateThroughBackend(const unsigned int iterations) {
+	unsigned int result = 0;
+	for (unsigned int frame = 0; frame < iterations; ++frame) {
+		result += translateKeys(*backendKeyboard);
+	}
+	return result;
+}
+
+} // anonymous namespace
+
+void runBackendBenchmarks() {
+#if defined( I43D_BACKEND_VIRTUAL ) || !defined( _WIN32 )
+	BackendMouse mouse;
+	BackendKeyboard keyboard;
+
+	// -- Hold a few keys and a button so the polls see a realistic mix.
+	const unsigned short heldKeys[] = { 17, 30, 31, 32, 42, 57 };
+	for (unsigned int idx = 0; idx < sizeof(heldKeys) / sizeof(heldKeys[0]); ++idx) {
+		keyboard.pushEvent(makeInputEvent(0, 1, IEVT_KEY_PRESSED, heldKeys[idx], heldKeys[idx]));
+	}
+	mouse.pushEvent(makeInputEvent(0, 2, IEVT_MOUSE_MOVED, 0, 320, 240));
+	mouse.pushEvent(makeInputEvent(0, 2, IEVT_MOUSE_BUTTON_PRESSED, 1));
+
+	backendMouse = &mouse;
+	backendKeyboard = &keyboard;
+	interfaceMouse = &mouse;
+	interfaceKeyboard = &keyboard;
+
+	printHeading("Backend: one frame of polling, 2 axes + 5 buttons + 128 keys");
+#if !defined( _MSC_VER ) && __cplusplus < 201103L
+	printf("  (I43D_FINAL is empty in this build, so both paths call through the vtable)\n");
+#endif
+	measure("through Mouse& and Keyboard&", pollThroughInterfaces, FRAME_COUNT);
+	measure("through BackendMouse and BackendKeyboard", pollThroughBackend, FRAME_COUNT);
+	printHeading("Backend: scan codes of 128 keys");
+	measure("through Keyboard&", translateThroughInterface, FRAME_COUNT);
+	measure("through BackendKeyboard", translateThroughBackend, FRAME_COUNT);
+#else
+	// -- The Win32 devices need a window to exist. Define I43D_BACKEND_VIRTUAL to measure
+	// -- the virtual devices instead.
+	printHeading("Backend: skipped, the benchmark needs I43D_BACKEND_VIRTUAL on Win32");
+#endif
+}
+
+} // namespace I43DBench
@@ -0,0 +1,65 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+#include "I43DBench.h"
+#include <cstdio>
+
+/*!
+ * @file
+ *     This file contains the driver of the benchmarks. Build it with optimizations; the 
+ *     numbers of a debug build say little.
+ * @author Robert Eugene Simmons Jr. (Kraythe)
+ */
+
+namespace I43DBench {
+
+namespace {
+
+/*! @brief The number of runs of each benchmark. */
+const unsigned int RUN_COUNT = 7;
+
+/*! @brief Receives the results of the benchmarks so no work is optimized away. */
+volatile unsigned int resultSink = 0;
+
+} // anonymous namespace
+
+void measure(const char* name, BenchBody body, const unsigned int iterations) {
+	I43D::Timestamp fastest = 0;
+	for (unsigned int run = 0; run < RUN_COUNT; ++run) {
+		const I43D::Timestamp start = I43D::getTimestamp();
+		resultSink = resultSink + body(iterations);
+		const I43D::Timestamp elapsed = I43D::getTimestamp() - start;
+		if (run == 0 || elapsed < fastest) {
+			fastest = elapsed;
+		}
+	}
+	printf("  %-44s %9.1f ns\n", name, fastest * 1000.0 / iterations);
+}
+
+void printHeading(const char* title) {
+	printf("\n%s\n", title);
+}
+
+} // namespace I43DBench
+
+int main() {
+	I43DBench::runBackendBenchmarks();
+	I43DBench::runFilterBenchmarks();
+	return 0;
+}
@@ -0,0 +1,80 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+#ifndef _I43D_BENCH_H_
+#define _I43D_BENCH_H_
+
+#include "I43DTimer.h"
+
+/*!
+ * @file
+ *     This file contains the helpers shared by the benchmarks of the Input43D library and
+ *     the benchmarks the driver runs.
+ * @author Robert Eugene Simmons Jr. (Kraythe)
+ */
+
+namespace I43DBench {
+
+/*!
+ * @brief
+ *     The code being measured.
+ * @param iterations
+ *     The number of times to repeat the measured work.
+ * @return
+ *     A value computed from the work so the compiler can not leave it out.
+ */
+typedef unsigned int (*BenchBody)(const unsigned int iterations);
+
+/*!
+ * @brief
+ *     Runs a benchmark and prints the time of one iteration.
+ * @remarks
+ *     The body runs a few times and the fastest run is reported, which filters out the 
+ *     runs that were interrupted by the operating system.
+ * @param name
+ *     The name printed with the time.
+ * @param body
+ *     The code to measure.
+ * @param iterations
+ *     The number of iterations of each run.
+ */
+void measure(const char* name, BenchBody body, const unsigned int iterations);
+
+/*!
+ * @brief
+ *     Prints the heading of a group of benchmarks.
+ */
+void printHeading(const char* title);
+
+/*!
+ * @brief
+ *     Compares polling the mouse and keyboard through their interfaces and through the
+ *     backend classes. See I43DBackend.h.
+ */
+void runBackendBenchmarks();
+
+/*!
+ * @brief
+ *     Compares filtering events with a chain of listeners and with the filter pipeline.
+ *     See I43DInputFilter.h.
+ */
+void runFilterBenchmarks();
+
+} // namespace I43DBench
+#endif  // _I43D_BENCH_H_
@@ -0,0 +1,206 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+
+#include "I43DBench.h"
+#include "I43DInputFilter.h"
+
+/*!
+ * @file
+ *     This file contains the benchmark of the filter pipeline. The same four filters run
+ *     over the same frames of controller and mouse input as a chain of listeners, each a
+ *     sink that filters an event and pushes it on to the next, as a FilterPipeline over a
+ *     FilterChain and as a FilterPipeline over a DynamicFilterChain.
+ *     <br><br>
+ *     CoalesceFilter is left out because a listener sees one event at a time and has no
+ *     batch to fold into.
+ * @author Robert Eugene Simmons Jr. (Kraythe)
+ */
+
+using namespace I43D;
+
+namespace I43DBench {
+
+namespace {
+
+/*! @brief The number of frames of input in each run. */
+const unsigned int FRAME_COUNT = 20000;
+
+/*! @brief The number of events in a frame. */
+const unsigned int FRAME_EVENTS = 64;
+
+/*! @brief The controller the events come from. */
+const DeviceID CONTROLLER_DEVICE = 1;
+
+/*! @brief The mouse the events come from. */
+const DeviceID MOUSE_DEVICE = 2;
+
+/*!
+ * @brief
+ *     Receives the filtered events at the end of every variant.
+ */
+class SumSink : public InputEventSink {
+public:
+	SumSink() : sum(0) {}
+
+	virtual bool pushEvent(const InputEvent& event) {
+		this->sum += static_cast<unsigned int>(event.value + event.value2 + event.code);
+		return true;
+	}
+
+	/*! @brief A value computed from every event received. */
+	unsigned int sum;
+};
+
+/*!
+ * @brief
+ *     One filter of the listener chain. The event arrives through a virtual call, is
+ *     filtered and leaves through another.
+ */
+template <class Filter>
+class ListenerStage : public InputEventSink {
+public:
+	ListenerStage() : next(0) {}
+
+	virtual bool pushEvent(const InputEvent& event) {
+		InputEvent filtered = event;
+		FilterBatch batch;
+		batch.events = &filtered;
+		batch.count = 0;
+		batch.replaced = 0;
+		return this->filter.filter(filtered, batch) && this->next->pushEvent(filtered);
+	}
+
+	/*! @brief The filter. */
+	Filter filter;
+
+	/*! @brief The stage or sink the survivors go to. */
+	InputEventSink* next;
+};
+
+/*! @brief The fused chain of the four filters. */
+typedef FilterChain<DeadzoneFilter, FilterChain<SmoothingFilter,
+        FilterChain<InvertFilter, RemapFilter> > > FusedFilters;
+
+/*! @brief The frames of input, which every variant filters. */
+InputEvent frames[FRAME_EVENTS];
+
+/*!
+ * @brief
+ *     Fills a frame with axis moves of the controller and moves of the mouse.
+ */
+void buildFrame() {
+	for (unsigned int idx = 0; idx < FRAME_EVENTS; ++idx) {
+		const int swing = static_cast<int>((idx * 7919) % 65535) - 32767;
+		if (idx % 4 == 3) {
+			frames[idx] = makeInputEvent(idx * 100, MOUSE_DEVICE, IEVT_MOUSE_MOVED, 0,
+			                             swing / 64, swing / 128);
+		} else {
+			frames[idx] = makeInputEvent(idx * 100, CONTROLLER_DEVICE, IEVT_CONTROLLER_AXIS_MOVED,
+			                             static_cast<unsigned short>(idx % 3), swing, swing);
+		}
+	}
+}
+
+/*!
+ * @brief
+ *     Sets up the four filters the same way in every variant.
+ */
+void configure(DeadzoneFilter& deadzone, SmoothingFilter& smoothing, InvertFilter& invert,
+               RemapFilter& remap) {
+	deadzone.setDefaultDeadzone(0.2f);
+	smoothing.setFactor(0.5f);
+	invert.setInverted(CONTROLLER_DEVICE, 1, true);
+	remap.setMapping(CONTROLLER_DEVICE, IEVT_CONTROLLER_AXIS_MOVED, 2, 4);
+}
+
+unsigned int runListenerChain(const unsigned int iterations) {
+	SumSink sink;
+	ListenerStage<DeadzoneFilter> deadzone;
+	ListenerStage<SmoothingFilter> smoothing;
+	ListenerStage<InvertFilter> invert;
+	ListenerStage<RemapFilter> remap;
+	configure(deadzone.filter, smoothing.filter, invert.filter, remap.filter);
+	deadzone.next = &smoothing;
+	smoothing.next = &invert;
+	invert.next = &remap;
+	remap.next = &sink;
+
+	// -- Reach the chain through its interface, the way a device reaches its listeners.
+	InputEventSink* volatile first = &deadzone;
+	for (unsigned int frame = 0; frame < iterations; ++frame) {
+		for (unsigned int idx = 0; idx < FRAME_EVENTS; ++idx) {
+			first->pushEvent(frames[idx]);
+		}
+	}
+	return sink.sum;
+}
+
+unsigned int runFusedPipeline(const unsigned int iterations) {
+	SumSink sink;
+	FilterPipeline<FusedFilters> pipeline(&sink, FRAME_EVENTS);
+	FusedFilters& filters = pipeline.getFilter();
+	configure(filters.getHead(), filters.getTail().getHead(),
+	          filters.getTail().getTail().getHead(), filters.getTail().getTail().getTail());
+
+	InputEventSink* volatile first = &pipeline;
+	for (unsigned int frame = 0; frame < iterations; ++frame) {
+		for (unsigned int idx = 0; idx < FRAME_EVENTS; ++idx) {
+			first->pushEvent(frames[idx]);
+		}
+		pipeline.flush(frames[FRAME_EVENTS - 1].time);
+	}
+	return sink.sum;
+}
+
+unsigned int runDynamicPipeline(const unsigned int iterations) {
+	SumSink sink;
+	InputFilterAdapter<DeadzoneFilter> deadzone;
+	InputFilterAdapter<SmoothingFilter> smoothing;
+	InputFilterAdapter<InvertFilter> invert;
+	InputFilterAdapter<RemapFilter> remap;
+	configure(deadzone.getFilter(), smoothing.getFilter(), invert.getFilter(),
+	          remap.getFilter());
+	FilterPipeline<DynamicFilterChain> pipeline(&sink, FRAME_EVENTS);
+	pipeline.getFilter().addFilter(&deadzone);
+	pipeline.getFilter().addFilter(&smoothing);
+	pipeline.getFilter().addFilter(&invert);
+	pipeline.getFilter().addFilter(&remap);
+
+	InputEventSink* volatile first = &pipeline;
+	for (unsigned int frame = 0; frame < iterations; ++frame) {
+		for (unsigned int idx = 0; idx < FRAME_EVENTS; ++idx) {
+			first->pushEvent(frames[idx]);
+		}
+		pipeline.flush(frames[FRAME_EVENTS - 1].time);
+	}
+	return sink.sum;
+}
+
+} // anonymous namespace
+
+void runFilterBenchmarks() {
+	buildFrame();
+	printHeading("Filters: one frame of 64 events through deadzone, smoothing, invert, remap");
+	measure("chain of listeners", runListenerChain, FRAME_COUNT);
+	measure("FilterPipeline<FilterChain>", runFusedPipeline, FRAME_COUNT);
+	measure("FilterPipeline<DynamicFilterChain>", runDynamicPipeline, FRAME_COUNT);
+}
+
+} // namespace I43DBench
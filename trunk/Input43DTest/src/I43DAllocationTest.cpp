@@ -0,0 +1,322 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+
+#include "I43DTest.h"
+#include "I43DAtomic.h"
+#include "I43DEventQueue.h"
+#include "I43DInputWait.h"
+#include "I43DParallelDispatch.h"
+#include "I43DSeat.h"
+#include "I43DVirtualDevice.h"
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+/*!
+ * @file
+ *     This file contains a test that the event path does not allocate once it is warmed
+ *     up. Queues, a seat with a virtual keyboard and mouse, listeners, a waiter that waits
+ *     again each time it is woken and a dispatcher that hands the frames to listeners on
+ *     a pool of threads run for a number of frames, and the test fails if any frame after
+ *     the first few allocated.
+ *     <br><br>
+ *     Allocations are counted by replacing the global operator new. The library sources 
+ *     are built into the test instead of linking the DLL, whose allocations a replacement 
+ *     in the executable would not see.
+ * @author Robert Eugene Simmons Jr. (Kraythe)
+ */
+
+namespace {
+
+/*! @brief The number of allocations made while counting. */
+volatile unsigned int allocationCount = 0;
+
+/*! @brief Whether allocations are counted. */
+volatile unsigned int counting = 0;
+
+/*!
+ * @brief
+ *     Counts an allocation if counting is on.
+ */
+inline void countAllocation() {
+	if (I43D::atomicLoad(counting) != 0) {
+		I43D::atomicAdd(allocationCount, 1);
+	}
+}
+
+/*! @brief The device id the keyboard is bound with. */
+const I43D::DeviceID KEYBOARD_DEVICE = 1;
+
+/*! @brief The device id the mouse is bound with. */
+const I43D::DeviceID MOUSE_DEVICE = 2;
+
+/*! @brief The key pressed every frame. */
+const unsigned short TEST_KEY = 30;
+
+/*! @brief The number of frames run before counting starts. */
+const unsigned int WARM_UP_FRAMES = 4;
+
+/*! @brief The number of frames counted. */
+const unsigned int FRAME_COUNT = 1000;
+
+/*!
+ * @brief
+ *     Counts what the devices dispatch.
+ */
+class CountingListener : public I43D::KeyboardListener, public I43D::MouseListener {
+public:
+	CountingListener() : keyCount(0), moveCount(0), buttonCount(0) {}
+
+	virtual void keyPressed(const I43D::Keyboard* source, const unsigned short keyNum,
+	                        const unsigned int scanCode) {
+		++this->keyCount;
+	}
+
+	virtual void keyReleased(const I43D::Keyboard* source, const unsigned short keyNum,
+	                         const unsigned int scanCode) {
+		++this->keyCount;
+	}
+
+	virtual void moved(const I43D::Mouse* source, const unsigned int x, const unsigned int y) {
+		++this->moveCount;
+	}
+
+	virtual void buttonPressed(const I43D::Mouse* source, const unsigned short buttonNum) {
+		++this->buttonCount;
+	}
+
+	virtual void buttonReleased(const I43D::Mouse* source, const unsigned short buttonNum) {
+		++this->buttonCount;
+	}
+
+	/*! @brief The key events seen. */
+	unsigned int keyCount;
+
+	/*! @brief The mouse moves seen. */
+	unsigned int moveCount;
+
+	/*! @brief The button events seen. */
+	unsigned int buttonCount;
+};
+
+/*!
+ * @brief
+ *     Counts the events dispatched on the pool.
+ */
+class CountingBatchListener : public I43D::InputBatchListener {
+public:
+	CountingBatchListener() : eventCount(0) {}
+
+	virtual void eventsReceived(const I43D::InputEvent* events, const unsigned int count) {
+		this->eventCount += count;
+	}
+
+	/*! @brief The events seen. Only read after the dispatcher joined. */
+	unsigned int eventCount;
+};
+
+/*!
+ * @brief
+ *     Waits for the test key again every time it is woken.
+ */
+class RepeatingWaiter : public I43D::InputWaiter {
+public:
+	RepeatingWaiter(I43D::InputWaitTable& table) : wakeCount(0), table(table) {
+		this->table.add(TEST_KEY, *this);
+	}
+
+	/*! @brief The number of times the waiter was woken. */
+	unsigned int wakeCount;
+
+protected:
+	virtual void inputArrived(const unsigned int code) {
+		++this->wakeCount;
+		this->table.add(TEST_KEY, *this);
+	}
+
+private:
+	RepeatingWaiter& operator=(const RepeatingWaiter&);
+
+	/*! @brief The table waited in. */
+	I43D::InputWaitTable& table;
+};
+
+/*!
+ * @brief
+ *     The objects on the event path.
+ */
+class EventPath {
+public:
+	EventPath()
+		: queue(256), priorityQueue(256, 64), seat(0, 256), waiter(keyboard.getKeyPressWaits()),
+		  pool(2), dispatcher(&pool) {
+		this->dispatcher.addListener(&this->batchListeners[0]);
+		this->dispatcher.addListener(&this->batchListeners[1]);
+		this->seat.bindKeyboard(&this->keyboard, KEYBOARD_DEVICE);
+		this->seat.bindMouse(&this->mouse, MOUSE_DEVICE);
+		this->keyboard.addKeyboardListener(&this->listener);
+		this->mouse.addMouseListener(&this->listener);
+	}
+
+	~EventPath() {
+		this->keyboard.removeKeyboardListener(&this->listener);
+		this->mouse.removeMouseListener(&this->listener);
+	}
+
+	/*!
+	 * @brief
+	 *     Runs one frame of input through everything.
+	 */
+	void runFrame(const unsigned int frame) {
+		using namespace I43D;
+		const Timestamp time = static_cast<Timestamp>(frame) * 16000;
+		const int position = static_cast<int>(frame % 640);
+		const InputEvent events[] = {
+			makeInputEvent(time, KEYBOARD_DEVICE, IEVT_KEY_PRESSED, TEST_KEY, 0x1E),
+			makeInputEvent(time + 1000, MOUSE_DEVICE, IEVT_MOUSE_MOVED, 0, position, position),
+			makeInputEvent(time + 2000, MOUSE_DEVICE, IEVT_MOUSE_BUTTON_PRESSED, 1),
+			makeInputEvent(time + 3000, MOUSE_DEVICE, IEVT_MOUSE_MOVED, 0, position + 1, position),
+			makeInputEvent(time + 4000, MOUSE_DEVICE, IEVT_MOUSE_BUTTON_RELEASED, 1),
+			makeInputEvent(time + 5000, KEYBOARD_DEVICE, IEVT_KEY_RELEASED, TEST_KEY, 0x1E)
+		};
+		const unsigned int eventCount = sizeof(events) / sizeof(events[0]);
+
+		InputEvent event;
+		for (unsigned int idx = 0; idx < eventCount; ++idx) {
+			this->queue.pushEvent(events[idx]);
+			this->priorityQueue.pushEvent(events[idx]);
+			this->dispatcher.pushEvent(events[idx]);
+		}
+		this->dispatcher.dispatch();
+		while (this->queue.popEvent(event)) {
+			if (this->mouse.pushEvent(event) == false) {
+				this->keyboard.pushEvent(event);
+			}
+		}
+		while (this->priorityQueue.popEvent(event)) {
+		}
+		this->keyboard.update(time + 8000);
+
+		InputEvent seatEvents[16];
+		while (this->seat.popEvents(seatEvents, 16) > 0) {
+		}
+		SeatState state;
+		this->seat.getState(state);
+		this->dispatcher.join();
+	}
+
+	/*! @brief A plain queue. */
+	I43D::EventQueue queue;
+
+	/*! @brief A queue with a priority lane. */
+	I43D::PriorityEventQueue priorityQueue;
+
+	/*! @brief The keyboard the events are played on. */
+	I43D::VirtualKeyboard keyboard;
+
+	/*! @brief The mouse the events are played on. */
+	I43D::VirtualMouse mouse;
+
+	/*! @brief The seat both devices are bound to. */
+	I43D::Seat seat;
+
+	/*! @brief Counts what the devices dispatch. */
+	CountingListener listener;
+
+	/*! @brief Waits on the keyboard. */
+	RepeatingWaiter waiter;
+
+	/*! @brief Count the events of the dispatcher. */
+	CountingBatchListener batchListeners[2];
+
+	/*! @brief Runs the batch listeners. */
+	I43D::WorkerPool pool;
+
+	/*! @brief Hands the frames to the batch listeners on the pool. */
+	I43D::ParallelEventDispatcher dispatcher;
+
+private:
+	EventPath(const EventPath&);
+	EventPath& operator=(const EventPath&);
+};
+
+} // anonymous namespace
+
+void* operator new(size_t size) {
+	countAllocation();
+	void* memory = malloc(size > 0 ? size : 1);
+	if (memory == 0) {
+		abort();
+	}
+	return memory;
+}
+
+void* operator new[](size_t size) {
+	return operator new(size);
+}
+
+void operator delete(void* memory) throw() {
+	free(memory);
+}
+
+void operator delete[](void* memory) throw() {
+	free(memory);
+}
+
+#if defined( __cpp_sized_deallocation )
+
+void operator delete(void* memory, size_t) throw() {
+	free(memory);
+}
+
+void operator delete[](void* memory, size_t) throw() {
+	free(memory);
+}
+
+#endif
+
+namespace I43DTest {
+
+bool runAllocationTest() {
+	EventPath path;
+	unsigned int frame = 0;
+	for (; frame < WARM_UP_FRAMES; ++frame) {
+		path.runFrame(frame);
+	}
+
+	I43D::atomicStore(counting, 1);
+	for (; frame < WARM_UP_FRAMES + FRAME_COUNT; ++frame) {
+		path.runFrame(frame);
+	}
+	I43D::atomicStore(counting, 0);
+
+	const unsigned int frames = WARM_UP_FRAMES + FRAME_COUNT;
+	const unsigned int allocations = I43D::atomicLoad(allocationCount);
+	printf("%u allocations in %u frames\n", allocations, FRAME_COUNT);
+	const bool dispatched = check(
+		path.listener.keyCount == 2 * frames && path.listener.moveCount == 2 * frames &&
+		path.listener.buttonCount == 2 * frames && path.waiter.wakeCount == frames &&
+		path.batchListeners[0].eventCount == 6 * frames && 
+		path.batchListeners[1].eventCount == 6 * frames, 
+		"the events were not all dispatched");
+	return check(allocations == 0, "the event path allocated once warmed up") && dispatched;
+}
+
+} // namespace I43DTest
@@ -0,0 +1,178 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+
+#include "I43DTest.h"
+#include "I43DEventCodec.h"
+#include <climits>
+#include <cstring>
+
+/*!
+ * @file
+ *     This file contains the tests of the event wire format. Packets without events, with 
+ *     events whose fields sit on either side of the byte boundaries of the variable length
+ *     integers and filled until the writer refuses more are encoded and decoded again. 
+ *     Packets cut short must be refused.
+ * @author Robert Eugene Simmons Jr. (Kraythe)
+ */
+
+using namespace I43D;
+
+namespace I43DTest {
+
+namespace {
+
+/*! @brief More events than a packet can hold, as every event takes at least a byte. */
+const unsigned int MAX_EVENTS = EventPacketWriter::MAX_PACKET_SIZE;
+
+/*! @brief The latest time there is. */
+const Timestamp MAX_TIME = ~0ull;
+
+/*!
+ * @brief
+ *     Collects the decoded events.
+ */
+class CollectingSink : public InputEventSink {
+public:
+	CollectingSink() : count(0) {}
+
+	virtual bool pushEvent(const InputEvent& event) {
+		if (this->count < MAX_EVENTS) {
+			this->events[this->count++] = event;
+		}
+		return true;
+	}
+
+	/*! @brief The events received. */
+	InputEvent events[MAX_EVENTS];
+
+	/*! @brief The number of events received. */
+	unsigned int count;
+};
+
+/*!
+ * @brief
+ *     Determines if two events carry the same fields.
+ */
+bool sameEvent(const InputEvent& first, const InputEvent& second) {
+	return first.time == second.time && first.device == second.device && 
+	       first.type == second.type && first.code == second.code && 
+	       first.value == second.value && first.value2 == second.value2;
+}
+
+/*!
+ * @brief
+ *     Writes events into a packet, reads it back and checks that the same events come out.
+ * @param events
+ *     The events.
+ * @param count
+ *     The number of events.
+ * @param what
+ *     The name of the case, printed if it fails.
+ * @return
+ *     False if the case failed.
+ */
+bool checkRoundTrip(const InputEvent* events, const unsigned int count, const char* what) {
+	const Timestamp sendTime = 0x0123456789ABCDEFull;
+	EventPacketWriter writer;
+	for (unsigned int idx = 0; idx < count; ++idx) {
+		if (check(writer.addEvent(events[idx]), what) == false) {
+			return false;
+		}
+	}
+	unsigned int size = 0;
+	const unsigned char* packet = writer.finish(sendTime, size);
+	bool passed = check(size >= EventPacketWriter::HEADER_SIZE && 
+	                    size <= EventPacketWriter::MAX_PACKET_SIZE &&
+	                    EventPacketReader::getPacketSize(packet) == size, what);
+
+	EventPacketReader reader;
+	CollectingSink sink;
+	passed = check(reader.readPacket(packet, size, sink), what) && passed;
+	passed = check(reader.getSendTime() == sendTime && sink.count == count, what) && passed;
+	for (unsigned int idx = 0; idx < count && idx < sink.count; ++idx) {
+		passed = check(sameEvent(sink.events[idx], events[idx]), what) && passed;
+	}
+	return passed;
+}
+
+} // anonymous namespace
+
+bool runCodecTests() {
+	bool passed = checkRoundTrip(0, 0, "a packet without events");
+
+	// -- Each field on either side of the byte boundaries of the variable length integers
+	// -- and at its limits, with the signed ones going both ways.
+	const InputEvent edges[] = {
+		makeInputEvent(0, 0, IEVT_KEY_PRESSED, 0, 0, 0),
+		makeInputEvent(63, 127, IEVT_KEY_PRESSED, 127, 63, -64),
+		makeInputEvent(127, 128, IEVT_KEY_PRESSED, 128, 127, 64),
+		makeInputEvent(64, 16383, IEVT_KEY_PRESSED, 16383, 63, -65),
+		makeInputEvent(16447, 16384, IEVT_KEY_PRESSED, 16384, 8255, 8256),
+		makeInputEvent(16447, UINT_MAX, IEVT_MOUSE_MOVED, USHRT_MAX, INT_MAX, INT_MIN),
+		makeInputEvent(16447, UINT_MAX, IEVT_MOUSE_MOVED, USHRT_MAX, INT_MIN, INT_MAX),
+		makeInputEvent(MAX_TIME, 1, IEVT_MOUSE_MOVED, 0, INT_MAX, INT_MIN),
+		makeInputEvent(0, 1, IEVT_CONTROLLER_AXIS_MOVED, 1, -1, 1),
+		makeInputEvent(MAX_TIME / 2, 1, IEVT_CONTROLLER_AXIS_MOVED, 1, 1, -1)
+	};
+	passed = checkRoundTrip(edges, sizeof(edges) / sizeof(edges[0]), "varint edge values") && 
+	         passed;
+
+	// -- Fill a packet with events that take the most bytes until the writer refuses one.
+	static InputEvent full[MAX_EVENTS];
+	EventPacketWriter writer;
+	unsigned int count = 0;
+	for (; count < MAX_EVENTS; ++count) {
+		const bool odd = (count & 1) != 0;
+		full[count] = makeInputEvent(odd ? MAX_TIME / 2 + count : count, odd ? UINT_MAX : 1, 
+		                             IEVT_CONTROLLER_AXIS_MOVED, USHRT_MAX, 
+		                             odd ? INT_MAX : INT_MIN, odd ? INT_MIN : INT_MAX);
+		if (writer.addEvent(full[count]) == false) {
+			break;
+		}
+	}
+	passed = check(count > 0 && count < MAX_EVENTS, "the writer refusing a full packet") && 
+	         passed;
+	passed = checkRoundTrip(full, count, "a full packet") && passed;
+
+	// -- A packet cut short in the middle of an event must be refused, whether the size 
+	// -- in its header is left alone or made to match.
+	EventPacketWriter cutWriter;
+	cutWriter.addEvent(edges[5]);
+	unsigned int size = 0;
+	const unsigned char* packet = cutWriter.finish(0, size);
+	unsigned char cut[EventPacketWriter::MAX_PACKET_SIZE];
+	memcpy(cut, packet, size);
+	EventPacketReader reader;
+	CollectingSink sink;
+	passed = check(reader.readPacket(cut, size - 1, sink) == false, 
+	               "a packet shorter than its header says") && passed;
+	for (unsigned int length = EventPacketWriter::HEADER_SIZE + 1; length < size; ++length) {
+		cut[0] = static_cast<unsigned char>(length - 2);
+		cut[1] = static_cast<unsigned char>((length - 2) >> 8);
+		passed = check(reader.readPacket(cut, length, sink) == false, 
+		               "a packet cut in the middle of an event") && passed;
+	}
+	passed = check(reader.readPacket(cut, EventPacketWriter::HEADER_SIZE - 1, sink) == false,
+	               "a packet shorter than a header") && passed;
+	passed = check(sink.count == 0, "events of a cut packet") && passed;
+	return passed;
+}
+
+} // namespace I43DTest
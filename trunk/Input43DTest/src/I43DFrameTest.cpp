@@ -0,0 +1,131 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+
+#include "I43DTest.h"
+#include "I43DInputFrame.h"
+#include <cstring>
+
+/*!
+ * @file
+ *     This file contains the tests of the frame deltas. Frames without changes, with one 
+ *     changed word, with every word changed by a bit and with every bit changed, which 
+ *     takes the largest delta, are encoded and decoded again. Deltas cut short and deltas
+ *     that claim a changed block without changed words must be refused.
+ * @author Robert Eugene Simmons Jr. (Kraythe)
+ */
+
+using namespace I43D;
+
+namespace I43DTest {
+
+namespace {
+
+/*!
+ * @brief
+ *     Encodes a frame against another, decodes it and checks that it comes back the same.
+ * @param previous
+ *     The frame the delta is encoded against.
+ * @param frame
+ *     The frame to encode.
+ * @param expectedSize
+ *     The size the delta must take, or 0 to not check it.
+ * @param what
+ *     The name of the case, printed if it fails.
+ * @return
+ *     False if the case failed.
+ */
+bool checkRoundTrip(const InputFrame& previous, const InputFrame& frame, 
+                    const unsigned int expectedSize, const char* what) {
+	unsigned char buffer[InputFrame::MAX_DELTA_SIZE];
+	const unsigned int size = frame.encodeDelta(previous, buffer);
+	bool passed = check(size > 0 && size <= InputFrame::MAX_DELTA_SIZE, what);
+	if (expectedSize != 0) {
+		passed = check(size == expectedSize, what) && passed;
+	}
+
+	InputFrame decoded;
+	decoded.clear();
+	passed = check(decoded.decodeDelta(previous, buffer, size) == size, what) && passed;
+	passed = check(decoded.equals(frame), what) && passed;
+
+	// -- Every byte of a delta is needed, so any shorter read must be refused and must 
+	// -- leave the frame alone.
+	for (unsigned int cut = 0; cut < size; ++cut) {
+		InputFrame truncated = previous;
+		if (check(truncated.decodeDelta(previous, buffer, cut) == 0, what) == false ||
+		    check(truncated.equals(previous), what) == false) {
+			return false;
+		}
+	}
+	return passed;
+}
+
+} // anonymous namespace
+
+bool runFrameTests() {
+	InputFrame empty;
+	empty.clear();
+
+	bool passed = checkRoundTrip(empty, empty, 1, "a frame without changes");
+
+	InputFrame keyDown = empty;
+	keyDown.setKey(30, true);
+	passed = checkRoundTrip(empty, keyDown, 3, "a key press") && passed;
+	passed = checkRoundTrip(keyDown, empty, 3, "a key release") && passed;
+
+	InputFrame oneWord = empty;
+	oneWord.axes[3] = -12345;
+	passed = checkRoundTrip(empty, oneWord, 0, "one word with many changed bits") && passed;
+
+	// -- One bit in every word takes the short form for each of them.
+	InputFrame everyWord = empty;
+	unsigned int words[InputFrame::WORD_COUNT];
+	for (unsigned int word = 0; word < InputFrame::WORD_COUNT; ++word) {
+		words[word] = 1u << (word + 7);
+	}
+	memcpy(&everyWord, words, sizeof(words));
+	passed = checkRoundTrip(empty, everyWord, 0, "every word changed by one bit") && passed;
+
+	// -- Every bit changed takes the long form for every word, the largest delta there is.
+	InputFrame full;
+	memset(&full, 0xFF, sizeof(full));
+	passed = checkRoundTrip(empty, full, InputFrame::MAX_DELTA_SIZE, "every bit changed") && 
+	         passed;
+	passed = checkRoundTrip(full, empty, InputFrame::MAX_DELTA_SIZE, "every bit cleared") && 
+	         passed;
+
+	// -- Deltas are sent back to back, so decoding must stop at the end of the first.
+	unsigned char stream[2 * InputFrame::MAX_DELTA_SIZE];
+	const unsigned int first = keyDown.encodeDelta(empty, stream);
+	const unsigned int second = empty.encodeDelta(keyDown, stream + first);
+	InputFrame decoded = empty;
+	passed = check(decoded.decodeDelta(empty, stream, first + second) == first &&
+	               decoded.equals(keyDown), "the first of two deltas") && passed;
+	passed = check(decoded.decodeDelta(keyDown, stream + first, second) == second &&
+	               decoded.equals(empty), "the second of two deltas") && passed;
+
+	// -- A changed block must name at least one changed word.
+	const unsigned char noWords[] = { 0x01, 0x00 };
+	passed = check(decoded.decodeDelta(empty, noWords, sizeof(noWords)) == 0, 
+	               "a changed block without changed words") && passed;
+	return passed;
+}
+
+} // namespace I43DTest
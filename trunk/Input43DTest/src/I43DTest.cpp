@@ -0,0 +1,52 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+
+#include "I43DTest.h"
+#include <cstdio>
+
+/*!
+ * @file
+ *     This file contains the driver of the tests. It runs every test and returns 1 if any 
+ *     failed.
+ * @author Robert Eugene Simmons Jr. (Kraythe)
+ */
+
+namespace I43DTest {
+
+bool check(const bool condition, const char* what) {
+	if (condition == false) {
+		printf("FAILED: %s\n", what);
+	}
+	return condition;
+}
+
+} // namespace I43DTest
+
+int main() {
+	// -- Every test runs even if an earlier one failed, so one run shows all failures.
+	bool passed = I43DTest::runFrameTests();
+	passed = I43DTest::runCodecTests() && passed;
+	passed = I43DTest::runAllocationTest() && passed;
+	if (passed == false) {
+		return 1;
+	}
+	printf("passed\n");
+	return 0;
+}
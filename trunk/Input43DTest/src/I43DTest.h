@@ -0,0 +1,72 @@
+/* -------------------------------------------------------------------------------------
+This source file is part of Input43D : Copyright (c) 2000-2005 The Input43D Team
+----------------------------------------------------------------------------------------
+LICENSE:
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU Lesser General Public License as published by the Free Software
+Foundation; either version 2 of the License, or (at your option) any later
+version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+http://www.gnu.org/copyleft/lesser.txt.
+------------------------------------------------------------------------------------- */
+
+#ifndef _I43D_TEST_H_
+#define _I43D_TEST_H_
+
+/*!
+ * @file
+ *     This file contains the helpers shared by the tests of the Input43D library and the 
+ *     tests the driver runs.
+ * @author Robert Eugene Simmons Jr. (Kraythe)
+ */
+
+namespace I43DTest {
+
+/*!
+ * @brief
+ *     Checks a condition of a test and prints what failed if it does not hold.
+ * @param condition
+ *     The condition.
+ * @param what
+ *     What the condition checks, printed if it does not hold.
+ * @return
+ *     The condition.
+ */
+bool check(const bool condition, const char* what);
+
+/*!
+ * @brief
+ *     Tests that the event path does not allocate once it is warmed up.
+ * @return
+ *     False if the test failed.
+ */
+bool runAllocationTest();
+
+/*!
+ * @brief
+ *     Tests that frames survive being encoded as deltas and decoded again. See 
+ *     I43DInputFrame.h.
+ * @return
+ *     False if a test failed.
+ */
+bool runFrameTests();
+
+/*!
+ * @brief
+ *     Tests that events survive being written into packets and read again. See 
+ *     I43DEventCodec.h.
+ * @return
+ *     False if a test failed.
+ */
+bool runCodecTests();
+
+} // namespace I43DTest
+#endif  // _I43D_TEST_H_